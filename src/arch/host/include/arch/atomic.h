@@ -33,6 +33,16 @@ static inline void arch_atomic_init(atomic_t *a, int32_t value)
 }
 
 /* use gcc atomic built-ins for host library */
+static inline int32_t arch_atomic_read_acquire(const atomic_t *a)
+{
+	return __atomic_load_n(&a->value, __ATOMIC_ACQUIRE);
+}
+
+static inline void arch_atomic_set_release(atomic_t *a, int32_t value)
+{
+	__atomic_store_n(&a->value, value, __ATOMIC_RELEASE);
+}
+
 static inline int32_t arch_atomic_add(atomic_t *a, int32_t value)
 {
 	return __sync_fetch_and_add(&a->value, value);
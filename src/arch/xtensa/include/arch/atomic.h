@@ -35,6 +35,24 @@ static inline void arch_atomic_init(atomic_t *a, int32_t value)
 	arch_atomic_set(a, value);
 }
 
+/* memw orders the load before all the following memory accesses */
+static inline int32_t arch_atomic_read_acquire(const atomic_t *a)
+{
+	int32_t value = arch_atomic_read(a);
+
+	__asm__ __volatile__("memw" : : : "memory");
+
+	return value;
+}
+
+/* memw completes all the previous memory accesses before the store */
+static inline void arch_atomic_set_release(atomic_t *a, int32_t value)
+{
+	__asm__ __volatile__("memw" : : : "memory");
+
+	arch_atomic_set(a, value);
+}
+
 #if XCHAL_HAVE_EXCLUSIVE && CONFIG_XTENSA_EXCLUSIVE && __XCC__
 
 /* Use exclusive instructions */
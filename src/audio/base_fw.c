@@ -2,6 +2,8 @@
 //
 
 #include <sof/audio/component.h>
+#include <sof/ipc/common.h>
+#include <sof/lib/perf_cnt.h>
 #include <sof/lib/memory.h>
 #include <sof/ut.h>
 #include <ipc4/base_fw.h>
@@ -256,6 +258,68 @@ static int basefw_get_dsp_properties(uint32_t *data_offset, char *data)
 	return 0;
 }
 
+#if CONFIG_COMP_PROFILING
+static void basefw_comp_profile_item(struct ipc4_comp_profile_item *item,
+				     struct comp_dev *cd)
+{
+	struct perf_cnt_profile *prof = &cd->prof;
+	int i;
+
+	memset(item, 0, sizeof(*item));
+	item->mi.item.resource_id = dev_comp_id(cd);
+	item->mi.total_iteration_count = prof->count;
+	item->mi.total_cycles_consumed = prof->cycles_total;
+	item->budget_cycles = prof->budget;
+	item->avg_cycles = perf_cnt_profile_avg(prof);
+	item->p99_cycles = perf_cnt_profile_p99(prof);
+	item->peak_cycles = prof->cycles_peak;
+	item->deadline_misses = prof->deadline_misses;
+	item->frames = prof->frames;
+	for (i = 0; i < IPC4_COMP_PROFILE_BINS; i++)
+		item->hist[i] = prof->hist[i];
+
+	/* period is in us, one period of cycles per period us */
+	if (cd->period) {
+		item->mi.item.avg_kcps = (uint64_t)item->avg_cycles * 1000 / cd->period;
+		item->mi.item.peak_kcps = (uint64_t)item->peak_cycles * 1000 / cd->period;
+	}
+}
+
+/* copy() cycles profile of all components, starting from item first */
+static int basefw_comp_profile(uint32_t first, uint32_t *data_offset, char *data)
+{
+	struct ipc4_comp_profile_data *perf = (struct ipc4_comp_profile_data *)data;
+	uint32_t max_items = (SOF_IPC_MSG_MAX_SIZE - sizeof(uint32_t) - sizeof(*perf)) /
+		sizeof(struct ipc4_comp_profile_item);
+	struct list_item *clist;
+	struct ipc_comp_dev *icd;
+	uint32_t index = 0;
+
+	STATIC_ASSERT(IPC4_COMP_PROFILE_BINS == PERF_CNT_PROF_BINS,
+		      invalid_comp_profile_bins);
+
+	perf->first_item = first;
+	perf->perf_item_count = 0;
+
+	list_for_item(clist, &ipc_get()->comp_list) {
+		icd = container_of(clist, struct ipc_comp_dev, list);
+		if (icd->type != COMP_TYPE_COMPONENT)
+			continue;
+
+		if (index >= first && perf->perf_item_count < max_items)
+			basefw_comp_profile_item(&perf->perf_items[perf->perf_item_count++],
+						 icd->cd);
+		index++;
+	}
+
+	perf->total_item_count = index;
+	*data_offset = sizeof(*perf) +
+		perf->perf_item_count * sizeof(struct ipc4_comp_profile_item);
+
+	return 0;
+}
+#endif
+
 static int basefw_get_large_config(struct comp_dev *dev,
 				   uint32_t param_id,
 				   bool first_block,
@@ -266,6 +330,7 @@ static int basefw_get_large_config(struct comp_dev *dev,
 	switch (param_id) {
 	case IPC4_PERF_MEASUREMENTS_STATE:
 	case IPC4_GLOBAL_PERF_DATA:
+	case IPC4_SOF_COMP_PROFILE_DATA:
 		break;
 	default:
 		if (!first_block)
@@ -281,6 +346,11 @@ static int basefw_get_large_config(struct comp_dev *dev,
 		return basefw_mem_state_info(data_offset, data);
 	case IPC4_DSP_PROPERTIES:
 		return basefw_get_dsp_properties(data_offset, data);
+#if CONFIG_COMP_PROFILING
+	case IPC4_SOF_COMP_PROFILE_DATA:
+		return basefw_comp_profile(first_block ? 0 : *data_offset,
+					   data_offset, data);
+#endif
 	/* TODO: add more support */
 	case IPC4_DSP_RESOURCE_STATE:
 	case IPC4_NOTIFICATION_MASK:
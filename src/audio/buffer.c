@@ -5,11 +5,13 @@
 // Author: Liam Girdwood <liam.r.girdwood@linux.intel.com>
 //         Keyon Jie <yang.jie@linux.intel.com>
 
+#include <sof/atomic.h>
 #include <sof/audio/buffer.h>
 #include <sof/audio/component.h>
 #include <sof/drivers/interrupt.h>
 #include <sof/lib/alloc.h>
 #include <sof/lib/cache.h>
+#include <sof/lib/cpu.h>
 #include <sof/lib/memory.h>
 #include <sof/lib/notifier.h>
 #include <sof/list.h>
@@ -84,6 +86,14 @@ int buffer_set_size(struct comp_buffer *buffer, uint32_t size)
 	if (size == buffer->stream.size)
 		return 0;
 
+#if CONFIG_BUFFER_INPLACE
+	/* shared memory is not resized, the buffers get own memory back */
+	if (buffer->inplace_source)
+		buffer_inplace_unlink(buffer);
+	if (buffer->inplace_sink)
+		buffer_inplace_unlink(buffer->inplace_sink);
+#endif
+
 	new_ptr = rbrealloc(buffer->stream.addr, SOF_MEM_FLAG_NO_COPY,
 			    buffer->caps, size, buffer->stream.size);
 
@@ -152,6 +162,250 @@ bool buffer_params_match(struct comp_buffer *buffer, struct sof_ipc_stream_param
 	return true;
 }
 
+#if CONFIG_BUFFER_SPSC
+/*
+ * The lock-free mode positions run modulo two buffer sizes, so a full buffer
+ * is told apart from an empty one without a shared avail counter.
+ */
+static inline uint32_t buffer_spsc_avail(const struct audio_stream *stream,
+					 uint32_t w_pos, uint32_t r_pos)
+{
+	return w_pos >= r_pos ? w_pos - r_pos : w_pos + 2 * stream->size - r_pos;
+}
+
+static inline uint32_t buffer_spsc_advance(const struct audio_stream *stream,
+					   uint32_t pos, uint32_t bytes)
+{
+	pos += bytes;
+
+	return pos >= 2 * stream->size ? pos - 2 * stream->size : pos;
+}
+
+static inline void *buffer_spsc_ptr(const struct audio_stream *stream, uint32_t pos)
+{
+	return (char *)stream->addr + (pos >= stream->size ? pos - stream->size : pos);
+}
+
+void buffer_spsc_enable(struct comp_buffer *buffer)
+{
+	struct coherent *c = coherent_acquire_thread(&buffer->c, sizeof(*buffer));
+
+	buffer = container_of(c, struct comp_buffer, c);
+
+	/* the link is set up before streaming so start from empty buffer */
+	audio_stream_reset(&buffer->stream);
+	buffer_spsc_reset(buffer);
+	buffer->spsc = true;
+
+	coherent_release_thread(&buffer->c, sizeof(*buffer));
+}
+
+void buffer_spsc_sync_producer(struct comp_buffer *buffer)
+{
+	struct buffer_spsc *pos = cache_to_uncache(&buffer->spsc_pos);
+	struct audio_stream *stream = &buffer->stream;
+	uint32_t w_pos = atomic_read(&pos->w_pos);
+	uint32_t r_pos = atomic_read_acquire(&pos->r_pos);
+
+	stream->w_ptr = buffer_spsc_ptr(stream, w_pos);
+	stream->free = stream->size - buffer_spsc_avail(stream, w_pos, r_pos);
+}
+
+void buffer_spsc_sync_consumer(struct comp_buffer *buffer)
+{
+	struct buffer_spsc *pos = cache_to_uncache(&buffer->spsc_pos);
+	struct audio_stream *stream = &buffer->stream;
+	uint32_t r_pos = atomic_read(&pos->r_pos);
+	uint32_t w_pos = atomic_read_acquire(&pos->w_pos);
+	uint32_t w_seen = atomic_read(&pos->w_seen);
+	uint32_t bytes;
+	uint32_t head;
+	char *ptr;
+
+	/* invalidate only the data published since the previous sync */
+	if (w_pos != w_seen) {
+		bytes = buffer_spsc_avail(stream, w_pos, w_seen);
+		ptr = buffer_spsc_ptr(stream, w_seen);
+		head = MIN(bytes, (char *)stream->end_addr - ptr);
+		dcache_invalidate_region(ptr, head);
+		if (bytes > head)
+			dcache_invalidate_region(stream->addr, bytes - head);
+
+		atomic_set(&pos->w_seen, w_pos);
+	}
+
+	stream->r_ptr = buffer_spsc_ptr(stream, r_pos);
+	stream->avail = buffer_spsc_avail(stream, w_pos, r_pos);
+}
+
+void buffer_spsc_sync(struct comp_buffer *buffer)
+{
+	if (buffer->source && cpu_is_me(buffer->source->ipc_config.core))
+		buffer_spsc_sync_producer(buffer);
+
+	if (buffer->sink && cpu_is_me(buffer->sink->ipc_config.core))
+		buffer_spsc_sync_consumer(buffer);
+}
+
+static void buffer_spsc_produce(struct comp_buffer *buffer, uint32_t bytes)
+{
+	struct buffer_spsc *pos = cache_to_uncache(&buffer->spsc_pos);
+	struct audio_stream *stream = &buffer->stream;
+	uint32_t w_pos = atomic_read(&pos->w_pos);
+	uint32_t r_pos = atomic_read_acquire(&pos->r_pos);
+	uint32_t free = stream->size - buffer_spsc_avail(stream, w_pos, r_pos);
+
+	/* the consumer owns the read position so overrun drops the new data */
+	if (bytes > free) {
+		buf_warn(buffer, "buffer_spsc_produce(): overrun of %u bytes", bytes - free);
+		bytes = free;
+	}
+
+	/* write back only the produced cache lines before publishing them */
+	stream->w_ptr = buffer_spsc_ptr(stream, w_pos);
+	audio_stream_writeback(stream, bytes);
+
+	w_pos = buffer_spsc_advance(stream, w_pos, bytes);
+	atomic_set_release(&pos->w_pos, w_pos);
+
+	stream->w_ptr = buffer_spsc_ptr(stream, w_pos);
+	stream->free = free - bytes;
+}
+
+static void buffer_spsc_consume(struct comp_buffer *buffer, uint32_t bytes)
+{
+	struct buffer_spsc *pos = cache_to_uncache(&buffer->spsc_pos);
+	struct audio_stream *stream = &buffer->stream;
+	uint32_t r_pos = atomic_read(&pos->r_pos);
+	uint32_t w_pos = atomic_read_acquire(&pos->w_pos);
+	uint32_t avail = buffer_spsc_avail(stream, w_pos, r_pos);
+
+	/* the producer owns the write position so underrun can't skip data */
+	if (bytes > avail) {
+		buf_warn(buffer, "buffer_spsc_consume(): underrun of %u bytes", bytes - avail);
+		bytes = avail;
+	}
+
+	/* the data reads are complete before the space is released */
+	r_pos = buffer_spsc_advance(stream, r_pos, bytes);
+	atomic_set_release(&pos->r_pos, r_pos);
+
+	stream->r_ptr = buffer_spsc_ptr(stream, r_pos);
+	stream->avail = avail - bytes;
+}
+#endif
+
+#if CONFIG_BUFFER_INPLACE
+/* set memory of the buffer and of the buffers using it, positions are reset */
+static void buffer_inplace_set_addr(struct comp_buffer *buffer, void *addr)
+{
+	struct comp_buffer *b;
+
+	while (buffer) {
+		b = buffer_acquire(buffer);
+		b->stream.addr = addr;
+		buffer_init(b, b->stream.size, b->caps);
+		buffer = b->inplace_sink;
+		buffer_release(b);
+	}
+}
+
+static void buffer_inplace_clear_sink(struct comp_buffer *buffer)
+{
+	buffer = buffer_acquire(buffer);
+	buffer->inplace_sink = NULL;
+	buffer_release(buffer);
+}
+
+int buffer_inplace_link(struct comp_buffer *source, struct comp_buffer *sink)
+{
+	struct comp_buffer *src = buffer_acquire(source);
+	struct comp_buffer *snk = buffer_acquire(sink);
+	struct comp_buffer *prev = snk->inplace_source;
+	void *addr = src->stream.addr;
+	int ret = 0;
+
+	if (prev == source)
+		goto out;
+
+	if (src->stream.size != snk->stream.size || src->inplace_sink) {
+		buf_err(snk, "buffer_inplace_link(): can't use memory of buffer %u",
+			src->id);
+		ret = -EINVAL;
+		goto out;
+	}
+
+	/* own memory is kept, so unlink can always give it back */
+	if (!prev)
+		snk->inplace_addr = snk->stream.addr;
+
+	snk->inplace_source = source;
+	src->inplace_sink = sink;
+
+	buf_info(snk, "buffer_inplace_link(): in place with buffer %u", src->id);
+
+out:
+	buffer_release(snk);
+	buffer_release(src);
+
+	if (ret < 0 || prev == source)
+		return ret;
+
+	if (prev)
+		buffer_inplace_clear_sink(prev);
+
+	buffer_inplace_set_addr(sink, addr);
+
+	return 0;
+}
+
+void buffer_inplace_unlink(struct comp_buffer *sink)
+{
+	struct comp_buffer *snk = buffer_acquire(sink);
+	struct comp_buffer *source = snk->inplace_source;
+	void *addr = snk->inplace_addr;
+
+	snk->inplace_source = NULL;
+	snk->inplace_addr = NULL;
+	buffer_release(snk);
+
+	if (!source)
+		return;
+
+	buffer_inplace_clear_sink(source);
+	buffer_inplace_set_addr(sink, addr);
+}
+
+/*
+ * The data consumed by an in-place component stays in the memory as the
+ * data of its sink buffer, so the free space of each buffer sharing the
+ * memory excludes the data available in the buffers after it.
+ */
+static void buffer_inplace_update_free(struct comp_buffer *buffer)
+{
+	struct comp_buffer *b = buffer_acquire(buffer);
+	uint32_t used = 0;
+
+	/* start from the last buffer using the memory */
+	while (b->inplace_sink) {
+		buffer = b->inplace_sink;
+		buffer_release(b);
+		b = buffer_acquire(buffer);
+	}
+
+	for (;;) {
+		used += b->stream.avail;
+		b->stream.free = b->stream.size - used;
+		buffer = b->inplace_source;
+		buffer_release(b);
+		if (!buffer)
+			break;
+
+		b = buffer_acquire(buffer);
+	}
+}
+#endif
+
 /* free component in the pipeline */
 void buffer_free(struct comp_buffer *buffer)
 {
@@ -170,6 +424,16 @@ void buffer_free(struct comp_buffer *buffer)
 	/* In case some listeners didn't unregister from buffer's callbacks */
 	notifier_unregister_all(NULL, buffer);
 
+#if CONFIG_BUFFER_INPLACE
+	/* the buffer using this memory needs own memory now */
+	if (buffer->inplace_sink)
+		buffer_inplace_unlink(buffer->inplace_sink);
+
+	/* and this buffer frees own memory */
+	if (buffer->inplace_source)
+		buffer_inplace_unlink(buffer);
+#endif
+
 	coherent_free_thread(buffer, c);
 	rfree(buffer->stream.addr);
 	rfree(buffer);
@@ -182,6 +446,9 @@ void comp_update_buffer_produce(struct comp_buffer *buffer, uint32_t bytes)
 		.transaction_amount = bytes,
 		.transaction_begin_address = buffer->stream.w_ptr,
 	};
+#if CONFIG_BUFFER_INPLACE
+	bool inplace;
+#endif
 
 	/* return if no bytes */
 	if (!bytes) {
@@ -195,7 +462,18 @@ void comp_update_buffer_produce(struct comp_buffer *buffer, uint32_t bytes)
 
 	buffer = buffer_acquire(buffer);
 
+#if CONFIG_BUFFER_SPSC
+	if (buffer->spsc)
+		buffer_spsc_produce(buffer, bytes);
+	else
+		audio_stream_produce(&buffer->stream, bytes);
+#else
 	audio_stream_produce(&buffer->stream, bytes);
+#endif
+
+#if CONFIG_BUFFER_INPLACE
+	inplace = buffer->inplace_source || buffer->inplace_sink;
+#endif
 
 	notifier_event(buffer, NOTIFIER_ID_BUFFER_PRODUCE,
 		       NOTIFIER_TARGET_CORE_LOCAL, &cb_data, sizeof(cb_data));
@@ -209,6 +487,11 @@ void comp_update_buffer_produce(struct comp_buffer *buffer, uint32_t bytes)
 		((char *)buffer->stream.w_ptr - (char *)buffer->stream.addr));
 
 	buffer = buffer_release(buffer);
+
+#if CONFIG_BUFFER_INPLACE
+	if (inplace)
+		buffer_inplace_update_free(buffer);
+#endif
 }
 
 void comp_update_buffer_consume(struct comp_buffer *buffer, uint32_t bytes)
@@ -218,6 +501,9 @@ void comp_update_buffer_consume(struct comp_buffer *buffer, uint32_t bytes)
 		.transaction_amount = bytes,
 		.transaction_begin_address = buffer->stream.r_ptr,
 	};
+#if CONFIG_BUFFER_INPLACE
+	bool inplace;
+#endif
 
 	/* return if no bytes */
 	if (!bytes) {
@@ -231,7 +517,18 @@ void comp_update_buffer_consume(struct comp_buffer *buffer, uint32_t bytes)
 
 	buffer = buffer_acquire(buffer);
 
+#if CONFIG_BUFFER_SPSC
+	if (buffer->spsc)
+		buffer_spsc_consume(buffer, bytes);
+	else
+		audio_stream_consume(&buffer->stream, bytes);
+#else
 	audio_stream_consume(&buffer->stream, bytes);
+#endif
+
+#if CONFIG_BUFFER_INPLACE
+	inplace = buffer->inplace_source || buffer->inplace_sink;
+#endif
 
 	notifier_event(buffer, NOTIFIER_ID_BUFFER_CONSUME,
 		       NOTIFIER_TARGET_CORE_LOCAL, &cb_data, sizeof(cb_data));
@@ -244,4 +541,9 @@ void comp_update_buffer_consume(struct comp_buffer *buffer, uint32_t bytes)
 		((char *)buffer->stream.w_ptr - (char *)buffer->stream.addr));
 
 	buffer = buffer_release(buffer);
+
+#if CONFIG_BUFFER_INPLACE
+	if (inplace)
+		buffer_inplace_update_free(buffer);
+#endif
 }
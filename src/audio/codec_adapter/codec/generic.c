@@ -92,7 +92,8 @@ int module_init(struct processing_module *mod, struct module_interface *interfac
 		return -EIO;
 	}
 
-	if (!interface->init || !interface->prepare || !interface->process ||
+	if (!interface->init || !interface->prepare ||
+	    (!interface->process && !interface->process_segments) ||
 	    !interface->reset || !interface->free) {
 		comp_err(dev, "module_init(): comp %d is missing mandatory interfaces",
 			 dev_comp_id(dev));
@@ -258,6 +259,84 @@ int module_process(struct processing_module *mod, struct input_stream_buffer *in
 	return ret;
 }
 
+int module_process_segments(struct processing_module *mod,
+			    const struct module_stream_segments *input,
+			    const struct module_stream_segments *output)
+{
+	struct comp_dev *dev = mod->dev;
+	struct module_data *md = &mod->priv;
+	int ret;
+
+	comp_dbg(dev, "module_process_segments() start");
+
+	if (md->state != MODULE_IDLE) {
+		comp_err(dev, "module_process_segments(): wrong state of comp_id %x, state %d",
+			 dev_comp_id(dev), md->state);
+		return -EPERM;
+	}
+
+	/* set state to processing */
+	md->state = MODULE_PROCESSING;
+
+	ret = md->ops->process_segments(mod, input, output);
+
+	/* reset state to idle, also on error so the next copy can retry */
+	md->state = MODULE_IDLE;
+
+	if (ret && ret != -ENOSPC) {
+		comp_err(dev, "module_process_segments() error %d: for comp %d",
+			 ret, dev_comp_id(dev));
+		return ret;
+	}
+
+	/* the module must not use more than it was given */
+	if (md->mpd.consumed > input->bytes || md->mpd.produced > output->bytes) {
+		comp_err(dev, "module_process_segments(): consumed %u of %u, produced %u of %u",
+			 md->mpd.consumed, input->bytes, md->mpd.produced, output->bytes);
+		return -EINVAL;
+	}
+
+	comp_dbg(dev, "module_process_segments() done");
+
+	return ret;
+}
+
+/**
+ * \brief Copy data from the input segments to the output segments
+ * \param[in] output - output segments, filled from the first one
+ * \param[in] input - input segments, read from the first one
+ * \param[in] bytes - bytes to copy, not more than the size of either
+ */
+void module_segments_copy(const struct module_stream_segments *output,
+			  const struct module_stream_segments *input, uint32_t bytes)
+{
+	uint32_t in_offset = 0;
+	uint32_t out_offset = 0;
+	uint32_t size;
+	int in = 0;
+	int out = 0;
+
+	/* copy in chunks that end where either of the regions wraps */
+	while (bytes) {
+		size = MIN(input->seg[in].size - in_offset, output->seg[out].size - out_offset);
+		size = MIN(size, bytes);
+		memcpy_s((char *)output->seg[out].ptr + out_offset,
+			 output->seg[out].size - out_offset,
+			 (char *)input->seg[in].ptr + in_offset, size);
+		bytes -= size;
+		in_offset += size;
+		out_offset += size;
+		if (in_offset == input->seg[in].size) {
+			in++;
+			in_offset = 0;
+		}
+		if (out_offset == output->seg[out].size) {
+			out++;
+			out_offset = 0;
+		}
+	}
+}
+
 int module_reset(struct processing_module *mod)
 {
 	int ret;
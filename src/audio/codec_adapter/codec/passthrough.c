@@ -78,6 +78,27 @@ passthrough_codec_process(struct processing_module *mod,
 	return 0;
 }
 
+static int
+passthrough_codec_process_segments(struct processing_module *mod,
+				   const struct module_stream_segments *input,
+				   const struct module_stream_segments *output)
+{
+	struct comp_dev *dev = mod->dev;
+	struct module_data *codec = comp_get_module_data(dev);
+	uint32_t bytes = MIN(input->bytes, output->bytes);
+
+	if (!codec->mpd.init_done)
+		return passthrough_codec_init_process(dev);
+
+	comp_dbg(dev, "passthrough_codec_process_segments()");
+
+	module_segments_copy(output, input, bytes);
+	codec->mpd.produced = bytes;
+	codec->mpd.consumed = bytes;
+
+	return 0;
+}
+
 static int passthrough_codec_reset(struct processing_module *mod)
 {
 	comp_info(mod->dev, "passthrough_codec_reset()");
@@ -103,6 +124,7 @@ static struct module_interface passthrough_interface = {
 	.init  = passthrough_codec_init,
 	.prepare = passthrough_codec_prepare,
 	.process = passthrough_codec_process,
+	.process_segments = passthrough_codec_process_segments,
 	.reset = passthrough_codec_reset,
 	.free = passthrough_codec_free
 };
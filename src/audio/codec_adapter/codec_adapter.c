@@ -315,10 +315,164 @@ static void generate_zeroes(struct comp_buffer *sink, uint32_t bytes)
 	comp_update_buffer_produce(sink, bytes);
 }
 
+/**
+ * \brief Copy a period of processed data from the local buffer to the sink.
+ * \param[in] dev - codec adapter component device pointer.
+ * \param[in] sink - a pointer to sink buffer.
+ * \param[in] produced - bytes produced by the module in this copy.
+ *
+ * Zeroes are produced instead while the deep buffering is in progress.
+ */
+static void ca_copy_to_sink(struct comp_dev *dev, struct comp_buffer *sink, uint32_t produced)
+{
+	struct processing_module *mod = comp_get_drvdata(dev);
+	struct comp_buffer *local_buff = mod->local_buff;
+	struct comp_copy_limits cl;
+	uint32_t copy_bytes;
+
+	if (!produced && !mod->deep_buff_bytes) {
+		comp_dbg(dev, "codec_adapter_copy(): nothing processed in this call");
+		/* we haven't produced anything in this period but we
+		 * still have data in the local buffer to copy to sink
+		 */
+		if (audio_stream_get_avail_bytes(&local_buff->stream) < mod->period_bytes)
+			return;
+	} else if (mod->deep_buff_bytes) {
+		if (mod->deep_buff_bytes >= audio_stream_get_avail_bytes(&local_buff->stream)) {
+			generate_zeroes(sink, mod->period_bytes);
+			return;
+		}
+
+		comp_dbg(dev, "codec_adapter_copy(): deep buffering has ended after gathering %d bytes of processed data",
+			 audio_stream_get_avail_bytes(&local_buff->stream));
+		mod->deep_buff_bytes = 0;
+	}
+
+	comp_get_copy_limits_with_lock(local_buff, sink, &cl);
+	copy_bytes = cl.frames * cl.source_frame_bytes;
+	audio_stream_copy(&local_buff->stream, 0,
+			  &sink->stream, 0,
+			  copy_bytes / mod->stream_params.sample_container_bytes);
+	buffer_stream_writeback(sink, copy_bytes);
+
+	comp_update_buffer_produce(sink, copy_bytes);
+	comp_update_buffer_consume(local_buff, copy_bytes);
+}
+
+/**
+ * Function to describe a region of a circular buffer as segments split at the wrap
+ * @stream: audio buffer stream
+ * @ptr: start of the region in the stream
+ * @bytes: size of the region
+ * @segs: segments to fill
+ */
+static void ca_stream_segments(const struct audio_stream *stream, void *ptr, uint32_t bytes,
+			       struct module_stream_segments *segs)
+{
+	const uint32_t without_wrap = audio_stream_bytes_without_wrap(stream, ptr);
+	uint32_t head_size = MIN(bytes, without_wrap);
+
+	segs->seg[0].ptr = ptr;
+	segs->seg[0].size = head_size;
+	segs->seg[1].ptr = stream->addr;
+	segs->seg[1].size = bytes - head_size;
+	segs->bytes = bytes;
+}
+
+/**
+ * \brief Let the module process one codec buffer of the source in place.
+ * \param[in] mod - processing module pointer.
+ * \param[in] source - a pointer to source buffer.
+ * \param[in,out] bytes - bytes left to process in the source.
+ * \param[in,out] produced - bytes produced to the local buffer.
+ *
+ * \return: 0 on success or the module_process_segments() error.
+ */
+static int ca_process_segments(struct processing_module *mod, struct comp_buffer *source,
+			       uint32_t *bytes, uint32_t *produced)
+{
+	struct module_data *md = &mod->priv;
+	struct audio_stream *local = &mod->local_buff->stream;
+	struct module_stream_segments input;
+	struct module_stream_segments output;
+	int ret;
+
+	buffer_stream_invalidate(source, md->mpd.in_buff_size);
+	ca_stream_segments(&source->stream, source->stream.r_ptr, md->mpd.in_buff_size, &input);
+	ca_stream_segments(local, local->w_ptr, audio_stream_get_free_bytes(local), &output);
+
+	md->mpd.consumed = 0;
+	md->mpd.produced = 0;
+	ret = module_process_segments(mod, &input, &output);
+	if (ret)
+		return ret;
+
+	/* the data would have been copied to in_buff and back from out_buff */
+	mod->copy_bytes_saved += md->mpd.consumed + md->mpd.produced;
+
+	/* producing nothing would mark an empty buffer as full */
+	if (md->mpd.produced)
+		audio_stream_produce(local, md->mpd.produced);
+	comp_update_buffer_consume(source, md->mpd.consumed);
+	*bytes -= md->mpd.consumed;
+	*produced += md->mpd.produced;
+
+	return 0;
+}
+
+/**
+ * \brief Copy for the modules processing the source and local buffers in place.
+ * \param[in] dev - codec adapter component device pointer.
+ * \param[in] source - a pointer to source buffer.
+ * \param[in] sink - a pointer to sink buffer.
+ *
+ * \return: 0 on success or the module processing error.
+ */
+static int ca_copy_segments(struct comp_dev *dev, struct comp_buffer *source,
+			    struct comp_buffer *sink)
+{
+	struct processing_module *mod = comp_get_drvdata(dev);
+	struct module_data *md = &mod->priv;
+	struct comp_copy_limits cl;
+	uint32_t bytes_to_process;
+	uint32_t produced = 0;
+	int ret = 0;
+
+	comp_get_copy_limits_with_lock(source, mod->local_buff, &cl);
+	bytes_to_process = cl.frames * cl.source_frame_bytes;
+
+	/* same as with copying, the module gets a full codec buffer */
+	if (bytes_to_process < md->mpd.in_buff_size)
+		goto out;
+
+	if (!md->mpd.init_done) {
+		ret = ca_process_segments(mod, source, &bytes_to_process, &produced);
+		if (ret)
+			return ret;
+
+		if (bytes_to_process < md->mpd.in_buff_size)
+			goto out;
+	}
+
+	ret = ca_process_segments(mod, source, &bytes_to_process, &produced);
+	if (ret == -ENOSPC)
+		ret = 0;
+	else if (ret)
+		comp_err(dev, "codec_adapter_copy() error %x: lib processing failed", ret);
+
+out:
+	ca_copy_to_sink(dev, sink, produced);
+
+	comp_dbg(dev, "codec_adapter_copy(): %d bytes left for next period, %u kB copying saved",
+		 bytes_to_process, (uint32_t)(mod->copy_bytes_saved >> 10));
+
+	return ret;
+}
+
 int codec_adapter_copy(struct comp_dev *dev)
 {
 	int ret = 0;
-	uint32_t bytes_to_process, copy_bytes, processed = 0, produced = 0;
+	uint32_t bytes_to_process, processed = 0, produced = 0;
 	struct comp_buffer *source = list_first_item(&dev->bsource_list, struct comp_buffer,
 						     sink_list);
 	struct comp_buffer *sink = list_first_item(&dev->bsink_list, struct comp_buffer,
@@ -338,6 +492,10 @@ int codec_adapter_copy(struct comp_dev *dev)
 		return -EINVAL;
 	}
 
+	/* no bounce buffers when the module can work in place */
+	if (md->ops->process_segments)
+		return ca_copy_segments(dev, source, sink);
+
 	comp_get_copy_limits_with_lock(source, local_buff, &cl);
 	bytes_to_process = cl.frames * cl.source_frame_bytes;
 
@@ -454,39 +612,8 @@ int codec_adapter_copy(struct comp_dev *dev)
 	comp_update_buffer_consume(source, md->mpd.consumed);
 
 db_verify:
-	if (!produced && !mod->deep_buff_bytes) {
-		comp_dbg(dev, "codec_adapter_copy(): nothing processed in this call");
-		/* we haven't produced anything in this period but we
-		 * still have data in the local buffer to copy to sink
-		 */
-		if (audio_stream_get_avail_bytes(&local_buff->stream) >= mod->period_bytes)
-			goto copy_period;
-
-		goto end;
-	}
+	ca_copy_to_sink(dev, sink, produced);
 
-	if (mod->deep_buff_bytes) {
-		if (mod->deep_buff_bytes >= audio_stream_get_avail_bytes(&local_buff->stream)) {
-			generate_zeroes(sink, mod->period_bytes);
-			goto end;
-		}
-
-		comp_dbg(dev, "codec_adapter_copy(): deep buffering has ended after gathering %d bytes of processed data",
-			 audio_stream_get_avail_bytes(&local_buff->stream));
-		mod->deep_buff_bytes = 0;
-	}
-
-copy_period:
-	comp_get_copy_limits_with_lock(local_buff, sink, &cl);
-	copy_bytes = cl.frames * cl.source_frame_bytes;
-	audio_stream_copy(&local_buff->stream, 0,
-			  &sink->stream, 0,
-			  copy_bytes / mod->stream_params.sample_container_bytes);
-	buffer_stream_writeback(sink, copy_bytes);
-
-	comp_update_buffer_produce(sink, copy_bytes);
-	comp_update_buffer_consume(local_buff, copy_bytes);
-end:
 	comp_dbg(dev, "codec_adapter_copy(): processed %d in this call %d bytes left for next period",
 		 processed, bytes_to_process);
 
@@ -621,6 +748,12 @@ int codec_adapter_reset(struct comp_dev *dev)
 			 ret);
 	}
 
+	if (mod->copy_bytes_saved) {
+		comp_info(dev, "codec_adapter_reset(): in place processing saved copying %u kB",
+			  (uint32_t)(mod->copy_bytes_saved >> 10));
+		mod->copy_bytes_saved = 0;
+	}
+
 	/* if module is not prepared, local_buffer won't be allocated */
 	if (mod->local_buff)
 		buffer_zero(mod->local_buff);
@@ -504,6 +504,10 @@ int audio_stream_copy(const struct audio_stream *source, uint32_t ioffset,
 	size_t bytes_snk;
 	size_t bytes_copied;
 
+	/* nothing to copy when the sink uses the source memory in place */
+	if (src == snk && source->addr == sink->addr)
+		return samples;
+
 	while (bytes) {
 		bytes_src = audio_stream_bytes_without_wrap(source, src);
 		bytes_snk = audio_stream_bytes_without_wrap(sink, snk);
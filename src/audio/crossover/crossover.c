@@ -18,6 +18,7 @@
 #include <sof/lib/memory.h>
 #include <sof/lib/uuid.h>
 #include <sof/math/iir_df2t.h>
+#include <sof/math/iir_df2t_block.h>
 #include <sof/list.h>
 #include <sof/platform.h>
 #include <sof/string.h>
@@ -48,6 +49,30 @@ static inline void crossover_free_config(struct sof_crossover_config **config)
 	*config = NULL;
 }
 
+#if IIR_DF2T_BLOCK
+/**
+ * \brief Reset the state (coefficients and delay) of the crossover filter
+ *	  across all channels.
+ */
+void crossover_reset_state_all(struct crossover_state *state)
+{
+	int i;
+
+	rfree(state->mem);
+	state->mem = NULL;
+	for (i = 0; i < CROSSOVER_4WAY_NUM_SINKS; i++)
+		state->band[i] = NULL;
+}
+
+/**
+ * \brief Reset the state (coefficients and delay) of the crossover filter
+ *	  across all channels
+ */
+static inline void crossover_reset_state(struct comp_data *cd)
+{
+	crossover_reset_state_all(&cd->state);
+}
+#else
 /**
  * \brief Reset the state of an LR4 filter.
  */
@@ -85,6 +110,7 @@ static inline void crossover_reset_state(struct comp_data *cd)
 	for (i = 0; i < PLATFORM_MAX_CHANNELS; i++)
 		crossover_reset_state_ch(&cd->state[i]);
 }
+#endif
 
 /**
  * \brief Returns the index i such that assign_sink[i] = pipe_id.
@@ -166,6 +192,115 @@ static int crossover_assign_sinks(struct comp_dev *dev,
 	return num_sinks;
 }
 
+#if IIR_DF2T_BLOCK
+/**
+ * \brief Sets single channel LR4 filters for all channels.
+ *
+ * An LR4 filter is built by cascading two biquads in series. Only one set of
+ * coefficients is stored in config for both biquads in series due to
+ * identity. To maintain the structure of iir_state_df2t, it requires two
+ * copies of coefficients in a row.
+ *
+ * \param coef struct containing the coefficients of a butterworth
+ *	       high/low pass filter.
+ * \param[out] lr4_coef two biquads coefficients
+ * \param[out] iir channel filters pointing to lr4_coef
+ * \param nch number of channels
+ */
+static void crossover_init_iir_lr4(struct sof_eq_iir_biquad_df2t *coef,
+				   int32_t *lr4_coef,
+				   struct iir_state_df2t *iir, int32_t nch)
+{
+	int ret;
+	int ch;
+
+	/* coefficients of the first biquad */
+	ret = memcpy_s(lr4_coef, sizeof(struct sof_eq_iir_biquad_df2t),
+		       coef, sizeof(struct sof_eq_iir_biquad_df2t));
+	assert(!ret);
+
+	/* coefficients of the second biquad */
+	ret = memcpy_s(lr4_coef + SOF_EQ_IIR_NBIQUAD_DF2T,
+		       sizeof(struct sof_eq_iir_biquad_df2t),
+		       coef, sizeof(struct sof_eq_iir_biquad_df2t));
+	assert(!ret);
+
+	for (ch = 0; ch < nch; ch++) {
+		iir[ch].biquads = 2;
+		iir[ch].biquads_in_series = 2;
+		iir[ch].coef = lr4_coef;
+		iir[ch].delay = NULL;
+	}
+}
+
+/**
+ * \brief Sets the state of a single LR4 filter for all channels.
+ *
+ * \param coef struct containing the coefficients of a butterworth
+ *	       high/low pass filter.
+ * \param[out] lr4 initialized block filter
+ * \param nch number of channels
+ * \param[in,out] data memory for the block filter
+ */
+static void crossover_init_coef_lr4(struct sof_eq_iir_biquad_df2t *coef,
+				    struct iir_df2t_block *lr4, int32_t nch,
+				    void **data)
+{
+	struct iir_state_df2t iir[PLATFORM_MAX_CHANNELS];
+	int32_t lr4_coef[2 * SOF_EQ_IIR_NBIQUAD_DF2T];
+
+	/* The block filter makes its own copy for every channel */
+	crossover_init_iir_lr4(coef, lr4_coef, iir, nch);
+	iir_df2t_block_init(lr4, iir, nch, data);
+}
+
+/**
+ * \brief Initializes the crossover coefficients for all channels
+ */
+int crossover_init_coef_all(struct sof_eq_iir_biquad_df2t *coef,
+			    struct crossover_state *state,
+			    int32_t nch, int32_t num_sinks)
+{
+	struct iir_state_df2t iir[PLATFORM_MAX_CHANNELS];
+	int32_t lr4_coef[2 * SOF_EQ_IIR_NBIQUAD_DF2T];
+	int32_t num_lr4s = num_sinks == CROSSOVER_2WAY_NUM_SINKS ? 1 : 3;
+	int32_t i;
+	int32_t j = 0;
+	size_t lr4_size;
+	void *data;
+
+	if (nch < 1 || nch > PLATFORM_MAX_CHANNELS ||
+	    num_sinks < CROSSOVER_2WAY_NUM_SINKS ||
+	    num_sinks > CROSSOVER_4WAY_NUM_SINKS)
+		return -EINVAL;
+
+	/* All LR4 filters have the same structure and size */
+	crossover_init_iir_lr4(coef, lr4_coef, iir, nch);
+	lr4_size = iir_df2t_block_size(iir, nch);
+	state->mem = rzalloc(SOF_MEM_ZONE_RUNTIME, 0, SOF_MEM_CAPS_RAM,
+			     2 * num_lr4s * lr4_size +
+			     num_sinks * IIR_DF2T_BLOCK_SAMPLES(nch) * sizeof(int32_t));
+	if (!state->mem)
+		return -ENOMEM;
+
+	data = state->mem;
+	for (i = 0; i < num_lr4s; i++) {
+		/* Get the low pass coefficients */
+		crossover_init_coef_lr4(&coef[j], &state->lowpass[i], nch, &data);
+		/* Get the high pass coefficients */
+		crossover_init_coef_lr4(&coef[j + 1], &state->highpass[i], nch, &data);
+		j += 2;
+	}
+
+	for (i = 0; i < num_sinks; i++) {
+		state->band[i] = data;
+		data = state->band[i] + IIR_DF2T_BLOCK_SAMPLES(nch);
+	}
+
+	return 0;
+}
+
+#else
 /**
  * \brief Sets the state of a single LR4 filter.
  *
@@ -244,6 +379,8 @@ int crossover_init_coef_ch(struct sof_eq_iir_biquad_df2t *coef,
 	return 0;
 }
 
+#endif
+
 /**
  * \brief Initializes the coefficients of the crossover filter
  *	  and assign them to the first nch channels.
@@ -252,9 +389,11 @@ int crossover_init_coef_ch(struct sof_eq_iir_biquad_df2t *coef,
  */
 static int crossover_init_coef(struct comp_data *cd, int nch)
 {
-	struct sof_eq_iir_biquad_df2t *crossover;
 	struct sof_crossover_config *config = cd->config;
-	int ch, err;
+#if !IIR_DF2T_BLOCK
+	int ch;
+#endif
+	int err;
 
 	if (!config) {
 		comp_cl_err(&comp_crossover, "crossover_init_coef(), no config is set");
@@ -271,10 +410,19 @@ static int crossover_init_coef(struct comp_data *cd, int nch)
 	comp_cl_info(&comp_crossover, "crossover_init_coef(), initializing %i-way crossover",
 		     config->num_sinks);
 
+#if IIR_DF2T_BLOCK
+	/* Collect the coef array and assign it to every channel */
+	err = crossover_init_coef_all(config->coef, &cd->state, nch,
+				      config->num_sinks);
+	if (err < 0) {
+		comp_cl_err(&comp_crossover, "crossover_init_coef(), could not assign coefficients");
+		crossover_reset_state(cd);
+		return err;
+	}
+#else
 	/* Collect the coef array and assign it to every channel */
-	crossover = config->coef;
 	for (ch = 0; ch < nch; ch++) {
-		err = crossover_init_coef_ch(crossover, &cd->state[ch],
+		err = crossover_init_coef_ch(config->coef, &cd->state[ch],
 					     config->num_sinks);
 		/* Free all previously allocated blocks in case of an error */
 		if (err < 0) {
@@ -284,6 +432,7 @@ static int crossover_init_coef(struct comp_data *cd, int nch)
 			return err;
 		}
 	}
+#endif
 
 	return 0;
 }
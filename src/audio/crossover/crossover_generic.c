@@ -10,6 +10,321 @@
 #include <sof/audio/format.h>
 #include <sof/audio/crossover/crossover.h>
 #include <sof/math/iir_df2t.h>
+#include <sof/math/iir_df2t_block.h>
+#include <sof/math/numbers.h>
+#include <sof/string.h>
+
+#if CONFIG_FORMAT_S16LE
+static void crossover_s16_default_pass(const struct comp_dev *dev,
+				       const struct comp_buffer *source,
+				       struct comp_buffer *sinks[],
+				       int32_t num_sinks,
+				       uint32_t frames)
+{
+	const struct audio_stream *source_stream = &source->stream;
+	int16_t *x;
+	int32_t *y;
+	int i, j;
+	int n = source_stream->channels * frames;
+
+	for (i = 0; i < n; i++) {
+		x = audio_stream_read_frag_s16(source_stream, i);
+		for (j = 0; j < num_sinks; j++) {
+			if (!sinks[j])
+				continue;
+			y = audio_stream_write_frag_s16((&sinks[j]->stream), i);
+			*y = *x;
+		}
+	}
+}
+#endif /* CONFIG_FORMAT_S16LE */
+
+#if CONFIG_FORMAT_S24LE || CONFIG_FORMAT_S32LE
+static void crossover_s32_default_pass(const struct comp_dev *dev,
+				       const struct comp_buffer *source,
+				       struct comp_buffer *sinks[],
+				       int32_t num_sinks,
+				       uint32_t frames)
+{
+	const struct audio_stream *source_stream = &source->stream;
+	int32_t *x, *y;
+	int i, j;
+	int n = source_stream->channels * frames;
+
+	for (i = 0; i < n; i++) {
+		x = audio_stream_read_frag_s32(source_stream, i);
+		for (j = 0; j < num_sinks; j++) {
+			if (!sinks[j])
+				continue;
+			y = audio_stream_write_frag_s32((&sinks[j]->stream), i);
+			*y = *x;
+		}
+	}
+}
+#endif /* CONFIG_FORMAT_S24LE || CONFIG_FORMAT_S32LE */
+
+#if CROSSOVER_GENERIC
+#if IIR_DF2T_BLOCK
+/*
+ * \brief Splits the block x into two based on the coefficients set in
+ *        the lp and hp filters. The output of the lp is in y1, the output
+ *        of the hp is in y2. The block x may be either of y1 or y2.
+ *
+ * As a side effect, this function mutates the delay values of both
+ * filters.
+ */
+static inline void crossover_generic_lr4_split(struct iir_df2t_block *lp,
+					       struct iir_df2t_block *hp,
+					       int32_t *x, int32_t *y1,
+					       int32_t *y2, int frames)
+{
+	size_t bytes = frames * lp->lanes * sizeof(int32_t);
+	int ret;
+
+	if (x != y1) {
+		ret = memcpy_s(y1, bytes, x, bytes);
+		assert(!ret);
+	}
+
+	if (x != y2) {
+		ret = memcpy_s(y2, bytes, x, bytes);
+		assert(!ret);
+	}
+
+	iir_df2t_block(lp, y1, frames);
+	iir_df2t_block(hp, y2, frames);
+}
+
+/*
+ * \brief Splits input signal into two and merges it back to it's
+ *        original form.
+ *
+ * With 3-way crossovers, one output goes through only one LR4 filter,
+ * whereas the other two go through two LR4 filters. This causes the signals
+ * to be out of phase. We need to pass the signal through another set of LR4
+ * filters to align back the phase. The block in tmp is used as scratch.
+ */
+static inline void crossover_generic_lr4_merge(struct iir_df2t_block *lp,
+					       struct iir_df2t_block *hp,
+					       int32_t *y, int32_t *tmp,
+					       int frames)
+{
+	int n = frames * lp->lanes;
+	int i;
+
+	crossover_generic_lr4_split(lp, hp, y, y, tmp, frames);
+	for (i = 0; i < n; i++)
+		y[i] = sat_int32((int64_t)y[i] + tmp[i]);
+}
+
+static void crossover_generic_split_2way(struct crossover_state *state,
+					 int frames)
+{
+	int32_t **band = state->band;
+
+	crossover_generic_lr4_split(&state->lowpass[0], &state->highpass[0],
+				    band[0], band[0], band[1], frames);
+}
+
+static void crossover_generic_split_3way(struct crossover_state *state,
+					 int frames)
+{
+	int32_t **band = state->band;
+
+	crossover_generic_lr4_split(&state->lowpass[0], &state->highpass[0],
+				    band[0], band[0], band[2], frames);
+	/* Realign the phase of the low band, band[1] is free for scratch */
+	crossover_generic_lr4_merge(&state->lowpass[1], &state->highpass[1],
+				    band[0], band[1], frames);
+	crossover_generic_lr4_split(&state->lowpass[2], &state->highpass[2],
+				    band[2], band[1], band[2], frames);
+}
+
+static void crossover_generic_split_4way(struct crossover_state *state,
+					 int frames)
+{
+	int32_t **band = state->band;
+
+	crossover_generic_lr4_split(&state->lowpass[1], &state->highpass[1],
+				    band[0], band[0], band[2], frames);
+	crossover_generic_lr4_split(&state->lowpass[0], &state->highpass[0],
+				    band[0], band[0], band[1], frames);
+	crossover_generic_lr4_split(&state->lowpass[2], &state->highpass[2],
+				    band[2], band[2], band[3], frames);
+}
+
+#if CONFIG_FORMAT_S16LE
+static void crossover_s16_default(const struct comp_dev *dev,
+				  const struct comp_buffer *source,
+				  struct comp_buffer *sinks[],
+				  int32_t num_sinks,
+				  uint32_t frames)
+{
+	struct comp_data *cd = comp_get_drvdata(dev);
+	struct crossover_state *state = &cd->state;
+	const struct audio_stream *source_stream = &source->stream;
+	struct audio_stream *sink_stream;
+	int16_t *x, *y;
+	int32_t *band;
+	int ch, i, j;
+	int idx;
+	int n;
+	int start;
+	int nch = source_stream->channels;
+	int lanes = state->lowpass[0].lanes;
+
+	/* Process in blocks of up to IIR_DF2T_BLOCK_FRAMES frames */
+	for (start = 0; start < frames; start += n) {
+		n = MIN(frames - start, IIR_DF2T_BLOCK_FRAMES);
+		idx = start * nch;
+		band = state->band[0];
+		for (i = 0; i < n; i++) {
+			for (ch = 0; ch < nch; ch++) {
+				x = audio_stream_read_frag_s16(source_stream, idx + ch);
+				band[ch] = *x << 16;
+			}
+
+			idx += nch;
+			band += lanes;
+		}
+
+		cd->crossover_split(state, n);
+
+		for (j = 0; j < num_sinks; j++) {
+			if (!sinks[j])
+				continue;
+			sink_stream = &sinks[j]->stream;
+			idx = start * nch;
+			band = state->band[j];
+			for (i = 0; i < n; i++) {
+				for (ch = 0; ch < nch; ch++) {
+					y = audio_stream_write_frag_s16(sink_stream, idx + ch);
+					*y = sat_int16(Q_SHIFT_RND(band[ch], 31, 15));
+				}
+
+				idx += nch;
+				band += lanes;
+			}
+		}
+	}
+}
+#endif /* CONFIG_FORMAT_S16LE */
+
+#if CONFIG_FORMAT_S24LE
+static void crossover_s24_default(const struct comp_dev *dev,
+				  const struct comp_buffer *source,
+				  struct comp_buffer *sinks[],
+				  int32_t num_sinks,
+				  uint32_t frames)
+{
+	struct comp_data *cd = comp_get_drvdata(dev);
+	struct crossover_state *state = &cd->state;
+	const struct audio_stream *source_stream = &source->stream;
+	struct audio_stream *sink_stream;
+	int32_t *x, *y;
+	int32_t *band;
+	int ch, i, j;
+	int idx;
+	int n;
+	int start;
+	int nch = source_stream->channels;
+	int lanes = state->lowpass[0].lanes;
+
+	/* Process in blocks of up to IIR_DF2T_BLOCK_FRAMES frames */
+	for (start = 0; start < frames; start += n) {
+		n = MIN(frames - start, IIR_DF2T_BLOCK_FRAMES);
+		idx = start * nch;
+		band = state->band[0];
+		for (i = 0; i < n; i++) {
+			for (ch = 0; ch < nch; ch++) {
+				x = audio_stream_read_frag_s32(source_stream, idx + ch);
+				band[ch] = *x << 8;
+			}
+
+			idx += nch;
+			band += lanes;
+		}
+
+		cd->crossover_split(state, n);
+
+		for (j = 0; j < num_sinks; j++) {
+			if (!sinks[j])
+				continue;
+			sink_stream = &sinks[j]->stream;
+			idx = start * nch;
+			band = state->band[j];
+			for (i = 0; i < n; i++) {
+				for (ch = 0; ch < nch; ch++) {
+					y = audio_stream_write_frag_s32(sink_stream, idx + ch);
+					*y = sat_int24(Q_SHIFT_RND(band[ch], 31, 23));
+				}
+
+				idx += nch;
+				band += lanes;
+			}
+		}
+	}
+}
+#endif /* CONFIG_FORMAT_S24LE */
+
+#if CONFIG_FORMAT_S32LE
+static void crossover_s32_default(const struct comp_dev *dev,
+				  const struct comp_buffer *source,
+				  struct comp_buffer *sinks[],
+				  int32_t num_sinks,
+				  uint32_t frames)
+{
+	struct comp_data *cd = comp_get_drvdata(dev);
+	struct crossover_state *state = &cd->state;
+	const struct audio_stream *source_stream = &source->stream;
+	struct audio_stream *sink_stream;
+	int32_t *x, *y;
+	int32_t *band;
+	int ch, i, j;
+	int idx;
+	int n;
+	int start;
+	int nch = source_stream->channels;
+	int lanes = state->lowpass[0].lanes;
+
+	/* Process in blocks of up to IIR_DF2T_BLOCK_FRAMES frames */
+	for (start = 0; start < frames; start += n) {
+		n = MIN(frames - start, IIR_DF2T_BLOCK_FRAMES);
+		idx = start * nch;
+		band = state->band[0];
+		for (i = 0; i < n; i++) {
+			for (ch = 0; ch < nch; ch++) {
+				x = audio_stream_read_frag_s32(source_stream, idx + ch);
+				band[ch] = *x;
+			}
+
+			idx += nch;
+			band += lanes;
+		}
+
+		cd->crossover_split(state, n);
+
+		for (j = 0; j < num_sinks; j++) {
+			if (!sinks[j])
+				continue;
+			sink_stream = &sinks[j]->stream;
+			idx = start * nch;
+			band = state->band[j];
+			for (i = 0; i < n; i++) {
+				for (ch = 0; ch < nch; ch++) {
+					y = audio_stream_write_frag_s32(sink_stream, idx + ch);
+					*y = band[ch];
+				}
+
+				idx += nch;
+				band += lanes;
+			}
+		}
+	}
+}
+#endif /* CONFIG_FORMAT_S32LE */
+
+#else /* IIR_DF2T_BLOCK */
 
 /*
  * \brief Splits x into two based on the coefficients set in the lp
@@ -85,55 +400,6 @@ static void crossover_generic_split_4way(int32_t in,
 				    z2, &out[2], &out[3]);
 }
 
-#if CONFIG_FORMAT_S16LE
-static void crossover_s16_default_pass(const struct comp_dev *dev,
-				       const struct comp_buffer *source,
-				       struct comp_buffer *sinks[],
-				       int32_t num_sinks,
-				       uint32_t frames)
-{
-	const struct audio_stream *source_stream = &source->stream;
-	int16_t *x;
-	int32_t *y;
-	int i, j;
-	int n = source_stream->channels * frames;
-
-	for (i = 0; i < n; i++) {
-		x = audio_stream_read_frag_s16(source_stream, i);
-		for (j = 0; j < num_sinks; j++) {
-			if (!sinks[j])
-				continue;
-			y = audio_stream_read_frag_s16((&sinks[j]->stream), i);
-			*y = *x;
-		}
-	}
-}
-#endif /* CONFIG_FORMAT_S16LE */
-
-#if CONFIG_FORMAT_S24LE || CONFIG_FORMAT_S32LE
-static void crossover_s32_default_pass(const struct comp_dev *dev,
-				       const struct comp_buffer *source,
-				       struct comp_buffer *sinks[],
-				       int32_t num_sinks,
-				       uint32_t frames)
-{
-	const struct audio_stream *source_stream = &source->stream;
-	int32_t *x, *y;
-	int i, j;
-	int n = source_stream->channels * frames;
-
-	for (i = 0; i < n; i++) {
-		x = audio_stream_read_frag_s32(source_stream, i);
-		for (j = 0; j < num_sinks; j++) {
-			if (!sinks[j])
-				continue;
-			y = audio_stream_read_frag_s32((&sinks[j]->stream), i);
-			*y = *x;
-		}
-	}
-}
-#endif /* CONFIG_FORMAT_S24LE || CONFIG_FORMAT_S32LE */
-
 #if CONFIG_FORMAT_S16LE
 static void crossover_s16_default(const struct comp_dev *dev,
 				  const struct comp_buffer *source,
@@ -162,8 +428,8 @@ static void crossover_s16_default(const struct comp_dev *dev,
 				if (!sinks[j])
 					continue;
 				sink_stream = &sinks[j]->stream;
-				y = audio_stream_read_frag_s16(sink_stream,
-							       idx);
+				y = audio_stream_write_frag_s16(sink_stream,
+								idx);
 				*y = sat_int16(Q_SHIFT_RND(out[j], 31, 15));
 			}
 
@@ -201,8 +467,8 @@ static void crossover_s24_default(const struct comp_dev *dev,
 				if (!sinks[j])
 					continue;
 				sink_stream = &sinks[j]->stream;
-				y = audio_stream_read_frag_s32(sink_stream,
-							       idx);
+				y = audio_stream_write_frag_s32(sink_stream,
+								idx);
 				*y = sat_int24(Q_SHIFT_RND(out[j], 31, 23));
 			}
 
@@ -231,7 +497,7 @@ static void crossover_s32_default(const struct comp_dev *dev,
 
 	for (ch = 0; ch < nch; ch++) {
 		idx = ch;
-		state = &cd->state[0];
+		state = &cd->state[ch];
 		for (i = 0; i < frames; i++) {
 			x = audio_stream_read_frag_s32(source_stream, idx);
 			cd->crossover_split(*x, out, state);
@@ -240,8 +506,8 @@ static void crossover_s32_default(const struct comp_dev *dev,
 				if (!sinks[j])
 					continue;
 				sink_stream = &sinks[j]->stream;
-				y = audio_stream_read_frag_s32(sink_stream,
-							       idx);
+				y = audio_stream_write_frag_s32(sink_stream,
+								idx);
 				*y = out[j];
 			}
 
@@ -251,6 +517,8 @@ static void crossover_s32_default(const struct comp_dev *dev,
 }
 #endif /* CONFIG_FORMAT_S32LE */
 
+#endif /* IIR_DF2T_BLOCK */
+
 const struct crossover_proc_fnmap crossover_proc_fnmap[] = {
 /* { SOURCE_FORMAT , PROCESSING FUNCTION } */
 #if CONFIG_FORMAT_S16LE
@@ -266,6 +534,18 @@ const struct crossover_proc_fnmap crossover_proc_fnmap[] = {
 #endif /* CONFIG_FORMAT_S32LE */
 };
 
+const size_t crossover_proc_fncount = ARRAY_SIZE(crossover_proc_fnmap);
+
+const crossover_split crossover_split_fnmap[] = {
+	crossover_generic_split_2way,
+	crossover_generic_split_3way,
+	crossover_generic_split_4way,
+};
+
+const size_t crossover_split_fncount = ARRAY_SIZE(crossover_split_fnmap);
+
+#endif /* CROSSOVER_GENERIC */
+
 const struct crossover_proc_fnmap crossover_proc_fnmap_pass[] = {
 /* { SOURCE_FORMAT , PROCESSING FUNCTION } */
 #if CONFIG_FORMAT_S16LE
@@ -280,13 +560,3 @@ const struct crossover_proc_fnmap crossover_proc_fnmap_pass[] = {
 	{ SOF_IPC_FRAME_S32_LE, crossover_s32_default_pass },
 #endif /* CONFIG_FORMAT_S32LE */
 };
-
-const size_t crossover_proc_fncount = ARRAY_SIZE(crossover_proc_fnmap);
-
-const crossover_split crossover_split_fnmap[] = {
-	crossover_generic_split_2way,
-	crossover_generic_split_3way,
-	crossover_generic_split_4way,
-};
-
-const size_t crossover_split_fncount = ARRAY_SIZE(crossover_split_fnmap);
@@ -0,0 +1,346 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2022 Google LLC. All rights reserved.
+
+#include <stdint.h>
+#include <sof/audio/component.h>
+#include <sof/audio/format.h>
+#include <sof/audio/crossover/crossover.h>
+#include <sof/math/iir_df2t.h>
+#include <sof/math/iir_df2t_block.h>
+#include <sof/math/numbers.h>
+
+#if CROSSOVER_HIFI3
+
+#include <xtensa/tie/xt_hifi3.h>
+
+/* Sets the stream buffer as circular for the _XC loads and stores */
+static inline void crossover_setup_circular(const struct audio_stream *buffer)
+{
+	AE_SETCBEGIN0(buffer->addr);
+	AE_SETCEND0(buffer->end_addr);
+}
+
+/* Copies a [frame][lane] block, the lanes count is even so the blocks are
+ * 64 bit aligned and copied as sample pairs.
+ */
+static inline void crossover_hifi3_copy(int32_t *dst, const int32_t *src,
+					int samples)
+{
+	ae_int32x2 *in = (ae_int32x2 *)src;
+	ae_int32x2 *out = (ae_int32x2 *)dst;
+	ae_int32x2 d;
+	int i;
+
+	for (i = 0; i < samples; i += 2) {
+		AE_L32X2_IP(d, in, sizeof(ae_int32x2));
+		AE_S32X2_IP(d, out, sizeof(ae_int32x2));
+	}
+}
+
+/*
+ * \brief Splits the block x into two based on the coefficients set in
+ *        the lp and hp filters. The output of the lp is in y1, the output
+ *        of the hp is in y2. The block x may be either of y1 or y2.
+ *
+ * As a side effect, this function mutates the delay values of both
+ * filters.
+ */
+static inline void crossover_hifi3_lr4_split(struct iir_df2t_block *lp,
+					     struct iir_df2t_block *hp,
+					     int32_t *x, int32_t *y1,
+					     int32_t *y2, int frames)
+{
+	int samples = frames * lp->lanes;
+
+	if (x != y1)
+		crossover_hifi3_copy(y1, x, samples);
+
+	if (x != y2)
+		crossover_hifi3_copy(y2, x, samples);
+
+	iir_df2t_block(lp, y1, frames);
+	iir_df2t_block(hp, y2, frames);
+}
+
+/*
+ * \brief Splits input signal into two and merges it back to it's
+ *        original form. The block in tmp is used as scratch.
+ */
+static inline void crossover_hifi3_lr4_merge(struct iir_df2t_block *lp,
+					     struct iir_df2t_block *hp,
+					     int32_t *y, int32_t *tmp,
+					     int frames)
+{
+	ae_int32x2 *out = (ae_int32x2 *)y;
+	ae_int32x2 *in = (ae_int32x2 *)tmp;
+	ae_int32x2 d0;
+	ae_int32x2 d1;
+	int samples = frames * lp->lanes;
+	int i;
+
+	crossover_hifi3_lr4_split(lp, hp, y, y, tmp, frames);
+
+	/* Saturated sum of the two outputs, two samples at a time */
+	for (i = 0; i < samples; i += 2) {
+		AE_L32X2_IP(d1, in, sizeof(ae_int32x2));
+		d0 = AE_L32X2_I(out, 0);
+		d0 = AE_ADD32S(d0, d1);
+		AE_S32X2_IP(d0, out, sizeof(ae_int32x2));
+	}
+}
+
+static void crossover_hifi3_split_2way(struct crossover_state *state,
+				       int frames)
+{
+	int32_t **band = state->band;
+
+	crossover_hifi3_lr4_split(&state->lowpass[0], &state->highpass[0],
+				  band[0], band[0], band[1], frames);
+}
+
+static void crossover_hifi3_split_3way(struct crossover_state *state,
+				       int frames)
+{
+	int32_t **band = state->band;
+
+	crossover_hifi3_lr4_split(&state->lowpass[0], &state->highpass[0],
+				  band[0], band[0], band[2], frames);
+	/* Realign the phase of the low band, band[1] is free for scratch */
+	crossover_hifi3_lr4_merge(&state->lowpass[1], &state->highpass[1],
+				  band[0], band[1], frames);
+	crossover_hifi3_lr4_split(&state->lowpass[2], &state->highpass[2],
+				  band[2], band[1], band[2], frames);
+}
+
+static void crossover_hifi3_split_4way(struct crossover_state *state,
+				       int frames)
+{
+	int32_t **band = state->band;
+
+	crossover_hifi3_lr4_split(&state->lowpass[1], &state->highpass[1],
+				  band[0], band[0], band[2], frames);
+	crossover_hifi3_lr4_split(&state->lowpass[0], &state->highpass[0],
+				  band[0], band[0], band[1], frames);
+	crossover_hifi3_lr4_split(&state->lowpass[2], &state->highpass[2],
+				  band[2], band[2], band[3], frames);
+}
+
+#if CONFIG_FORMAT_S16LE
+static void crossover_s16_default(const struct comp_dev *dev,
+				  const struct comp_buffer *source,
+				  struct comp_buffer *sinks[],
+				  int32_t num_sinks,
+				  uint32_t frames)
+{
+	struct comp_data *cd = comp_get_drvdata(dev);
+	struct crossover_state *state = &cd->state;
+	const struct audio_stream *source_stream = &source->stream;
+	ae_int16 *x = (ae_int16 *)source_stream->r_ptr;
+	ae_int16 *y[CROSSOVER_4WAY_NUM_SINKS];
+	ae_int16x4 d;
+	ae_int32x2 s;
+	ae_int32 *band;
+	int ch, i, j;
+	int n;
+	int start;
+	const int nch = source_stream->channels;
+	const int lanes = state->lowpass[0].lanes;
+	const int pad = (lanes - nch) * sizeof(int32_t);
+
+	for (j = 0; j < num_sinks; j++)
+		if (sinks[j])
+			y[j] = (ae_int16 *)sinks[j]->stream.w_ptr;
+
+	/* Process in blocks of up to IIR_DF2T_BLOCK_FRAMES frames */
+	for (start = 0; start < frames; start += n) {
+		n = MIN(frames - start, IIR_DF2T_BLOCK_FRAMES);
+
+		/* Q1.15 source to Q1.31 band[0] */
+		crossover_setup_circular(source_stream);
+		band = (ae_int32 *)state->band[0];
+		for (i = 0; i < n; i++) {
+			for (ch = 0; ch < nch; ch++) {
+				AE_L16_XC(d, x, sizeof(int16_t));
+				s = AE_CVT32X2F16_32(d);
+				AE_S32_L_IP(s, band, sizeof(int32_t));
+			}
+
+			band = (ae_int32 *)((int8_t *)band + pad);
+		}
+
+		cd->crossover_split(state, n);
+
+		/* Round and saturate the bands to Q1.15 sinks */
+		for (j = 0; j < num_sinks; j++) {
+			if (!sinks[j])
+				continue;
+
+			crossover_setup_circular(&sinks[j]->stream);
+			band = (ae_int32 *)state->band[j];
+			for (i = 0; i < n; i++) {
+				for (ch = 0; ch < nch; ch++) {
+					AE_L32_IP(s, band, sizeof(int32_t));
+					d = AE_ROUND16X4F32SSYM(s, s);
+					AE_S16_0_XC(d, y[j], sizeof(int16_t));
+				}
+
+				band = (ae_int32 *)((int8_t *)band + pad);
+			}
+		}
+	}
+}
+#endif /* CONFIG_FORMAT_S16LE */
+
+#if CONFIG_FORMAT_S24LE
+static void crossover_s24_default(const struct comp_dev *dev,
+				  const struct comp_buffer *source,
+				  struct comp_buffer *sinks[],
+				  int32_t num_sinks,
+				  uint32_t frames)
+{
+	struct comp_data *cd = comp_get_drvdata(dev);
+	struct crossover_state *state = &cd->state;
+	const struct audio_stream *source_stream = &source->stream;
+	ae_int32 *x = (ae_int32 *)source_stream->r_ptr;
+	ae_int32 *y[CROSSOVER_4WAY_NUM_SINKS];
+	ae_int32x2 s;
+	ae_int32 *band;
+	int ch, i, j;
+	int n;
+	int start;
+	const int nch = source_stream->channels;
+	const int lanes = state->lowpass[0].lanes;
+	const int pad = (lanes - nch) * sizeof(int32_t);
+
+	for (j = 0; j < num_sinks; j++)
+		if (sinks[j])
+			y[j] = (ae_int32 *)sinks[j]->stream.w_ptr;
+
+	/* Process in blocks of up to IIR_DF2T_BLOCK_FRAMES frames */
+	for (start = 0; start < frames; start += n) {
+		n = MIN(frames - start, IIR_DF2T_BLOCK_FRAMES);
+
+		/* Q1.23 source to Q1.31 band[0] */
+		crossover_setup_circular(source_stream);
+		band = (ae_int32 *)state->band[0];
+		for (i = 0; i < n; i++) {
+			for (ch = 0; ch < nch; ch++) {
+				AE_L32_XC(s, x, sizeof(int32_t));
+				s = AE_SLAI32(s, 8);
+				AE_S32_L_IP(s, band, sizeof(int32_t));
+			}
+
+			band = (ae_int32 *)((int8_t *)band + pad);
+		}
+
+		cd->crossover_split(state, n);
+
+		/* Round to Q1.23, saturate and shift to LSB side for sinks */
+		for (j = 0; j < num_sinks; j++) {
+			if (!sinks[j])
+				continue;
+
+			crossover_setup_circular(&sinks[j]->stream);
+			band = (ae_int32 *)state->band[j];
+			for (i = 0; i < n; i++) {
+				for (ch = 0; ch < nch; ch++) {
+					AE_L32_IP(s, band, sizeof(int32_t));
+					s = AE_SRAI32(AE_SLAI32S(AE_SRAI32R(s, 8), 8), 8);
+					AE_S32_L_XC(s, y[j], sizeof(int32_t));
+				}
+
+				band = (ae_int32 *)((int8_t *)band + pad);
+			}
+		}
+	}
+}
+#endif /* CONFIG_FORMAT_S24LE */
+
+#if CONFIG_FORMAT_S32LE
+static void crossover_s32_default(const struct comp_dev *dev,
+				  const struct comp_buffer *source,
+				  struct comp_buffer *sinks[],
+				  int32_t num_sinks,
+				  uint32_t frames)
+{
+	struct comp_data *cd = comp_get_drvdata(dev);
+	struct crossover_state *state = &cd->state;
+	const struct audio_stream *source_stream = &source->stream;
+	ae_int32 *x = (ae_int32 *)source_stream->r_ptr;
+	ae_int32 *y[CROSSOVER_4WAY_NUM_SINKS];
+	ae_int32x2 s;
+	ae_int32 *band;
+	int ch, i, j;
+	int n;
+	int start;
+	const int nch = source_stream->channels;
+	const int lanes = state->lowpass[0].lanes;
+	const int pad = (lanes - nch) * sizeof(int32_t);
+
+	for (j = 0; j < num_sinks; j++)
+		if (sinks[j])
+			y[j] = (ae_int32 *)sinks[j]->stream.w_ptr;
+
+	/* Process in blocks of up to IIR_DF2T_BLOCK_FRAMES frames */
+	for (start = 0; start < frames; start += n) {
+		n = MIN(frames - start, IIR_DF2T_BLOCK_FRAMES);
+
+		crossover_setup_circular(source_stream);
+		band = (ae_int32 *)state->band[0];
+		for (i = 0; i < n; i++) {
+			for (ch = 0; ch < nch; ch++) {
+				AE_L32_XC(s, x, sizeof(int32_t));
+				AE_S32_L_IP(s, band, sizeof(int32_t));
+			}
+
+			band = (ae_int32 *)((int8_t *)band + pad);
+		}
+
+		cd->crossover_split(state, n);
+
+		for (j = 0; j < num_sinks; j++) {
+			if (!sinks[j])
+				continue;
+
+			crossover_setup_circular(&sinks[j]->stream);
+			band = (ae_int32 *)state->band[j];
+			for (i = 0; i < n; i++) {
+				for (ch = 0; ch < nch; ch++) {
+					AE_L32_IP(s, band, sizeof(int32_t));
+					AE_S32_L_XC(s, y[j], sizeof(int32_t));
+				}
+
+				band = (ae_int32 *)((int8_t *)band + pad);
+			}
+		}
+	}
+}
+#endif /* CONFIG_FORMAT_S32LE */
+
+const struct crossover_proc_fnmap crossover_proc_fnmap[] = {
+/* { SOURCE_FORMAT , PROCESSING FUNCTION } */
+#if CONFIG_FORMAT_S16LE
+	{ SOF_IPC_FRAME_S16_LE, crossover_s16_default },
+#endif /* CONFIG_FORMAT_S16LE */
+
+#if CONFIG_FORMAT_S24LE
+	{ SOF_IPC_FRAME_S24_4LE, crossover_s24_default },
+#endif /* CONFIG_FORMAT_S24LE */
+
+#if CONFIG_FORMAT_S32LE
+	{ SOF_IPC_FRAME_S32_LE, crossover_s32_default },
+#endif /* CONFIG_FORMAT_S32LE */
+};
+
+const size_t crossover_proc_fncount = ARRAY_SIZE(crossover_proc_fnmap);
+
+const crossover_split crossover_split_fnmap[] = {
+	crossover_hifi3_split_2way,
+	crossover_hifi3_split_3way,
+	crossover_hifi3_split_4way,
+};
+
+const size_t crossover_split_fncount = ARRAY_SIZE(crossover_split_fnmap);
+
+#endif /* CROSSOVER_HIFI3 */
@@ -392,6 +392,7 @@ static const struct comp_driver comp_dcblock = {
 	.type = SOF_COMP_DCBLOCK,
 	.uid  = SOF_RT_UUID(dcblock_uuid),
 	.tctx = &dcblock_tr,
+	.flags = COMP_DRV_FLAG_INPLACE,
 	.ops  = {
 		 .create	= dcblock_new,
 		 .free		= dcblock_free,
@@ -53,6 +53,17 @@ struct comp_data {
 			    const struct audio_stream *source,
 			    struct audio_stream *sink,
 			    int frames, int nch);
+#if CONFIG_COMP_FIR_FFT
+	struct fir_fft_state fft[PLATFORM_MAX_CHANNELS]; /**< FFT filters state */
+	struct fir_fft_coef fft_coef[SOF_EQ_FIR_MAX_RESPONSES]; /**< FFT responses */
+	struct fir_fft_plan fft_plan;		/**< FFT and work buffers */
+	bool fir_fft;				/**< long responses, use FFT */
+	void (*eq_fir_fft_func)(struct fir_fft_plan *plan,
+				struct fir_fft_state fir[],
+				const struct audio_stream *source,
+				struct audio_stream *sink,
+				int frames, int nch);
+#endif
 };
 
 /*
@@ -102,6 +113,32 @@ static inline void set_s32_fir(struct comp_data *cd)
 #endif /* CONFIG_FORMAT_S32LE */
 #endif
 
+#if CONFIG_COMP_FIR_FFT
+static inline void set_fir_fft_func(struct comp_data *cd, enum sof_ipc_frame frame_fmt)
+{
+	switch (frame_fmt) {
+#if CONFIG_FORMAT_S16LE
+	case SOF_IPC_FRAME_S16_LE:
+		cd->eq_fir_fft_func = eq_fir_fft_s16;
+		break;
+#endif /* CONFIG_FORMAT_S16LE */
+#if CONFIG_FORMAT_S24LE
+	case SOF_IPC_FRAME_S24_4LE:
+		cd->eq_fir_fft_func = eq_fir_fft_s24;
+		break;
+#endif /* CONFIG_FORMAT_S24LE */
+#if CONFIG_FORMAT_S32LE
+	case SOF_IPC_FRAME_S32_LE:
+		cd->eq_fir_fft_func = eq_fir_fft_s32;
+		break;
+#endif /* CONFIG_FORMAT_S32LE */
+	default:
+		cd->eq_fir_fft_func = NULL;
+		break;
+	}
+}
+#endif
+
 static inline int set_fir_func(struct comp_dev *dev)
 {
 	struct comp_data *cd = comp_get_drvdata(dev);
@@ -133,6 +170,10 @@ static inline int set_fir_func(struct comp_dev *dev)
 		comp_err(dev, "set_fir_func(), invalid frame_fmt");
 		return -EINVAL;
 	}
+
+#if CONFIG_COMP_FIR_FFT
+	set_fir_fft_func(cd, sourceb->stream.frame_fmt);
+#endif
 	return 0;
 }
 
@@ -161,22 +202,26 @@ static void eq_fir_free_delaylines(struct comp_data *cd)
 	cd->fir_delay_size = 0;
 	for (i = 0; i < PLATFORM_MAX_CHANNELS; i++)
 		fir[i].delay = NULL;
+
+#if CONFIG_COMP_FIR_FFT
+	fir_fft_plan_free(&cd->fft_plan);
+	for (i = 0; i < PLATFORM_MAX_CHANNELS; i++)
+		fir_fft_reset(&cd->fft[i]);
+
+	cd->fir_fft = false;
+#endif
 }
 
-static int eq_fir_init_coef(struct sof_eq_fir_config *config,
-			    struct fir_state_32x16 *fir, int nch)
+/* Collect the responses from blob and check it for sanity */
+static int eq_fir_get_responses(struct sof_eq_fir_config *config,
+				struct sof_fir_coef_data *lookup[], int nch)
 {
-	struct sof_fir_coef_data *lookup[SOF_EQ_FIR_MAX_RESPONSES];
 	struct sof_fir_coef_data *eq;
-	int16_t *assign_response;
 	int16_t *coef_data;
-	size_t size_sum = 0;
-	int resp = 0;
 	int i;
 	int j;
-	int s;
 
-	comp_cl_info(&comp_eq_fir, "eq_fir_init_coef(), response assign for %u channels, %u responses",
+	comp_cl_info(&comp_eq_fir, "eq_fir_get_responses(), response assign for %u channels, %u responses",
 		     config->channels_in_config,
 		     config->number_of_responses);
 
@@ -184,17 +229,16 @@ static int eq_fir_init_coef(struct sof_eq_fir_config *config,
 	if (nch > PLATFORM_MAX_CHANNELS ||
 	    config->channels_in_config > PLATFORM_MAX_CHANNELS ||
 	    !config->channels_in_config) {
-		comp_cl_err(&comp_eq_fir, "eq_fir_init_coef(), invalid channels count");
+		comp_cl_err(&comp_eq_fir, "eq_fir_get_responses(), invalid channels count");
 		return -EINVAL;
 	}
 	if (config->number_of_responses > SOF_EQ_FIR_MAX_RESPONSES) {
-		comp_cl_err(&comp_eq_fir, "eq_fir_init_coef(), # of resp exceeds max");
+		comp_cl_err(&comp_eq_fir, "eq_fir_get_responses(), # of resp exceeds max");
 		return -EINVAL;
 	}
 
 	/* Collect index of response start positions in all_coefficients[]  */
 	j = 0;
-	assign_response = ASSUME_ALIGNED(&config->data[0], 4);
 	coef_data = ASSUME_ALIGNED(&config->data[config->channels_in_config],
 				   4);
 	for (i = 0; i < SOF_EQ_FIR_MAX_RESPONSES; i++) {
@@ -207,6 +251,22 @@ static int eq_fir_init_coef(struct sof_eq_fir_config *config,
 		}
 	}
 
+	return 0;
+}
+
+static int eq_fir_init_coef(struct sof_eq_fir_config *config,
+			    struct sof_fir_coef_data *lookup[],
+			    struct fir_state_32x16 *fir, int nch)
+{
+	struct sof_fir_coef_data *eq;
+	int16_t *assign_response;
+	size_t size_sum = 0;
+	int resp = 0;
+	int i;
+	int s;
+
+	assign_response = ASSUME_ALIGNED(&config->data[0], 4);
+
 	/* Initialize 1st phase */
 	for (i = 0; i < nch; i++) {
 		/* Check for not reading past blob response to channel assign
@@ -274,15 +334,140 @@ static void eq_fir_init_delay(struct fir_state_32x16 *fir,
 	}
 }
 
+#if CONFIG_COMP_FIR_FFT
+/* Get the longest response, it selects between direct form and FFT */
+static int eq_fir_max_length(struct sof_eq_fir_config *config,
+			     struct sof_fir_coef_data *lookup[])
+{
+	int taps = 0;
+	int i;
+
+	for (i = 0; i < config->number_of_responses; i++)
+		taps = MAX(taps, lookup[i]->length);
+
+	return taps;
+}
+
+static int eq_fir_fft_setup(struct comp_data *cd, struct sof_fir_coef_data *lookup[],
+			    int nch, int taps)
+{
+	struct sof_eq_fir_config *config = cd->config;
+	int16_t *assign_response = ASSUME_ALIGNED(&config->data[0], 4);
+	int16_t resp[PLATFORM_MAX_CHANNELS];
+	bool used[SOF_EQ_FIR_MAX_RESPONSES] = { false };
+	size_t size_sum = 0;
+	int32_t *data;
+	int r = 0;
+	int i;
+	int s;
+	int ret;
+
+	ret = fir_fft_plan_init(&cd->fft_plan, fir_fft_block_size(taps));
+	if (ret < 0) {
+		comp_cl_err(&comp_eq_fir, "eq_fir_fft_setup(), FFT init failed for %d taps",
+			    taps);
+		return ret;
+	}
+
+	/* Same response assign as for direct form, the responses spectra are
+	 * shared by channels.
+	 */
+	for (i = 0; i < nch; i++) {
+		if (i < config->channels_in_config)
+			r = assign_response[i];
+
+		if (r >= config->number_of_responses) {
+			comp_cl_err(&comp_eq_fir, "eq_fir_fft_setup(), requested response %d exceeds what has been defined",
+				    r);
+			return -EINVAL;
+		}
+
+		resp[i] = r;
+		if (r < 0)
+			continue;
+
+		s = fir_fft_delay_size(&cd->fft_plan, lookup[r]);
+		if (s < 0) {
+			comp_cl_err(&comp_eq_fir, "eq_fir_fft_setup(), FIR length %d is invalid",
+				    lookup[r]->length);
+			return -EINVAL;
+		}
+
+		size_sum += s;
+		if (!used[r]) {
+			size_sum += fir_fft_coef_size(&cd->fft_plan, lookup[r]);
+			used[r] = true;
+		}
+	}
+
+	cd->fir_fft = true;
+	if (!size_sum)
+		return 0;
+
+	cd->fir_delay = rballoc(0, SOF_MEM_CAPS_RAM, size_sum);
+	if (!cd->fir_delay) {
+		comp_cl_err(&comp_eq_fir, "eq_fir_fft_setup(), allocation failed for size %d",
+			    size_sum);
+		return -ENOMEM;
+	}
+
+	memset(cd->fir_delay, 0, size_sum);
+	cd->fir_delay_size = size_sum;
+
+	/* Compute the partitions spectra and assign delay lines */
+	data = cd->fir_delay;
+	for (r = 0; r < SOF_EQ_FIR_MAX_RESPONSES; r++) {
+		if (used[r])
+			fir_fft_init_coef(&cd->fft_plan, &cd->fft_coef[r], lookup[r], &data);
+	}
+
+	for (i = 0; i < nch; i++) {
+		if (resp[i] < 0) {
+			comp_cl_info(&comp_eq_fir, "eq_fir_fft_setup(), ch %d is set to bypass",
+				     i);
+			fir_fft_reset(&cd->fft[i]);
+			continue;
+		}
+
+		fir_fft_init_delay(&cd->fft_plan, &cd->fft[i], &cd->fft_coef[resp[i]], &data);
+		comp_cl_info(&comp_eq_fir, "eq_fir_fft_setup(), ch %d is set to response = %d, %d taps",
+			     i, resp[i], lookup[resp[i]]->length);
+	}
+
+	return 0;
+}
+#endif
+
 static int eq_fir_setup(struct comp_data *cd, int nch)
 {
+	struct sof_fir_coef_data *lookup[SOF_EQ_FIR_MAX_RESPONSES];
 	int delay_size;
+	int ret;
+#if CONFIG_COMP_FIR_FFT
+	int taps;
+#endif
 
 	/* Free existing FIR channels data if it was allocated */
 	eq_fir_free_delaylines(cd);
 
+	ret = eq_fir_get_responses(cd->config, lookup, nch);
+	if (ret < 0)
+		return ret;
+
+#if CONFIG_COMP_FIR_FFT
+	/* Responses longer than the threshold are run with FFT convolution */
+	taps = eq_fir_max_length(cd->config, lookup);
+	if (taps > CONFIG_COMP_FIR_FFT_MIN_LENGTH) {
+		ret = eq_fir_fft_setup(cd, lookup, nch, taps);
+		if (ret < 0)
+			eq_fir_free_delaylines(cd);
+
+		return ret;
+	}
+#endif
+
 	/* Set coefficients for each channel EQ from coefficient blob */
-	delay_size = eq_fir_init_coef(cd->config, cd->fir, nch);
+	delay_size = eq_fir_init_coef(cd->config, lookup, cd->fir, nch);
 	if (delay_size < 0)
 		return delay_size; /* Contains error code */
 
@@ -328,8 +513,8 @@ static struct comp_dev *eq_fir_new(const struct comp_driver *drv,
 	/* Check first before proceeding with dev and cd that coefficients
 	 * blob size is sane.
 	 */
-	if (bs > SOF_EQ_FIR_MAX_SIZE) {
-		comp_cl_err(&comp_eq_fir, "eq_fir_new(): coefficients blob size = %u > SOF_EQ_FIR_MAX_SIZE",
+	if (bs > EQ_FIR_MAX_BLOB_SIZE) {
+		comp_cl_err(&comp_eq_fir, "eq_fir_new(): coefficients blob size = %u > EQ_FIR_MAX_BLOB_SIZE",
 			    bs);
 		return NULL;
 	}
@@ -476,8 +661,14 @@ static void eq_fir_process(struct comp_dev *dev, struct comp_buffer *source,
 
 	buffer_stream_invalidate(source, source_bytes);
 
-	cd->eq_fir_func(cd->fir, &source->stream, &sink->stream, frames,
-			source->stream.channels);
+#if CONFIG_COMP_FIR_FFT
+	if (cd->fir_fft && cd->eq_fir_fft_func)
+		cd->eq_fir_fft_func(&cd->fft_plan, cd->fft, &source->stream,
+				    &sink->stream, frames, source->stream.channels);
+	else
+#endif
+		cd->eq_fir_func(cd->fir, &source->stream, &sink->stream, frames,
+				source->stream.channels);
 
 	buffer_stream_writeback(sink, sink_bytes);
 
@@ -602,6 +793,9 @@ static int eq_fir_reset(struct comp_dev *dev)
 	eq_fir_free_delaylines(cd);
 
 	cd->eq_fir_func = NULL;
+#if CONFIG_COMP_FIR_FFT
+	cd->eq_fir_fft_func = NULL;
+#endif
 	for (i = 0; i < PLATFORM_MAX_CHANNELS; i++)
 		fir_reset(&cd->fir[i]);
 
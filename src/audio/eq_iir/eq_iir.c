@@ -20,6 +20,7 @@
 #include <sof/lib/uuid.h>
 #include <sof/list.h>
 #include <sof/math/iir_df2t.h>
+#include <sof/math/iir_df2t_block.h>
 #include <sof/platform.h>
 #include <sof/string.h>
 #include <sof/ut.h>
@@ -48,9 +49,23 @@ struct comp_data {
 	struct sof_eq_iir_config *config;
 	int64_t *iir_delay;			/**< pointer to allocated RAM */
 	size_t iir_delay_size;			/**< allocated size */
+	struct iir_df2t_block block;		/**< all channels block filter */
+	void *block_mem;			/**< block filter allocated RAM */
+	int32_t *block_data;			/**< block filter [frame][lane] */
 	eq_iir_func eq_iir_func;		/**< processing function */
 };
 
+/* Returns frames for one block filter run without source or sink wrap */
+static int eq_iir_block_frames(const struct audio_stream *source, const void *x,
+			       const struct audio_stream *sink, const void *y,
+			       int frames)
+{
+	int n = MIN(frames, IIR_DF2T_BLOCK_FRAMES);
+
+	n = MIN(n, audio_stream_frames_without_wrap(source, x));
+	return MIN(n, audio_stream_frames_without_wrap(sink, y));
+}
+
 #if CONFIG_FORMAT_S16LE
 
 /*
@@ -99,6 +114,46 @@ static void eq_iir_s16_default(const struct comp_dev *dev, const struct audio_st
 		y = audio_stream_wrap(sink, y + n);
 	}
 }
+
+static void eq_iir_s16_block(const struct comp_dev *dev, const struct audio_stream *source,
+			     struct audio_stream *sink, uint32_t frames)
+{
+	struct comp_data *cd = comp_get_drvdata(dev);
+	int16_t *x = source->r_ptr;
+	int16_t *y = sink->w_ptr;
+	int32_t *d;
+	const int nch = source->channels;
+	const int lanes = cd->block.lanes;
+	int remaining = frames;
+	int i;
+	int j;
+	int n;
+
+	while (remaining) {
+		n = eq_iir_block_frames(source, x, sink, y, remaining);
+		d = cd->block_data;
+		for (i = 0; i < n; i++) {
+			for (j = 0; j < nch; j++)
+				d[j] = (int32_t)x[j] << 16;
+			x += nch;
+			d += lanes;
+		}
+
+		iir_df2t_block(&cd->block, cd->block_data, n);
+
+		d = cd->block_data;
+		for (i = 0; i < n; i++) {
+			for (j = 0; j < nch; j++)
+				y[j] = iir_df2t_out_s16(d[j]);
+			y += nch;
+			d += lanes;
+		}
+
+		remaining -= n;
+		x = audio_stream_wrap(source, x);
+		y = audio_stream_wrap(sink, y);
+	}
+}
 #endif /* CONFIG_FORMAT_S16LE */
 
 #if CONFIG_FORMAT_S24LE
@@ -145,6 +200,46 @@ static void eq_iir_s24_default(const struct comp_dev *dev, const struct audio_st
 		y = audio_stream_wrap(sink, y + n);
 	}
 }
+
+static void eq_iir_s24_block(const struct comp_dev *dev, const struct audio_stream *source,
+			     struct audio_stream *sink, uint32_t frames)
+{
+	struct comp_data *cd = comp_get_drvdata(dev);
+	int32_t *x = source->r_ptr;
+	int32_t *y = sink->w_ptr;
+	int32_t *d;
+	const int nch = source->channels;
+	const int lanes = cd->block.lanes;
+	int remaining = frames;
+	int i;
+	int j;
+	int n;
+
+	while (remaining) {
+		n = eq_iir_block_frames(source, x, sink, y, remaining);
+		d = cd->block_data;
+		for (i = 0; i < n; i++) {
+			for (j = 0; j < nch; j++)
+				d[j] = x[j] << 8;
+			x += nch;
+			d += lanes;
+		}
+
+		iir_df2t_block(&cd->block, cd->block_data, n);
+
+		d = cd->block_data;
+		for (i = 0; i < n; i++) {
+			for (j = 0; j < nch; j++)
+				y[j] = iir_df2t_out_s24(d[j]);
+			y += nch;
+			d += lanes;
+		}
+
+		remaining -= n;
+		x = audio_stream_wrap(source, x);
+		y = audio_stream_wrap(sink, y);
+	}
+}
 #endif /* CONFIG_FORMAT_S24LE */
 
 #if CONFIG_FORMAT_S32LE
@@ -191,6 +286,46 @@ static void eq_iir_s32_default(const struct comp_dev *dev, const struct audio_st
 		y = audio_stream_wrap(sink, y + n);
 	}
 }
+
+static void eq_iir_s32_block(const struct comp_dev *dev, const struct audio_stream *source,
+			     struct audio_stream *sink, uint32_t frames)
+{
+	struct comp_data *cd = comp_get_drvdata(dev);
+	int32_t *x = source->r_ptr;
+	int32_t *y = sink->w_ptr;
+	int32_t *d;
+	const int nch = source->channels;
+	const int lanes = cd->block.lanes;
+	int remaining = frames;
+	int i;
+	int j;
+	int n;
+
+	while (remaining) {
+		n = eq_iir_block_frames(source, x, sink, y, remaining);
+		d = cd->block_data;
+		for (i = 0; i < n; i++) {
+			for (j = 0; j < nch; j++)
+				d[j] = x[j];
+			x += nch;
+			d += lanes;
+		}
+
+		iir_df2t_block(&cd->block, cd->block_data, n);
+
+		d = cd->block_data;
+		for (i = 0; i < n; i++) {
+			for (j = 0; j < nch; j++)
+				y[j] = d[j];
+			y += nch;
+			d += lanes;
+		}
+
+		remaining -= n;
+		x = audio_stream_wrap(source, x);
+		y = audio_stream_wrap(sink, y);
+	}
+}
 #endif /* CONFIG_FORMAT_S32LE */
 
 #if CONFIG_FORMAT_S32LE && CONFIG_FORMAT_S16LE
@@ -236,6 +371,46 @@ static void eq_iir_s32_16_default(const struct comp_dev *dev, const struct audio
 		y = audio_stream_wrap(sink, y + n);
 	}
 }
+
+static void eq_iir_s32_16_block(const struct comp_dev *dev, const struct audio_stream *source,
+				struct audio_stream *sink, uint32_t frames)
+{
+	struct comp_data *cd = comp_get_drvdata(dev);
+	int32_t *x = source->r_ptr;
+	int16_t *y = sink->w_ptr;
+	int32_t *d;
+	const int nch = source->channels;
+	const int lanes = cd->block.lanes;
+	int remaining = frames;
+	int i;
+	int j;
+	int n;
+
+	while (remaining) {
+		n = eq_iir_block_frames(source, x, sink, y, remaining);
+		d = cd->block_data;
+		for (i = 0; i < n; i++) {
+			for (j = 0; j < nch; j++)
+				d[j] = x[j];
+			x += nch;
+			d += lanes;
+		}
+
+		iir_df2t_block(&cd->block, cd->block_data, n);
+
+		d = cd->block_data;
+		for (i = 0; i < n; i++) {
+			for (j = 0; j < nch; j++)
+				y[j] = iir_df2t_out_s16(d[j]);
+			y += nch;
+			d += lanes;
+		}
+
+		remaining -= n;
+		x = audio_stream_wrap(source, x);
+		y = audio_stream_wrap(sink, y);
+	}
+}
 #endif /* CONFIG_FORMAT_S32LE && CONFIG_FORMAT_S16LE */
 
 #if CONFIG_FORMAT_S32LE && CONFIG_FORMAT_S24LE
@@ -281,6 +456,46 @@ static void eq_iir_s32_24_default(const struct comp_dev *dev, const struct audio
 		y = audio_stream_wrap(sink, y + n);
 	}
 }
+
+static void eq_iir_s32_24_block(const struct comp_dev *dev, const struct audio_stream *source,
+				struct audio_stream *sink, uint32_t frames)
+{
+	struct comp_data *cd = comp_get_drvdata(dev);
+	int32_t *x = source->r_ptr;
+	int32_t *y = sink->w_ptr;
+	int32_t *d;
+	const int nch = source->channels;
+	const int lanes = cd->block.lanes;
+	int remaining = frames;
+	int i;
+	int j;
+	int n;
+
+	while (remaining) {
+		n = eq_iir_block_frames(source, x, sink, y, remaining);
+		d = cd->block_data;
+		for (i = 0; i < n; i++) {
+			for (j = 0; j < nch; j++)
+				d[j] = x[j];
+			x += nch;
+			d += lanes;
+		}
+
+		iir_df2t_block(&cd->block, cd->block_data, n);
+
+		d = cd->block_data;
+		for (i = 0; i < n; i++) {
+			for (j = 0; j < nch; j++)
+				y[j] = iir_df2t_out_s24(d[j]);
+			y += nch;
+			d += lanes;
+		}
+
+		remaining -= n;
+		x = audio_stream_wrap(source, x);
+		y = audio_stream_wrap(sink, y);
+	}
+}
 #endif /* CONFIG_FORMAT_S32LE && CONFIG_FORMAT_S24LE */
 
 static void eq_iir_pass(const struct comp_dev *dev,
@@ -376,6 +591,25 @@ const struct eq_iir_func_map fm_configured[] = {
 #endif /* CONFIG_FORMAT_S32LE */
 };
 
+/* Used when all channels can run as one block filter */
+const struct eq_iir_func_map fm_block[] = {
+#if CONFIG_FORMAT_S16LE
+	{SOF_IPC_FRAME_S16_LE,  SOF_IPC_FRAME_S16_LE,  eq_iir_s16_block},
+#endif /* CONFIG_FORMAT_S16LE */
+#if CONFIG_FORMAT_S16LE && CONFIG_FORMAT_S32LE
+	{SOF_IPC_FRAME_S32_LE,  SOF_IPC_FRAME_S16_LE,  eq_iir_s32_16_block},
+#endif /* CONFIG_FORMAT_S16LE && CONFIG_FORMAT_S32LE */
+#if CONFIG_FORMAT_S24LE
+	{SOF_IPC_FRAME_S24_4LE, SOF_IPC_FRAME_S24_4LE, eq_iir_s24_block},
+#endif /* CONFIG_FORMAT_S24LE */
+#if CONFIG_FORMAT_S24LE && CONFIG_FORMAT_S32LE
+	{SOF_IPC_FRAME_S32_LE,  SOF_IPC_FRAME_S24_4LE, eq_iir_s32_24_block},
+#endif /* CONFIG_FORMAT_S24LE && CONFIG_FORMAT_S32LE */
+#if CONFIG_FORMAT_S32LE
+	{SOF_IPC_FRAME_S32_LE,  SOF_IPC_FRAME_S32_LE,  eq_iir_s32_block},
+#endif /* CONFIG_FORMAT_S32LE */
+};
+
 const struct eq_iir_func_map fm_passthrough[] = {
 #if CONFIG_FORMAT_S16LE
 	{SOF_IPC_FRAME_S16_LE,  SOF_IPC_FRAME_S16_LE,  eq_iir_pass},
@@ -434,6 +668,11 @@ static void eq_iir_free_delaylines(struct comp_data *cd)
 	cd->iir_delay_size = 0;
 	for (i = 0; i < PLATFORM_MAX_CHANNELS; i++)
 		iir[i].delay = NULL;
+
+	rfree(cd->block_mem);
+	cd->block_mem = NULL;
+	cd->block_data = NULL;
+	cd->block.biquads = 0;
 }
 
 static int eq_iir_init_coef(struct sof_eq_iir_config *config,
@@ -542,8 +781,29 @@ static void eq_iir_init_delay(struct iir_state_df2t *iir,
 	}
 }
 
+static int eq_iir_setup_block(struct comp_data *cd, int nch, int block_size)
+{
+	void *data;
+	size_t size = block_size + IIR_DF2T_BLOCK_SAMPLES(nch) * sizeof(int32_t);
+
+	/* Allocate block filter state and the [frame][lane] buffer */
+	cd->block_mem = rzalloc(SOF_MEM_ZONE_RUNTIME, 0, SOF_MEM_CAPS_RAM, size);
+	if (!cd->block_mem) {
+		comp_cl_err(&comp_eq_iir, "eq_iir_setup_block(), allocation fail");
+		return -ENOMEM;
+	}
+
+	data = cd->block_mem;
+	iir_df2t_block_init(&cd->block, cd->iir, nch, &data);
+	cd->block_data = data;
+	comp_cl_info(&comp_eq_iir, "eq_iir_setup_block(), %d channels as block filter",
+		     nch);
+	return 0;
+}
+
 static int eq_iir_setup(struct comp_data *cd, int nch)
 {
+	int block_size;
 	int delay_size;
 
 	/* Free existing IIR channels data if it was allocated */
@@ -560,6 +820,13 @@ static int eq_iir_setup(struct comp_data *cd, int nch)
 	if (!delay_size)
 		return 0;
 
+	/* Run all channels with one block filter if they share the sections
+	 * structure. The single channel delay lines are not needed then.
+	 */
+	block_size = iir_df2t_block_size(cd->iir, nch);
+	if (block_size > 0)
+		return eq_iir_setup_block(cd, nch, block_size);
+
 	/* Allocate all IIR channels data in a big chunk and clear it */
 	cd->iir_delay = rzalloc(SOF_MEM_ZONE_RUNTIME, 0, SOF_MEM_CAPS_RAM,
 				delay_size);
@@ -807,6 +1074,19 @@ static void eq_iir_process(struct comp_dev *dev, struct comp_buffer *source,
 	comp_update_buffer_produce(sink, sink_bytes);
 }
 
+/* block function when the channels can run as one block filter */
+static eq_iir_func eq_iir_find_configured_func(struct comp_data *cd,
+					       enum sof_ipc_frame source_format,
+					       enum sof_ipc_frame sink_format)
+{
+	if (cd->block.biquads)
+		return eq_iir_find_func(source_format, sink_format, fm_block,
+					ARRAY_SIZE(fm_block));
+
+	return eq_iir_find_func(source_format, sink_format, fm_configured,
+				ARRAY_SIZE(fm_configured));
+}
+
 /* copy and process stream data from source to sink buffers */
 static int eq_iir_copy(struct comp_dev *dev)
 {
@@ -820,6 +1100,8 @@ static int eq_iir_copy(struct comp_dev *dev)
 
 	sourceb = list_first_item(&dev->bsource_list, struct comp_buffer,
 				  sink_list);
+	sinkb = list_first_item(&dev->bsink_list, struct comp_buffer,
+				source_list);
 
 	/* Check for changed configuration */
 	if (comp_is_new_data_blob_available(cd->model_handler)) {
@@ -829,10 +1111,15 @@ static int eq_iir_copy(struct comp_dev *dev)
 			comp_err(dev, "eq_iir_copy(), failed IIR setup");
 			return ret;
 		}
-	}
 
-	sinkb = list_first_item(&dev->bsink_list, struct comp_buffer,
-				source_list);
+		/* The setup may switch between block and channel filters */
+		cd->eq_iir_func = eq_iir_find_configured_func(cd, sourceb->stream.frame_fmt,
+							      sinkb->stream.frame_fmt);
+		if (!cd->eq_iir_func) {
+			comp_err(dev, "eq_iir_copy(), No proc func");
+			return -EINVAL;
+		}
+	}
 
 	/* Get source, sink, number of frames etc. to process. */
 	comp_get_copy_limits_with_lock(sourceb, sinkb, &cl);
@@ -895,8 +1182,7 @@ static int eq_iir_prepare(struct comp_dev *dev)
 			comp_err(dev, "eq_iir_prepare(), setup failed.");
 			goto err;
 		}
-		cd->eq_iir_func = eq_iir_find_func(source_format, sink_format, fm_configured,
-						   ARRAY_SIZE(fm_configured));
+		cd->eq_iir_func = eq_iir_find_configured_func(cd, source_format, sink_format);
 		if (!cd->eq_iir_func) {
 			comp_err(dev, "eq_iir_prepare(), No proc func");
 			ret = -EINVAL;
@@ -941,6 +1227,7 @@ static const struct comp_driver comp_eq_iir = {
 	.type = SOF_COMP_EQ_IIR,
 	.uid = SOF_RT_UUID(eq_iir_uuid),
 	.tctx = &eq_iir_tr,
+	.flags = COMP_DRV_FLAG_INPLACE,
 	.ops = {
 		.create = eq_iir_new,
 		.free = eq_iir_free,
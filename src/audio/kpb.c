@@ -484,6 +484,7 @@ static int kpb_prepare(struct comp_dev *dev)
 	struct list_item *blist;
 	struct comp_buffer *sink;
 	size_t hb_size_req = KPB_MAX_BUFFER_SIZE(kpb->config.sampling_width);
+	size_t ratio = KPB_HISTORY_RATIO(kpb->config.sampling_width);
 
 	comp_info(dev, "kpb_prepare()");
 
@@ -523,7 +524,7 @@ static int kpb_prepare(struct comp_dev *dev)
 	if (!kpb->hd.c_hb) {
 		/* Allocate history buffer */
 		kpb->hd.buffer_size = kpb_allocate_history_buffer(kpb,
-								  hb_size_req);
+								  hb_size_req / ratio) * ratio;
 
 		/* Have we allocated what we requested? */
 		if (kpb->hd.buffer_size < hb_size_req) {
@@ -856,6 +857,7 @@ static int kpb_buffer_data(struct comp_dev *dev,
 	uint64_t current_time;
 	enum kpb_state state_preserved = kpb->state;
 	size_t sample_width = kpb->config.sampling_width;
+	size_t ratio = KPB_HISTORY_RATIO(sample_width);
 	struct timer *timer = timer_get();
 
 	comp_dbg(dev, "kpb_buffer_data()");
@@ -904,7 +906,8 @@ static int kpb_buffer_data(struct comp_dev *dev,
 		}
 
 		/* Check how much space there is in current write buffer */
-		space_avail = (uintptr_t)buff->end_addr - (uintptr_t)buff->w_ptr;
+		space_avail = ((uintptr_t)buff->end_addr - (uintptr_t)buff->w_ptr) *
+			      ratio;
 
 		if (size_to_copy > space_avail) {
 			/* We have more data to copy than available space
@@ -914,7 +917,7 @@ static int kpb_buffer_data(struct comp_dev *dev,
 			kpb_buffer_samples(&source->stream, offset, buff->w_ptr,
 					   space_avail, sample_width);
 			/* Update write pointer & requested copy size */
-			buff->w_ptr = (char *)buff->w_ptr + space_avail;
+			buff->w_ptr = (char *)buff->w_ptr + space_avail / ratio;
 			size_to_copy = size_to_copy - space_avail;
 			/* Update read pointer's offset before continuing
 			 * with next buffer.
@@ -928,7 +931,7 @@ static int kpb_buffer_data(struct comp_dev *dev,
 			kpb_buffer_samples(&source->stream, offset, buff->w_ptr,
 					   size_to_copy, sample_width);
 			/* Update write pointer & requested copy size */
-			buff->w_ptr = (char *)buff->w_ptr + size_to_copy;
+			buff->w_ptr = (char *)buff->w_ptr + size_to_copy / ratio;
 			/* Reset requested copy size */
 			size_to_copy = 0;
 		}
@@ -1067,6 +1070,7 @@ static void kpb_init_draining(struct comp_dev *dev, struct kpb_client *cli)
 			      (KPB_SAMPLE_CONTAINER_SIZE(sample_width) / 8) *
 			      kpb->config.channels;
 	size_t period_bytes_limit;
+	size_t ratio = KPB_HISTORY_RATIO(sample_width);
 
 	comp_info(dev, "kpb_init_draining(): requested draining of %d [ms] from history buffer",
 		  cli->drain_req);
@@ -1103,12 +1107,12 @@ static void kpb_init_draining(struct comp_dev *dev, struct kpb_client *cli)
 			 */
 			buff->r_ptr = buff->start_addr;
 			if (buff->state == KPB_BUFFER_FREE) {
-				local_buffered = (uintptr_t)buff->w_ptr -
-						 (uintptr_t)buff->start_addr;
+				local_buffered = ((uintptr_t)buff->w_ptr -
+						  (uintptr_t)buff->start_addr) * ratio;
 				buffered += local_buffered;
 			} else if (buff->state == KPB_BUFFER_FULL) {
-				local_buffered = (uintptr_t)buff->end_addr -
-						 (uintptr_t)buff->start_addr;
+				local_buffered = ((uintptr_t)buff->end_addr -
+						  (uintptr_t)buff->start_addr) * ratio;
 				buffered += local_buffered;
 			} else {
 				comp_err(dev, "kpb_init_draining(): incorrect buffer label");
@@ -1127,10 +1131,10 @@ static void kpb_init_draining(struct comp_dev *dev, struct kpb_client *cli)
 					 * and buffer's end address.
 					 */
 					buff = buff->prev;
-					buffered += (uintptr_t)buff->end_addr -
-						    (uintptr_t)buff->w_ptr;
+					buffered += ((uintptr_t)buff->end_addr -
+						     (uintptr_t)buff->w_ptr) * ratio;
 					buff->r_ptr = (char *)buff->w_ptr +
-						      (buffered - drain_req);
+						      (buffered - drain_req) / ratio;
 					break;
 				}
 				buff = buff->prev;
@@ -1139,7 +1143,7 @@ static void kpb_init_draining(struct comp_dev *dev, struct kpb_client *cli)
 				break;
 			} else {
 				buff->r_ptr = (char *)buff->start_addr +
-					      (buffered - drain_req);
+					      (buffered - drain_req) / ratio;
 				break;
 			}
 
@@ -1163,6 +1167,11 @@ static void kpb_init_draining(struct comp_dev *dev, struct kpb_client *cli)
 			comp_info(dev, "kpb_init_draining(): sync_draining_mode selected with interval %u [uS].",
 				  (unsigned int)(drain_interval * 1000 /
 						 clock_ms_to_ticks(PLATFORM_DEFAULT_CLOCK, 1)));
+		} else if (IS_ENABLED(CONFIG_KPB_ADAPTIVE_DRAINING)) {
+			/* Bursts sized by host sink space and throughput */
+			drain_interval = 0;
+			period_bytes_limit = 0;
+			comp_info(dev, "kpb_init_draining(): adaptive draining selected.");
 		} else {
 			/* Unlimited draining */
 			drain_interval = 0;
@@ -1181,6 +1190,14 @@ static void kpb_init_draining(struct comp_dev *dev, struct kpb_client *cli)
 		kpb->draining_task_data.pb_limit = period_bytes_limit;
 		kpb->draining_task_data.dev = dev;
 		kpb->draining_task_data.sync_mode_on = kpb->sync_draining_mode;
+		kpb->draining_task_data.adaptive_mode_on =
+			IS_ENABLED(CONFIG_KPB_ADAPTIVE_DRAINING) &&
+			!kpb->sync_draining_mode;
+		kpb->draining_task_data.min_burst = bytes_per_ms;
+		kpb->draining_task_data.next_burst_time = 0;
+		memset(&kpb->draining_task_data.stats, 0,
+		       sizeof(kpb->draining_task_data.stats));
+		perf_cnt_clear(&kpb->draining_task_data.pcd);
 
 		/* save current sink copy type */
 		comp_get_attribute(kpb->host_sink->sink, COMP_ATTR_COPY_TYPE,
@@ -1198,6 +1215,81 @@ static void kpb_init_draining(struct comp_dev *dev, struct kpb_client *cli)
 	}
 }
 
+#if CONFIG_KPB_ADAPTIVE_DRAINING
+/**
+ * \brief Check if the host has freed enough space for next adaptive burst.
+ *
+ * Updates host DMA throughput estimate from the growth of sink free space
+ * since last burst. A burst covers KPB_DRAIN_BURST_MS of host reading, so
+ * draining follows the link speed without copying a few bytes at a time.
+ *
+ * \param[in,out] dd - draining data.
+ * \param[in] sink - host sink stream.
+ * \param[in] drain_req - number of bytes left to drain.
+ *
+ * \return true if the burst should be copied now.
+ */
+static bool kpb_drain_burst_ready(struct draining_data *dd,
+				  const struct audio_stream *sink,
+				  size_t drain_req)
+{
+	uint64_t ms_ticks = clock_ms_to_ticks(PLATFORM_DEFAULT_CLOCK, 1);
+	uint64_t now = platform_timer_get(timer_get());
+	size_t free_bytes = audio_stream_get_free_bytes(sink);
+	size_t threshold;
+	int32_t rate;
+
+	if (now < dd->next_burst_time)
+		return false;
+
+	if (free_bytes > dd->last_free && now > dd->last_time) {
+		rate = (uint64_t)(free_bytes - dd->last_free) * ms_ticks /
+		       (now - dd->last_time);
+		if (dd->stats.host_rate)
+			dd->stats.host_rate += (rate - (int32_t)dd->stats.host_rate) >>
+					       KPB_DRAIN_RATE_SHIFT;
+		else
+			dd->stats.host_rate = rate;
+		dd->last_free = free_bytes;
+		dd->last_time = now;
+	}
+
+	/* Rest of the data fits or host throughput is not known yet */
+	if (free_bytes >= drain_req || !dd->stats.host_rate)
+		return true;
+
+	threshold = MAX(dd->min_burst,
+			dd->stats.host_rate * KPB_DRAIN_BURST_MS);
+	threshold = MIN(threshold, sink->size / 2);
+	if (free_bytes >= threshold)
+		return true;
+
+	/* Come back when the host is expected to have read the rest */
+	dd->next_burst_time = now + (uint64_t)(threshold - free_bytes) * ms_ticks /
+			      dd->stats.host_rate;
+
+	return false;
+}
+#endif /* CONFIG_KPB_ADAPTIVE_DRAINING */
+
+/**
+ * \brief Account a burst copied to the host sink.
+ * \param[in,out] dd - draining data.
+ * \param[in] sink - host sink stream.
+ * \param[in] size - burst size in bytes.
+ */
+static void kpb_drain_burst_done(struct draining_data *dd,
+				 const struct audio_stream *sink, size_t size)
+{
+	dd->stats.bursts++;
+	dd->stats.burst_peak = MAX(dd->stats.burst_peak, size);
+	perf_cnt_stamp(&dd->pcd, perf_trace_null, NULL);
+
+	/* Host reading is measured from here on */
+	dd->last_free = audio_stream_get_free_bytes(sink);
+	dd->last_time = platform_timer_get(timer_get());
+}
+
 /**
  * \brief Draining task.
  *
@@ -1213,6 +1305,8 @@ static enum task_state kpb_draining_task(void *arg)
 	struct history_buffer *buff = draining_data->hb;
 	size_t drain_req = draining_data->drain_req;
 	size_t sample_width = draining_data->sample_width;
+	size_t ratio = KPB_HISTORY_RATIO(sample_width);
+	size_t sample_bytes = KPB_SAMPLE_CONTAINER_SIZE(sample_width) / 8;
 	size_t size_to_read;
 	size_t size_to_copy;
 	bool move_buffer = false;
@@ -1244,6 +1338,8 @@ static enum task_state kpb_draining_task(void *arg)
 	kpb_change_state(kpb, KPB_STATE_DRAINING);
 
 	draining_time_start = platform_timer_get(timer);
+	draining_data->last_free = audio_stream_get_free_bytes(&sink->stream);
+	draining_data->last_time = draining_time_start;
 
 	while (drain_req > 0) {
 		/* Have we received reset request? */
@@ -1264,7 +1360,19 @@ static enum task_state kpb_draining_task(void *arg)
 			period_copy_start = platform_timer_get(timer);
 		}
 
-		size_to_read = (uintptr_t)buff->end_addr - (uintptr_t)buff->r_ptr;
+#if CONFIG_KPB_ADAPTIVE_DRAINING
+		if (draining_data->adaptive_mode_on &&
+		    !kpb_drain_burst_ready(draining_data, &sink->stream, drain_req)) {
+			/* Let the host move what it already has, as in the
+			 * synchronized mode the loop waits for the host then.
+			 */
+			comp_copy(sink->sink);
+			continue;
+		}
+#endif
+
+		size_to_read = ((uintptr_t)buff->end_addr - (uintptr_t)buff->r_ptr) *
+			       ratio;
 
 		if (size_to_read > audio_stream_get_free_bytes(&sink->stream)) {
 			if (audio_stream_get_free_bytes(&sink->stream) >= drain_req)
@@ -1280,10 +1388,13 @@ static enum task_state kpb_draining_task(void *arg)
 			}
 		}
 
+		/* whole samples only, so the history read pointer stays exact */
+		size_to_copy = ALIGN_DOWN(size_to_copy, sample_bytes);
+
 		kpb_drain_samples(buff->r_ptr, &sink->stream, size_to_copy,
 				  sample_width);
 
-		buff->r_ptr = (char *)buff->r_ptr + (uint32_t)size_to_copy;
+		buff->r_ptr = (char *)buff->r_ptr + (uint32_t)size_to_copy / ratio;
 		drain_req -= size_to_copy;
 		drained += size_to_copy;
 		period_bytes += size_to_copy;
@@ -1298,9 +1409,11 @@ static enum task_state kpb_draining_task(void *arg)
 
 		if (size_to_copy) {
 			comp_update_buffer_produce(sink, size_to_copy);
+			kpb_drain_burst_done(draining_data, &sink->stream,
+					     size_to_copy);
 			comp_copy(sink->sink);
-		} else if (!audio_stream_get_free_bytes(&sink->stream)) {
-			/* There is no free space in sink buffer.
+		} else {
+			/* There is no free space for a sample in sink buffer.
 			 * Call .copy() on sink component so it can
 			 * process its data further.
 			 */
@@ -1353,9 +1466,98 @@ out:
 		comp_cl_info(&comp_kpb, "KPB: kpb_draining_task(), done. %u drained in > %u ms",
 			     drained, UINT_MAX);
 
+	draining_data->stats.duration = draining_time_end - draining_time_start;
+	draining_data->stats.drained = drained;
+	if (draining_data->stats.duration)
+		draining_data->stats.throughput = (uint64_t)drained *
+			clock_ms_to_ticks(PLATFORM_DEFAULT_CLOCK, 1) /
+			draining_data->stats.duration;
+
+	comp_cl_info(&comp_kpb, "KPB: kpb_draining_task(), %u bursts, peak %u, throughput %u host %u [bytes/ms]",
+		     draining_data->stats.bursts, draining_data->stats.burst_peak,
+		     draining_data->stats.throughput, draining_data->stats.host_rate);
+#if CONFIG_PERFORMANCE_COUNTERS
+	perf_cnt_trace(&kpb_tr, &draining_data->pcd);
+#endif
+
 	return SOF_TASK_STATE_COMPLETED;
 }
 
+#if CONFIG_KPB_HISTORY_COMPRESSED
+/**
+ * \brief Decode samples from compressed history buffer.
+ * \param[in] source - pointer to history buffer data.
+ * \param[in,out] sink - pointer to sink stream.
+ * \param[in] samples - number of samples.
+ * \param[in] sample_width - sample width.
+ */
+static void kpb_decode_samples(const uint8_t *source, struct audio_stream *sink,
+			       size_t samples, size_t sample_width)
+{
+	int16_t *dst16 = sink->w_ptr;
+	int32_t *dst32 = sink->w_ptr;
+	int shift = sample_width - 16;
+	size_t n;
+	size_t i;
+
+	while (samples) {
+		if (sample_width == 16) {
+			n = MIN(samples, audio_stream_bytes_without_wrap(sink, dst16) >> 1);
+			for (i = 0; i < n; i++)
+				dst16[i] = kpb_ulaw_decode(source[i]);
+			dst16 = audio_stream_wrap(sink, dst16 + n);
+		} else {
+			n = MIN(samples, audio_stream_bytes_without_wrap(sink, dst32) >> 2);
+			for (i = 0; i < n; i++)
+				dst32[i] = kpb_ulaw_decode(source[i]) << shift;
+			dst32 = audio_stream_wrap(sink, dst32 + n);
+		}
+
+		source += n;
+		samples -= n;
+	}
+}
+
+/**
+ * \brief Encode samples to compressed history buffer.
+ * \param[in] source - pointer to source stream.
+ * \param[in] offset - start offset of source stream in bytes.
+ * \param[out] sink - pointer to history buffer data.
+ * \param[in] samples - number of samples.
+ * \param[in] sample_width - sample width.
+ */
+static void kpb_encode_samples(const struct audio_stream *source, int offset,
+			       uint8_t *sink, size_t samples, size_t sample_width)
+{
+	void *src = audio_stream_wrap(source, (char *)source->r_ptr + offset);
+	int16_t *src16;
+	int32_t *src32;
+	size_t n;
+	size_t i;
+
+	while (samples) {
+		if (sample_width == 16) {
+			src16 = src;
+			n = MIN(samples, audio_stream_bytes_without_wrap(source, src16) >> 1);
+			for (i = 0; i < n; i++)
+				sink[i] = kpb_ulaw_encode(src16[i]);
+			src = audio_stream_wrap(source, src16 + n);
+		} else {
+			src32 = src;
+			n = MIN(samples, audio_stream_bytes_without_wrap(source, src32) >> 2);
+			for (i = 0; i < n; i++)
+				sink[i] = kpb_ulaw_encode(sample_width == 24 ?
+							  sign_extend_s24(src32[i]) >> 8 :
+							  src32[i] >> 16);
+			src = audio_stream_wrap(source, src32 + n);
+		}
+
+		sink += n;
+		samples -= n;
+	}
+}
+#endif /* CONFIG_KPB_HISTORY_COMPRESSED */
+
 /**
  * \brief Drain data samples safe, according to configuration.
  *
@@ -1368,6 +1570,10 @@ out:
 static void kpb_drain_samples(void *source, struct audio_stream *sink,
 			      size_t size, size_t sample_width)
 {
+#if CONFIG_KPB_HISTORY_COMPRESSED
+	kpb_decode_samples(source, sink, size / (KPB_SAMPLE_CONTAINER_SIZE(sample_width) / 8),
+			   sample_width);
+#else
 	unsigned int samples;
 
 	switch (sample_width) {
@@ -1388,6 +1594,7 @@ static void kpb_drain_samples(void *source, struct audio_stream *sink,
 		comp_cl_err(&comp_kpb, "KPB: An attempt to copy not supported format!");
 		return;
 	}
+#endif /* CONFIG_KPB_HISTORY_COMPRESSED */
 }
 
 /**
@@ -1402,6 +1609,10 @@ static void kpb_buffer_samples(const struct audio_stream *source,
 			       int offset, void *sink, size_t size,
 			       size_t sample_width)
 {
+#if CONFIG_KPB_HISTORY_COMPRESSED
+	kpb_encode_samples(source, offset, sink,
+			   size / (KPB_SAMPLE_CONTAINER_SIZE(sample_width) / 8), sample_width);
+#else
 	unsigned int samples_count;
 	int samples_offset;
 
@@ -1427,6 +1638,7 @@ static void kpb_buffer_samples(const struct audio_stream *source,
 		comp_cl_err(&comp_kpb, "KPB: An attempt to copy not supported format!");
 		return;
 	}
+#endif /* CONFIG_KPB_HISTORY_COMPRESSED */
 }
 
 /**
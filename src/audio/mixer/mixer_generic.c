@@ -0,0 +1,226 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2022 Intel Corporation. All rights reserved.
+//
+// Author: Liam Girdwood <liam.r.girdwood@linux.intel.com>
+//         Keyon Jie <yang.jie@linux.intel.com>
+
+#include <sof/audio/mixer.h>
+
+#ifdef MIXER_GENERIC
+
+#include <sof/audio/audio_stream.h>
+#include <sof/audio/component.h>
+#include <sof/audio/format.h>
+#include <sof/common.h>
+#include <sof/math/numbers.h>
+#include <sof/platform.h>
+#include <ipc/stream.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * The sources are mixed in blocks of MIXER_BLOCK_SAMPLES. Two sources at a
+ * time are added to a wide accumulator that is saturated once when stored
+ * to sink. The inner loops run over contiguous samples without the per
+ * sample walk of the sources pointers array, so the compiler can vectorize
+ * them.
+ */
+
+#if CONFIG_FORMAT_S16LE
+static void mix_s16_acc(int32_t *acc, const int16_t **src, uint32_t num_sources, int n)
+{
+	const int16_t *x0 = src[0];
+	const int16_t *x1;
+	int i;
+	int j;
+
+	/* with odd sources count the first one initializes the accumulator */
+	if (num_sources & 1) {
+		for (i = 0; i < n; i++)
+			acc[i] = x0[i];
+		j = 1;
+	} else {
+		x1 = src[1];
+		for (i = 0; i < n; i++)
+			acc[i] = (int32_t)x0[i] + x1[i];
+		j = 2;
+	}
+
+	for (; j < num_sources; j += 2) {
+		x0 = src[j];
+		x1 = src[j + 1];
+		for (i = 0; i < n; i++)
+			acc[i] += (int32_t)x0[i] + x1[i];
+	}
+}
+
+/* Mix n 16 bit PCM source streams to one sink stream */
+static void mix_n_s16(struct comp_dev *dev, struct audio_stream *sink,
+		      const struct audio_stream **sources, uint32_t num_sources,
+		      uint32_t frames)
+{
+	int32_t acc[MIXER_BLOCK_SAMPLES];
+	int16_t *src[PLATFORM_MAX_STREAMS];
+	int16_t *dest;
+	int i, j, n;
+	int processed = 0;
+	int samples = frames * sink->channels;
+
+	dest = sink->w_ptr;
+	for (j = 0; j < num_sources; j++)
+		src[j] = sources[j]->r_ptr;
+
+	while (processed < samples) {
+		n = mixer_samples_without_wrap(sink, dest, sources, (void **)src,
+					       num_sources, 1, samples - processed);
+		mix_s16_acc(acc, (const int16_t **)src, num_sources, n);
+
+		/* Saturate to 16 bits */
+		for (i = 0; i < n; i++)
+			dest[i] = sat_int16(acc[i]);
+
+		processed += n;
+		dest = audio_stream_wrap(sink, dest + n);
+		for (j = 0; j < num_sources; j++)
+			src[j] = audio_stream_wrap(sources[j], src[j] + n);
+	}
+}
+#endif /* CONFIG_FORMAT_S16LE */
+
+#if CONFIG_FORMAT_S24LE
+static void mix_s24_acc(int32_t *acc, const int32_t **src, uint32_t num_sources, int n)
+{
+	const int32_t *x0 = src[0];
+	const int32_t *x1;
+	int i;
+	int j;
+
+	/* shift left and back to sign extend the 24 bit samples */
+	if (num_sources & 1) {
+		for (i = 0; i < n; i++)
+			acc[i] = (x0[i] << 8) >> 8;
+		j = 1;
+	} else {
+		x1 = src[1];
+		for (i = 0; i < n; i++)
+			acc[i] = ((x0[i] << 8) >> 8) + ((x1[i] << 8) >> 8);
+		j = 2;
+	}
+
+	for (; j < num_sources; j += 2) {
+		x0 = src[j];
+		x1 = src[j + 1];
+		for (i = 0; i < n; i++)
+			acc[i] += ((x0[i] << 8) >> 8) + ((x1[i] << 8) >> 8);
+	}
+}
+
+/* Mix n 24 bit PCM source streams to one sink stream */
+static void mix_n_s24(struct comp_dev *dev, struct audio_stream *sink,
+		      const struct audio_stream **sources, uint32_t num_sources,
+		      uint32_t frames)
+{
+	int32_t acc[MIXER_BLOCK_SAMPLES];
+	int32_t *src[PLATFORM_MAX_STREAMS];
+	int32_t *dest;
+	int i, j, n;
+	int processed = 0;
+	int samples = frames * sink->channels;
+
+	dest = sink->w_ptr;
+	for (j = 0; j < num_sources; j++)
+		src[j] = sources[j]->r_ptr;
+
+	while (processed < samples) {
+		n = mixer_samples_without_wrap(sink, dest, sources, (void **)src,
+					       num_sources, 2, samples - processed);
+		mix_s24_acc(acc, (const int32_t **)src, num_sources, n);
+
+		/* Saturate to 24 bits */
+		for (i = 0; i < n; i++)
+			dest[i] = sat_int24(acc[i]);
+
+		processed += n;
+		dest = audio_stream_wrap(sink, dest + n);
+		for (j = 0; j < num_sources; j++)
+			src[j] = audio_stream_wrap(sources[j], src[j] + n);
+	}
+}
+#endif /* CONFIG_FORMAT_S24LE */
+
+#if CONFIG_FORMAT_S32LE
+static void mix_s32_acc(int64_t *acc, const int32_t **src, uint32_t num_sources, int n)
+{
+	const int32_t *x0 = src[0];
+	const int32_t *x1;
+	int i;
+	int j;
+
+	if (num_sources & 1) {
+		for (i = 0; i < n; i++)
+			acc[i] = x0[i];
+		j = 1;
+	} else {
+		x1 = src[1];
+		for (i = 0; i < n; i++)
+			acc[i] = (int64_t)x0[i] + x1[i];
+		j = 2;
+	}
+
+	for (; j < num_sources; j += 2) {
+		x0 = src[j];
+		x1 = src[j + 1];
+		for (i = 0; i < n; i++)
+			acc[i] += (int64_t)x0[i] + x1[i];
+	}
+}
+
+/* Mix n 32 bit PCM source streams to one sink stream */
+static void mix_n_s32(struct comp_dev *dev, struct audio_stream *sink,
+		      const struct audio_stream **sources, uint32_t num_sources,
+		      uint32_t frames)
+{
+	int64_t acc[MIXER_BLOCK_SAMPLES];
+	int32_t *src[PLATFORM_MAX_STREAMS];
+	int32_t *dest;
+	int i, j, n;
+	int processed = 0;
+	int samples = frames * sink->channels;
+
+	dest = sink->w_ptr;
+	for (j = 0; j < num_sources; j++)
+		src[j] = sources[j]->r_ptr;
+
+	while (processed < samples) {
+		n = mixer_samples_without_wrap(sink, dest, sources, (void **)src,
+					       num_sources, 2, samples - processed);
+		mix_s32_acc(acc, (const int32_t **)src, num_sources, n);
+
+		/* Saturate to 32 bits */
+		for (i = 0; i < n; i++)
+			dest[i] = sat_int32(acc[i]);
+
+		processed += n;
+		dest = audio_stream_wrap(sink, dest + n);
+		for (j = 0; j < num_sources; j++)
+			src[j] = audio_stream_wrap(sources[j], src[j] + n);
+	}
+}
+#endif /* CONFIG_FORMAT_S32LE */
+
+const struct mix_func_map mix_func_map[] = {
+#if CONFIG_FORMAT_S16LE
+	{ SOF_IPC_FRAME_S16_LE, mix_n_s16 },
+#endif /* CONFIG_FORMAT_S16LE */
+#if CONFIG_FORMAT_S24LE
+	{ SOF_IPC_FRAME_S24_4LE, mix_n_s24 },
+#endif /* CONFIG_FORMAT_S24LE */
+#if CONFIG_FORMAT_S32LE
+	{ SOF_IPC_FRAME_S32_LE, mix_n_s32 }
+#endif /* CONFIG_FORMAT_S32LE */
+};
+
+const size_t mix_func_count = ARRAY_SIZE(mix_func_map);
+
+#endif
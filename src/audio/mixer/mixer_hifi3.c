@@ -0,0 +1,329 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2022 Intel Corporation. All rights reserved.
+//
+// Author: Liam Girdwood <liam.r.girdwood@linux.intel.com>
+//         Keyon Jie <yang.jie@linux.intel.com>
+
+#include <sof/audio/mixer.h>
+
+#ifdef MIXER_HIFI3
+
+#include <sof/audio/audio_stream.h>
+#include <sof/audio/component.h>
+#include <sof/audio/format.h>
+#include <sof/common.h>
+#include <sof/math/numbers.h>
+#include <sof/platform.h>
+#include <ipc/stream.h>
+#include <xtensa/tie/xt_hifi3.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Same block processing as the generic version. Two sources at a time are
+ * loaded with unaligned 64 bit loads, widened and added to the accumulator.
+ * The tail of the block that does not fill a 64 bit register is mixed with
+ * scalar code.
+ */
+
+#if CONFIG_FORMAT_S16LE
+/* Add two 16 bit sources or one if x1 is NULL to the 32 bit accumulator */
+static void mix_s16_acc(int32_t *acc, const int16_t *x0, const int16_t *x1, int n,
+			bool init)
+{
+	ae_int16x4 *in0 = (ae_int16x4 *)x0;
+	ae_int16x4 *in1 = (ae_int16x4 *)x1;
+	ae_int32x2 *pa = (ae_int32x2 *)acc;
+	ae_valign align0 = AE_LA64_PP(in0);
+	ae_valign align1;
+	ae_int16x4 s0;
+	ae_int16x4 s1 = AE_ZERO16();
+	ae_int32x2 hi;
+	ae_int32x2 lo;
+	int m = n >> 2;
+	int i;
+
+	if (x1)
+		align1 = AE_LA64_PP(in1);
+
+	for (i = 0; i < m; i++) {
+		AE_LA16X4_IP(s0, align0, in0);
+		if (x1)
+			AE_LA16X4_IP(s1, align1, in1);
+
+		/* sign extended 16 bit samples in 32 bit lanes */
+		hi = AE_ADD32(AE_SRAI32(AE_CVT32X2F16_32(s0), 16),
+			      AE_SRAI32(AE_CVT32X2F16_32(s1), 16));
+		lo = AE_ADD32(AE_SRAI32(AE_CVT32X2F16_10(s0), 16),
+			      AE_SRAI32(AE_CVT32X2F16_10(s1), 16));
+		if (!init) {
+			hi = AE_ADD32(hi, pa[0]);
+			lo = AE_ADD32(lo, pa[1]);
+		}
+
+		AE_S32X2_IP(hi, pa, sizeof(ae_int32x2));
+		AE_S32X2_IP(lo, pa, sizeof(ae_int32x2));
+	}
+
+	for (i = m << 2; i < n; i++) {
+		if (init)
+			acc[i] = 0;
+
+		acc[i] += x0[i];
+		if (x1)
+			acc[i] += x1[i];
+	}
+}
+
+/* Mix n 16 bit PCM source streams to one sink stream */
+static void mix_n_s16(struct comp_dev *dev, struct audio_stream *sink,
+		      const struct audio_stream **sources, uint32_t num_sources,
+		      uint32_t frames)
+{
+	int32_t acc[MIXER_BLOCK_SAMPLES] __aligned(8);
+	int16_t *src[PLATFORM_MAX_STREAMS];
+	ae_int32x2 *pa;
+	ae_int16x4 *out;
+	ae_valign align_out;
+	int16_t *dest;
+	int i, j, n, m;
+	int processed = 0;
+	int samples = frames * sink->channels;
+
+	dest = sink->w_ptr;
+	for (j = 0; j < num_sources; j++)
+		src[j] = sources[j]->r_ptr;
+
+	while (processed < samples) {
+		n = mixer_samples_without_wrap(sink, dest, sources, (void **)src,
+					       num_sources, 1, samples - processed);
+
+		/* with odd sources count the first one initializes the accumulator */
+		j = num_sources & 1;
+		mix_s16_acc(acc, src[0], j ? NULL : src[1], n, true);
+		for (j = 2 - j; j < num_sources; j += 2)
+			mix_s16_acc(acc, src[j], src[j + 1], n, false);
+
+		/* Saturate to 16 bits */
+		pa = (ae_int32x2 *)acc;
+		out = (ae_int16x4 *)dest;
+		align_out = AE_ZALIGN64();
+		m = n >> 2;
+		for (i = 0; i < m; i++) {
+			AE_SA16X4_IP(AE_SAT16X4(pa[0], pa[1]), align_out, out);
+			pa += 2;
+		}
+
+		AE_SA64POS_FP(align_out, out);
+		for (i = m << 2; i < n; i++)
+			dest[i] = sat_int16(acc[i]);
+
+		processed += n;
+		dest = audio_stream_wrap(sink, dest + n);
+		for (j = 0; j < num_sources; j++)
+			src[j] = audio_stream_wrap(sources[j], src[j] + n);
+	}
+}
+#endif /* CONFIG_FORMAT_S16LE */
+
+#if CONFIG_FORMAT_S24LE
+/* Add two 24 bit sources or one if x1 is NULL to the 32 bit accumulator */
+static void mix_s24_acc(int32_t *acc, const int32_t *x0, const int32_t *x1, int n,
+			bool init)
+{
+	ae_int32x2 *in0 = (ae_int32x2 *)x0;
+	ae_int32x2 *in1 = (ae_int32x2 *)x1;
+	ae_int32x2 *pa = (ae_int32x2 *)acc;
+	ae_valign align0 = AE_LA64_PP(in0);
+	ae_valign align1;
+	ae_int32x2 s0;
+	ae_int32x2 s1 = AE_ZERO32();
+	ae_int32x2 sum;
+	int m = n >> 1;
+	int i;
+
+	if (x1)
+		align1 = AE_LA64_PP(in1);
+
+	for (i = 0; i < m; i++) {
+		AE_LA32X2_IP(s0, align0, in0);
+		if (x1)
+			AE_LA32X2_IP(s1, align1, in1);
+
+		/* shift left and back to sign extend the 24 bit samples */
+		sum = AE_ADD32(AE_SRAI32(AE_SLAI32(s0, 8), 8),
+			       AE_SRAI32(AE_SLAI32(s1, 8), 8));
+		if (!init)
+			sum = AE_ADD32(sum, *pa);
+
+		AE_S32X2_IP(sum, pa, sizeof(ae_int32x2));
+	}
+
+	if (n & 1) {
+		i = n - 1;
+		if (init)
+			acc[i] = 0;
+
+		acc[i] += (x0[i] << 8) >> 8;
+		if (x1)
+			acc[i] += (x1[i] << 8) >> 8;
+	}
+}
+
+/* Mix n 24 bit PCM source streams to one sink stream */
+static void mix_n_s24(struct comp_dev *dev, struct audio_stream *sink,
+		      const struct audio_stream **sources, uint32_t num_sources,
+		      uint32_t frames)
+{
+	int32_t acc[MIXER_BLOCK_SAMPLES] __aligned(8);
+	int32_t *src[PLATFORM_MAX_STREAMS];
+	ae_int32x2 *pa;
+	ae_int32x2 *out;
+	ae_valign align_out;
+	int32_t *dest;
+	int i, j, n, m;
+	int processed = 0;
+	int samples = frames * sink->channels;
+
+	dest = sink->w_ptr;
+	for (j = 0; j < num_sources; j++)
+		src[j] = sources[j]->r_ptr;
+
+	while (processed < samples) {
+		n = mixer_samples_without_wrap(sink, dest, sources, (void **)src,
+					       num_sources, 2, samples - processed);
+
+		j = num_sources & 1;
+		mix_s24_acc(acc, src[0], j ? NULL : src[1], n, true);
+		for (j = 2 - j; j < num_sources; j += 2)
+			mix_s24_acc(acc, src[j], src[j + 1], n, false);
+
+		/* Saturate to 24 bits */
+		pa = (ae_int32x2 *)acc;
+		out = (ae_int32x2 *)dest;
+		align_out = AE_ZALIGN64();
+		m = n >> 1;
+		for (i = 0; i < m; i++) {
+			AE_SA32X2_IP(AE_SRAI32(AE_SLAI32S(*pa, 8), 8), align_out, out);
+			pa++;
+		}
+
+		AE_SA64POS_FP(align_out, out);
+		if (n & 1)
+			dest[n - 1] = sat_int24(acc[n - 1]);
+
+		processed += n;
+		dest = audio_stream_wrap(sink, dest + n);
+		for (j = 0; j < num_sources; j++)
+			src[j] = audio_stream_wrap(sources[j], src[j] + n);
+	}
+}
+#endif /* CONFIG_FORMAT_S24LE */
+
+#if CONFIG_FORMAT_S32LE
+/*
+ * Add two 32 bit sources or one if x1 is NULL to the 64 bit accumulator.
+ * The samples are widened to Q17.47 that leaves 16 guard bits.
+ */
+static void mix_s32_acc(ae_int64 *acc, const int32_t *x0, const int32_t *x1, int n,
+			bool init)
+{
+	ae_int32x2 *in0 = (ae_int32x2 *)x0;
+	ae_int32x2 *in1 = (ae_int32x2 *)x1;
+	ae_valign align0 = AE_LA64_PP(in0);
+	ae_valign align1;
+	ae_int32x2 s0;
+	ae_int32x2 s1 = AE_ZERO32();
+	ae_int64 hi;
+	ae_int64 lo;
+	int m = n >> 1;
+	int i;
+
+	if (x1)
+		align1 = AE_LA64_PP(in1);
+
+	for (i = 0; i < m; i++) {
+		AE_LA32X2_IP(s0, align0, in0);
+		if (x1)
+			AE_LA32X2_IP(s1, align1, in1);
+
+		hi = AE_ADD64(AE_CVT64F32_H(s0), AE_CVT64F32_H(s1));
+		lo = AE_ADD64(AE_CVT64F32_H(AE_SEL32_LL(s0, s0)),
+			      AE_CVT64F32_H(AE_SEL32_LL(s1, s1)));
+		if (!init) {
+			hi = AE_ADD64(hi, acc[0]);
+			lo = AE_ADD64(lo, acc[1]);
+		}
+
+		acc[0] = hi;
+		acc[1] = lo;
+		acc += 2;
+	}
+
+	if (n & 1) {
+		s0 = AE_MOVDA32(x0[n - 1]);
+		s1 = x1 ? AE_MOVDA32(x1[n - 1]) : AE_ZERO32();
+		hi = AE_ADD64(AE_CVT64F32_H(s0), AE_CVT64F32_H(s1));
+		*acc = init ? hi : AE_ADD64(hi, *acc);
+	}
+}
+
+/* Mix n 32 bit PCM source streams to one sink stream */
+static void mix_n_s32(struct comp_dev *dev, struct audio_stream *sink,
+		      const struct audio_stream **sources, uint32_t num_sources,
+		      uint32_t frames)
+{
+	ae_int64 acc[MIXER_BLOCK_SAMPLES];
+	int32_t *src[PLATFORM_MAX_STREAMS];
+	ae_int32 *out;
+	ae_int32x2 y;
+	int32_t *dest;
+	int i, j, n;
+	int processed = 0;
+	int samples = frames * sink->channels;
+
+	dest = sink->w_ptr;
+	for (j = 0; j < num_sources; j++)
+		src[j] = sources[j]->r_ptr;
+
+	while (processed < samples) {
+		n = mixer_samples_without_wrap(sink, dest, sources, (void **)src,
+					       num_sources, 2, samples - processed);
+
+		j = num_sources & 1;
+		mix_s32_acc(acc, src[0], j ? NULL : src[1], n, true);
+		for (j = 2 - j; j < num_sources; j += 2)
+			mix_s32_acc(acc, src[j], src[j + 1], n, false);
+
+		/* Round back from Q17.47 with saturation to 32 bits */
+		out = (ae_int32 *)dest;
+		for (i = 0; i < n; i++) {
+			y = AE_ROUND32F64SSYM(acc[i]);
+			AE_S32_L_IP(y, out, sizeof(ae_int32));
+		}
+
+		processed += n;
+		dest = audio_stream_wrap(sink, dest + n);
+		for (j = 0; j < num_sources; j++)
+			src[j] = audio_stream_wrap(sources[j], src[j] + n);
+	}
+}
+#endif /* CONFIG_FORMAT_S32LE */
+
+const struct mix_func_map mix_func_map[] = {
+#if CONFIG_FORMAT_S16LE
+	{ SOF_IPC_FRAME_S16_LE, mix_n_s16 },
+#endif /* CONFIG_FORMAT_S16LE */
+#if CONFIG_FORMAT_S24LE
+	{ SOF_IPC_FRAME_S24_4LE, mix_n_s24 },
+#endif /* CONFIG_FORMAT_S24LE */
+#if CONFIG_FORMAT_S32LE
+	{ SOF_IPC_FRAME_S32_LE, mix_n_s32 }
+#endif /* CONFIG_FORMAT_S32LE */
+};
+
+const size_t mix_func_count = ARRAY_SIZE(mix_func_map);
+
+#endif
@@ -40,6 +40,72 @@ DECLARE_SOF_RT_UUID("multiband_drc", multiband_drc_uuid, 0x0d9f2256, 0x8e4f, 0x4
 
 DECLARE_TR_CTX(multiband_drc_tr, SOF_UUID(multiband_drc_uuid), LOG_LEVEL_INFO);
 
+#if IIR_DF2T_BLOCK
+static inline void multiband_drc_reset_state(struct multiband_drc_state *state)
+{
+	int i;
+
+	/* Reset emphasis and deemphasis eq-iir state */
+	rfree(state->emp_deemp);
+	state->emp_deemp = NULL;
+
+	/* Reset crossover state */
+	crossover_reset_state_all(&state->crossover);
+
+	/* Reset drc kernel state */
+	for (i = 0; i < SOF_MULTIBAND_DRC_MAX_BANDS; i++)
+		drc_reset_state(&state->drc[i]);
+}
+
+/* Sets the emphasis or deemphasis EQ coefficients to all channels */
+static void multiband_drc_init_iir_eq(struct sof_eq_iir_biquad_df2t *coef,
+				      int32_t *eq_coef,
+				      struct iir_state_df2t *iir, int nch)
+{
+	int ret;
+	int ch;
+
+	/* Coefficients of the first biquad and second biquad */
+	ret = memcpy_s(eq_coef, sizeof(struct sof_eq_iir_biquad_df2t) * SOF_EMP_DEEMP_BIQUADS,
+		       coef, sizeof(struct sof_eq_iir_biquad_df2t) * SOF_EMP_DEEMP_BIQUADS);
+	assert(!ret);
+
+	for (ch = 0; ch < nch; ch++) {
+		iir[ch].biquads = SOF_EMP_DEEMP_BIQUADS;
+		iir[ch].biquads_in_series = SOF_EMP_DEEMP_BIQUADS;
+		iir[ch].coef = eq_coef;
+		iir[ch].delay = NULL;
+	}
+}
+
+static int multiband_drc_eq_init_coef(struct multiband_drc_state *state,
+				      struct sof_eq_iir_biquad_df2t *emphasis,
+				      struct sof_eq_iir_biquad_df2t *deemphasis,
+				      int nch)
+{
+	struct iir_state_df2t iir[PLATFORM_MAX_CHANNELS];
+	int32_t eq_coef[SOF_EMP_DEEMP_BIQUADS * SOF_EQ_IIR_NBIQUAD_DF2T];
+	void *data;
+	int size;
+
+	/* Both EQs are two 2nd order filters in series */
+	multiband_drc_init_iir_eq(emphasis, eq_coef, iir, nch);
+	size = iir_df2t_block_size(iir, nch);
+	if (size < 0)
+		return size;
+
+	state->emp_deemp = rzalloc(SOF_MEM_ZONE_RUNTIME, 0, SOF_MEM_CAPS_RAM,
+				   2 * size);
+	if (!state->emp_deemp)
+		return -ENOMEM;
+
+	data = state->emp_deemp;
+	iir_df2t_block_init(&state->emphasis, iir, nch, &data);
+	multiband_drc_init_iir_eq(deemphasis, eq_coef, iir, nch);
+	iir_df2t_block_init(&state->deemphasis, iir, nch, &data);
+	return 0;
+}
+#else
 static inline void multiband_drc_iir_reset_state_ch(struct iir_state_df2t *iir)
 {
 	rfree(iir->coef);
@@ -99,16 +165,17 @@ static int multiband_drc_eq_init_coef_ch(struct sof_eq_iir_biquad_df2t *coef,
 
 	return 0;
 }
+#endif
 
 static int multiband_drc_init_coef(struct multiband_drc_comp_data *cd, int16_t nch, uint32_t rate)
 {
-	struct sof_eq_iir_biquad_df2t *crossover;
-	struct sof_eq_iir_biquad_df2t *emphasis;
-	struct sof_eq_iir_biquad_df2t *deemphasis;
 	struct sof_multiband_drc_config *config = cd->config;
 	struct multiband_drc_state *state = &cd->state;
 	uint32_t sample_bytes = get_sample_bytes(cd->source_format);
-	int i, ch, ret, num_bands;
+	int i, ret, num_bands;
+#if !IIR_DF2T_BLOCK
+	int ch;
+#endif
 
 	if (!config) {
 		comp_cl_err(&comp_multiband_drc, "multiband_drc_init_coef(), no config is set");
@@ -135,10 +202,31 @@ static int multiband_drc_init_coef(struct multiband_drc_comp_data *cd, int16_t n
 		     "multiband_drc_init_coef(), initializing %i-way crossover",
 		     config->num_bands);
 
+#if IIR_DF2T_BLOCK
+	/* Crossover: collect the coef array and assign it to every channel */
+	ret = crossover_init_coef_all(config->crossover_coef, &state->crossover,
+				      nch, config->num_bands);
+	/* Free all previously allocated blocks in case of an error */
+	if (ret < 0) {
+		comp_cl_err(&comp_multiband_drc,
+			    "multiband_drc_init_coef(), could not assign crossover coeffs");
+		goto err;
+	}
+
+	comp_cl_info(&comp_multiband_drc,
+		     "multiband_drc_init_coef(), initializing emphasis and deemphasis eq");
+
+	/* Emphasis and deemphasis: assign the coef arrays to every channel */
+	ret = multiband_drc_eq_init_coef(state, config->emp_coef, config->deemp_coef, nch);
+	if (ret < 0) {
+		comp_cl_err(&comp_multiband_drc,
+			    "multiband_drc_init_coef(), could not assign eq coeffs");
+		goto err;
+	}
+#else
 	/* Crossover: collect the coef array and assign it to every channel */
-	crossover = config->crossover_coef;
 	for (ch = 0; ch < nch; ch++) {
-		ret = crossover_init_coef_ch(crossover, &state->crossover[ch],
+		ret = crossover_init_coef_ch(config->crossover_coef, &state->crossover[ch],
 					     config->num_bands);
 		/* Free all previously allocated blocks in case of an error */
 		if (ret < 0) {
@@ -152,9 +240,8 @@ static int multiband_drc_init_coef(struct multiband_drc_comp_data *cd, int16_t n
 	comp_cl_info(&comp_multiband_drc, "multiband_drc_init_coef(), initializing emphasis_eq");
 
 	/* Emphasis: collect the coef array and assign it to every channel */
-	emphasis = config->emp_coef;
 	for (ch = 0; ch < nch; ch++) {
-		ret = multiband_drc_eq_init_coef_ch(emphasis, &state->emphasis[ch]);
+		ret = multiband_drc_eq_init_coef_ch(config->emp_coef, &state->emphasis[ch]);
 		/* Free all previously allocated blocks in case of an error */
 		if (ret < 0) {
 			comp_cl_err(&comp_multiband_drc,
@@ -167,9 +254,8 @@ static int multiband_drc_init_coef(struct multiband_drc_comp_data *cd, int16_t n
 	comp_cl_info(&comp_multiband_drc, "multiband_drc_init_coef(), initializing deemphasis_eq");
 
 	/* Deemphasis: collect the coef array and assign it to every channel */
-	deemphasis = config->deemp_coef;
 	for (ch = 0; ch < nch; ch++) {
-		ret = multiband_drc_eq_init_coef_ch(deemphasis, &state->deemphasis[ch]);
+		ret = multiband_drc_eq_init_coef_ch(config->deemp_coef, &state->deemphasis[ch]);
 		/* Free all previously allocated blocks in case of an error */
 		if (ret < 0) {
 			comp_cl_err(&comp_multiband_drc,
@@ -178,6 +264,7 @@ static int multiband_drc_init_coef(struct multiband_drc_comp_data *cd, int16_t n
 			goto err;
 		}
 	}
+#endif
 
 	/* Allocate all DRC pre-delay buffers and set delay time with band number */
 	for (i = 0; i < num_bands; i++) {
@@ -9,6 +9,8 @@
 #include <sof/audio/format.h>
 #include <sof/audio/multiband_drc/multiband_drc.h>
 #include <sof/math/iir_df2t.h>
+#include <sof/math/iir_df2t_block.h>
+#include <sof/math/numbers.h>
 
 static void multiband_drc_default_pass(const struct comp_dev *dev,
 				       const struct audio_stream *source,
@@ -18,6 +20,365 @@ static void multiband_drc_default_pass(const struct comp_dev *dev,
 	audio_stream_copy(source, 0, sink, 0, source->channels * frames);
 }
 
+#if MULTIBAND_DRC_GENERIC
+#if IIR_DF2T_BLOCK
+
+/* Runs emphasis and crossover for the block of frames in band[0] */
+static void multiband_drc_process_emp_crossover(struct multiband_drc_state *state,
+						crossover_split split_func,
+						int enable_emp,
+						int frames)
+{
+	if (enable_emp)
+		iir_df2t_block(&state->emphasis, state->crossover.band[0], frames);
+
+	split_func(&state->crossover, frames);
+}
+
+#if CONFIG_FORMAT_S16LE
+/* Runs the DRC of one band in place for a block of frames. The pre-delay
+ * buffers are accessed in fragments that end at the DRC division boundaries.
+ */
+static void multiband_drc_s16_process_drc(struct drc_state *state,
+					  const struct sof_drc_params *p,
+					  int32_t *buf,
+					  int lanes,
+					  int nch,
+					  int frames)
+{
+	int16_t *pd_write;
+	int16_t *pd_read;
+	int32_t *x;
+	int offset;
+	int fragment;
+	int ch;
+	int f;
+	int i = 0;
+
+	if (p->enabled && !state->processed) {
+		drc_update_envelope(state, p);
+		drc_compress_output(state, p, 2, nch);
+		state->processed = 1;
+	}
+
+	offset = state->pre_delay_write_index & DRC_DIVISION_FRAMES_MASK;
+	while (i < frames) {
+		fragment = MIN(DRC_DIVISION_FRAMES - offset, frames - i);
+		for (ch = 0; ch < nch; ++ch) {
+			pd_write = (int16_t *)state->pre_delay_buffers[ch] +
+				state->pre_delay_write_index;
+			pd_read = (int16_t *)state->pre_delay_buffers[ch] +
+				state->pre_delay_read_index;
+			x = buf + i * lanes + ch;
+			for (f = 0; f < fragment; ++f) {
+				*pd_write++ = sat_int16(Q_SHIFT_RND(*x, 31, 15));
+				*x = *pd_read++ << 16;
+				x += lanes;
+			}
+		}
+
+		state->pre_delay_write_index =
+			(state->pre_delay_write_index + fragment) & DRC_MAX_PRE_DELAY_FRAMES_MASK;
+		state->pre_delay_read_index =
+			(state->pre_delay_read_index + fragment) & DRC_MAX_PRE_DELAY_FRAMES_MASK;
+
+		i += fragment;
+		offset = (offset + fragment) & DRC_DIVISION_FRAMES_MASK;
+
+		/* Process the input division (32 frames), only delay if not enabled */
+		if (p->enabled && !offset) {
+			drc_update_detector_average(state, p, 2, nch);
+			drc_update_envelope(state, p);
+			drc_compress_output(state, p, 2, nch);
+		}
+	}
+}
+#endif /* CONFIG_FORMAT_S16LE */
+
+#if CONFIG_FORMAT_S24LE || CONFIG_FORMAT_S32LE
+/* Runs the DRC of one band in place for a block of frames. The pre-delay
+ * buffers are accessed in fragments that end at the DRC division boundaries.
+ */
+static void multiband_drc_s32_process_drc(struct drc_state *state,
+					  const struct sof_drc_params *p,
+					  int32_t *buf,
+					  int lanes,
+					  int nch,
+					  int frames)
+{
+	int32_t *pd_write;
+	int32_t *pd_read;
+	int32_t *x;
+	int offset;
+	int fragment;
+	int ch;
+	int f;
+	int i = 0;
+
+	if (p->enabled && !state->processed) {
+		drc_update_envelope(state, p);
+		drc_compress_output(state, p, 4, nch);
+		state->processed = 1;
+	}
+
+	offset = state->pre_delay_write_index & DRC_DIVISION_FRAMES_MASK;
+	while (i < frames) {
+		fragment = MIN(DRC_DIVISION_FRAMES - offset, frames - i);
+		for (ch = 0; ch < nch; ++ch) {
+			pd_write = (int32_t *)state->pre_delay_buffers[ch] +
+				state->pre_delay_write_index;
+			pd_read = (int32_t *)state->pre_delay_buffers[ch] +
+				state->pre_delay_read_index;
+			x = buf + i * lanes + ch;
+			for (f = 0; f < fragment; ++f) {
+				*pd_write++ = *x;
+				*x = *pd_read++;
+				x += lanes;
+			}
+		}
+
+		state->pre_delay_write_index =
+			(state->pre_delay_write_index + fragment) & DRC_MAX_PRE_DELAY_FRAMES_MASK;
+		state->pre_delay_read_index =
+			(state->pre_delay_read_index + fragment) & DRC_MAX_PRE_DELAY_FRAMES_MASK;
+
+		i += fragment;
+		offset = (offset + fragment) & DRC_DIVISION_FRAMES_MASK;
+
+		/* Process the input division (32 frames), only delay if not enabled */
+		if (p->enabled && !offset) {
+			drc_update_detector_average(state, p, 4, nch);
+			drc_update_envelope(state, p);
+			drc_compress_output(state, p, 4, nch);
+		}
+	}
+}
+#endif /* CONFIG_FORMAT_S24LE || CONFIG_FORMAT_S32LE */
+
+/* Mixes the bands to band[0] and runs deemphasis for the block of frames */
+static void multiband_drc_process_deemp(struct multiband_drc_state *state,
+					int enable_deemp,
+					int nband,
+					int frames)
+{
+	int32_t *mix_out = state->crossover.band[0];
+	int32_t *buf_src_band;
+	int n = frames * state->deemphasis.lanes;
+	int band;
+	int i;
+
+	for (band = 1; band < nband; band++) {
+		buf_src_band = state->crossover.band[band];
+		for (i = 0; i < n; i++)
+			mix_out[i] = sat_int32((int64_t)mix_out[i] + buf_src_band[i]);
+	}
+
+	if (enable_deemp)
+		iir_df2t_block(&state->deemphasis, mix_out, frames);
+}
+
+ /* This graph illustrates the buffers used in the following default functions, as the example
+  * of a 3-band Multiband DRC. The frames are processed in blocks of up to IIR_DF2T_BLOCK_FRAMES
+  * frames in the crossover [frame][lane] band buffers. The DRC processes each band block in
+  * place.
+  *
+  *            :band[0]                                 :band[0..nband-1]
+  *            :                                        :
+  *            :                           o-[]-> DRC0 -[]--o
+  *            :                           | :          :   |
+  *            :                 3-WAY     | :          :   |
+  *    source -[]-> EQ EMP --> CROSSOVER --o-[]-> DRC1 -[]-(+)--> EQ DEEMP -[]-> sink
+  *                                        | :          :   |               :
+  *                                        | :          :   |               :
+  *                                        o-[]-> DRC2 -[]--o               :
+  *                                          :                              :
+  *                                          :band[0..nband-1]              :band[0]
+  */
+#if CONFIG_FORMAT_S16LE
+static void multiband_drc_s16_default(const struct comp_dev *dev,
+				      const struct audio_stream *source,
+				      struct audio_stream *sink,
+				      uint32_t frames)
+{
+	struct multiband_drc_comp_data *cd = comp_get_drvdata(dev);
+	struct multiband_drc_state *state = &cd->state;
+	int32_t *buf;
+	int16_t *x;
+	int16_t *y;
+	int idx_src = 0;
+	int idx_sink = 0;
+	int ch;
+	int band;
+	int i;
+	int n;
+	int start;
+	int nch = source->channels;
+	int nband = cd->config->num_bands;
+	int enable_emp_deemp = cd->config->enable_emp_deemp;
+	int lanes = state->emphasis.lanes;
+
+	for (start = 0; start < frames; start += n) {
+		n = MIN(frames - start, IIR_DF2T_BLOCK_FRAMES);
+		buf = state->crossover.band[0];
+		for (i = 0; i < n; ++i) {
+			for (ch = 0; ch < nch; ch++) {
+				x = audio_stream_read_frag_s16(source, idx_src);
+				buf[ch] = *x << 16;
+				idx_src++;
+			}
+
+			buf += lanes;
+		}
+
+		multiband_drc_process_emp_crossover(state, cd->crossover_split,
+						    enable_emp_deemp, n);
+
+		for (band = 0; band < nband; ++band)
+			multiband_drc_s16_process_drc(&state->drc[band],
+						      &cd->config->drc_coef[band],
+						      state->crossover.band[band],
+						      lanes, nch, n);
+
+		multiband_drc_process_deemp(state, enable_emp_deemp, nband, n);
+
+		buf = state->crossover.band[0];
+		for (i = 0; i < n; ++i) {
+			for (ch = 0; ch < nch; ch++) {
+				y = audio_stream_write_frag_s16(sink, idx_sink);
+				*y = sat_int16(Q_SHIFT_RND(buf[ch], 31, 15));
+				idx_sink++;
+			}
+
+			buf += lanes;
+		}
+	}
+}
+#endif /* CONFIG_FORMAT_S16LE */
+
+#if CONFIG_FORMAT_S24LE
+static void multiband_drc_s24_default(const struct comp_dev *dev,
+				      const struct audio_stream *source,
+				      struct audio_stream *sink,
+				      uint32_t frames)
+{
+	struct multiband_drc_comp_data *cd = comp_get_drvdata(dev);
+	struct multiband_drc_state *state = &cd->state;
+	int32_t *buf;
+	int32_t *x;
+	int32_t *y;
+	int idx_src = 0;
+	int idx_sink = 0;
+	int ch;
+	int band;
+	int i;
+	int n;
+	int start;
+	int nch = source->channels;
+	int nband = cd->config->num_bands;
+	int enable_emp_deemp = cd->config->enable_emp_deemp;
+	int lanes = state->emphasis.lanes;
+
+	for (start = 0; start < frames; start += n) {
+		n = MIN(frames - start, IIR_DF2T_BLOCK_FRAMES);
+		buf = state->crossover.band[0];
+		for (i = 0; i < n; ++i) {
+			for (ch = 0; ch < nch; ch++) {
+				x = audio_stream_read_frag_s32(source, idx_src);
+				buf[ch] = *x << 8;
+				idx_src++;
+			}
+
+			buf += lanes;
+		}
+
+		multiband_drc_process_emp_crossover(state, cd->crossover_split,
+						    enable_emp_deemp, n);
+
+		for (band = 0; band < nband; ++band)
+			multiband_drc_s32_process_drc(&state->drc[band],
+						      &cd->config->drc_coef[band],
+						      state->crossover.band[band],
+						      lanes, nch, n);
+
+		multiband_drc_process_deemp(state, enable_emp_deemp, nband, n);
+
+		buf = state->crossover.band[0];
+		for (i = 0; i < n; ++i) {
+			for (ch = 0; ch < nch; ch++) {
+				y = audio_stream_write_frag_s32(sink, idx_sink);
+				*y = sat_int24(Q_SHIFT_RND(buf[ch], 31, 23));
+				idx_sink++;
+			}
+
+			buf += lanes;
+		}
+	}
+}
+#endif /* CONFIG_FORMAT_S24LE */
+
+#if CONFIG_FORMAT_S32LE
+static void multiband_drc_s32_default(const struct comp_dev *dev,
+				      const struct audio_stream *source,
+				      struct audio_stream *sink,
+				      uint32_t frames)
+{
+	struct multiband_drc_comp_data *cd = comp_get_drvdata(dev);
+	struct multiband_drc_state *state = &cd->state;
+	int32_t *buf;
+	int32_t *x;
+	int32_t *y;
+	int idx_src = 0;
+	int idx_sink = 0;
+	int ch;
+	int band;
+	int i;
+	int n;
+	int start;
+	int nch = source->channels;
+	int nband = cd->config->num_bands;
+	int enable_emp_deemp = cd->config->enable_emp_deemp;
+	int lanes = state->emphasis.lanes;
+
+	for (start = 0; start < frames; start += n) {
+		n = MIN(frames - start, IIR_DF2T_BLOCK_FRAMES);
+		buf = state->crossover.band[0];
+		for (i = 0; i < n; ++i) {
+			for (ch = 0; ch < nch; ch++) {
+				x = audio_stream_read_frag_s32(source, idx_src);
+				buf[ch] = *x;
+				idx_src++;
+			}
+
+			buf += lanes;
+		}
+
+		multiband_drc_process_emp_crossover(state, cd->crossover_split,
+						    enable_emp_deemp, n);
+
+		for (band = 0; band < nband; ++band)
+			multiband_drc_s32_process_drc(&state->drc[band],
+						      &cd->config->drc_coef[band],
+						      state->crossover.band[band],
+						      lanes, nch, n);
+
+		multiband_drc_process_deemp(state, enable_emp_deemp, nband, n);
+
+		buf = state->crossover.band[0];
+		for (i = 0; i < n; ++i) {
+			for (ch = 0; ch < nch; ch++) {
+				y = audio_stream_write_frag_s32(sink, idx_sink);
+				*y = buf[ch];
+				idx_sink++;
+			}
+
+			buf += lanes;
+		}
+	}
+}
+#endif /* CONFIG_FORMAT_S32LE */
+
+#else /* IIR_DF2T_BLOCK */
+
 static void multiband_drc_process_emp_crossover(struct multiband_drc_state *state,
 						crossover_split split_func,
 						int32_t *buf_src,
@@ -375,6 +736,8 @@ static void multiband_drc_s32_default(const struct comp_dev *dev,
 }
 #endif /* CONFIG_FORMAT_S32LE */
 
+#endif /* IIR_DF2T_BLOCK */
+
 const struct multiband_drc_proc_fnmap multiband_drc_proc_fnmap[] = {
 /* { SOURCE_FORMAT , PROCESSING FUNCTION } */
 #if CONFIG_FORMAT_S16LE
@@ -390,6 +753,10 @@ const struct multiband_drc_proc_fnmap multiband_drc_proc_fnmap[] = {
 #endif /* CONFIG_FORMAT_S32LE */
 };
 
+const size_t multiband_drc_proc_fncount = ARRAY_SIZE(multiband_drc_proc_fnmap);
+
+#endif /* MULTIBAND_DRC_GENERIC */
+
 const struct multiband_drc_proc_fnmap multiband_drc_proc_fnmap_pass[] = {
 /* { SOURCE_FORMAT , PROCESSING FUNCTION } */
 #if CONFIG_FORMAT_S16LE
@@ -404,5 +771,3 @@ const struct multiband_drc_proc_fnmap multiband_drc_proc_fnmap_pass[] = {
 	{ SOF_IPC_FRAME_S32_LE, multiband_drc_default_pass },
 #endif /* CONFIG_FORMAT_S32LE */
 };
-
-const size_t multiband_drc_proc_fncount = ARRAY_SIZE(multiband_drc_proc_fnmap);
@@ -0,0 +1,339 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2022 Google LLC. All rights reserved.
+
+#include <stdint.h>
+#include <sof/audio/drc/drc_algorithm.h>
+#include <sof/audio/format.h>
+#include <sof/audio/multiband_drc/multiband_drc.h>
+#include <sof/math/iir_df2t.h>
+#include <sof/math/iir_df2t_block.h>
+#include <sof/math/numbers.h>
+
+#if MULTIBAND_DRC_HIFI3
+
+#include <xtensa/tie/xt_hifi3.h>
+
+/* Sets the stream buffer as circular for the _XC loads and stores */
+static inline void multiband_drc_setup_circular(const struct audio_stream *buffer)
+{
+	AE_SETCBEGIN0(buffer->addr);
+	AE_SETCEND0(buffer->end_addr);
+}
+
+/* Runs emphasis and crossover for the block of frames in band[0] */
+static void multiband_drc_process_emp_crossover(struct multiband_drc_state *state,
+						crossover_split split_func,
+						int enable_emp,
+						int frames)
+{
+	if (enable_emp)
+		iir_df2t_block(&state->emphasis, state->crossover.band[0], frames);
+
+	split_func(&state->crossover, frames);
+}
+
+/* Runs the DRC of one band in place for a block of frames. The pre-delay
+ * buffers are accessed in fragments that end at the DRC division boundaries.
+ * The band block is accessed with a stride of lanes samples per frame.
+ */
+static void multiband_drc_process_drc(struct drc_state *state,
+				      const struct sof_drc_params *p,
+				      int32_t *buf,
+				      int lanes,
+				      int nbyte,
+				      int nch,
+				      int frames)
+{
+	ae_int16 *pd_write16;
+	ae_int16 *pd_read16;
+	ae_int32 *pd_write;
+	ae_int32 *pd_read;
+	ae_int32 *x;
+	ae_int16x4 d16;
+	ae_int32x2 d;
+	ae_int32x2 out;
+	const int step = lanes * sizeof(int32_t);
+	int offset;
+	int fragment;
+	int ch;
+	int f;
+	int i = 0;
+
+	if (p->enabled && !state->processed) {
+		drc_update_envelope(state, p);
+		drc_compress_output(state, p, nbyte, nch);
+		state->processed = 1;
+	}
+
+	offset = state->pre_delay_write_index & DRC_DIVISION_FRAMES_MASK;
+	while (i < frames) {
+		fragment = MIN(DRC_DIVISION_FRAMES - offset, frames - i);
+		for (ch = 0; ch < nch; ++ch) {
+			x = (ae_int32 *)(buf + i * lanes + ch);
+			if (nbyte == 2) {
+				pd_write16 = (ae_int16 *)state->pre_delay_buffers[ch] +
+					state->pre_delay_write_index;
+				pd_read16 = (ae_int16 *)state->pre_delay_buffers[ch] +
+					state->pre_delay_read_index;
+				for (f = 0; f < fragment; ++f) {
+					AE_L16_IP(d16, pd_read16, sizeof(int16_t));
+					out = AE_CVT32X2F16_32(d16);
+					d = AE_L32_I(x, 0);
+					d16 = AE_ROUND16X4F32SSYM(d, d);
+					AE_S16_0_IP(d16, pd_write16, sizeof(int16_t));
+					AE_S32_L_XP(out, x, step);
+				}
+			} else {
+				pd_write = (ae_int32 *)state->pre_delay_buffers[ch] +
+					state->pre_delay_write_index;
+				pd_read = (ae_int32 *)state->pre_delay_buffers[ch] +
+					state->pre_delay_read_index;
+				for (f = 0; f < fragment; ++f) {
+					AE_L32_IP(out, pd_read, sizeof(int32_t));
+					d = AE_L32_I(x, 0);
+					AE_S32_L_IP(d, pd_write, sizeof(int32_t));
+					AE_S32_L_XP(out, x, step);
+				}
+			}
+		}
+
+		state->pre_delay_write_index =
+			(state->pre_delay_write_index + fragment) & DRC_MAX_PRE_DELAY_FRAMES_MASK;
+		state->pre_delay_read_index =
+			(state->pre_delay_read_index + fragment) & DRC_MAX_PRE_DELAY_FRAMES_MASK;
+
+		i += fragment;
+		offset = (offset + fragment) & DRC_DIVISION_FRAMES_MASK;
+
+		/* Process the input division (32 frames), only delay if not enabled */
+		if (p->enabled && !offset) {
+			drc_update_detector_average(state, p, nbyte, nch);
+			drc_update_envelope(state, p);
+			drc_compress_output(state, p, nbyte, nch);
+		}
+	}
+}
+
+/* Runs the DRC of every band and mixes the bands to band[0] with saturation,
+ * followed by deemphasis.
+ */
+static void multiband_drc_process_drc_deemp(struct multiband_drc_comp_data *cd,
+					    int nbyte,
+					    int nch,
+					    int frames)
+{
+	struct multiband_drc_state *state = &cd->state;
+	ae_int32x2 *mix_out;
+	ae_int32x2 *in;
+	ae_int32x2 d0;
+	ae_int32x2 d1;
+	const int lanes = state->emphasis.lanes;
+	const int samples = frames * lanes;
+	int nband = cd->config->num_bands;
+	int band;
+	int i;
+
+	for (band = 0; band < nband; ++band)
+		multiband_drc_process_drc(&state->drc[band], &cd->config->drc_coef[band],
+					  state->crossover.band[band], lanes, nbyte, nch,
+					  frames);
+
+	for (band = 1; band < nband; band++) {
+		mix_out = (ae_int32x2 *)state->crossover.band[0];
+		in = (ae_int32x2 *)state->crossover.band[band];
+		for (i = 0; i < samples; i += 2) {
+			AE_L32X2_IP(d1, in, sizeof(ae_int32x2));
+			d0 = AE_L32X2_I(mix_out, 0);
+			d0 = AE_ADD32S(d0, d1);
+			AE_S32X2_IP(d0, mix_out, sizeof(ae_int32x2));
+		}
+	}
+
+	if (cd->config->enable_emp_deemp)
+		iir_df2t_block(&state->deemphasis, state->crossover.band[0], frames);
+}
+
+#if CONFIG_FORMAT_S16LE
+static void multiband_drc_s16_default(const struct comp_dev *dev,
+				      const struct audio_stream *source,
+				      struct audio_stream *sink,
+				      uint32_t frames)
+{
+	struct multiband_drc_comp_data *cd = comp_get_drvdata(dev);
+	struct multiband_drc_state *state = &cd->state;
+	ae_int16 *x = (ae_int16 *)source->r_ptr;
+	ae_int16 *y = (ae_int16 *)sink->w_ptr;
+	ae_int16x4 d;
+	ae_int32x2 s;
+	ae_int32 *buf;
+	int ch;
+	int i;
+	int n;
+	int start;
+	const int nch = source->channels;
+	const int lanes = state->emphasis.lanes;
+	const int pad = (lanes - nch) * sizeof(int32_t);
+
+	for (start = 0; start < frames; start += n) {
+		n = MIN(frames - start, IIR_DF2T_BLOCK_FRAMES);
+
+		/* Q1.15 source to Q1.31 band[0] */
+		multiband_drc_setup_circular(source);
+		buf = (ae_int32 *)state->crossover.band[0];
+		for (i = 0; i < n; ++i) {
+			for (ch = 0; ch < nch; ch++) {
+				AE_L16_XC(d, x, sizeof(int16_t));
+				s = AE_CVT32X2F16_32(d);
+				AE_S32_L_IP(s, buf, sizeof(int32_t));
+			}
+
+			buf = (ae_int32 *)((int8_t *)buf + pad);
+		}
+
+		multiband_drc_process_emp_crossover(state, cd->crossover_split,
+						    cd->config->enable_emp_deemp, n);
+		multiband_drc_process_drc_deemp(cd, 2, nch, n);
+
+		/* Round and saturate band[0] to Q1.15 sink */
+		multiband_drc_setup_circular(sink);
+		buf = (ae_int32 *)state->crossover.band[0];
+		for (i = 0; i < n; ++i) {
+			for (ch = 0; ch < nch; ch++) {
+				AE_L32_IP(s, buf, sizeof(int32_t));
+				d = AE_ROUND16X4F32SSYM(s, s);
+				AE_S16_0_XC(d, y, sizeof(int16_t));
+			}
+
+			buf = (ae_int32 *)((int8_t *)buf + pad);
+		}
+	}
+}
+#endif /* CONFIG_FORMAT_S16LE */
+
+#if CONFIG_FORMAT_S24LE
+static void multiband_drc_s24_default(const struct comp_dev *dev,
+				      const struct audio_stream *source,
+				      struct audio_stream *sink,
+				      uint32_t frames)
+{
+	struct multiband_drc_comp_data *cd = comp_get_drvdata(dev);
+	struct multiband_drc_state *state = &cd->state;
+	ae_int32 *x = (ae_int32 *)source->r_ptr;
+	ae_int32 *y = (ae_int32 *)sink->w_ptr;
+	ae_int32x2 s;
+	ae_int32 *buf;
+	int ch;
+	int i;
+	int n;
+	int start;
+	const int nch = source->channels;
+	const int lanes = state->emphasis.lanes;
+	const int pad = (lanes - nch) * sizeof(int32_t);
+
+	for (start = 0; start < frames; start += n) {
+		n = MIN(frames - start, IIR_DF2T_BLOCK_FRAMES);
+
+		/* Q1.23 source to Q1.31 band[0] */
+		multiband_drc_setup_circular(source);
+		buf = (ae_int32 *)state->crossover.band[0];
+		for (i = 0; i < n; ++i) {
+			for (ch = 0; ch < nch; ch++) {
+				AE_L32_XC(s, x, sizeof(int32_t));
+				s = AE_SLAI32(s, 8);
+				AE_S32_L_IP(s, buf, sizeof(int32_t));
+			}
+
+			buf = (ae_int32 *)((int8_t *)buf + pad);
+		}
+
+		multiband_drc_process_emp_crossover(state, cd->crossover_split,
+						    cd->config->enable_emp_deemp, n);
+		multiband_drc_process_drc_deemp(cd, 4, nch, n);
+
+		/* Round to Q1.23, saturate and shift to LSB side for sink */
+		multiband_drc_setup_circular(sink);
+		buf = (ae_int32 *)state->crossover.band[0];
+		for (i = 0; i < n; ++i) {
+			for (ch = 0; ch < nch; ch++) {
+				AE_L32_IP(s, buf, sizeof(int32_t));
+				s = AE_SRAI32(AE_SLAI32S(AE_SRAI32R(s, 8), 8), 8);
+				AE_S32_L_XC(s, y, sizeof(int32_t));
+			}
+
+			buf = (ae_int32 *)((int8_t *)buf + pad);
+		}
+	}
+}
+#endif /* CONFIG_FORMAT_S24LE */
+
+#if CONFIG_FORMAT_S32LE
+static void multiband_drc_s32_default(const struct comp_dev *dev,
+				      const struct audio_stream *source,
+				      struct audio_stream *sink,
+				      uint32_t frames)
+{
+	struct multiband_drc_comp_data *cd = comp_get_drvdata(dev);
+	struct multiband_drc_state *state = &cd->state;
+	ae_int32 *x = (ae_int32 *)source->r_ptr;
+	ae_int32 *y = (ae_int32 *)sink->w_ptr;
+	ae_int32x2 s;
+	ae_int32 *buf;
+	int ch;
+	int i;
+	int n;
+	int start;
+	const int nch = source->channels;
+	const int lanes = state->emphasis.lanes;
+	const int pad = (lanes - nch) * sizeof(int32_t);
+
+	for (start = 0; start < frames; start += n) {
+		n = MIN(frames - start, IIR_DF2T_BLOCK_FRAMES);
+
+		multiband_drc_setup_circular(source);
+		buf = (ae_int32 *)state->crossover.band[0];
+		for (i = 0; i < n; ++i) {
+			for (ch = 0; ch < nch; ch++) {
+				AE_L32_XC(s, x, sizeof(int32_t));
+				AE_S32_L_IP(s, buf, sizeof(int32_t));
+			}
+
+			buf = (ae_int32 *)((int8_t *)buf + pad);
+		}
+
+		multiband_drc_process_emp_crossover(state, cd->crossover_split,
+						    cd->config->enable_emp_deemp, n);
+		multiband_drc_process_drc_deemp(cd, 4, nch, n);
+
+		multiband_drc_setup_circular(sink);
+		buf = (ae_int32 *)state->crossover.band[0];
+		for (i = 0; i < n; ++i) {
+			for (ch = 0; ch < nch; ch++) {
+				AE_L32_IP(s, buf, sizeof(int32_t));
+				AE_S32_L_XC(s, y, sizeof(int32_t));
+			}
+
+			buf = (ae_int32 *)((int8_t *)buf + pad);
+		}
+	}
+}
+#endif /* CONFIG_FORMAT_S32LE */
+
+const struct multiband_drc_proc_fnmap multiband_drc_proc_fnmap[] = {
+/* { SOURCE_FORMAT , PROCESSING FUNCTION } */
+#if CONFIG_FORMAT_S16LE
+	{ SOF_IPC_FRAME_S16_LE, multiband_drc_s16_default },
+#endif /* CONFIG_FORMAT_S16LE */
+
+#if CONFIG_FORMAT_S24LE
+	{ SOF_IPC_FRAME_S24_4LE, multiband_drc_s24_default },
+#endif /* CONFIG_FORMAT_S24LE */
+
+#if CONFIG_FORMAT_S32LE
+	{ SOF_IPC_FRAME_S32_LE, multiband_drc_s32_default },
+#endif /* CONFIG_FORMAT_S32LE */
+};
+
+const size_t multiband_drc_proc_fncount = ARRAY_SIZE(multiband_drc_proc_fnmap);
+
+#endif /* MULTIBAND_DRC_HIFI3 */
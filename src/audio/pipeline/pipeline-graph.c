@@ -187,8 +187,66 @@ void pipeline_disconnect(struct comp_dev *comp, struct comp_buffer *buffer, int
 	list_item_del(buffer_comp_list(buffer, dir));
 	comp_writeback(comp);
 	irq_local_enable(flags);
+
+#if CONFIG_BUFFER_INPLACE
+	/* in-place memory sharing through the component ends with the link */
+	if (dir == PPL_CONN_DIR_COMP_TO_BUFFER)
+		buffer_inplace_unlink(buffer);
+	else if (buffer->inplace_sink)
+		buffer_inplace_unlink(buffer->inplace_sink);
+#endif
 }
 
+#if CONFIG_BUFFER_INPLACE
+static bool pipeline_comp_inplace_ok(struct comp_dev *dev, struct comp_buffer *source,
+				     struct comp_buffer *sink)
+{
+	struct comp_buffer *src = buffer_acquire(source);
+	struct comp_buffer *snk = buffer_acquire(sink);
+	bool ok;
+
+	/* both buffers are reset together with the pipeline on prepare */
+	ok = src->source && src->source->pipeline == dev->pipeline &&
+	     snk->sink && snk->sink->pipeline == dev->pipeline;
+
+	/* the buffers are local and the frames are of the same size */
+	ok = ok && !is_coherent_shared(src, c) && !is_coherent_shared(snk, c) &&
+	     src->stream.size == snk->stream.size && src->caps == snk->caps &&
+	     src->stream.frame_fmt == snk->stream.frame_fmt &&
+	     src->stream.channels == snk->stream.channels &&
+	     src->stream.rate == snk->stream.rate &&
+	     (!src->inplace_sink || src->inplace_sink == sink);
+
+	buffer_release(snk);
+	buffer_release(src);
+
+	return ok;
+}
+
+int pipeline_comp_inplace(struct comp_dev *dev)
+{
+	struct comp_buffer *source;
+	struct comp_buffer *sink;
+
+	if (!(dev->drv->flags & COMP_DRV_FLAG_INPLACE) ||
+	    list_is_empty(&dev->bsource_list) || list_is_empty(&dev->bsink_list))
+		return 0;
+
+	source = list_first_item(&dev->bsource_list, struct comp_buffer, sink_list);
+	sink = list_first_item(&dev->bsink_list, struct comp_buffer, source_list);
+
+	/* single source and single sink only */
+	if (dev->bsource_list.next == dev->bsource_list.prev &&
+	    dev->bsink_list.next == dev->bsink_list.prev &&
+	    pipeline_comp_inplace_ok(dev, source, sink))
+		return buffer_inplace_link(source, sink);
+
+	buffer_inplace_unlink(sink);
+
+	return 0;
+}
+#endif
+
 /* pipelines must be inactive */
 int pipeline_free(struct pipeline *p)
 {
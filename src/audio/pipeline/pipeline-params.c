@@ -290,6 +290,12 @@ static int pipeline_comp_prepare(struct comp_dev *current,
 	if (err < 0 || err == PPL_STATUS_PATH_STOP)
 		return err;
 
+#if CONFIG_BUFFER_INPLACE
+	err = pipeline_comp_inplace(current);
+	if (err < 0)
+		return err;
+#endif
+
 	return pipeline_for_each_comp(current, ctx, dir);
 }
 
@@ -8,7 +8,9 @@
 #include <sof/audio/buffer.h>
 #include <sof/audio/component_ext.h>
 #include <sof/audio/pipeline.h>
+#include <sof/lib/clk.h>
 #include <sof/lib/dai.h>
+#include <sof/lib/perf_cnt.h>
 #include <sof/lib/wait.h>
 #include <sof/list.h>
 #include <sof/spinlock.h>
@@ -19,6 +21,9 @@
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
+#if CONFIG_COMP_PROFILING && CONFIG_LIBRARY
+#include <time.h>
+#endif
 
 /*
  * Check whether pipeline is incapable of acquiring data for capture.
@@ -61,6 +66,91 @@ pipeline_should_report_enodata_on_trigger(struct comp_dev *rsrc,
 	return false;
 }
 
+#if CONFIG_COMP_PROFILING
+/* time stamp in cycles, the host build has no cycle counter and profiles
+ * in nanoseconds of the monotonic clock
+ */
+static uint64_t pipeline_comp_profile_time(void)
+{
+#if CONFIG_LIBRARY
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+#else
+	return timer_get_system(cpu_timer_get());
+#endif
+}
+
+/* cycles available to one component copy() in a period */
+static uint32_t pipeline_comp_profile_budget(struct comp_dev *current)
+{
+#if CONFIG_LIBRARY
+	/* host profile time counts nanoseconds */
+	return current->period * 1000;
+#else
+	return clock_us_to_ticks(CLK_CPU(cpu_get_id()), current->period);
+#endif
+}
+
+/* frames ready in the first sink, or frames free in the first source for
+ * endpoint components without sink
+ */
+static uint32_t pipeline_comp_profile_level(struct comp_dev *current)
+{
+	struct comp_buffer *buf;
+	uint32_t frames;
+
+	if (!list_is_empty(&current->bsink_list)) {
+		buf = list_first_item(&current->bsink_list, struct comp_buffer,
+				      source_list);
+		buf = buffer_acquire(buf);
+		frames = audio_stream_get_avail_frames(&buf->stream);
+		buffer_release(buf);
+		return frames;
+	}
+
+	if (!list_is_empty(&current->bsource_list)) {
+		buf = list_first_item(&current->bsource_list, struct comp_buffer,
+				      sink_list);
+		buf = buffer_acquire(buf);
+		frames = audio_stream_get_free_frames(&buf->stream);
+		buffer_release(buf);
+		return frames;
+	}
+
+	return 0;
+}
+
+static int pipeline_comp_profile_copy(struct comp_dev *current)
+{
+	uint32_t level = pipeline_comp_profile_level(current);
+	uint64_t start;
+	uint32_t cycles;
+	uint32_t frames;
+	int err;
+
+	if (!current->prof.count)
+		perf_cnt_profile_init(&current->prof,
+				      pipeline_comp_profile_budget(current));
+
+	start = pipeline_comp_profile_time();
+	err = comp_copy(current);
+	cycles = pipeline_comp_profile_time() - start;
+
+	if (err < 0)
+		return err;
+
+	frames = pipeline_comp_profile_level(current);
+	frames = frames > level ? frames - level : 0;
+	perf_cnt_profile_record(&current->prof, cycles, frames);
+
+	return err;
+}
+#else
+#define pipeline_comp_profile_copy(current) comp_copy(current)
+#endif
+
 static int pipeline_comp_copy(struct comp_dev *current,
 			      struct comp_buffer *calling_buf,
 			      struct pipeline_walk_context *ctx, int dir)
@@ -85,7 +175,7 @@ static int pipeline_comp_copy(struct comp_dev *current,
 
 	/* copy to downstream immediately */
 	if (dir == PPL_DIR_DOWNSTREAM) {
-		err = comp_copy(current);
+		err = pipeline_comp_profile_copy(current);
 		if (err < 0 || err == PPL_STATUS_PATH_STOP)
 			return err;
 	}
@@ -95,7 +185,7 @@ static int pipeline_comp_copy(struct comp_dev *current,
 		return err;
 
 	if (dir == PPL_DIR_UPSTREAM)
-		err = comp_copy(current);
+		err = pipeline_comp_profile_copy(current);
 
 	return err;
 }
@@ -34,7 +34,9 @@
 #include <stddef.h>
 #include <stdint.h>
 
-#if SRC_SHORT || CONFIG_COMP_SRC_TINY
+#if CONFIG_COMP_SRC_DESIGN
+#include <sof/audio/src/src_design.h>
+#elif SRC_SHORT || CONFIG_COMP_SRC_TINY
 #include <sof/audio/coefficients/src/src_tiny_int16_define.h>
 #include <sof/audio/coefficients/src/src_tiny_int16_table.h>
 #else
@@ -115,6 +117,7 @@ static int src_out_delay_length(struct src_stage *s)
 	return 1 + (s->num_of_subfilters - 1) * s->odm;
 }
 
+#if !CONFIG_COMP_SRC_DESIGN
 /* Returns index of a matching sample rate */
 static int src_find_fs(int fs_list[], int list_length, int fs)
 {
@@ -126,6 +129,7 @@ static int src_find_fs(int fs_list[], int list_length, int fs)
 	}
 	return -EINVAL;
 }
+#endif
 
 /* Calculates buffers to allocate for a SRC mode */
 int src_buffer_lengths(struct src_param *a, int fs_in, int fs_out, int nch,
@@ -134,6 +138,9 @@ int src_buffer_lengths(struct src_param *a, int fs_in, int fs_out, int nch,
 	struct src_stage *stage1;
 	struct src_stage *stage2;
 	int r1;
+#if CONFIG_COMP_SRC_DESIGN
+	int ret;
+#endif
 
 	if (nch > PLATFORM_MAX_CHANNELS) {
 		/* TODO: should be device, not class */
@@ -143,6 +150,24 @@ int src_buffer_lengths(struct src_param *a, int fs_in, int fs_out, int nch,
 	}
 
 	a->nch = nch;
+#if CONFIG_COMP_SRC_DESIGN
+	ret = src_design_get(&stage1, &stage2, fs_in, fs_out);
+	if (ret < 0) {
+		comp_cl_err(&comp_src, "src_buffer_lengths(): filter design failed, fs_in: %u, fs_out: %u",
+			    fs_in, fs_out);
+		return ret;
+	}
+
+	/* Release the stages of previous params after getting the new
+	 * ones, so a repeated conversion reuses the designed filters.
+	 */
+	src_design_put(a->stage1);
+	src_design_put(a->stage2);
+	a->stage1 = stage1;
+	a->stage2 = stage2;
+	comp_cl_info(&comp_src, "src_buffer_lengths(), stage lengths %d, %d",
+		     stage1->filter_length, stage2->filter_length);
+#else
 	a->idx_in = src_find_fs(src_in_fs, NUM_IN_FS, fs_in);
 	a->idx_out = src_find_fs(src_out_fs, NUM_OUT_FS, fs_out);
 
@@ -162,6 +187,7 @@ int src_buffer_lengths(struct src_param *a, int fs_in, int fs_out, int nch,
 			    fs_in, fs_out);
 		return -EINVAL;
 	}
+#endif
 
 	a->fir_s1 = nch * src_fir_delay_length(stage1);
 	a->out_s1 = nch * src_out_delay_length(stage1);
@@ -291,12 +317,21 @@ int src_polyphase_init(struct polyphase_src *src, struct src_param *p,
 	int n_stages;
 	int ret;
 
+#if CONFIG_COMP_SRC_DESIGN
+	if (!p->stage1 || !p->stage2)
+		return -EINVAL;
+
+	/* Get setup for 2 stage conversion */
+	stage1 = p->stage1;
+	stage2 = p->stage2;
+#else
 	if (p->idx_in < 0 || p->idx_out < 0)
 		return -EINVAL;
 
 	/* Get setup for 2 stage conversion */
 	stage1 = src_table1[p->idx_out][p->idx_in];
 	stage2 = src_table2[p->idx_out][p->idx_in];
+#endif
 	ret = init_stages(stage1, stage2, src, p, 2, delay_lines_start);
 	if (ret < 0)
 		return -EINVAL;
@@ -308,7 +343,11 @@ int src_polyphase_init(struct polyphase_src *src, struct src_param *p,
 	 * tap.
 	 */
 	n_stages = (src->stage2->filter_length == 1) ? 1 : 2;
+#if CONFIG_COMP_SRC_DESIGN
+	if (src->stage1->filter_length == 1)
+#else
 	if (p->idx_in == p->idx_out)
+#endif
 		n_stages = 0;
 
 	/* If filter length for first stage is zero this is a deleted
@@ -603,6 +642,10 @@ static void src_free(struct comp_dev *dev)
 	if (cd->delay_lines)
 		rfree(cd->delay_lines);
 
+#if CONFIG_COMP_SRC_DESIGN
+	src_design_put(cd->param.stage1);
+	src_design_put(cd->param.stage2);
+#endif
 	rfree(cd);
 	rfree(dev);
 }
@@ -964,18 +1007,30 @@ static int src_prepare(struct comp_dev *dev)
 	case SOF_IPC_FRAME_S16_LE:
 		cd->data_shift = 0;
 		cd->polyphase_func = src_polyphase_stage_cir_s16;
+#if SRC_MULTICH
+		if (sourceb->stream.channels > 2)
+			cd->polyphase_func = src_polyphase_stage_cir_multich_s16;
+#endif
 		break;
 #endif /* CONFIG_FORMAT_S16LE */
 #if CONFIG_FORMAT_S24LE
 	case SOF_IPC_FRAME_S24_4LE:
 		cd->data_shift = 8;
 		cd->polyphase_func = src_polyphase_stage_cir;
+#if SRC_MULTICH
+		if (sourceb->stream.channels > 2)
+			cd->polyphase_func = src_polyphase_stage_cir_multich;
+#endif
 		break;
 #endif /* CONFIG_FORMAT_S24LE */
 #if CONFIG_FORMAT_S32LE
 	case SOF_IPC_FRAME_S32_LE:
 		cd->data_shift = 0;
 		cd->polyphase_func = src_polyphase_stage_cir;
+#if SRC_MULTICH
+		if (sourceb->stream.channels > 2)
+			cd->polyphase_func = src_polyphase_stage_cir_multich;
+#endif
 		break;
 #endif /* CONFIG_FORMAT_S32LE */
 	default:
@@ -1026,6 +1081,9 @@ static SHARED_DATA struct comp_driver_info comp_src_info = {
 
 UT_STATIC void sys_comp_src_init(void)
 {
+#if CONFIG_COMP_SRC_DESIGN
+	src_design_init();
+#endif
 	comp_register(platform_shared_get(&comp_src_info,
 					  sizeof(comp_src_info)));
 }
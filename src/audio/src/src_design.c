@@ -0,0 +1,608 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2022 Intel Corporation. All rights reserved.
+
+/* Polyphase filter design for SRC. This is a fixed point version of the
+ * design in tools/tune/src: the conversion ratio is factorized into two
+ * stages and the filter of each stage is a Kaiser windowed sinc with 70 dB
+ * stop band attenuation. The filter length is started from the Kaiser
+ * estimate and increased until the stop band requirement is met near the
+ * stop band edge.
+ */
+
+#include <sof/audio/format.h>
+#include <sof/audio/src/src.h>
+#include <sof/audio/src/src_config.h>
+#include <sof/audio/src/src_design.h>
+#include <sof/common.h>
+#include <sof/lib/alloc.h>
+#include <sof/lib/cache.h>
+#include <sof/lib/memory.h>
+#include <sof/list.h>
+#include <sof/math/numbers.h>
+#include <sof/math/trig.h>
+#include <sof/platform.h>
+#include <sof/spinlock.h>
+#include <sof/string.h>
+#include <ipc/topology.h>
+#include <errno.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#if CONFIG_COMP_SRC_DESIGN
+
+#if SRC_SHORT
+typedef int16_t src_coef_t;
+#define SRC_DESIGN_COEF_BITS	16
+#define SRC_DESIGN_ONE		16384
+#else
+typedef int32_t src_coef_t;
+#define SRC_DESIGN_COEF_BITS	32
+#define SRC_DESIGN_ONE		1073741824
+#endif
+
+/* Kaiser window for 70 dB stop band, beta = 0.1102 * (70 - 8.7) */
+#define SRC_DESIGN_BETA		Q_CONVERT_FLOAT(6.75526, 28)
+
+/* Kaiser order estimate (70 - 8) / (2.285 * 2 * pi) x 1e4 */
+#define SRC_DESIGN_ORDER_C	43184
+
+/* Stop band max. magnitude, -70 dB */
+#define SRC_DESIGN_RS		Q_CONVERT_FLOAT(3.1623e-4, 31)
+
+/* Gain in DC, -1 dB for one stage or -0.5 dB per stage for two stages */
+#define SRC_DESIGN_GAIN_1S	Q_CONVERT_FLOAT(0.8912509, 31)
+#define SRC_DESIGN_GAIN_2S	Q_CONVERT_FLOAT(0.9440609, 31)
+
+/* Max. peak coefficient value 32767/32768 is from src_get.m */
+#define SRC_DESIGN_PEAK_MAX	(INT32_MAX - (1 << 16) + 1)
+
+/* Stop band is checked from stop band edge to eight sidelobes above it */
+#define SRC_DESIGN_CHECK_POINTS	64
+#define SRC_DESIGN_CHECK_LOBES	8
+
+/* Filter of one tap for 1:1 conversion or for the unused second stage */
+static src_coef_t src_design_fir_one = SRC_DESIGN_ONE;
+static struct src_stage src_design_one = {
+	0, 0, 1, 1, 1, 1, 1, 0, -1, &src_design_fir_one };
+
+/* A designed stage in pool, the key is the stage parameters */
+struct src_design_stage {
+	struct list_item list;
+	int refs;
+	int l;
+	int m;
+	int pb;		/* Pass band end x 1e-4 of lower rate */
+	int sb;		/* Stop band start x 1e-4 of lower rate */
+	int32_t gain;	/* Q1.31 */
+	struct src_stage stage;
+};
+
+struct src_design_pool {
+	struct k_spinlock lock;	/* protects the list and reference counts */
+	struct list_item stages;
+};
+
+static SHARED_DATA struct src_design_pool design_pool;
+
+void src_design_init(void)
+{
+	k_spinlock_init(&design_pool.lock);
+	list_init(&design_pool.stages);
+}
+
+static uint32_t src_design_isqrt(uint64_t x)
+{
+	uint64_t bit = (uint64_t)1 << 62;
+	uint64_t y = 0;
+
+	while (bit > x)
+		bit >>= 2;
+
+	while (bit) {
+		if (x >= y + bit) {
+			x -= y + bit;
+			y = (y >> 1) + bit;
+		} else {
+			y >>= 1;
+		}
+		bit >>= 2;
+	}
+
+	return (uint32_t)y;
+}
+
+/* Factorize c to a * b where a is the divisor nearest to sqrt(c) */
+static int src_design_factor2(int c, int *a, int *b)
+{
+	int x = src_design_isqrt(c);
+	int a1 = 0;
+	int a2 = 0;
+	int t;
+
+	if (c - x * x > x)
+		x++;
+
+	for (t = x; t <= 2 * x; t++) {
+		if (c % t == 0) {
+			a1 = t;
+			break;
+		}
+	}
+
+	for (t = x; t > 0 && t >= x / 2; t--) {
+		if (c % t == 0) {
+			a2 = t;
+			break;
+		}
+	}
+
+	if (!a1 && !a2)
+		return -EINVAL;
+
+	*a = (a1 && (!a2 || a1 - x < x - a2)) ? a1 : a2;
+	*b = c / *a;
+	return 0;
+}
+
+/* Factorize the conversion fs2 / fs1 to two stages l1 / m1 * l2 / m2 as
+ * src_factor2_lm.m. The intermediate rate is the one of four candidates
+ * that is nearest above the lower of input and output rates.
+ */
+static int src_design_factor2_lm(int fs1, int fs2, int *l1, int *m1,
+				 int *l2, int *m2)
+{
+	int64_t fs3[4];
+	int64_t delta;
+	int64_t delta_min = INT64_MAX;
+	int fs_min = MIN(fs1, fs2);
+	int k = gcd(fs1, fs2);
+	int l = fs2 / k;
+	int m = fs1 / k;
+	int f[4][4];
+	int l01;
+	int l02;
+	int m01;
+	int m02;
+	int idx = -1;
+	int i;
+
+	if (src_design_factor2(l, &l01, &l02) < 0 ||
+	    src_design_factor2(m, &m01, &m02) < 0)
+		return -EINVAL;
+
+	/* Hand fixing for reuse of common 44.1 kHz family filters */
+	if (l == 147 && (m == 640 || m == 320 || m == 160)) {
+		l01 = 7;
+		m01 = 8;
+	} else if ((l == 160 || l == 320) && m == 147) {
+		l01 = 8;
+		m01 = 7;
+	} else if ((l == 4 && m == 3) || (l == 3 && m == 4)) {
+		l01 = l;
+		m01 = m;
+	}
+
+	l02 = l / l01;
+	m02 = m / m01;
+
+	f[0][0] = l01; f[0][1] = m01; f[0][2] = l02; f[0][3] = m02;
+	f[1][0] = l01; f[1][1] = m02; f[1][2] = l02; f[1][3] = m01;
+	f[2][0] = l02; f[2][1] = m01; f[2][2] = l01; f[2][3] = m02;
+	f[3][0] = l02; f[3][1] = m02; f[3][2] = l01; f[3][3] = m01;
+
+	/* Compare rates x m01 * m02 to keep them integers */
+	for (i = 0; i < 4; i++) {
+		fs3[i] = (int64_t)fs1 * f[i][0] * m / f[i][1];
+		delta = fs3[i] - (int64_t)fs_min * m;
+		if (delta >= 0 && delta < delta_min) {
+			delta_min = delta;
+			idx = i;
+		}
+	}
+
+	if (idx < 0)
+		return -EINVAL;
+
+	*l1 = f[idx][0];
+	*m1 = f[idx][1];
+	*l2 = f[idx][2];
+	*m2 = f[idx][3];
+
+	/* If 1st stage is 1:1 */
+	if (*l1 == 1 && *m1 == 1) {
+		*l1 = *l2;
+		*m1 = *m2;
+		*l2 = 1;
+		*m2 = 1;
+	}
+
+	return 0;
+}
+
+/* Find idm and odm to meet -idm * L + odm * M == 1 as src_find_l0m0.m */
+static int src_design_l0m0(int l, int m, int *idm, int *odm)
+{
+	int lt;
+
+	if (m == 1) {
+		*idm = 0;
+		*odm = 1;
+		return 0;
+	}
+
+	if (l == 1) {
+		*idm = 1;
+		*odm = 0;
+		return 0;
+	}
+
+	for (lt = 1; lt <= 4 * l; lt++) {
+		if ((1 + lt * l) % m == 0) {
+			*idm = lt;
+			*odm = (1 + lt * l) / m;
+			return 0;
+		}
+	}
+
+	return -EINVAL;
+}
+
+/* Modified Bessel function of first kind and order zero, Q4.28 in and
+ * Q8.24 out.
+ */
+static int64_t src_design_i0(int32_t x)
+{
+	int64_t y = Q_MULTSR_32X32((int64_t)x, x, 28, 28, 24) >> 2;
+	int64_t t = 1 << 24;
+	int64_t s = t;
+	int k;
+
+	for (k = 1; k < 32 && t > 0; k++) {
+		t = ((t * y) >> 24) / (k * k);
+		s += t;
+	}
+
+	return s;
+}
+
+/* Kaiser windowed sinc prototype filter of length n with cutoff at r32
+ * (Q0.32 fraction of sample rate), Q1.31 output. Returns the DC gain.
+ */
+static int64_t src_design_prototype(int32_t *b, int n, uint32_t r32)
+{
+	int64_t i0_beta = src_design_i0(SRC_DESIGN_BETA);
+	int64_t sum = 0;
+	int64_t h;
+	int64_t w;
+	uint32_t phase;
+	int32_t x;
+	int32_t s;
+	int m2;
+	int k;
+
+	/* The filter is symmetric, compute the first half and mirror */
+	for (k = 0; k < n / 2; k++) {
+		/* Twice the distance from the filter center, always odd
+		 * since the length is even.
+		 */
+		m2 = n - 1 - 2 * k;
+
+		/* sinc: 2 * sin(pi * r * m2) / (pi * m2) */
+		phase = (uint32_t)(((uint64_t)r32 * m2) >> 1);
+		s = sin_fixed_32b((int32_t)(((uint64_t)phase * PI_MUL2_Q4_28) >> 32));
+		h = ((int64_t)s << 29) / ((int64_t)PI_Q4_28 * m2);
+
+		/* Kaiser window I0(beta * sqrt(1 - (m2 / (n - 1))^2)) / I0(beta) */
+		x = (int64_t)SRC_DESIGN_BETA *
+			src_design_isqrt((uint64_t)((n - 1) * (n - 1) - m2 * m2) << 32) /
+			((int64_t)(n - 1) << 16);
+		w = (src_design_i0(x) << 31) / i0_beta;
+
+		b[k] = (int32_t)((h * w) >> 31);
+		b[n - 1 - k] = b[k];
+		sum += 2 * (int64_t)b[k];
+	}
+
+	return sum;
+}
+
+/* Check that the prototype filter magnitude is below the stop band
+ * requirement from u_sb (Q0.32 fraction of sample rate) to several
+ * sidelobe widths above it. The amplitude of a symmetric filter is
+ * 2 * sum(b(k) * cos(w * (k - (n - 1) / 2))), the cosines are got with a
+ * rotating Q1.30 phasor from w / 2 in steps of w. The headroom bit keeps
+ * the rounding drift of the phasor magnitude from wrapping around.
+ */
+static bool src_design_stopband_ok(int32_t *b, int n, int64_t dc, uint32_t u_sb)
+{
+	int64_t limit = (dc * SRC_DESIGN_RS) >> 31;
+	int64_t a;
+	uint64_t u_end = (uint64_t)u_sb + ((uint64_t)SRC_DESIGN_CHECK_LOBES << 32) / n;
+	uint32_t u;
+	int32_t c_re;
+	int32_t c_im;
+	int32_t z_re;
+	int32_t z_im;
+	int32_t tmp;
+	int32_t w;
+	int i;
+	int j;
+
+	if (u_end > (uint64_t)1 << 31)
+		u_end = (uint64_t)1 << 31;
+
+	for (i = 0; i < SRC_DESIGN_CHECK_POINTS; i++) {
+		u = u_sb + (uint32_t)((u_end - u_sb) * i / (SRC_DESIGN_CHECK_POINTS - 1));
+		w = (int32_t)(((uint64_t)u * PI_MUL2_Q4_28) >> 32);
+		c_re = cos_fixed_32b(w);
+		c_im = sin_fixed_32b(w);
+		z_re = cos_fixed_32b(w >> 1) >> 1;
+		z_im = sin_fixed_32b(w >> 1) >> 1;
+		a = 0;
+		for (j = n / 2 - 1; j >= 0; j--) {
+			a += ((int64_t)b[j] * z_re) >> 30;
+			tmp = Q_MULTSR_32X32((int64_t)z_re, c_re, 30, 31, 30) -
+				Q_MULTSR_32X32((int64_t)z_im, c_im, 30, 31, 30);
+			z_im = Q_MULTSR_32X32((int64_t)z_re, c_im, 30, 31, 30) +
+				Q_MULTSR_32X32((int64_t)z_im, c_re, 30, 31, 30);
+			z_re = tmp;
+		}
+
+		if (2 * a > limit || 2 * a < -limit)
+			return false;
+	}
+
+	return true;
+}
+
+/* Design a stage and return it in a new pool item */
+static struct src_design_stage *src_design_stage_new(int l, int m, int pb, int sb,
+						     int32_t gain)
+{
+	struct src_design_stage *ds;
+	src_coef_t *coefs;
+	int32_t *b;
+	int64_t dc;
+	int64_t g;
+	int64_t peak = 0;
+	int64_t v;
+	uint32_t r32;
+	uint32_t u_sb;
+	int lm = MAX(l, m);
+	int inc = 4 * l;
+	int idm;
+	int odm;
+	int shift;
+	int n_max;
+	int n;
+	int i;
+	int j;
+
+	if (lm > SRC_DESIGN_MAX_LM || src_design_l0m0(l, m, &idm, &odm) < 0)
+		return NULL;
+
+	/* The rates are normalized to interpolated rate L * fs1 where the
+	 * lower of stage rates is 1 / max(L, M). The cutoff is at middle of
+	 * transition band.
+	 */
+	r32 = ((uint64_t)(pb + sb) << 31) / (10000 * lm);
+	u_sb = ((uint64_t)sb << 32) / (10000 * lm);
+
+	/* Kaiser estimate for length, rounded up to multiple of 4 * L for
+	 * equal length subfilters that are multiple of four.
+	 */
+	n = (SRC_DESIGN_ORDER_C * lm + sb - pb - 1) / (sb - pb);
+	n = ((n + inc - 1) / inc) * inc;
+	if (n > SRC_DESIGN_MAX_FILTER_LENGTH)
+		return NULL;
+
+	n_max = MIN(n + (SRC_DESIGN_STOPBAND_ITER_MAX - 1) * inc,
+		    SRC_DESIGN_MAX_FILTER_LENGTH);
+	b = rballoc(0, SOF_MEM_CAPS_RAM, n_max * sizeof(int32_t));
+	if (!b)
+		return NULL;
+
+	for (;;) {
+		dc = src_design_prototype(b, n, r32);
+		if (src_design_stopband_ok(b, n, dc, u_sb) || n + inc > n_max)
+			break;
+
+		n += inc;
+	}
+
+	ds = rzalloc(SOF_MEM_ZONE_RUNTIME_SHARED, 0, SOF_MEM_CAPS_RAM, sizeof(*ds));
+	coefs = rballoc(0, SOF_MEM_CAPS_RAM, n * sizeof(src_coef_t));
+	if (!ds || !coefs) {
+		rfree(ds);
+		rfree(coefs);
+		rfree(b);
+		return NULL;
+	}
+
+	/* Scale for L times DC gain with the stage gain, Q8.24 */
+	g = (((int64_t)gain * l) << 24) / dc;
+	for (i = 0; i < n; i++) {
+		v = ((int64_t)b[i] * g) >> 24;
+		peak = MAX(peak, ABS(v));
+	}
+
+	/* Left shifts to normalize the peak coefficient */
+	shift = 0;
+	while (peak << (shift + 1) <= SRC_DESIGN_PEAK_MAX)
+		shift++;
+
+	while (shift > -8 && peak >> -shift > SRC_DESIGN_PEAK_MAX)
+		shift--;
+
+	/* Quantize and reorder to subfilters */
+	for (i = 0; i < l; i++) {
+		for (j = 0; j < n / l; j++) {
+			v = (int64_t)b[i + j * l] * g;
+			coefs[i * (n / l) + j] = (src_coef_t)Q_SHIFT_RND(v, 24 - shift + 32 -
+									 SRC_DESIGN_COEF_BITS, 0);
+		}
+	}
+
+	rfree(b);
+	dcache_writeback_region(coefs, n * sizeof(src_coef_t));
+
+	ds->l = l;
+	ds->m = m;
+	ds->pb = pb;
+	ds->sb = sb;
+	ds->gain = gain;
+	ds->refs = 1;
+	memcpy_s(&ds->stage, sizeof(ds->stage),
+		 &(struct src_stage){ idm, odm, l, n / l, n, m, l, 0, shift, coefs },
+		 sizeof(ds->stage));
+
+	return ds;
+}
+
+static struct src_design_stage *src_design_find(int l, int m, int pb, int sb, int32_t gain)
+{
+	struct src_design_stage *ds;
+	struct list_item *item;
+
+	list_for_item(item, &design_pool.stages) {
+		ds = container_of(item, struct src_design_stage, list);
+		if (ds->l == l && ds->m == m && ds->pb == pb && ds->sb == sb &&
+		    ds->gain == gain) {
+			ds->refs++;
+			return ds;
+		}
+	}
+
+	return NULL;
+}
+
+static void src_design_free(struct src_design_stage *ds)
+{
+	rfree((void *)ds->stage.coefs);
+	rfree(ds);
+}
+
+/* Get a stage from pool or design it. The design is done without the lock
+ * so if another core added the same stage meanwhile it is used instead.
+ */
+static struct src_stage *src_design_stage_get(int l, int m, int pb, int sb, int32_t gain)
+{
+	struct src_design_stage *ds;
+	struct src_design_stage *ds_new;
+	k_spinlock_key_t key;
+
+	key = k_spin_lock(&design_pool.lock);
+	ds = src_design_find(l, m, pb, sb, gain);
+	k_spin_unlock(&design_pool.lock, key);
+
+	if (ds) {
+		dcache_invalidate_region((void *)ds->stage.coefs,
+					 ds->stage.filter_length * sizeof(src_coef_t));
+		return &ds->stage;
+	}
+
+	ds_new = src_design_stage_new(l, m, pb, sb, gain);
+	if (!ds_new)
+		return NULL;
+
+	key = k_spin_lock(&design_pool.lock);
+	ds = src_design_find(l, m, pb, sb, gain);
+	if (!ds)
+		list_item_append(&ds_new->list, &design_pool.stages);
+	k_spin_unlock(&design_pool.lock, key);
+
+	if (ds) {
+		src_design_free(ds_new);
+		dcache_invalidate_region((void *)ds->stage.coefs,
+					 ds->stage.filter_length * sizeof(src_coef_t));
+		return &ds->stage;
+	}
+
+	return &ds_new->stage;
+}
+
+void src_design_put(struct src_stage *stage)
+{
+	struct src_design_stage *ds;
+	k_spinlock_key_t key;
+	int refs;
+
+	if (!stage || stage == &src_design_one)
+		return;
+
+	ds = container_of(stage, struct src_design_stage, stage);
+	key = k_spin_lock(&design_pool.lock);
+	refs = --ds->refs;
+	if (!refs)
+		list_item_del(&ds->list);
+	k_spin_unlock(&design_pool.lock, key);
+
+	if (!refs)
+		src_design_free(ds);
+}
+
+/* Pass band end for a stage as x 1e-4 of the lower stage rate. The pass
+ * band of both stages is the pass band of the conversion.
+ */
+static int src_design_pb(int fs_in, int fs_out, int fs1, int fs2)
+{
+	int fs_min = MIN(fs_in, fs_out);
+	int64_t f_pb;
+
+	/* Pass band in Hz x 1e4 */
+	if (fs_min > SRC_DESIGN_PB_HIGH_FS)
+		f_pb = (int64_t)SRC_DESIGN_PB_HIGH_HZ * 10000;
+	else
+		f_pb = (int64_t)fs_min * SRC_DESIGN_PB_HZ * 10000 / SRC_DESIGN_PB_FS;
+
+	fs_min = MIN(fs1, fs2);
+	return (f_pb + fs_min / 2) / fs_min;
+}
+
+int src_design_get(struct src_stage **stage1, struct src_stage **stage2,
+		   int fs_in, int fs_out)
+{
+	int32_t gain;
+	int fs3;
+	int l1;
+	int m1;
+	int l2;
+	int m2;
+
+	if (fs_in <= 0 || fs_out <= 0)
+		return -EINVAL;
+
+	if (fs_in == fs_out) {
+		*stage1 = &src_design_one;
+		*stage2 = &src_design_one;
+		return 0;
+	}
+
+	if (src_design_factor2_lm(fs_in, fs_out, &l1, &m1, &l2, &m2) < 0)
+		return -EINVAL;
+
+	fs3 = (int64_t)fs_in * l1 / m1;
+	gain = (l2 == 1 && m2 == 1) ? SRC_DESIGN_GAIN_1S : SRC_DESIGN_GAIN_2S;
+	*stage1 = src_design_stage_get(l1, m1, src_design_pb(fs_in, fs_out, fs_in, fs3),
+				       SRC_DESIGN_SB, gain);
+	if (!*stage1)
+		return -ENOMEM;
+
+	if (fs3 == fs_out) {
+		*stage2 = &src_design_one;
+		return 0;
+	}
+
+	*stage2 = src_design_stage_get(l2, m2, src_design_pb(fs_in, fs_out, fs3, fs_out),
+				       SRC_DESIGN_SB, gain);
+	if (!*stage2) {
+		src_design_put(*stage1);
+		*stage1 = NULL;
+		return -ENOMEM;
+	}
+
+	return 0;
+}
+
+#endif /* CONFIG_COMP_SRC_DESIGN */
@@ -222,8 +222,130 @@ static inline void fir_filter_generic(int32_t *rp, const void *cp, int32_t *wp0,
 
 #endif /* 32bit coefficients version */
 
+#if SRC_MULTICH
+/* Number of channels to filter with one pass of coefficients */
+#define SRC_MULTICH_GROUP	4
+
+/*
+ * Computes the FIR sub-filter for all channels with each coefficient
+ * loaded once for a group of four channels. The frame starts from the
+ * last channel sample and the data is read for every tap from the
+ * channels of a group with stride of channels count.
+ */
+static inline void fir_filter_multich(int32_t *rp, const void *cp, int32_t *wp0,
+				      int32_t *fir_start, int32_t *fir_end,
+				      const int fir_delay_length,
+				      const int taps_x_nch, const int shift,
+				      const int nch)
+{
+	int64_t y0;
+	int64_t y1;
+	int64_t y2;
+	int64_t y3;
+	int32_t *data;
+	int32_t c;
+	int i;
+	int j;
+	int n;
+	int n1;
+	int32_t *d = rp - nch + 1; /* Frame start */
+	int32_t *wp = wp0 + nch - 1; /* Output for the last channel */
+	const int taps = taps_x_nch / nch;
+	const int words = fir_end - d; /* Words until wrap */
+#if SRC_SHORT
+	const int16_t *coef;
+	const int qshift = 15 + shift; /* Q2.46 -> Q2.31 */
+#else
+	const int32_t *coef;
+	const int qshift = 23 + shift; /* Qx.54 -> Qx.31 */
+#endif
+	const int32_t rnd = 1 << (qshift - 1); /* Half LSB */
+
+	/* Taps before delay line wrap, wrap happens only between frames */
+	n1 = (taps_x_nch < words) ? taps : words / nch;
+
+	for (j = 0; j < nch; j += n) {
+		n = nch - j;
+		if (n > SRC_MULTICH_GROUP)
+			n = SRC_MULTICH_GROUP;
+
+		/* Initialize to half LSB for rounding, prepare for FIR core */
+		y0 = rnd;
+		y1 = rnd;
+		y2 = rnd;
+		y3 = rnd;
+		data = d + j;
+#if SRC_SHORT
+		coef = (const int16_t *)cp;
+#else
+		coef = (const int32_t *)cp;
+#endif
+
+		/* Groups of four and two channels share the coefficient load,
+		 * the remaining odd channel is filtered alone.
+		 */
+		switch (n) {
+		case SRC_MULTICH_GROUP:
+			for (i = 0; i < taps; i++) {
+				if (i == n1)
+					data -= fir_delay_length;
+#if SRC_SHORT
+				c = *coef++;
+#else
+				c = *coef++ >> 8;
+#endif
+				y0 += (int64_t)c * data[0];
+				y1 += (int64_t)c * data[1];
+				y2 += (int64_t)c * data[2];
+				y3 += (int64_t)c * data[3];
+				data += nch;
+			}
+			break;
+		case 3:
+		case 2:
+			n = 2;
+			for (i = 0; i < taps; i++) {
+				if (i == n1)
+					data -= fir_delay_length;
+#if SRC_SHORT
+				c = *coef++;
+#else
+				c = *coef++ >> 8;
+#endif
+				y0 += (int64_t)c * data[0];
+				y1 += (int64_t)c * data[1];
+				data += nch;
+			}
+			break;
+		default:
+			for (i = 0; i < taps; i++) {
+				if (i == n1)
+					data -= fir_delay_length;
+#if SRC_SHORT
+				c = *coef++;
+#else
+				c = *coef++ >> 8;
+#endif
+				y0 += (int64_t)c * data[0];
+				data += nch;
+			}
+			break;
+		}
+
+		/* The frame is in reverse channels order */
+		*wp-- = sat_int32(y0 >> qshift);
+		if (n > 1)
+			*wp-- = sat_int32(y1 >> qshift);
+		if (n > 2) {
+			*wp-- = sat_int32(y2 >> qshift);
+			*wp-- = sat_int32(y3 >> qshift);
+		}
+	}
+}
+#endif /* SRC_MULTICH */
+
 #if CONFIG_FORMAT_S24LE || CONFIG_FORMAT_S32LE
-void src_polyphase_stage_cir(struct src_stage_prm *s)
+static inline void src_stage_cir(struct src_stage_prm *s, const int multich)
 {
 	int i;
 	int n;
@@ -289,9 +411,16 @@ void src_polyphase_stage_cir(struct src_stage_prm *s)
 		src_inc_wrap(&rp, fir_end, fir_size);
 		wp = fir->out_rp;
 		for (i = 0; i < cfg->num_of_subfilters; i++) {
-			fir_filter_generic(rp, cp, wp,
-					   fir_delay, fir_end, fir_length,
-					   taps_x_nch, cfg->shift, nch);
+#if SRC_MULTICH
+			if (multich)
+				fir_filter_multich(rp, cp, wp,
+						   fir_delay, fir_end, fir_length,
+						   taps_x_nch, cfg->shift, nch);
+			else
+#endif
+				fir_filter_generic(rp, cp, wp,
+						   fir_delay, fir_end, fir_length,
+						   taps_x_nch, cfg->shift, nch);
 			wp += nch_x_odm;
 			cp = (char *)cp + subfilter_size;
 			src_inc_wrap(&wp, out_delay_end, out_size);
@@ -321,10 +450,22 @@ void src_polyphase_stage_cir(struct src_stage_prm *s)
 	s->x_rptr = x_rptr;
 	s->y_wptr = y_wptr;
 }
+
+void src_polyphase_stage_cir(struct src_stage_prm *s)
+{
+	src_stage_cir(s, 0);
+}
+
+#if SRC_MULTICH
+void src_polyphase_stage_cir_multich(struct src_stage_prm *s)
+{
+	src_stage_cir(s, 1);
+}
+#endif /* SRC_MULTICH */
 #endif /* CONFIG_FORMAT_S24LE || CONFIG_FORMAT_S32LE */
 
 #if CONFIG_FORMAT_S16LE
-void src_polyphase_stage_cir_s16(struct src_stage_prm *s)
+static inline void src_stage_cir_s16(struct src_stage_prm *s, const int multich)
 {
 	int i;
 	int n;
@@ -390,9 +531,16 @@ void src_polyphase_stage_cir_s16(struct src_stage_prm *s)
 		src_inc_wrap(&rp, fir_end, fir_size);
 		wp = fir->out_rp;
 		for (i = 0; i < cfg->num_of_subfilters; i++) {
-			fir_filter_generic(rp, cp, wp,
-					   fir_delay, fir_end, fir_length,
-					   taps_x_nch, cfg->shift, nch);
+#if SRC_MULTICH
+			if (multich)
+				fir_filter_multich(rp, cp, wp,
+						   fir_delay, fir_end, fir_length,
+						   taps_x_nch, cfg->shift, nch);
+			else
+#endif
+				fir_filter_generic(rp, cp, wp,
+						   fir_delay, fir_end, fir_length,
+						   taps_x_nch, cfg->shift, nch);
 			wp += nch_x_odm;
 			cp = (char *)cp + subfilter_size;
 			src_inc_wrap(&wp, out_delay_end, out_size);
@@ -422,6 +570,18 @@ void src_polyphase_stage_cir_s16(struct src_stage_prm *s)
 	s->x_rptr = x_rptr;
 	s->y_wptr = y_wptr;
 }
+
+void src_polyphase_stage_cir_s16(struct src_stage_prm *s)
+{
+	src_stage_cir_s16(s, 0);
+}
+
+#if SRC_MULTICH
+void src_polyphase_stage_cir_multich_s16(struct src_stage_prm *s)
+{
+	src_stage_cir_s16(s, 1);
+}
+#endif /* SRC_MULTICH */
 #endif /* CONFIG_FORMAT_S16LE */
 
 #endif
@@ -299,8 +299,267 @@ static inline void fir_filter(ae_f32 *rp, const void *cp, ae_f32 *wp0,
 
 #endif /* 32bit coefficients version */
 
+#if SRC_MULTICH
+
+#if SRC_SHORT /* 16 bit coefficients version */
+
+static inline void fir_filter_multich(ae_f32 *rp, const void *cp, ae_f32 *wp0,
+				      const int taps_div_4, const int shift,
+				      const int nch)
+{
+	/* This function uses
+	 * 13x 64 bit registers
+	 * 4x integers
+	 * 5x address pointers,
+	 */
+	ae_f64 a0;
+	ae_f64 a1;
+	ae_f64 a2;
+	ae_f64 a3;
+	ae_valign u;
+	ae_f16x4 coef4;
+	ae_f32x2 d0;
+	ae_f32x2 d1;
+	ae_f32x2 d2;
+	ae_f32x2 d3;
+	ae_f32x2 data2;
+	ae_f16x4 *coefp;
+	ae_f32x2 *dp0;
+	ae_f32x2 *dp1;
+	int i;
+	int j;
+	ae_f32 *wp = wp0 + nch - 1;
+	const int inc = nch * sizeof(int32_t);
+
+	/* The two samples loads need even channels count */
+	if (nch & 1) {
+		fir_filter(rp, cp, wp0, taps_div_4, shift, nch);
+		return;
+	}
+
+	/* Process channels in groups of four and two from the frame start
+	 * where is the last channel. Every four coefficients are loaded
+	 * once for the group.
+	 */
+	for (j = 0; j < nch - 2; j += 4) {
+		dp0 = (ae_f32x2 *)(rp - nch + 1 + j);
+		dp1 = dp0 + 1;
+		coefp = (ae_f16x4 *)cp;
+		u = AE_LA64_PP(coefp);
+		a0 = AE_ZERO64();
+		a1 = AE_ZERO64();
+		a2 = AE_ZERO64();
+		a3 = AE_ZERO64();
+		for (i = 0; i < taps_div_4; i++) {
+			/* Load four coefficients */
+			AE_LA16X4_IP(coef4, u, coefp);
+
+			/* Load four channels samples for two taps */
+			AE_L32X2_XC(d0, dp0, inc); /* c0, c1 */
+			AE_L32X2_XC(d1, dp1, inc); /* c2, c3 */
+			AE_L32X2_XC(d2, dp0, inc);
+			AE_L32X2_XC(d3, dp1, inc);
+
+			/* Accumulate data2_h * coef4_3 + data2_l * coef4_2 */
+			data2 = AE_SEL32_HH(d0, d2);
+			AE_MULAAFD32X16_H3_L2(a0, data2, coef4);
+			data2 = AE_SEL32_LL(d0, d2);
+			AE_MULAAFD32X16_H3_L2(a1, data2, coef4);
+			data2 = AE_SEL32_HH(d1, d3);
+			AE_MULAAFD32X16_H3_L2(a2, data2, coef4);
+			data2 = AE_SEL32_LL(d1, d3);
+			AE_MULAAFD32X16_H3_L2(a3, data2, coef4);
+
+			/* Repeat for next two taps with
+			 * data2_h * coef4_1 + data2_l * coef4_0.
+			 */
+			AE_L32X2_XC(d0, dp0, inc);
+			AE_L32X2_XC(d1, dp1, inc);
+			AE_L32X2_XC(d2, dp0, inc);
+			AE_L32X2_XC(d3, dp1, inc);
+			data2 = AE_SEL32_HH(d0, d2);
+			AE_MULAAFD32X16_H1_L0(a0, data2, coef4);
+			data2 = AE_SEL32_LL(d0, d2);
+			AE_MULAAFD32X16_H1_L0(a1, data2, coef4);
+			data2 = AE_SEL32_HH(d1, d3);
+			AE_MULAAFD32X16_H1_L0(a2, data2, coef4);
+			data2 = AE_SEL32_LL(d1, d3);
+			AE_MULAAFD32X16_H1_L0(a3, data2, coef4);
+		}
+
+		/* Scale, round, and store in reverse channels order */
+		AE_S32_L_XP(AE_ROUND32F48SSYM(AE_SRAA64(a0, shift)), wp,
+			    -sizeof(int32_t));
+		AE_S32_L_XP(AE_ROUND32F48SSYM(AE_SRAA64(a1, shift)), wp,
+			    -sizeof(int32_t));
+		AE_S32_L_XP(AE_ROUND32F48SSYM(AE_SRAA64(a2, shift)), wp,
+			    -sizeof(int32_t));
+		AE_S32_L_XP(AE_ROUND32F48SSYM(AE_SRAA64(a3, shift)), wp,
+			    -sizeof(int32_t));
+	}
+
+	if (j == nch)
+		return;
+
+	/* Remaining two channels */
+	dp0 = (ae_f32x2 *)(rp - nch + 1 + j);
+	coefp = (ae_f16x4 *)cp;
+	u = AE_LA64_PP(coefp);
+	a0 = AE_ZERO64();
+	a1 = AE_ZERO64();
+	for (i = 0; i < taps_div_4; i++) {
+		AE_LA16X4_IP(coef4, u, coefp);
+		AE_L32X2_XC(d0, dp0, inc);
+		AE_L32X2_XC(d1, dp0, inc);
+		data2 = AE_SEL32_HH(d0, d1);
+		AE_MULAAFD32X16_H3_L2(a0, data2, coef4);
+		data2 = AE_SEL32_LL(d0, d1);
+		AE_MULAAFD32X16_H3_L2(a1, data2, coef4);
+		AE_L32X2_XC(d0, dp0, inc);
+		AE_L32X2_XC(d1, dp0, inc);
+		data2 = AE_SEL32_HH(d0, d1);
+		AE_MULAAFD32X16_H1_L0(a0, data2, coef4);
+		data2 = AE_SEL32_LL(d0, d1);
+		AE_MULAAFD32X16_H1_L0(a1, data2, coef4);
+	}
+
+	AE_S32_L_XP(AE_ROUND32F48SSYM(AE_SRAA64(a0, shift)), wp,
+		    -sizeof(int32_t));
+	AE_S32_L_XP(AE_ROUND32F48SSYM(AE_SRAA64(a1, shift)), wp,
+		    -sizeof(int32_t));
+}
+
+#else /* 32bit coefficients version */
+
+static inline void fir_filter_multich(ae_f32 *rp, const void *cp, ae_f32 *wp0,
+				      const int taps_div_4, const int shift,
+				      const int nch)
+{
+	/* This function uses
+	 * 10x 64 bit registers
+	 * 4x integers
+	 * 5x address pointers,
+	 */
+	ae_f64 a0;
+	ae_f64 a1;
+	ae_f64 a2;
+	ae_f64 a3;
+	ae_f24x2 data2 = AE_ZERO24();
+	ae_f24x2 coef2 = AE_ZERO24();
+	ae_f24x2 d0 = AE_ZERO24();
+	ae_f24x2 d1 = AE_ZERO24();
+	ae_f24x2 d2 = AE_ZERO24();
+	ae_f24x2 d3 = AE_ZERO24();
+	ae_f24x2 *coefp;
+	ae_f24x2 *dp0;
+	ae_f24x2 *dp1;
+	int i;
+	int j;
+	ae_f32 *wp = wp0 + nch - 1;
+	const int inc = nch * sizeof(int32_t);
+
+	/* The two samples loads need even channels count */
+	if (nch & 1) {
+		fir_filter(rp, cp, wp0, taps_div_4, shift, nch);
+		return;
+	}
+
+	/* Process channels in groups of four and two from the frame start
+	 * where is the last channel. Every two coefficients are loaded
+	 * once for the group.
+	 */
+	for (j = 0; j < nch - 2; j += 4) {
+		dp0 = (ae_f24x2 *)(rp - nch + 1 + j);
+		dp1 = dp0 + 1;
+		coefp = (ae_f24x2 *)cp;
+		a0 = AE_ZERO64();
+		a1 = AE_ZERO64();
+		a2 = AE_ZERO64();
+		a3 = AE_ZERO64();
+		for (i = 0; i < taps_div_4; i++) {
+			/* Load two coefficients */
+			AE_L32X2F24_IP(coef2, coefp, sizeof(ae_f24x2));
+
+			/* Load four channels samples for two taps */
+			AE_L32X2F24_XC(d0, dp0, inc); /* c0, c1 */
+			AE_L32X2F24_XC(d1, dp1, inc); /* c2, c3 */
+			AE_L32X2F24_XC(d2, dp0, inc);
+			AE_L32X2F24_XC(d3, dp1, inc);
+
+			/* Accumulate data2_h * coef2_h + data2_l * coef2_l */
+			data2 = AE_SELP24_HH(d0, d2);
+			AE_MULAAFP24S_HH_LL(a0, data2, coef2);
+			data2 = AE_SELP24_LL(d0, d2);
+			AE_MULAAFP24S_HH_LL(a1, data2, coef2);
+			data2 = AE_SELP24_HH(d1, d3);
+			AE_MULAAFP24S_HH_LL(a2, data2, coef2);
+			data2 = AE_SELP24_LL(d1, d3);
+			AE_MULAAFP24S_HH_LL(a3, data2, coef2);
+
+			/* Repeat for next two taps */
+			AE_L32X2F24_IP(coef2, coefp, sizeof(ae_f24x2));
+			AE_L32X2F24_XC(d0, dp0, inc);
+			AE_L32X2F24_XC(d1, dp1, inc);
+			AE_L32X2F24_XC(d2, dp0, inc);
+			AE_L32X2F24_XC(d3, dp1, inc);
+			data2 = AE_SELP24_HH(d0, d2);
+			AE_MULAAFP24S_HH_LL(a0, data2, coef2);
+			data2 = AE_SELP24_LL(d0, d2);
+			AE_MULAAFP24S_HH_LL(a1, data2, coef2);
+			data2 = AE_SELP24_HH(d1, d3);
+			AE_MULAAFP24S_HH_LL(a2, data2, coef2);
+			data2 = AE_SELP24_LL(d1, d3);
+			AE_MULAAFP24S_HH_LL(a3, data2, coef2);
+		}
+
+		/* Scale, round, and store in reverse channels order */
+		AE_S32_L_XP(AE_ROUND32F48SSYM(AE_SRAA64(a0, shift)), wp,
+			    -sizeof(int32_t));
+		AE_S32_L_XP(AE_ROUND32F48SSYM(AE_SRAA64(a1, shift)), wp,
+			    -sizeof(int32_t));
+		AE_S32_L_XP(AE_ROUND32F48SSYM(AE_SRAA64(a2, shift)), wp,
+			    -sizeof(int32_t));
+		AE_S32_L_XP(AE_ROUND32F48SSYM(AE_SRAA64(a3, shift)), wp,
+			    -sizeof(int32_t));
+	}
+
+	if (j == nch)
+		return;
+
+	/* Remaining two channels */
+	dp0 = (ae_f24x2 *)(rp - nch + 1 + j);
+	coefp = (ae_f24x2 *)cp;
+	a0 = AE_ZERO64();
+	a1 = AE_ZERO64();
+	for (i = 0; i < taps_div_4; i++) {
+		AE_L32X2F24_IP(coef2, coefp, sizeof(ae_f24x2));
+		AE_L32X2F24_XC(d0, dp0, inc);
+		AE_L32X2F24_XC(d1, dp0, inc);
+		data2 = AE_SELP24_HH(d0, d1);
+		AE_MULAAFP24S_HH_LL(a0, data2, coef2);
+		data2 = AE_SELP24_LL(d0, d1);
+		AE_MULAAFP24S_HH_LL(a1, data2, coef2);
+		AE_L32X2F24_IP(coef2, coefp, sizeof(ae_f24x2));
+		AE_L32X2F24_XC(d0, dp0, inc);
+		AE_L32X2F24_XC(d1, dp0, inc);
+		data2 = AE_SELP24_HH(d0, d1);
+		AE_MULAAFP24S_HH_LL(a0, data2, coef2);
+		data2 = AE_SELP24_LL(d0, d1);
+		AE_MULAAFP24S_HH_LL(a1, data2, coef2);
+	}
+
+	AE_S32_L_XP(AE_ROUND32F48SSYM(AE_SRAA64(a0, shift)), wp,
+		    -sizeof(int32_t));
+	AE_S32_L_XP(AE_ROUND32F48SSYM(AE_SRAA64(a1, shift)), wp,
+		    -sizeof(int32_t));
+}
+
+#endif /* 32bit coefficients version */
+
+#endif /* SRC_MULTICH */
+
 #if CONFIG_FORMAT_S24LE || CONFIG_FORMAT_S32LE
-void src_polyphase_stage_cir(struct src_stage_prm *s)
+static inline void src_stage_cir(struct src_stage_prm *s, const int multich)
 {
 	/* This function uses
 	 *  1x 64 bit registers
@@ -384,7 +643,14 @@ void src_polyphase_stage_cir(struct src_stage_prm *s)
 		 */
 		wp = (ae_f32 *)fir->out_rp;
 		for (i = 0; i < cfg->num_of_subfilters; i++) {
-			fir_filter(rp, cp, wp, taps_div_4, cfg->shift, nch);
+#if SRC_MULTICH
+			if (multich)
+				fir_filter_multich(rp, cp, wp, taps_div_4,
+						   cfg->shift, nch);
+			else
+#endif
+				fir_filter(rp, cp, wp, taps_div_4, cfg->shift,
+					   nch);
 			wp += nch_x_odm;
 			cp = (char *)cp + subfilter_size;
 			src_inc_wrap((int32_t **)&wp, out_delay_end, out_size);
@@ -422,10 +688,22 @@ void src_polyphase_stage_cir(struct src_stage_prm *s)
 	s->x_rptr = x_rptr;
 	s->y_wptr = y_wptr;
 }
+
+void src_polyphase_stage_cir(struct src_stage_prm *s)
+{
+	src_stage_cir(s, 0);
+}
+
+#if SRC_MULTICH
+void src_polyphase_stage_cir_multich(struct src_stage_prm *s)
+{
+	src_stage_cir(s, 1);
+}
+#endif /* SRC_MULTICH */
 #endif /* CONFIG_FORMAT_S24LE || CONFIG_FORMAT_S32LE */
 
 #if CONFIG_FORMAT_S16LE
-void src_polyphase_stage_cir_s16(struct src_stage_prm *s)
+static inline void src_stage_cir_s16(struct src_stage_prm *s, const int multich)
 {
 	/* This function uses
 	 *  2x 64 bit registers
@@ -511,7 +789,14 @@ void src_polyphase_stage_cir_s16(struct src_stage_prm *s)
 		 */
 		wp = (ae_f32 *)fir->out_rp;
 		for (i = 0; i < cfg->num_of_subfilters; i++) {
-			fir_filter(rp, cp, wp, taps_div_4, cfg->shift, nch);
+#if SRC_MULTICH
+			if (multich)
+				fir_filter_multich(rp, cp, wp, taps_div_4,
+						   cfg->shift, nch);
+			else
+#endif
+				fir_filter(rp, cp, wp, taps_div_4, cfg->shift,
+					   nch);
 			wp += nch_x_odm;
 			cp = (char *)cp + subfilter_size;
 			src_inc_wrap((int32_t **)&wp, out_delay_end, out_size);
@@ -554,6 +839,18 @@ void src_polyphase_stage_cir_s16(struct src_stage_prm *s)
 	s->x_rptr = x_rptr;
 	s->y_wptr = y_wptr;
 }
+
+void src_polyphase_stage_cir_s16(struct src_stage_prm *s)
+{
+	src_stage_cir_s16(s, 0);
+}
+
+#if SRC_MULTICH
+void src_polyphase_stage_cir_multich_s16(struct src_stage_prm *s)
+{
+	src_stage_cir_s16(s, 1);
+}
+#endif /* SRC_MULTICH */
 #endif /* CONFIG_FORMAT_S16LE */
 
 #endif
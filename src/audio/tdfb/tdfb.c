@@ -42,6 +42,7 @@
  */
 #define CTRL_INDEX_PROCESS		0	/* switch */
 #define CTRL_INDEX_DIRECTION		1	/* switch */
+#define CTRL_INDEX_GCC_PHAT		2	/* switch */
 #define CTRL_INDEX_AZIMUTH		0	/* enum */
 #define CTRL_INDEX_AZIMUTH_ESTIMATE	1	/* enum */
 #define CTRL_INDEX_FILTERBANK		0	/* bytes */
@@ -514,12 +515,25 @@ static int tdfb_cmd_switch_get(struct sof_ipc_ctrl_data *cdata, struct tdfb_comp
 {
 	int j;
 
+	uint32_t value;
+
 	/* Fail if wrong index in control, needed if several in same type */
-	if (cdata->index != CTRL_INDEX_PROCESS)
+	switch (cdata->index) {
+	case CTRL_INDEX_PROCESS:
+		value = cd->beam_on;
+		break;
+	case CTRL_INDEX_DIRECTION:
+		value = cd->direction_updates;
+		break;
+	case CTRL_INDEX_GCC_PHAT:
+		value = cd->direction_gcc_phat;
+		break;
+	default:
 		return -EINVAL;
+	}
 
 	for (j = 0; j < cdata->num_elems; j++)
-		cdata->chanv[j].value = cd->beam_on;
+		cdata->chanv[j].value = value;
 
 	return 0;
 }
@@ -613,6 +627,9 @@ static int tdfb_cmd_switch_set(struct sof_ipc_ctrl_data *cdata, struct tdfb_comp
 	case CTRL_INDEX_DIRECTION:
 		cd->direction_updates = cdata->chanv[0].value;
 		break;
+	case CTRL_INDEX_GCC_PHAT:
+		cd->direction_gcc_phat = cdata->chanv[0].value;
+		break;
 	default:
 		return -EINVAL;
 	}
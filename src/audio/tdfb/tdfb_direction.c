@@ -7,7 +7,9 @@
 #include <ipc/topology.h>
 #include <sof/audio/tdfb/tdfb_comp.h>
 #include <sof/lib/alloc.h>
+#include <sof/math/fft.h>
 #include <sof/math/iir_df2t.h>
+#include <sof/math/numbers.h>
 #include <sof/math/trig.h>
 #include <sof/math/sqrt.h>
 #include <user/eq.h>
@@ -39,6 +41,12 @@
 #define SLOW_AZ_C1		Q_CONVERT_FLOAT(0.02, 15)
 #define SLOW_AZ_C2		Q_CONVERT_FLOAT(0.98, 15)
 
+/* GCC-PHAT magnitude estimate max(|re|, |im|) * 15/16 + min(|re|, |im|) * 15/32,
+ * the max. error is about 6% that is enough for phase transform weighting.
+ */
+#define PHAT_ALPHA_Q5		30
+#define PHAT_BETA_Q5		15
+
 /* Threshold for notifying user space, no more often than every 200 ms */
 #define CONTROL_UPDATE_MIN_TIME	Q_CONVERT_FLOAT(0.2, 16)
 
@@ -172,6 +180,47 @@ static bool line_array_mode_check(struct tdfb_comp_data *cd)
 	return true;
 }
 
+static void direction_fft_free(struct tdfb_comp_data *cd)
+{
+	fft_plan_free(cd->direction.fft_plan);
+	rfree(cd->direction.fft_in);
+	cd->direction.fft_plan = NULL;
+	cd->direction.fft_in = NULL;
+	cd->direction.fft_out = NULL;
+	cd->direction.fft_ref = NULL;
+	cd->direction.fft_size = 0;
+}
+
+static int direction_fft_init(struct tdfb_comp_data *cd, int ch_count)
+{
+	struct icomplex32 *buf;
+	int n = 1;
+
+	direction_fft_free(cd);
+	while (n < cd->max_frames + cd->direction.max_lag)
+		n <<= 1;
+
+	if (n > FFT_SIZE_MAX || ch_count < 2)
+		return 0;
+
+	/* Input, output, and reference spectrum in one allocation */
+	buf = rzalloc(SOF_MEM_ZONE_RUNTIME, 0, SOF_MEM_CAPS_RAM, 3 * n * sizeof(*buf));
+	if (!buf)
+		return -ENOMEM;
+
+	cd->direction.fft_in = buf;
+	cd->direction.fft_out = buf + n;
+	cd->direction.fft_ref = buf + 2 * n;
+	cd->direction.fft_plan = fft_plan_new(cd->direction.fft_in, cd->direction.fft_out, n);
+	if (!cd->direction.fft_plan) {
+		direction_fft_free(cd);
+		return -ENOMEM;
+	}
+
+	cd->direction.fft_size = n;
+	return 0;
+}
+
 int tdfb_direction_init(struct tdfb_comp_data *cd, int32_t fs, int ch_count)
 {
 	struct sof_eq_iir_header_df2t *filt;
@@ -238,6 +287,13 @@ int tdfb_direction_init(struct tdfb_comp_data *cd, int32_t fs, int ch_count)
 	if (!cd->direction.r)
 		goto err_free_all;
 
+	/* GCC-PHAT is possible if the FFT can hold the max frames plus max lag
+	 * without circular correlation wrap. If not, only the time domain
+	 * estimate is used.
+	 */
+	if (direction_fft_init(cd, ch_count) < 0)
+		goto err_free_all;
+
 	/* Check for line array mode */
 	cd->direction.line_array = line_array_mode_check(cd);
 
@@ -247,6 +303,8 @@ int tdfb_direction_init(struct tdfb_comp_data *cd, int32_t fs, int ch_count)
 	return 0;
 
 err_free_all:
+	rfree(cd->direction.r);
+	cd->direction.r = NULL;
 	rfree(cd->direction.d);
 	cd->direction.d = NULL;
 
@@ -261,6 +319,7 @@ void tdfb_direction_free(struct tdfb_comp_data *cd)
 	rfree(cd->direction.df2t_delay);
 	rfree(cd->direction.d);
 	rfree(cd->direction.r);
+	direction_fft_free(cd);
 }
 
 /* Measure level of one channel */
@@ -357,6 +416,172 @@ static void time_differences(struct tdfb_comp_data *cd, int frames, int ch_count
 	tdfb_cinc_s16(&cd->direction.rp, cd->direction.d_end, cd->direction.d_size);
 }
 
+/* Copy one or two channels from xcorr delay line to FFT input as Q1.31 real
+ * and imaginary parts. Negative channel b leaves the imaginary part zero.
+ */
+static void gcc_phat_fft_input(struct tdfb_comp_data *cd, int frames, int ch_count,
+			       int a, int b)
+{
+	struct icomplex32 *in = cd->direction.fft_in;
+	int16_t *x = cd->direction.rp;
+	int i;
+
+	for (i = 0; i < frames; i++) {
+		in[i].real = (int32_t)x[a] << 16;
+		in[i].imag = b < 0 ? 0 : (int32_t)x[b] << 16;
+		x += ch_count;
+		tdfb_cinc_s16(&x, cd->direction.d_end, cd->direction.d_size);
+	}
+
+	/* Zero pad to avoid circular wrap of correlation */
+	for (; i < cd->direction.fft_size; i++) {
+		in[i].real = 0;
+		in[i].imag = 0;
+	}
+}
+
+/* Normalize spectrum to use full Q1.31 range for cross spectrum precision */
+static void gcc_phat_normalize(struct icomplex32 *x, int n)
+{
+	int32_t max;
+	int shift;
+	int k;
+
+	max = find_max_abs_int32((int32_t *)x, 2 * n);
+	if (!max)
+		return;
+
+	shift = norm_int32(max);
+	for (k = 0; k < n; k++) {
+		x[k].real <<= shift;
+		x[k].imag <<= shift;
+	}
+}
+
+/* Phase transform weighted cross spectrum X * Y^* / |X * Y^*|. The result
+ * magnitude is 1/(2N) in Q1.31 to keep the inverse FFT output in range. The
+ * weight needs only phase so the cross spectrum is reduced to 16 bits for
+ * cheaper 32 bit divides, the very weak bins become zero.
+ */
+static struct icomplex32 gcc_phat_weight(struct icomplex32 x, struct icomplex32 y, int len)
+{
+	struct icomplex32 g = { 0, 0 };
+	int32_t mag;
+	int32_t re;
+	int32_t im;
+	int32_t abs_re;
+	int32_t abs_im;
+
+	re = (((int64_t)x.real * y.real >> 1) + ((int64_t)x.imag * y.imag >> 1)) >> 48;
+	im = (((int64_t)x.imag * y.real >> 1) - ((int64_t)x.real * y.imag >> 1)) >> 48;
+	abs_re = ABS(re);
+	abs_im = ABS(im);
+	mag = abs_re > abs_im ?
+		abs_re * PHAT_ALPHA_Q5 + abs_im * PHAT_BETA_Q5 :
+		abs_im * PHAT_ALPHA_Q5 + abs_re * PHAT_BETA_Q5;
+	mag >>= 5;
+	if (!mag)
+		return g;
+
+	/* Q1.15 ratio to magnitude, then scale to 1/(2N) that is 2^(30 - len) */
+	g.real = (re << 15) / mag << (15 - len);
+	g.imag = (im << 15) / mag << (15 - len);
+	return g;
+}
+
+/* Find lag of max correlation in -max_lag .. +max_lag, negative lags are in
+ * the end of inverse FFT output. The second channel of the pair is in the
+ * imaginary part with inverted sign.
+ */
+static int gcc_phat_find_lag(struct icomplex32 *r, int n, int max_lag, bool second)
+{
+	int32_t v;
+	int32_t v_max = INT32_MIN;
+	int lag = 0;
+	int k;
+
+	for (k = -max_lag; k <= max_lag; k++) {
+		v = second ? -r[k & (n - 1)].imag : r[k & (n - 1)].real;
+		if (v > v_max) {
+			v_max = v;
+			lag = k;
+		}
+	}
+
+	return lag;
+}
+
+/* Generalized cross correlation with phase transform (GCC-PHAT). Two real
+ * channels are transformed with one complex FFT. The spectra are separated
+ * with A = (Z(k) + Z*(N - k)) / 2 and B = (Z(k) - Z*(N - k)) / 2j, weighted
+ * with the reference channel, and combined as Ga + j * Gb for one inverse
+ * FFT that outputs both real cross correlations.
+ */
+static void time_differences_gcc_phat(struct tdfb_comp_data *cd, int frames, int ch_count)
+{
+	struct tdfb_direction_data *dir = &cd->direction;
+	struct icomplex32 *in = dir->fft_in;
+	struct icomplex32 *out = dir->fft_out;
+	struct icomplex32 *ref = dir->fft_ref;
+	struct icomplex32 a;
+	struct icomplex32 b;
+	struct icomplex32 ga;
+	struct icomplex32 gb;
+	int32_t r1, i1, r2, i2;
+	int len = dir->fft_plan->len;
+	int n = dir->fft_size;
+	int c2;
+	int c;
+	int k;
+	int m;
+
+	/* Reference channel spectrum */
+	gcc_phat_fft_input(cd, frames, ch_count, 0, -1);
+	fft_execute(dir->fft_plan, false);
+	gcc_phat_normalize(out, n);
+	memcpy_s(ref, n * sizeof(*ref), out, n * sizeof(*out));
+
+	/* Other channels in pairs c, c + 1 */
+	for (c = 1; c < ch_count; c += 2) {
+		c2 = c + 1 < ch_count ? c + 1 : -1;
+		gcc_phat_fft_input(cd, frames, ch_count, c, c2);
+		fft_execute(dir->fft_plan, false);
+		gcc_phat_normalize(out, n);
+
+		/* Weighted spectra of real signals are conjugate symmetric, so
+		 * only bins 0 .. N/2 are computed and bins N/2 + 1 .. N - 1 are
+		 * mirrored.
+		 */
+		for (k = 0; k <= n / 2; k++) {
+			m = (n - k) & (n - 1);
+			r1 = out[k].real >> 1;
+			i1 = out[k].imag >> 1;
+			r2 = out[m].real >> 1;
+			i2 = out[m].imag >> 1;
+			a.real = r1 + r2;
+			a.imag = i1 - i2;
+			b.real = i1 + i2;
+			b.imag = r2 - r1;
+			ga = gcc_phat_weight(a, ref[k], len);
+			gb = gcc_phat_weight(b, ref[k], len);
+			in[k].real = ga.real - gb.imag;
+			in[k].imag = ga.imag + gb.real;
+			in[m].real = ga.real + gb.imag;
+			in[m].imag = gb.real - ga.imag;
+		}
+
+		fft_execute(dir->fft_plan, true);
+		dir->timediff[c - 1] = gcc_phat_find_lag(out, n, dir->max_lag, false) *
+			dir->unit_delay;
+		if (c2 > 0)
+			dir->timediff[c2 - 1] = gcc_phat_find_lag(out, n, dir->max_lag, true) *
+				dir->unit_delay;
+	}
+
+	dir->rp += frames * ch_count;
+	tdfb_cinc_s16(&dir->rp, dir->d_end, dir->d_size);
+}
+
 static int16_t distance_from_source(struct tdfb_comp_data *cd, int mic_n,
 				    int16_t x, int16_t y, int16_t z)
 {
@@ -540,7 +765,10 @@ void tdfb_direction_estimate(struct tdfb_comp_data *cd, int frames, int ch_count
 	}
 
 	/* Compute time differences of ch_count vs. reference channel 1 */
-	time_differences(cd, frames, ch_count);
+	if (cd->direction_gcc_phat && cd->direction.fft_plan)
+		time_differences_gcc_phat(cd, frames, ch_count);
+	else
+		time_differences(cd, frames, ch_count);
 
 	/* Determine direction angle */
 	iterate_source_angle(cd);
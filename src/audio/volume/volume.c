@@ -336,6 +336,38 @@ static void volume_ramp(struct comp_dev *dev)
 	}
 }
 
+#if CONFIG_COMP_VOLUME_SMOOTH_RAMP
+/**
+ * \brief Ramps volume changes over a block with interpolated gain.
+ * \param[in,out] dev Volume base component device.
+ * \param[in] frames Number of frames in block.
+ *
+ * The ramp is advanced to the end of the block and the gain increments
+ * per frame are set for the processing function to go from the current
+ * gain to the ramp gain at the end of the block.
+ */
+static void volume_ramp_interp(struct comp_dev *dev, uint32_t frames)
+{
+	struct vol_data *cd = comp_get_drvdata(dev);
+	int32_t delta;
+	int i;
+
+	for (i = 0; i < cd->channels; i++)
+		cd->ramp_vol[i] = cd->volume[i];
+
+	if (cd->vol_ramp_active)
+		cd->vol_ramp_elapsed_frames += frames;
+
+	volume_ramp(dev);
+
+	for (i = 0; i < cd->channels; i++) {
+		delta = cd->volume[i] - cd->ramp_vol[i];
+		cd->ramp_inc[i] = (delta << VOL_RAMP_FRAC_BITS) / (int32_t)frames;
+		cd->ramp_vol[i] <<= VOL_RAMP_FRAC_BITS;
+	}
+}
+#endif
+
 /**
  * \brief Reset state except controls.
  */
@@ -583,7 +615,7 @@ static struct comp_dev *volume_new(const struct comp_driver *drv,
 {
 	struct comp_dev *dev;
 	struct vol_data *cd;
-	const size_t vol_size = sizeof(int32_t) * SOF_IPC_MAX_CHANNELS * 4;
+	const size_t vol_size = sizeof(int32_t) * VOL_GAIN_BUF_SIZE;
 	int ret;
 
 	comp_cl_dbg(&comp_volume, "volume_new()");
@@ -1137,6 +1169,23 @@ static int volume_copy(struct comp_dev *dev)
 		source_bytes = frames * c.source_frame_bytes;
 		sink_bytes = frames * c.sink_frame_bytes;
 
+#if CONFIG_COMP_VOLUME_SMOOTH_RAMP
+		/* copy and scale volume, ramp the gain from current to the
+		 * ramp gain at end of block
+		 */
+		buffer_stream_invalidate(source, source_bytes);
+		if (cd->ramp_finished) {
+			cd->scale_vol(dev, &sink->stream, &source->stream, frames);
+		} else {
+			volume_ramp_interp(dev, frames);
+			cd->scale_vol_ramp(dev, &sink->stream, &source->stream, frames);
+		}
+		buffer_stream_writeback(sink, sink_bytes);
+
+		/* calculate new free and available */
+		comp_update_buffer_produce(sink, sink_bytes);
+		comp_update_buffer_consume(source, source_bytes);
+#else
 		/* copy and scale volume */
 		buffer_stream_invalidate(source, source_bytes);
 		cd->scale_vol(dev, &sink->stream, &source->stream, frames);
@@ -1151,6 +1200,7 @@ static int volume_copy(struct comp_dev *dev)
 
 		if (!cd->ramp_finished)
 			volume_ramp(dev);
+#endif
 
 		c.frames -= frames;
 	}
@@ -1229,6 +1279,16 @@ static int volume_prepare(struct comp_dev *dev)
 		goto err;
 	}
 
+#if CONFIG_COMP_VOLUME_SMOOTH_RAMP
+	cd->scale_vol_ramp = vol_get_ramp_processing_function(dev);
+	if (!cd->scale_vol_ramp) {
+		comp_err(dev, "volume_prepare(): invalid cd->scale_vol_ramp");
+
+		ret = -EINVAL;
+		goto err;
+	}
+#endif
+
 	cd->zc_get = vol_get_zc_function(dev);
 	if (!cd->zc_get) {
 		comp_err(dev, "volume_prepare(): invalid cd->zc_get");
@@ -1287,6 +1347,7 @@ static const struct comp_driver comp_volume = {
 	.type	= SOF_COMP_VOLUME,
 	.uid	= SOF_RT_UUID(volume_uuid),
 	.tctx	= &volume_tr,
+	.flags	= COMP_DRV_FLAG_INPLACE,
 	.ops	= {
 		.create		= volume_new,
 		.free		= volume_free,
@@ -1323,6 +1384,7 @@ static const struct comp_driver comp_gain = {
 	.type	= SOF_COMP_VOLUME,
 	.uid	= SOF_RT_UUID(gain_uuid),
 	.tctx	= &volume_tr,
+	.flags	= COMP_DRV_FLAG_INPLACE,
 	.ops	= {
 		.create		= volume_new,
 		.free		= volume_free,
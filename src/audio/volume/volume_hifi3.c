@@ -59,6 +59,37 @@ static inline void peak_vol_calc(struct vol_data *cd, ae_f32x2 out_sample, size_
 #endif
 }
 
+#if CONFIG_COMP_VOLUME_SMOOTH_RAMP
+/**
+ * \brief store interpolated volume gain and increment for xtensa multi-way
+ * intrinsic operations.
+ * \param[in,out] cd Volume component private data.
+ * \param[in] channels_count Number of channels to process.
+ * \param[in] frames Number of frames of gains, 2 or 4.
+ *
+ * Every pair of gains is followed by the pair of increments. Each gain in
+ * buffer is used for every frames'th frame so the increment is the per
+ * frame increment times frames.
+ */
+static void vol_store_ramp_gain(struct vol_data *cd, const int channels_count,
+				const int frames)
+{
+	int32_t *buf = cd->vol;
+	int32_t i;
+	int32_t j;
+	int32_t k;
+
+	for (j = 0; j < frames; j++) {
+		for (i = 0; i < channels_count; i++) {
+			k = j * channels_count + i;
+			k = ((k >> 1) << 2) + (k & 1);
+			buf[k] = cd->ramp_vol[i] + j * cd->ramp_inc[i];
+			buf[k + 2] = frames * cd->ramp_inc[i];
+		}
+	}
+}
+#endif
+
 #if CONFIG_FORMAT_S24LE
 /**
  * \brief HiFi3 enabled volume processing from 24/32 bit to 24/32 or 32 bit.
@@ -145,6 +176,98 @@ static void vol_s24_to_s24_s32(struct comp_dev *dev, struct audio_stream *sink,
 	/* update peak vol */
 	peak_vol_update(cd);
 }
+
+#if CONFIG_COMP_VOLUME_SMOOTH_RAMP
+/**
+ * \brief HiFi3 enabled volume processing from 24/32 bit to 24/32 or 32 bit
+ * with gain ramp.
+ * \param[in,out] dev Volume base component device.
+ * \param[in,out] sink Destination buffer.
+ * \param[in,out] source Source buffer.
+ * \param[in] frames Number of frames to process.
+ */
+static void vol_s24_to_s24_s32_ramp(struct comp_dev *dev, struct audio_stream *sink,
+				    const struct audio_stream *source,
+				    uint32_t frames)
+{
+	struct vol_data *cd = comp_get_drvdata(dev);
+	ae_f32x2 in_sample = AE_ZERO32();
+	ae_f32x2 out_sample;
+	ae_f32x2 volume;
+	ae_f32x2 ramp;
+	ae_f32x2 *buf;
+	ae_f32x2 *buf_end;
+	ae_valign inu;
+	ae_valign outu;
+	int i;
+	ae_f32x2 *in = (ae_f32x2 *)source->r_ptr;
+	ae_f32x2 *out = (ae_f32x2 *)sink->w_ptr;
+	ae_f32x2 *vol;
+	ae_f32x2 *vol_w;
+	const int channels_count = sink->channels;
+	const int inc = sizeof(ae_f32x2);
+	const int samples = channels_count * frames;
+
+	/* gains and increments for two frames */
+	vol_store_ramp_gain(cd, channels_count, 2);
+	buf = (ae_f32x2 *)cd->vol;
+	buf_end = (ae_f32x2 *)(cd->vol + channels_count * 4);
+	vol = buf;
+	vol_w = buf;
+
+	/* use alignment register to prime the memory to
+	 * avoid risk of buf not aligned to 64 bits.
+	 */
+	AE_LA32X2POS_PC(inu, in);
+	AE_SA64POS_FC(outu, out);
+
+	/* process two continuous sample data once */
+	for (i = 0; i < samples; i += 2) {
+		/* Set buf who stores the volume gain data as circular buffer */
+		AE_SETCBEGIN0(buf);
+		AE_SETCEND0(buf_end);
+
+		/* Load the volume value and increment, store next gain */
+		AE_L32X2_XC(volume, vol, inc);
+		AE_L32X2_XC(ramp, vol, inc);
+		AE_S32X2_XC(AE_ADD32(volume, ramp), vol_w, 2 * inc);
+		volume = AE_SRAI32(volume, VOL_RAMP_FRAC_BITS);
+
+		/* Set source as circular buffer */
+		vol_setup_circular(source);
+
+		/* Load the input sample */
+		AE_LA32X2_IC(in_sample, inu, in);
+
+		/* Multiply the input sample */
+#if COMP_VOLUME_Q8_16
+		out_sample = AE_MULFP32X2RS(AE_SLAI32S(volume, 7), AE_SLAI32(in_sample, 8));
+#elif COMP_VOLUME_Q1_23
+		out_sample = AE_MULFP32X2RS(volume, AE_SLAI32(in_sample, 8));
+#else
+#error "Need CONFIG_COMP_VOLUME_Qx_y"
+#endif
+
+		/* Shift for S24_LE */
+		out_sample = AE_SLAI32S(out_sample, 8);
+		out_sample = AE_SRAI32(out_sample, 8);
+
+		/* Set sink as circular buffer */
+		vol_setup_circular(sink);
+
+		/* Store the output sample */
+		AE_SA32X2_IC(out_sample, outu, out);
+
+		/* calc peak vol
+		 * TODO: fix channel value
+		 */
+		peak_vol_calc(cd, out_sample, 0);
+	}
+
+	/* update peak vol */
+	peak_vol_update(cd);
+}
+#endif /* CONFIG_COMP_VOLUME_SMOOTH_RAMP */
 #endif /* CONFIG_FORMAT_S24LE */
 
 #if CONFIG_FORMAT_S32LE
@@ -234,6 +357,99 @@ static void vol_s32_to_s24_s32(struct comp_dev *dev, struct audio_stream *sink,
 	/* update peak vol */
 	peak_vol_update(cd);
 }
+
+#if CONFIG_COMP_VOLUME_SMOOTH_RAMP
+/**
+ * \brief HiFi3 enabled volume processing from 32 bit to 24/32 or 32 bit
+ * with gain ramp.
+ * \param[in,out] dev Volume base component device.
+ * \param[in,out] sink Destination buffer.
+ * \param[in,out] source Source buffer.
+ * \param[in] frames Number of frames to process.
+ */
+static void vol_s32_to_s24_s32_ramp(struct comp_dev *dev, struct audio_stream *sink,
+				    const struct audio_stream *source,
+				    uint32_t frames)
+{
+	struct vol_data *cd = comp_get_drvdata(dev);
+	ae_f32x2 in_sample = AE_ZERO32();
+	ae_f32x2 out_sample;
+	ae_f32x2 volume;
+	ae_f32x2 ramp;
+	int i;
+	ae_f64 mult0;
+	ae_f64 mult1;
+	ae_f32x2 *buf;
+	ae_f32x2 *buf_end;
+	ae_f32x2 *vol;
+	ae_f32x2 *vol_w;
+	const int inc = sizeof(ae_f32x2);
+	const int channels_count = sink->channels;
+	const int samples = channels_count * frames;
+	ae_f32x2 *in = (ae_f32x2 *)source->r_ptr;
+	ae_f32x2 *out = (ae_f32x2 *)sink->w_ptr;
+	ae_valign inu;
+	ae_valign outu;
+
+	/* gains and increments for two frames */
+	vol_store_ramp_gain(cd, channels_count, 2);
+	buf = (ae_f32x2 *)cd->vol;
+	buf_end = (ae_f32x2 *)(cd->vol + channels_count * 4);
+	vol = buf;
+	vol_w = buf;
+
+	/* use alignment register to prime the memory to
+	 * avoid risk of buf not aligned to 64 bits.
+	 */
+	AE_LA32X2POS_PC(inu, in);
+	AE_SA64POS_FC(outu, out);
+
+	/* process two continuous sample data once */
+	for (i = 0; i < samples; i += 2) {
+		/* Set buf who stores the volume gain data as circular buffer */
+		AE_SETCBEGIN0(buf);
+		AE_SETCEND0(buf_end);
+
+		/* Load the volume value and increment, store next gain */
+		AE_L32X2_XC(volume, vol, inc);
+		AE_L32X2_XC(ramp, vol, inc);
+		AE_S32X2_XC(AE_ADD32(volume, ramp), vol_w, 2 * inc);
+		volume = AE_SRAI32(volume, VOL_RAMP_FRAC_BITS);
+
+		/* Set source as circular buffer */
+		vol_setup_circular(source);
+
+		/* Load the input sample */
+		AE_LA32X2_IC(in_sample, inu, in);
+
+#if COMP_VOLUME_Q8_16
+		mult0 = AE_MULF32S_HH(volume, in_sample);	/* Q8.16 x Q1.31 << 1 -> Q9.48 */
+		mult0 = AE_SRAI64(mult0, 1);			/* Q9.47 */
+		mult1 = AE_MULF32S_LL(volume, in_sample);
+		mult1 = AE_SRAI64(mult1, 1);
+		out_sample = AE_ROUND32X2F48SSYM(mult0, mult1);	/* Q9.47 -> Q1.31 */
+#elif COMP_VOLUME_Q1_23
+		mult0 = AE_MULF32S_HH(volume, in_sample);	/* Q1.23 x Q1.31 << 1 -> Q2.55 */
+		mult0 = AE_SRAI64(mult0, 8);			/* Q2.47 */
+		mult1 = AE_MULF32S_LL(volume, in_sample);
+		mult1 = AE_SRAI64(mult1, 8);
+		out_sample = AE_ROUND32X2F48SSYM(mult0, mult1);	/* Q2.47 -> Q1.31 */
+#else
+#error "Need CONFIG_COMP_VOLUME_Qx_y"
+#endif
+		vol_setup_circular(sink);
+		AE_SA32X2_IC(out_sample, outu, out);
+
+		/* calc peak vol
+		 * TODO: fix channel value
+		 */
+		peak_vol_calc(cd, out_sample, 0);
+	}
+
+	/* update peak vol */
+	peak_vol_update(cd);
+}
+#endif /* CONFIG_COMP_VOLUME_SMOOTH_RAMP */
 #endif /* CONFIG_FORMAT_S32LE */
 
 #if CONFIG_FORMAT_S16LE
@@ -330,6 +546,106 @@ static void vol_s16_to_s16(struct comp_dev *dev, struct audio_stream *sink,
 	/* update peak vol */
 	peak_vol_update(cd);
 }
+
+#if CONFIG_COMP_VOLUME_SMOOTH_RAMP
+/**
+ * \brief HiFi3 enabled volume processing from 16 bit to 16 bit with gain ramp.
+ * \param[in,out] dev Volume base component device.
+ * \param[in,out] sink Destination buffer.
+ * \param[in,out] source Source buffer.
+ * \param[in] frames Number of frames to process.
+ */
+static void vol_s16_to_s16_ramp(struct comp_dev *dev, struct audio_stream *sink,
+				const struct audio_stream *source, uint32_t frames)
+{
+	struct vol_data *cd = comp_get_drvdata(dev);
+	ae_f32x2 volume0, volume1;
+	ae_f32x2 ramp0, ramp1;
+	ae_f32x2 out_sample0, out_sample1;
+	ae_f16x4 in_sample = AE_ZERO16();
+	ae_f16x4 out_sample = AE_ZERO16();
+	int i;
+	ae_f32x2 *buf;
+	ae_f32x2 *buf_end;
+	ae_f32x2 *vol;
+	ae_f32x2 *vol_w;
+	ae_valign inu;
+	ae_valign outu;
+	ae_f16x4 *in = (ae_f16x4 *)source->r_ptr;
+	ae_f16x4 *out = (ae_f16x4 *)sink->w_ptr;
+	const int channels_count = sink->channels;
+	const int inc = sizeof(ae_f32x2);
+	const int samples = channels_count * frames;
+
+	/* gains and increments for four frames */
+	vol_store_ramp_gain(cd, channels_count, 4);
+	buf = (ae_f32x2 *)cd->vol;
+	buf_end = (ae_f32x2 *)(cd->vol + channels_count * 8);
+	vol = buf;
+	vol_w = buf;
+
+	/*
+	 * use alignment register to prime the volume memory to avoid
+	 * risk of buf not aligned to 8-byte
+	 */
+	AE_LA16X4POS_PC(inu, in);
+	AE_SA64POS_FC(outu, out);
+
+	for (i = 0; i < samples; i += 4) {
+		/* Set buf as circular buffer */
+		AE_SETCBEGIN0(buf);
+		AE_SETCEND0(buf_end);
+
+		/* load four volume gains and increments, store next gains */
+		AE_L32X2_XC(volume0, vol, inc);
+		AE_L32X2_XC(ramp0, vol, inc);
+		AE_L32X2_XC(volume1, vol, inc);
+		AE_L32X2_XC(ramp1, vol, inc);
+		AE_S32X2_XC(AE_ADD32(volume0, ramp0), vol_w, 2 * inc);
+		AE_S32X2_XC(AE_ADD32(volume1, ramp1), vol_w, 2 * inc);
+		volume0 = AE_SRAI32(volume0, VOL_RAMP_FRAC_BITS);
+		volume1 = AE_SRAI32(volume1, VOL_RAMP_FRAC_BITS);
+
+#if COMP_VOLUME_Q8_16
+		/* Q8.16 to Q9.23 */
+		volume0 = AE_SLAI32S(volume0, 7);
+		volume1 = AE_SLAI32S(volume1, 7);
+#elif COMP_VOLUME_Q1_23
+		/* No need to shift, Q1.23 is OK as such */
+#else
+#error "Need CONFIG_COMP_VOLUME_Qx_y"
+#endif
+
+		/* Set source as circular buffer */
+		vol_setup_circular(source);
+
+		/* Load the input sample */
+		AE_LA16X4_IC(in_sample, inu, in);
+
+		/* Multiply the input sample */
+		out_sample0 = AE_MULFP32X16X2RS_H(volume0, in_sample);
+		out_sample1 = AE_MULFP32X16X2RS_L(volume1, in_sample);
+
+		/* Q9.23 to Q1.31 */
+		out_sample0 = AE_SLAI32S(out_sample0, 8);
+		out_sample1 = AE_SLAI32S(out_sample1, 8);
+
+		/* Set sink as circular buffer */
+		vol_setup_circular(sink);
+
+		/* store the output */
+		out_sample = AE_ROUND16X4F32SSYM(out_sample0, out_sample1);
+		AE_SA16X4_IC(out_sample, outu, out);
+
+		/* calc peak vol
+		 * TODO: fix channel value
+		 */
+		peak_vol_calc(cd, out_sample0, 0);
+	}
+	/* update peak vol */
+	peak_vol_update(cd);
+}
+#endif /* CONFIG_COMP_VOLUME_SMOOTH_RAMP */
 #endif /* CONFIG_FORMAT_S16LE */
 
 const struct comp_func_map func_map[] = {
@@ -346,4 +662,20 @@ const struct comp_func_map func_map[] = {
 
 const size_t func_count = ARRAY_SIZE(func_map);
 
+#if CONFIG_COMP_VOLUME_SMOOTH_RAMP
+const struct comp_func_map ramp_func_map[] = {
+#if CONFIG_FORMAT_S16LE
+	{ SOF_IPC_FRAME_S16_LE, vol_s16_to_s16_ramp },
+#endif
+#if CONFIG_FORMAT_S24LE
+	{ SOF_IPC_FRAME_S24_4LE, vol_s24_to_s24_s32_ramp },
+#endif
+#if CONFIG_FORMAT_S32LE
+	{ SOF_IPC_FRAME_S32_LE, vol_s32_to_s24_s32_ramp },
+#endif
+};
+
+const size_t ramp_func_count = ARRAY_SIZE(ramp_func_map);
+#endif
+
 #endif
@@ -24,6 +24,21 @@
 #define PROBE_PURPOSE_INJECTION		0x2
 
 #define PROBE_EXTRACT_SYNC_WORD		0xBABEBEBA
+#define PROBE_EXTRACT_BATCH_SYNC_WORD	0xBABEBEBB
+
+/**
+ * \brief Definitions of shifts and masks for the probe point purpose
+ *
+ * The low byte is PROBE_PURPOSE_EXTRACTION or PROBE_PURPOSE_INJECTION. For
+ * extraction probes, the upper bits may request reduction of the data
+ * before it is sent, so more probe points fit in the DMA bandwidth:
+ * bits 11..8 - decimation factor minus 1, groups of frames are averaged
+ * bit 12 - integer samples are reduced to 16 bits
+ */
+#define PROBE_MASK_PURPOSE		MASK(7, 0)
+#define PROBE_SHIFT_DECIMATION		8
+#define PROBE_MASK_DECIMATION		MASK(11, 8)
+#define PROBE_EXTRACT_S16		BIT(12)
 
 /**
  * \brief Definitions of shifts and masks for format encoding in probe
@@ -96,6 +111,25 @@ struct probe_data_packet {
 	uint32_t data[];		/**< Audio data extracted from buffer */
 } __attribute__((packed, aligned(4)));
 
+/**
+ * Header for batched data packets sent via compressed PCM from extraction
+ * probes. Several buffer transactions of a probe point are coalesced into
+ * one packet. The sequence number counts packets of the probe point, so
+ * a gap shows packets dropped when the extraction DMA buffer was full.
+ */
+struct probe_batch_packet {
+	uint32_t sync_word;		/**< PROBE_EXTRACT_BATCH_SYNC_WORD */
+	uint32_t buffer_id;		/**< Buffer ID from which data was extracted */
+	uint32_t format;		/**< Encoded format of the data after reduction */
+	uint32_t timestamp_low;		/**< Low 32 bits of first transaction timestamp */
+	uint32_t timestamp_high;	/**< High 32 bits of first transaction timestamp */
+	uint32_t checksum;		/**< CRC32 of header */
+	uint32_t sequence;		/**< Packet number of the probe point */
+	uint32_t transactions;		/**< Number of coalesced buffer transactions */
+	uint32_t data_size_bytes;	/**< Size of following audio data */
+	uint32_t data[];		/**< Audio data padded to 32 bits */
+} __attribute__((packed, aligned(4)));
+
 /**
  * Description of probe dma
  */
@@ -109,7 +143,9 @@ struct probe_dma {
  */
 struct probe_point {
 	uint32_t buffer_id;	/**< ID of buffer to which probe is attached */
-	uint32_t purpose;	/**< PROBE_PURPOSE_EXTRACTION or PROBE_PURPOSE_INJECTION */
+	uint32_t purpose;	/**< PROBE_PURPOSE_EXTRACTION or PROBE_PURPOSE_INJECTION,
+				 *   with optional extraction reduction flags
+				 */
 	uint32_t stream_tag;	/**< Stream tag of DMA via which data will be provided for injection.
 				 *   For extraction purposes, stream tag is ignored when received,
 				 *   but returned actual extraction stream tag via INFO function.
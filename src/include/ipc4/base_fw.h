@@ -305,6 +305,16 @@ enum ipc4_basefw_params {
 	IPC4_SDW_OWNERSHIP = 31,
 };
 
+/* SOF specific Base FW parameters. The ids are above the range of the
+ * parameters of the IPC4 specification.
+ */
+enum ipc4_sof_basefw_params {
+	/* Use LARGE_CONFIG_GET to read the copy() cycles profile of the
+	 * module instances as struct ipc4_comp_profile_data.
+	 */
+	IPC4_SOF_COMP_PROFILE_DATA = 0xf0,
+};
+
 enum ipc4_fw_config_params {
 	/* Firmware version */
 	IPC4_FW_VERSION_FW_CFG                  = 0,
@@ -544,6 +554,42 @@ struct ipc4_global_perf_data {
 	struct ipc4_perf_data_item  perf_items[1];
 } __attribute__((packed, aligned(4)));
 
+/* Number of cycles histogram bins in struct ipc4_comp_profile_item */
+#define IPC4_COMP_PROFILE_BINS	16
+
+/*
+ * Copy cycles profile of a module instance reported by
+ * IPC4_SOF_COMP_PROFILE_DATA. Histogram bin width is 1/8 of
+ * budget_cycles, the last bin also collects all longer periods.
+ */
+struct ipc4_comp_profile_item {
+	struct ipc4_perf_data_item_mi mi;
+	/* Cycles available per processing period */
+	uint32_t budget_cycles;
+	/* Average, 99th percentile and peak cycles per period */
+	uint32_t avg_cycles;
+	uint32_t p99_cycles;
+	uint32_t peak_cycles;
+	/* Number of periods longer than budget_cycles */
+	uint32_t deadline_misses;
+	/* Number of processed frames */
+	uint64_t frames;
+	uint32_t hist[IPC4_COMP_PROFILE_BINS];
+} __attribute__((packed, aligned(4)));
+
+/*
+ * The profile of all module instances does not fit in one reply. The driver
+ * sets data_off_size of the following blocks to the index of the first item
+ * to read, total_item_count tells when all items were received.
+ */
+struct ipc4_comp_profile_data {
+	uint32_t total_item_count;
+	uint32_t first_item;
+	/* Specifies number of items in perf_items array */
+	uint32_t perf_item_count;
+	struct ipc4_comp_profile_item perf_items[];
+} __attribute__((packed, aligned(4)));
+
 enum ipc4_low_latency_interrupt_source {
 	IPC4_LOW_POWER_TIMER_INTERRUPT_SOURCE = 1,
 	IPC4_DMA_GATEWAY_INTERRUPT_SOURCE = 2
@@ -50,6 +50,7 @@ enum sof_ipc4_module_type {
 	SOF_IPC4_MOD_ENTER_MODULE_RESTORE	= 9,
 	SOF_IPC4_MOD_EXIT_MODULE_RESTORE	= 10,
 	SOF_IPC4_MOD_DELETE_INSTANCE		= 11,
+	SOF_IPC4_MOD_BATCH_CONFIG_SET		= 12,
 };
 
 /*
@@ -236,6 +237,25 @@ struct ipc4_module_large_config {
 	} data;
 } __attribute__((packed, aligned(4)));
 
+/*
+ * ModuleMsg::BATCH_CONFIG_SET sets the large config of several module
+ * instances with one message. The header is struct ipc4_module_large_config
+ * with module and instance id 0 and data_off_size set to the size of the
+ * mailbox payload. The payload is a list of items, each one followed by its
+ * data padded to 4 bytes. Nothing is applied if any item is invalid,
+ * otherwise all items are applied together at the end of a LL period and
+ * the reply carries the status of applying them.
+ */
+struct ipc4_module_batch_config_item {
+	uint16_t module_id;
+	uint16_t instance_id;
+	/**< param type : VENDOR_CONFIG_PARAM / GENERIC_CONFIG_PARAM */
+	uint32_t large_param_id;
+	/**< size of data in bytes, without padding */
+	uint32_t data_size;
+	uint32_t data[0];
+} __attribute__((packed, aligned(4)));
+
 struct ipc4_module_large_config_reply {
 	union {
 		uint32_t dat;
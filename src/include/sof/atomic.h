@@ -29,6 +29,18 @@ static inline void atomic_set(atomic_t *a, int32_t value)
 	arch_atomic_set(a, value);
 }
 
+/* read with acquire ordering, later accesses are not moved before it */
+static inline int32_t atomic_read_acquire(const atomic_t *a)
+{
+	return arch_atomic_read_acquire(a);
+}
+
+/* set with release ordering, earlier accesses are completed before it */
+static inline void atomic_set_release(atomic_t *a, int32_t value)
+{
+	arch_atomic_set_release(a, value);
+}
+
 static inline int32_t atomic_add(atomic_t *a, int32_t value)
 {
 	return arch_atomic_add(a, value);
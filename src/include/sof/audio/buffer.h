@@ -11,6 +11,7 @@
 #include <sof/audio/audio_stream.h>
 #include <sof/audio/pipeline.h>
 #include <sof/math/numbers.h>
+#include <sof/atomic.h>
 #include <sof/common.h>
 #include <sof/debug/panic.h>
 #include <sof/lib/alloc.h>
@@ -100,7 +101,43 @@ extern struct tr_ctx buffer_tr;
  * 3) buffer is safe to use cached pointer for access.
  * 4) release buffer cached pointer
  * 5) write back cached data and release lock using uncache pointer.
+ *
+ * Buffers between two cores can instead be used in lock-free single
+ * producer/single consumer mode. The producer owns the write position and
+ * the consumer owns the read position, both published with release stores
+ * in cache lines of their own. Acquiring such buffer takes no lock but
+ * refreshes the stream fields owned by the local end: w_ptr and free for
+ * the producer, r_ptr and avail for the consumer. On cache incoherent
+ * architectures the buffer object is then accessed through the uncached
+ * pointer only, so neither end ever writes back a cache line holding the
+ * fields owned by the other end. Only the produced data cache lines are
+ * written back and only the newly available data cache lines are
+ * invalidated. The buffer configuration must not be changed while the link
+ * is streaming.
+ *
+ * The sink buffer of a component that processes in place can use the memory
+ * of its source buffer. The read position of the source then equals the
+ * write position of the sink, and the space is free for the producer of the
+ * source only after the consumer of the last buffer sharing the memory has
+ * read it. The sink keeps its own memory meanwhile. In-place buffers are
+ * local to one core.
+ */
+
+#if CONFIG_BUFFER_SPSC
+/*
+ * lock-free mode positions, accessed uncached only, the producer and the
+ * consumer owned positions are kept in separate cache lines
  */
+struct buffer_spsc {
+	/* owned by producer */
+	atomic_t w_pos __aligned(DCACHE_LINE_SIZE);	/**< write position modulo 2 * size */
+
+	/* owned by consumer */
+	atomic_t r_pos __aligned(DCACHE_LINE_SIZE);	/**< read position modulo 2 * size */
+	atomic_t w_seen;	/**< write position last seen by consumer */
+} __aligned(DCACHE_LINE_SIZE);
+#endif
+
 struct comp_buffer {
 	struct coherent c;
 
@@ -128,6 +165,19 @@ struct comp_buffer {
 
 	bool hw_params_configured; /**< indicates whether hw params were set */
 	bool walking;	/**< indicates if the buffer is being walking */
+
+#if CONFIG_BUFFER_SPSC
+	bool spsc;	/**< lock-free single producer/single consumer mode */
+
+	struct buffer_spsc spsc_pos;	/**< positions for lock-free mode */
+#endif
+
+#if CONFIG_BUFFER_INPLACE
+	/* in-place mode */
+	struct comp_buffer *inplace_source;	/**< buffer owning the memory */
+	struct comp_buffer *inplace_sink;	/**< buffer using the memory */
+	void *inplace_addr;			/**< own memory while in place */
+#endif
 };
 
 struct buffer_cb_transact {
@@ -187,8 +237,36 @@ int buffer_set_params(struct comp_buffer *buffer, struct sof_ipc_stream_params *
 bool buffer_params_match(struct comp_buffer *buffer, struct sof_ipc_stream_params *params,
 			 uint32_t flag);
 
+#if CONFIG_BUFFER_SPSC
+/* lock-free single producer/single consumer mode for links between cores */
+void buffer_spsc_enable(struct comp_buffer *buffer);
+
+/* refresh w_ptr and free from the published read position */
+void buffer_spsc_sync_producer(struct comp_buffer *buffer);
+
+/* refresh r_ptr and avail from the published write position */
+void buffer_spsc_sync_consumer(struct comp_buffer *buffer);
+
+/* refresh the stream fields owned by the ends of the buffer on this core */
+void buffer_spsc_sync(struct comp_buffer *buffer);
+#endif
+
+#if CONFIG_BUFFER_INPLACE
+/* use the memory of source buffer for sink buffer of in-place component */
+int buffer_inplace_link(struct comp_buffer *source, struct comp_buffer *sink);
+
+/* give own memory back to sink buffer of in-place component */
+void buffer_inplace_unlink(struct comp_buffer *sink);
+#endif
+
 static inline void buffer_stream_invalidate(struct comp_buffer *buffer, uint32_t bytes)
 {
+#if CONFIG_BUFFER_SPSC
+	/* lock-free mode invalidates the new data when it's published */
+	if (buffer->spsc)
+		return;
+#endif
+
 	if (!is_coherent_shared(buffer, c))
 		return;
 
@@ -197,6 +275,12 @@ static inline void buffer_stream_invalidate(struct comp_buffer *buffer, uint32_t
 
 static inline void buffer_stream_writeback(struct comp_buffer *buffer, uint32_t bytes)
 {
+#if CONFIG_BUFFER_SPSC
+	/* lock-free mode writes back the data before it's published */
+	if (buffer->spsc)
+		return;
+#endif
+
 	if (!is_coherent_shared(buffer, c))
 		return;
 
@@ -205,24 +289,57 @@ static inline void buffer_stream_writeback(struct comp_buffer *buffer, uint32_t
 
 __must_check static inline struct comp_buffer *buffer_acquire(struct comp_buffer *buffer)
 {
-	struct coherent *c = coherent_acquire_thread(&buffer->c, sizeof(*buffer));
+	struct coherent *c;
+
+#if CONFIG_BUFFER_SPSC
+	if (buffer->spsc) {
+		/* no cached copy of the object, the other end writes to it */
+		buffer = cache_to_uncache(buffer);
+		buffer_spsc_sync(buffer);
+		return buffer;
+	}
+#endif
+
+	c = coherent_acquire_thread(&buffer->c, sizeof(*buffer));
 
 	return container_of(c, struct comp_buffer, c);
 }
 
 static inline struct comp_buffer *buffer_release(struct comp_buffer *buffer)
 {
-	struct coherent *c = coherent_release_thread(&buffer->c, sizeof(*buffer));
+	struct coherent *c;
+
+#if CONFIG_BUFFER_SPSC
+	/* lock-free buffer is accessed uncached so there is nothing to write back */
+	if (buffer->spsc)
+		return buffer;
+#endif
+
+	c = coherent_release_thread(&buffer->c, sizeof(*buffer));
 
 	return container_of(c, struct comp_buffer, c);
 }
 
+#if CONFIG_BUFFER_SPSC
+static inline void buffer_spsc_reset(struct comp_buffer *buffer)
+{
+	struct buffer_spsc *pos = cache_to_uncache(&buffer->spsc_pos);
+
+	atomic_init(&pos->w_pos, 0);
+	atomic_init(&pos->r_pos, 0);
+	atomic_init(&pos->w_seen, 0);
+}
+#endif
+
 static inline void buffer_reset_pos(struct comp_buffer *buffer, void *data)
 {
 	buffer = buffer_acquire(buffer);
 
 	/* reset rw pointers and avail/free bytes counters */
 	audio_stream_reset(&buffer->stream);
+#if CONFIG_BUFFER_SPSC
+	buffer_spsc_reset(buffer);
+#endif
 
 	/* clear buffer contents */
 	buffer_zero(buffer);
@@ -236,6 +353,9 @@ static inline void buffer_init(struct comp_buffer *buffer, uint32_t size, uint32
 
 	/* addr should be set in alloc function */
 	audio_stream_init(&buffer->stream, buffer->stream.addr, size);
+#if CONFIG_BUFFER_SPSC
+	buffer_spsc_reset(buffer);
+#endif
 }
 
 static inline void buffer_reset_params(struct comp_buffer *buffer, void *data)
@@ -114,6 +114,20 @@ struct output_stream_buffer {
 	uint32_t size; /* size of data in the buffer */
 };
 
+/**
+ * \struct module_stream_segments
+ * \brief Data or free space of a circular buffer given to the module in place.
+ * The region starts at seg[0] and continues at seg[1] after the buffer wrap,
+ * seg[1] has zero size when the region does not wrap.
+ */
+struct module_stream_segments {
+	struct {
+		void *ptr; /* start of the segment */
+		uint32_t size; /* size of the segment */
+	} seg[2];
+	uint32_t bytes; /* total size of the segments */
+};
+
 /*****************************************************************************/
 /* Module generic data types						     */
 /*****************************************************************************/
@@ -142,6 +156,19 @@ struct module_interface {
 		       int num_input_buffers, struct output_stream_buffer *output_buffers,
 		       int num_output_buffers);
 
+	/**
+	 * Optional module specific processing procedure working directly on the
+	 * codec_adapter source buffer and local output buffer. Data available in
+	 * the source and free space in the output are passed as segments split at
+	 * the buffer wrap, so the module must handle the wrap but the copies to and
+	 * from mpd.in_buff and mpd.out_buff are avoided. The module reports the
+	 * bytes it used in mpd.consumed and mpd.produced. When set, it is called
+	 * instead of process().
+	 */
+	int (*process_segments)(struct processing_module *mod,
+				const struct module_stream_segments *input,
+				const struct module_stream_segments *output);
+
 	/**
 	 * Set module configuration for the given configuration ID
 	 *
@@ -284,6 +311,7 @@ struct processing_module {
 	uint32_t deep_buff_bytes; /**< copy start threshold */
 	uint32_t num_input_buffers; /**< number of input buffers */
 	uint32_t num_output_buffers; /**< number of output buffers */
+	uint64_t copy_bytes_saved; /**< bytes not copied thanks to process_segments() */
 };
 
 /*****************************************************************************/
@@ -298,6 +326,11 @@ int module_prepare(struct processing_module *mod);
 int module_process(struct processing_module *mod, struct input_stream_buffer *input_buffers,
 		   int num_input_buffers, struct output_stream_buffer *output_buffers,
 		   int num_output_buffers);
+int module_process_segments(struct processing_module *mod,
+			    const struct module_stream_segments *input,
+			    const struct module_stream_segments *output);
+void module_segments_copy(const struct module_stream_segments *output,
+			  const struct module_stream_segments *input, uint32_t bytes);
 int module_reset(struct processing_module *mod);
 int module_free(struct processing_module *mod);
 int module_set_configuration(struct processing_module *mod,
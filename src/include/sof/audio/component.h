@@ -130,6 +130,17 @@ enum {
 #define COMP_ATTR_COPY_DIR	2	/**< Comp copy direction */
 /** @}*/
 
+/** \name Component driver flags
+ *  @{
+ */
+/**
+ * Processing can write the sink in place of the read source samples. The
+ * driver must consume and produce the same number of frames in every copy,
+ * so it's not for rate converters or decimators.
+ */
+#define COMP_DRV_FLAG_INPLACE	BIT(0)
+/** @}*/
+
 /** \name Trace macros
  *  @{
  */
@@ -477,6 +488,7 @@ struct comp_driver {
 	uint32_t type;			/**< SOF_COMP_ for driver */
 	const struct sof_uuid *uid;	/**< Address to UUID value */
 	struct tr_ctx *tctx;		/**< Pointer to trace context */
+	uint32_t flags;			/**< COMP_DRV_FLAG_ */
 	struct comp_ops ops;		/**< component operations */
 };
 
@@ -549,6 +561,9 @@ struct comp_dev {
 #if CONFIG_PERFORMANCE_COUNTERS
 	struct perf_cnt_data pcd;
 #endif
+#if CONFIG_COMP_PROFILING
+	struct perf_cnt_profile prof;	/**< copy() cycles profile */
+#endif
 };
 
 /** @}*/
@@ -10,11 +10,45 @@
 #include <stdint.h>
 #include <sof/platform.h>
 #include <sof/math/iir_df2t.h>
+#include <sof/math/iir_df2t_block.h>
 #include <user/crossover.h>
 
 struct comp_buffer;
 struct comp_dev;
 
+/* If next defines are set to 1 the crossover is configured automatically.
+ * Setting to zero temporarily is useful is for testing needs.
+ */
+#define CROSSOVER_AUTOARCH	1
+
+/* Force manually some code variant when CROSSOVER_AUTOARCH is set to zero.
+ * These are useful in code debugging.
+ */
+#if CROSSOVER_AUTOARCH == 0
+#define CROSSOVER_GENERIC	1
+#define CROSSOVER_HIFI3		0
+#endif
+
+/* Select optimized code variant when xt-xcc compiler is used, the HiFi3
+ * version is selected with COMP_CROSSOVER_HIFI3
+ */
+#if CROSSOVER_AUTOARCH == 1
+#if defined __XCC__
+#include <xtensa/config/core-isa.h>
+#if XCHAL_HAVE_HIFI3 == 1 && CONFIG_COMP_CROSSOVER_HIFI3
+#define CROSSOVER_GENERIC	0
+#define CROSSOVER_HIFI3		1
+#else
+#define CROSSOVER_GENERIC	1
+#define CROSSOVER_HIFI3		0
+#endif /* XCHAL_HAVE_HIFI3 && CONFIG_COMP_CROSSOVER_HIFI3 */
+#else
+/* GCC */
+#define CROSSOVER_GENERIC	1
+#define CROSSOVER_HIFI3		0
+#endif /* __XCC__ */
+#endif /* CROSSOVER_AUTOARCH */
+
 /* Maximum number of LR4 highpass OR lowpass filters */
 #define CROSSOVER_MAX_LR4 3
 /* Number of delay slots allocated for LR4 Filters */
@@ -55,8 +89,25 @@ struct comp_dev;
  * In total, we keep track of the state of at most 6 IIRs each made of two
  * biquads in series.
  *
+ * With IIR_DF2T_BLOCK each LR4 runs as a block filter for all channels, see
+ * iir_df2t_block(). The input is written to band[0] and the split functions
+ * leave the outputs y1(n) ... y4(n) to band[0] ... band[num_sinks - 1], all
+ * [frame][lane] blocks of up to IIR_DF2T_BLOCK_FRAMES frames. Otherwise
+ * every channel has its own state and the split is done sample by sample.
  */
 
+#if IIR_DF2T_BLOCK
+/**
+ * Stores the state of the Crossover filter for all channels
+ */
+struct crossover_state {
+	/* Store the state for each LR4 filter. */
+	struct iir_df2t_block lowpass[CROSSOVER_MAX_LR4];
+	struct iir_df2t_block highpass[CROSSOVER_MAX_LR4];
+	int32_t *band[CROSSOVER_4WAY_NUM_SINKS]; /* [frame][lane] blocks */
+	void *mem; /* LR4 filters and band blocks allocation */
+};
+#else
 /**
  * Stores the state of one channel of the Crossover filter
  */
@@ -65,6 +116,7 @@ struct crossover_state {
 	struct iir_state_df2t lowpass[CROSSOVER_MAX_LR4];
 	struct iir_state_df2t highpass[CROSSOVER_MAX_LR4];
 };
+#endif
 
 typedef void (*crossover_process)(const struct comp_dev *dev,
 				  const struct comp_buffer *source,
@@ -72,13 +124,21 @@ typedef void (*crossover_process)(const struct comp_dev *dev,
 				  int32_t num_sinks,
 				  uint32_t frames);
 
+#if IIR_DF2T_BLOCK
+typedef void (*crossover_split)(struct crossover_state *state, int frames);
+#else
 typedef void (*crossover_split)(int32_t in, int32_t out[],
 				struct crossover_state *state);
+#endif
 
 /* Crossover component private data */
 struct comp_data {
 	/**< filter state */
+#if IIR_DF2T_BLOCK
+	struct crossover_state state;
+#else
 	struct crossover_state state[PLATFORM_MAX_CHANNELS];
+#endif
 	struct sof_crossover_config *config;      /**< pointer to setup blob */
 	struct sof_crossover_config *config_new;  /**< pointer to new setup */
 	enum sof_ipc_frame source_format;         /**< source frame format */
@@ -142,6 +202,7 @@ static inline crossover_split crossover_find_split_func(int32_t num_sinks)
 	return crossover_split_fnmap[num_sinks - CROSSOVER_2WAY_NUM_SINKS];
 }
 
+#if !IIR_DF2T_BLOCK
 /*
  * \brief Runs input in through the LR4 filter and returns it's output.
  */
@@ -151,5 +212,6 @@ static inline int32_t crossover_generic_process_lr4(int32_t in,
 	/* Cascade two biquads with same coefficients in series. */
 	return iir_df2t(lr4, in);
 }
+#endif
 
 #endif //  __SOF_AUDIO_CROSSOVER_CROSSOVER_H__
@@ -13,6 +13,15 @@
 #include <sof/math/iir_df2t.h>
 #include <user/crossover.h>
 
+#if IIR_DF2T_BLOCK
+/* crossover reset function */
+void crossover_reset_state_all(struct crossover_state *state);
+
+/* crossover init function */
+int crossover_init_coef_all(struct sof_eq_iir_biquad_df2t *coef,
+			    struct crossover_state *state,
+			    int32_t nch, int32_t num_sinks);
+#else
 /* crossover reset function */
 void crossover_reset_state_ch(struct crossover_state *ch_state);
 
@@ -20,5 +29,6 @@ void crossover_reset_state_ch(struct crossover_state *ch_state);
 int crossover_init_coef_ch(struct sof_eq_iir_biquad_df2t *coef,
 			   struct crossover_state *ch_state,
 			   int32_t num_sinks);
+#endif
 
 #endif //  __SOF_AUDIO_CROSSOVER_CROSSOVER_ALGORITHM_H__
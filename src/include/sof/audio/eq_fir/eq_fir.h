@@ -20,9 +20,22 @@
 #if FIR_HIFI3
 #include <sof/math/fir_hifi3.h>
 #endif
+#if CONFIG_COMP_FIR_FFT
+#include <sof/math/fir_fft.h>
+#endif
+#include <user/eq.h>
 #include <user/fir.h>
 #include <stdint.h>
 
+/** \brief Max coefficients blob size, long responses for FFT convolution
+ * need a bigger blob than SOF_EQ_FIR_MAX_SIZE.
+ */
+#if CONFIG_COMP_FIR_FFT
+#define EQ_FIR_MAX_BLOB_SIZE	(4 * SOF_EQ_FIR_MAX_SIZE)
+#else
+#define EQ_FIR_MAX_BLOB_SIZE	SOF_EQ_FIR_MAX_SIZE
+#endif
+
 /** \brief Macros to convert without division bytes count to samples count */
 #define EQ_FIR_BYTES_TO_S16_SAMPLES(b)	((b) >> 1)
 #define EQ_FIR_BYTES_TO_S32_SAMPLES(b)	((b) >> 2)
@@ -51,4 +64,24 @@ void eq_fir_2x_s32(struct fir_state_32x16 *fir, const struct audio_stream *sourc
 		   struct audio_stream *sink, int frames, int nch);
 #endif /* CONFIG_FORMAT_S32LE */
 
+#if CONFIG_COMP_FIR_FFT
+#if CONFIG_FORMAT_S16LE
+void eq_fir_fft_s16(struct fir_fft_plan *plan, struct fir_fft_state fir[],
+		    const struct audio_stream *source, struct audio_stream *sink,
+		    int frames, int nch);
+#endif /* CONFIG_FORMAT_S16LE */
+
+#if CONFIG_FORMAT_S24LE
+void eq_fir_fft_s24(struct fir_fft_plan *plan, struct fir_fft_state fir[],
+		    const struct audio_stream *source, struct audio_stream *sink,
+		    int frames, int nch);
+#endif /* CONFIG_FORMAT_S24LE */
+
+#if CONFIG_FORMAT_S32LE
+void eq_fir_fft_s32(struct fir_fft_plan *plan, struct fir_fft_state fir[],
+		    const struct audio_stream *source, struct audio_stream *sink,
+		    int frames, int nch);
+#endif /* CONFIG_FORMAT_S32LE */
+#endif /* CONFIG_COMP_FIR_FFT */
+
 #endif /* __SOF_AUDIO_EQ_FIR_EQ_FIR_H__ */
@@ -8,6 +8,7 @@
 #ifndef __SOF_AUDIO_KPB_H__
 #define __SOF_AUDIO_KPB_H__
 
+#include <sof/lib/perf_cnt.h>
 #include <sof/trace/trace.h>
 #include <user/trace.h>
 #include <stdint.h>
@@ -47,6 +48,21 @@ struct comp_buffer;
 /**< Host buffer shall be at least two times bigger than history buffer. */
 #define HOST_BUFFER_MIN_SIZE(hb) (hb * 2)
 
+#if CONFIG_KPB_HISTORY_COMPRESSED
+/**< Stream bytes per history buffer byte, samples are kept as mu-law */
+#define KPB_HISTORY_RATIO(sw) (KPB_SAMPLE_CONTAINER_SIZE(sw) / 8)
+#else
+#define KPB_HISTORY_RATIO(sw) 1
+#endif
+/**< Adaptive draining burst covers this many ms of host DMA reading */
+#define KPB_DRAIN_BURST_MS 2
+/**< Weight of a new host throughput sample is 1 / (1 << shift) */
+#define KPB_DRAIN_RATE_SHIFT 2
+
+/**< Largest magnitude and bias of mu-law coding */
+#define KPB_ULAW_CLIP 32635
+#define KPB_ULAW_BIAS 0x84
+
 /**< Convert with right shift a bytes count to samples count */
 #define KPB_BYTES_TO_S16_SAMPLES(s)	((s) >> 1)
 #define KPB_BYTES_TO_S32_SAMPLES(s)	((s) >> 2)
@@ -122,6 +138,16 @@ struct history_buffer {
 };
 
 /* Draining task data */
+/**< Draining statistics, throughput is in bytes per ms */
+struct kpb_drain_stats {
+	uint64_t duration; /**< draining time in platform timer ticks */
+	uint32_t drained; /**< number of drained bytes */
+	uint32_t bursts; /**< number of copies to the host sink */
+	uint32_t burst_peak; /**< largest copy to the host sink in bytes */
+	uint32_t throughput; /**< average draining throughput */
+	uint32_t host_rate; /**< last host DMA throughput estimate */
+};
+
 struct draining_data {
 	struct comp_buffer *sink;
 	struct history_buffer *hb;
@@ -134,15 +160,68 @@ struct draining_data {
 	struct comp_dev *dev;
 	bool sync_mode_on;
 	enum comp_copy_type copy_type;
+	bool adaptive_mode_on;
+	size_t min_burst; /**< adaptive draining minimal burst in bytes */
+	size_t last_free; /**< host sink free bytes after last burst */
+	uint64_t last_time; /**< time of last_free sample */
+	uint64_t next_burst_time; /**< earliest time of next burst */
+	struct kpb_drain_stats stats;
+#if CONFIG_PERFORMANCE_COUNTERS
+	struct perf_cnt_data pcd; /**< time between bursts */
+#endif
 };
 
 struct history_data {
-	size_t buffer_size; /**< size of internal history buffer */
+	size_t buffer_size; /**< size of internal history buffer in stream bytes */
 	size_t buffered; /**< amount of buffered data */
 	size_t free; /** spce we can use to write new data */
 	struct history_buffer *c_hb; /**< current buffer used for writing */
 };
 
+/**
+ * \brief Encode sample as 8-bit mu-law. The bits are not inverted as done
+ *	  for transmission, so zeroed history buffer decodes to silence.
+ * \param[in] sample - 16-bit sample.
+ *
+ * \return mu-law code.
+ */
+static inline uint8_t kpb_ulaw_encode(int32_t sample)
+{
+	uint8_t sign = 0;
+	int32_t v;
+	int exp = 0;
+
+	if (sample < 0) {
+		sample = -sample;
+		sign = 0x80;
+	}
+
+	if (sample > KPB_ULAW_CLIP)
+		sample = KPB_ULAW_CLIP;
+
+	sample += KPB_ULAW_BIAS;
+
+	for (v = sample >> 8; v; v >>= 1)
+		exp++;
+
+	return sign | exp << 4 | ((sample >> (exp + 3)) & 0xF);
+}
+
+/**
+ * \brief Decode 8-bit mu-law sample.
+ * \param[in] code - mu-law code.
+ *
+ * \return 16-bit sample.
+ */
+static inline int32_t kpb_ulaw_decode(uint8_t code)
+{
+	int exp = (code >> 4) & 0x7;
+	int32_t sample = ((((code & 0xF) << 3) + KPB_ULAW_BIAS) << exp) -
+			 KPB_ULAW_BIAS;
+
+	return code & 0x80 ? -sample : sample;
+}
+
 #ifdef UNIT_TEST
 void sys_comp_kpb_init(void);
 #endif
@@ -8,6 +8,103 @@
 #ifndef __SOF_AUDIO_MIXER_H__
 #define __SOF_AUDIO_MIXER_H__
 
+#include <sof/audio/audio_stream.h>
+#include <sof/audio/component.h>
+#include <sof/common.h>
+#include <sof/math/numbers.h>
+#include <ipc/stream.h>
+#include <stddef.h>
+#include <stdint.h>
+#if CONFIG_IPC_MAJOR_4
+#include <ipc4/base-config.h>
+#endif
+
+#define MIXER_GENERIC
+
+/* Select optimized code variant when xt-xcc compiler is used, the HiFi3
+ * version is opt-in with COMP_MIXER_HIFI3
+ */
+#if defined(__XCC__)
+#include <xtensa/config/core-isa.h>
+
+#if XCHAL_HAVE_HIFI3 && CONFIG_COMP_MIXER_HIFI3
+#undef MIXER_GENERIC
+#define MIXER_HIFI3
+#endif
+
+#endif
+
+/** \brief Samples mixed per block into the wide accumulator. */
+#define MIXER_BLOCK_SAMPLES	64
+
+/** \brief Mixer processing function. */
+typedef void (*mix_func)(struct comp_dev *dev, struct audio_stream *sink,
+			 const struct audio_stream **sources, uint32_t num_sources,
+			 uint32_t frames);
+
+/** \brief Mixer component private data. */
+struct mixer_data {
+#if CONFIG_IPC_MAJOR_4
+	struct ipc4_base_module_cfg base_cfg;
+#endif
+
+	mix_func mix_func;
+};
+
+/** \brief Mixer processing functions map item. */
+struct mix_func_map {
+	uint16_t frame_fmt;	/**< frame format */
+	mix_func func;		/**< mixing function */
+};
+
+/** \brief Map of formats with mixing functions. */
+extern const struct mix_func_map mix_func_map[];
+
+/** \brief Number of mixing functions in the map. */
+extern const size_t mix_func_count;
+
+/**
+ * \brief Retrieves mixing function for the frame format.
+ * \param[in] frame_fmt Sink stream frame format.
+ * \return Mixing function or NULL if the format is not supported.
+ */
+static inline mix_func mixer_get_processing_function(enum sof_ipc_frame frame_fmt)
+{
+	int i;
+
+	for (i = 0; i < mix_func_count; i++)
+		if (frame_fmt == mix_func_map[i].frame_fmt)
+			return mix_func_map[i].func;
+
+	return NULL;
+}
+
+/**
+ * \brief Get the number of samples to mix in one block.
+ * \param[in] sink Sink stream.
+ * \param[in] dest Sink write pointer.
+ * \param[in] sources Source streams.
+ * \param[in] src Source read pointers.
+ * \param[in] num_sources Number of sources.
+ * \param[in] shift Sample size as bytes shift.
+ * \param[in] nmax Samples left to mix.
+ * \return Samples count that can be mixed without wrap in any of the streams.
+ */
+static inline int mixer_samples_without_wrap(struct audio_stream *sink, void *dest,
+					     const struct audio_stream **sources,
+					     void **src, uint32_t num_sources, int shift,
+					     int nmax)
+{
+	int n = MIN(nmax, MIXER_BLOCK_SAMPLES);
+	int i;
+
+	n = MIN(n, audio_stream_bytes_without_wrap(sink, dest) >> shift);
+	for (i = 0; i < num_sources; i++)
+		n = MIN(n, audio_stream_bytes_without_wrap(sources[i], src[i]) >> shift);
+
+	return n;
+}
+
 #ifdef UNIT_TEST
 void sys_comp_mixer_init(void);
 #endif
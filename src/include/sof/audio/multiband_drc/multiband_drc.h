@@ -13,8 +13,55 @@
 #include <sof/audio/drc/drc.h>
 #include <sof/platform.h>
 #include <sof/math/iir_df2t.h>
+#include <sof/math/iir_df2t_block.h>
 #include <user/multiband_drc.h>
 
+/* If next defines are set to 1 the Multiband DRC is configured automatically.
+ * Setting to zero temporarily is useful is for testing needs.
+ */
+#define MULTIBAND_DRC_AUTOARCH	1
+
+/* Force manually some code variant when MULTIBAND_DRC_AUTOARCH is set to zero.
+ * These are useful in code debugging.
+ */
+#if MULTIBAND_DRC_AUTOARCH == 0
+#define MULTIBAND_DRC_GENERIC	1
+#define MULTIBAND_DRC_HIFI3	0
+#endif
+
+/* Select optimized code variant when xt-xcc compiler is used, the HiFi3
+ * version is selected with COMP_MULTIBAND_DRC_HIFI3
+ */
+#if MULTIBAND_DRC_AUTOARCH == 1
+#if defined __XCC__
+#include <xtensa/config/core-isa.h>
+#if XCHAL_HAVE_HIFI3 == 1 && CONFIG_COMP_MULTIBAND_DRC_HIFI3
+#define MULTIBAND_DRC_GENERIC	0
+#define MULTIBAND_DRC_HIFI3	1
+#else
+#define MULTIBAND_DRC_GENERIC	1
+#define MULTIBAND_DRC_HIFI3	0
+#endif /* XCHAL_HAVE_HIFI3 && CONFIG_COMP_MULTIBAND_DRC_HIFI3 */
+#else
+/* GCC */
+#define MULTIBAND_DRC_GENERIC	1
+#define MULTIBAND_DRC_HIFI3	0
+#endif /* __XCC__ */
+#endif /* MULTIBAND_DRC_AUTOARCH */
+
+#if IIR_DF2T_BLOCK
+/**
+ * Stores the state of the sub-components in Multiband DRC. The emphasis,
+ * crossover and deemphasis filters run as block filters for all channels.
+ */
+struct multiband_drc_state {
+	struct iir_df2t_block emphasis;
+	struct crossover_state crossover;
+	struct drc_state drc[SOF_MULTIBAND_DRC_MAX_BANDS];
+	struct iir_df2t_block deemphasis;
+	void *emp_deemp; /* emphasis and deemphasis filters allocation */
+};
+#else
 /**
  * Stores the state of the sub-components in Multiband DRC
  */
@@ -24,6 +71,7 @@ struct multiband_drc_state {
 	struct drc_state drc[SOF_MULTIBAND_DRC_MAX_BANDS];
 	struct iir_state_df2t deemphasis[PLATFORM_MAX_CHANNELS];
 };
+#endif
 
 typedef void (*multiband_drc_func)(const struct comp_dev *dev,
 				   const struct audio_stream *source,
@@ -164,6 +164,17 @@ int pipeline_connect(struct comp_dev *comp, struct comp_buffer *buffer,
 void pipeline_disconnect(struct comp_dev *comp, struct comp_buffer *buffer,
 			 int dir);
 
+#if CONFIG_BUFFER_INPLACE
+/**
+ * \brief Shares the source buffer memory with the sink buffer of an in-place
+ *	  capable component, or gives the sink its own memory back when the
+ *	  buffers no longer match.
+ * \param[in] dev Component device.
+ * \return 0 on success.
+ */
+int pipeline_comp_inplace(struct comp_dev *dev);
+#endif
+
 /**
  * \brief Completes a pipeline.
  * \param[in] p pipeline.
@@ -26,6 +26,10 @@ struct src_param {
 	int idx_in;
 	int idx_out;
 	int nch;
+#if CONFIG_COMP_SRC_DESIGN
+	struct src_stage *stage1;
+	struct src_stage *stage2;
+#endif
 };
 
 struct src_stage {
@@ -115,6 +119,19 @@ void src_polyphase_stage_cir(struct src_stage_prm *s);
 void src_polyphase_stage_cir_s16(struct src_stage_prm *s);
 #endif /* CONFIG_FORMAT_S16LE */
 
+#if CONFIG_COMP_SRC_MULTICH
+/* Stage versions that load each filter coefficient once for several
+ * channels, used for more than two channels.
+ */
+#if CONFIG_FORMAT_S24LE || CONFIG_FORMAT_S32LE
+void src_polyphase_stage_cir_multich(struct src_stage_prm *s);
+#endif /* CONFIG_FORMAT_S24LE || CONFIG_FORMAT_S32LE */
+
+#if CONFIG_FORMAT_S16LE
+void src_polyphase_stage_cir_multich_s16(struct src_stage_prm *s);
+#endif /* CONFIG_FORMAT_S16LE */
+#endif /* CONFIG_COMP_SRC_MULTICH */
+
 int src_buffer_lengths(struct src_param *a, int fs_in, int fs_out, int nch,
 		       int source_frames);
 
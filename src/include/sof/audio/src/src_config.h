@@ -65,4 +65,14 @@
 #endif
 #endif
 
+/* The multichannel filter core is available for generic and HiFi3, the
+ * HiFi3 version is selected with COMP_SRC_MULTICH_HIFI3
+ */
+#if CONFIG_COMP_SRC_MULTICH && \
+	(SRC_GENERIC || (SRC_HIFI3 && CONFIG_COMP_SRC_MULTICH_HIFI3))
+#define SRC_MULTICH	1
+#else
+#define SRC_MULTICH	0
+#endif
+
 #endif /* __SOF_AUDIO_SRC_SRC_CONFIG_H__ */
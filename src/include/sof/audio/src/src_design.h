@@ -0,0 +1,59 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright(c) 2022 Intel Corporation. All rights reserved.
+ *
+ */
+
+#ifndef __SOF_AUDIO_SRC_SRC_DESIGN_H__
+#define __SOF_AUDIO_SRC_SRC_DESIGN_H__
+
+#include <sof/audio/src/src.h>
+
+/* Max. lengths of the designed filters and their delay lines per channel.
+ * These replace the limits of the pre-generated coefficient sets.
+ */
+#define SRC_DESIGN_MAX_FILTER_LENGTH	4096
+#define SRC_DESIGN_MAX_LM		160
+#define MAX_FIR_DELAY_SIZE		2048
+#define MAX_OUT_DELAY_SIZE		2048
+
+/* Design parameters of the SRC filters, the values are as in
+ * tools/tune/src/src_param.m for the quality 1.0 set.
+ */
+#define SRC_DESIGN_PB_HZ		20000	/* Pass band for 44.1 kHz */
+#define SRC_DESIGN_PB_FS		44100
+#define SRC_DESIGN_PB_HIGH_FS		80000	/* Fixed pass band above this */
+#define SRC_DESIGN_PB_HIGH_HZ		24000
+#define SRC_DESIGN_SB			5000	/* Stop band start x 1e-4 Fs */
+#define SRC_DESIGN_STOPBAND_ITER_MAX	16
+
+/**
+ * \brief Initialize the shared pool of designed stages.
+ */
+void src_design_init(void);
+
+/**
+ * \brief Get polyphase filter stages for a conversion.
+ *
+ * The stage 1 and stage 2 filters for conversion from fs_in to fs_out
+ * are returned from the shared pool if another SRC instance uses the
+ * same filter, otherwise they are designed and added to the pool. The
+ * stages must be returned with src_design_put() when not used.
+ *
+ * \param[out] stage1 First stage of conversion.
+ * \param[out] stage2 Second stage of conversion, a one tap filter if the
+ *		      conversion is done in one stage.
+ * \param[in] fs_in Input sample rate.
+ * \param[in] fs_out Output sample rate.
+ * \return Zero if success, otherwise error code.
+ */
+int src_design_get(struct src_stage **stage1, struct src_stage **stage2,
+		   int fs_in, int fs_out);
+
+/**
+ * \brief Release a stage got with src_design_get().
+ * \param[in] stage Stage to release, can be NULL.
+ */
+void src_design_put(struct src_stage *stage);
+
+#endif /* __SOF_AUDIO_SRC_SRC_DESIGN_H__ */
@@ -10,6 +10,7 @@
 
 #include <sof/platform.h>
 #include <sof/audio/audio_stream.h>
+#include <sof/math/fft.h>
 #include <sof/math/fir_generic.h>
 #include <sof/math/fir_hifi2ep.h>
 #include <sof/math/fir_hifi3.h>
@@ -67,6 +68,10 @@ struct tdfb_direction_data {
 	int32_t frame_count_since_control;
 	int64_t *df2t_delay;
 	int32_t *r;
+	struct fft_plan *fft_plan;	/* GCC-PHAT transform, NULL if not possible */
+	struct icomplex32 *fft_in;
+	struct icomplex32 *fft_out;
+	struct icomplex32 *fft_ref;	/* Reference channel spectrum */
 	int16_t *d;
 	int16_t *d_end;
 	int16_t *wp;
@@ -77,6 +82,7 @@ struct tdfb_direction_data {
 	int16_t max_lag;
 	size_t d_size;
 	size_t r_size;
+	int fft_size;
 	int line_array:1; /* Limit scan to -90 to 90 degrees */
 };
 
@@ -101,6 +107,7 @@ struct tdfb_comp_data {
 	unsigned int max_frames;	    /**< max frames to process */
 	bool direction_updates:1;	    /**< set true if direction angle control is updated */
 	bool direction_change:1;	    /**< set if direction value has significant change */
+	bool direction_gcc_phat:1;	    /**< set true to use GCC-PHAT time differences */
 	bool beam_on:1;			    /**< set true if beam is off */
 	bool update:1;			    /**< set true if control enum has been received */
 	void (*tdfb_func)(struct tdfb_comp_data *cd,
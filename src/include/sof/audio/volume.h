@@ -88,6 +88,24 @@ struct sof_ipc_ctrl_value_chan;
 #define VOL_RAMP_UPDATE_THRESHOLD_FAST_MS	64
 #define VOL_RAMP_UPDATE_THRESHOLD_FASTEST_MS	32
 
+/**
+ * \brief Extra fraction bits of the interpolated ramp gain.
+ * The gains are max. 24 bits so seven bits can be added without
+ * overflow of the int32_t gain accumulator.
+ */
+#define VOL_RAMP_FRAC_BITS	7
+
+/**
+ * \brief Size of the gain buffer for xtensa multi-way intrinsic operations
+ * in int32_t words. The interpolated ramp stores a gain and an increment
+ * for four frames of channels.
+ */
+#if CONFIG_COMP_VOLUME_SMOOTH_RAMP
+#define VOL_GAIN_BUF_SIZE	(SOF_IPC_MAX_CHANNELS * 8)
+#else
+#define VOL_GAIN_BUF_SIZE	(SOF_IPC_MAX_CHANNELS * 4)
+#endif
+
 /**
  * \brief Volume maximum value.
  * TODO: This should be 1 << (VOL_QX_BITS + VOL_QY_BITS - 1) - 1 but
@@ -137,6 +155,11 @@ struct vol_data {
 	int32_t mvolume[SOF_IPC_MAX_CHANNELS];	/**< mute volume */
 	int32_t rvolume[SOF_IPC_MAX_CHANNELS];	/**< ramp start volume */
 	int32_t ramp_coef[SOF_IPC_MAX_CHANNELS]; /**< parameter for slope */
+#if CONFIG_COMP_VOLUME_SMOOTH_RAMP
+	/**< interpolated gain at block start, VOL_RAMP_FRAC_BITS more fraction */
+	int32_t ramp_vol[SOF_IPC_MAX_CHANNELS];
+	int32_t ramp_inc[SOF_IPC_MAX_CHANNELS]; /**< gain increment per frame */
+#endif
 	/**< store current volume 4 times for scale_vol function */
 	int32_t *vol;
 	uint32_t initial_ramp;			/**< ramp space in ms */
@@ -153,6 +176,9 @@ struct vol_data {
 	bool vol_ramp_active;			/**< set if volume is ramped */
 	bool ramp_finished;			/**< control ramp launch */
 	vol_scale_func scale_vol;		/**< volume processing function */
+#if CONFIG_COMP_VOLUME_SMOOTH_RAMP
+	vol_scale_func scale_vol_ramp;		/**< processing with gain ramp */
+#endif
 	vol_zc_func zc_get;			/**< function getting nearest zero crossing frame */
 	vol_ramp_func ramp_func;		/**< function for ramp shape */
 };
@@ -169,6 +195,14 @@ extern const struct comp_func_map func_map[];
 /** \brief Number of processing functions. */
 extern const size_t func_count;
 
+#if CONFIG_COMP_VOLUME_SMOOTH_RAMP
+/** \brief Map of formats with processing functions for interpolated gain. */
+extern const struct comp_func_map ramp_func_map[];
+
+/** \brief Number of interpolated gain processing functions. */
+extern const size_t ramp_func_count;
+#endif
+
 /** \brief Volume zero crossing functions map. */
 struct comp_zc_func_map {
 	uint16_t frame_fmt;	/**< frame format */
@@ -177,10 +211,14 @@ struct comp_zc_func_map {
 
 #if CONFIG_IPC_MAJOR_3
 /**
- * \brief Retrievies volume processing function.
+ * \brief Retrievies volume processing function from a map.
  * \param[in,out] dev Volume base component device.
+ * \param[in] map Map of processing functions.
+ * \param[in] count Number of functions in map.
  */
-static inline vol_scale_func vol_get_processing_function(struct comp_dev *dev)
+static inline vol_scale_func vol_get_map_function(struct comp_dev *dev,
+						  const struct comp_func_map *map,
+						  size_t count)
 {
 	struct comp_buffer *sinkb;
 	int i;
@@ -189,37 +227,61 @@ static inline vol_scale_func vol_get_processing_function(struct comp_dev *dev)
 				source_list);
 
 	/* map the volume function for source and sink buffers */
-	for (i = 0; i < func_count; i++) {
-		if (sinkb->stream.frame_fmt != func_map[i].frame_fmt)
+	for (i = 0; i < count; i++) {
+		if (sinkb->stream.frame_fmt != map[i].frame_fmt)
 			continue;
 
-		return func_map[i].func;
+		return map[i].func;
 	}
 
 	return NULL;
 }
 #else
 /**
- * \brief Retrievies volume processing function.
+ * \brief Retrievies volume processing function from a map.
  * \param[in,out] dev Volume base component device.
+ * \param[in] map Map of processing functions.
+ * \param[in] count Number of functions in map.
  */
-static inline vol_scale_func vol_get_processing_function(struct comp_dev *dev)
+static inline vol_scale_func vol_get_map_function(struct comp_dev *dev,
+						  const struct comp_func_map *map,
+						  size_t count)
 {
 	struct vol_data *cd = comp_get_drvdata(dev);
 
 	switch (cd->base.audio_fmt.depth) {
 	case IPC4_DEPTH_16BIT:
-		return func_map[0].func;
+		return map[0].func;
 	case IPC4_DEPTH_32BIT:
-		return func_map[2].func;
+		return map[2].func;
 	default:
-		comp_err(dev, "vol_get_processing_function(): unsupported depth %d",
+		comp_err(dev, "vol_get_map_function(): unsupported depth %d",
 			 cd->base.audio_fmt.depth);
 		return NULL;
 	}
 }
 #endif
 
+/**
+ * \brief Retrievies volume processing function.
+ * \param[in,out] dev Volume base component device.
+ */
+static inline vol_scale_func vol_get_processing_function(struct comp_dev *dev)
+{
+	return vol_get_map_function(dev, func_map, func_count);
+}
+
+#if CONFIG_COMP_VOLUME_SMOOTH_RAMP
+/**
+ * \brief Retrievies volume processing function for interpolated gain.
+ * \param[in,out] dev Volume base component device.
+ */
+static inline vol_scale_func vol_get_ramp_processing_function(struct comp_dev *dev)
+{
+	return vol_get_map_function(dev, ramp_func_map, ramp_func_count);
+}
+#endif
+
 static inline void peak_vol_update(struct vol_data *cd)
 {
 #if CONFIG_COMP_PEAK_VOL
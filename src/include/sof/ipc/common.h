@@ -61,6 +61,28 @@ extern struct tr_ctx ipc_tr;
 #define ipc_get_ppl_sink_comp(ipc, ppl_id) \
 	ipc_get_ppl_comp(ipc, ppl_id, PPL_DIR_DOWNSTREAM)
 
+/* number of hash buckets for component devices indexed by ID */
+#define IPC_COMP_HASH_BITS	6
+#define IPC_COMP_HASH_SIZE	(1 << IPC_COMP_HASH_BITS)
+
+/* number of hash buckets for component devices indexed by pipeline ID */
+#define IPC_PPL_HASH_BITS	5
+#define IPC_PPL_HASH_SIZE	(1 << IPC_PPL_HASH_BITS)
+
+/* multiplicative hash spreads both sequential IDs and IPC4 ID fields */
+static inline uint32_t ipc_comp_hash(uint32_t id, int bits)
+{
+	return (id * 2654435761u) >> (32 - bits);
+}
+
+/* Returns hash bucket of the component devices with ID */
+#define ipc_comp_bucket(ipc, id) \
+	(&(ipc)->comp_hash[ipc_comp_hash(id, IPC_COMP_HASH_BITS)])
+
+/* Returns hash bucket of the component devices of pipeline */
+#define ipc_ppl_bucket(ipc, ppl_id) \
+	(&(ipc)->ppl_hash[ipc_comp_hash(ppl_id, IPC_PPL_HASH_BITS)])
+
 #define IPC_TASK_INLINE		BIT(0)
 #define IPC_TASK_IN_THREAD	BIT(1)
 #define IPC_TASK_SECONDARY_CORE	BIT(2)
@@ -78,6 +100,8 @@ struct ipc {
 	unsigned int core;		/* core, processing the IPC */
 
 	struct list_item comp_list;	/* list of component devices */
+	struct list_item comp_hash[IPC_COMP_HASH_SIZE];	/* devices by ID */
+	struct list_item ppl_hash[IPC_PPL_HASH_SIZE];	/* devices by pipeline ID */
 
 	/* processing task */
 	struct task ipc_task;
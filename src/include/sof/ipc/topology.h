@@ -81,6 +81,8 @@ struct ipc_comp_dev {
 
 	/* lists */
 	struct list_item list;		/* list in components */
+	struct list_item hash_list;	/* list in ID hash bucket */
+	struct list_item ppl_list;	/* list in pipeline ID hash bucket */
 };
 
 /**
@@ -155,6 +157,19 @@ int ipc_comp_connect(struct ipc *ipc, ipc_pipe_comp_connect *connect);
  */
 int ipc_comp_disconnect(struct ipc *ipc, ipc_pipe_comp_connect *connect);
 
+/**
+ * \brief Add component device to the list and to the ID indexes.
+ * @param ipc The global IPC context.
+ * @param icd The component device, its ID and pipeline ID must be set.
+ */
+void ipc_comp_dev_add(struct ipc *ipc, struct ipc_comp_dev *icd);
+
+/**
+ * \brief Remove component device from the list and from the ID indexes.
+ * @param icd The component device.
+ */
+void ipc_comp_dev_del(struct ipc_comp_dev *icd);
+
 /**
  * \brief Get component device from component ID.
  * @param ipc The global IPC context.
@@ -13,6 +13,7 @@
 #include <sof/lib/alloc.h>
 #include <sof/lib/cache.h>
 #include <sof/lib/memory.h>
+#include <sof/list.h>
 #include <sof/sof.h>
 #include <sof/spinlock.h>
 
@@ -25,8 +26,13 @@ struct dma_sg_config;
 struct mm_info {
 	uint32_t used;
 	uint32_t free;
+	uint32_t slab_used;	/* bytes of objects allocated from slab pages */
+	uint32_t slab_free;	/* bytes of free objects in slab pages */
 };
 
+/* block_hdr used value of a block that is a slab page */
+#define BLOCK_USED_SLAB		2
+
 struct block_hdr {
 	uint16_t size;		/* size in blocks for continuous allocation */
 	uint16_t used;		/* usage flags for page */
@@ -59,6 +65,31 @@ struct mm_heap {
 	struct mm_info info;
 };
 
+#if CONFIG_MM_SLAB
+/* Slab caches of small runtime objects per runtime zone */
+#define MM_SLAB_CLASSES		2
+#define MM_SLAB_PAGE_SIZE	1024
+#define MM_SLAB_PAGE_RESERVE	1	/* page size blocks left to other users */
+#if CONFIG_CORE_COUNT > 1
+#define MM_SLAB_ZONES		2	/* runtime and runtime shared */
+#else
+#define MM_SLAB_ZONES		1
+#endif
+
+struct mm_slab_info {
+	uint32_t pages;		/* number of slab pages */
+	uint32_t used;		/* number of allocated objects */
+	uint32_t free;		/* number of free objects in pages */
+};
+
+struct mm_slab_cache {
+	struct list_item partial;	/* pages with free objects */
+	uint16_t obj_size;		/* object size in bytes */
+	uint16_t obj_count;		/* objects per page */
+	struct mm_slab_info info;
+};
+#endif
+
 /* heap block memory map */
 struct mm {
 	/* system heap - used during init cannot be freed */
@@ -76,6 +107,11 @@ struct mm {
 	/* general component buffer heap */
 	struct mm_heap buffer[PLATFORM_HEAP_BUFFER];
 
+#if CONFIG_MM_SLAB
+	/* slab caches for objects of the size classes */
+	struct mm_slab_cache slab[MM_SLAB_ZONES][MM_SLAB_CLASSES];
+#endif
+
 	struct mm_info total;
 	uint32_t heap_trace_updated;	/* updates that can be presented */
 	struct k_spinlock lock;	/* all allocs and frees are atomic */
@@ -102,6 +138,16 @@ void heap_trace(struct mm_heap *heap, int size);
  * @return error code or zero
  */
 int heap_info(enum mem_zone zone, int index, struct mm_info *out);
+
+#if CONFIG_MM_SLAB
+/** Fetch runtime information about slab cache
+ * @param zone SOF_MEM_ZONE_RUNTIME or SOF_MEM_ZONE_RUNTIME_SHARED.
+ * @param index size class index
+ * @param out output variable
+ * @return object size of the class or error code
+ */
+int heap_slab_info(enum mem_zone zone, int index, struct mm_slab_info *out);
+#endif
 #endif
 
 /* retrieve memory map pointer */
@@ -37,11 +37,30 @@ enum notify_id {
 	NOTIFIER_ID_COUNT
 };
 
+/** \brief Caller hash table size bits when first needed. */
+#define NOTIFIER_CALLER_MIN_BITS	3
+
 struct notify {
-	struct list_item list[NOTIFIER_ID_COUNT]; /* list of callback handles */
+	struct list_item list[NOTIFIER_ID_COUNT]; /* handles without caller filter */
+	/* handles with caller filter, hashed by caller and notify_id,
+	 * allocated on first use and grown with the number of handles
+	 */
+	struct list_item *caller_list;
+	uint32_t caller_bits;	/* log2 of caller_list buckets */
+	uint32_t caller_count;	/* handles in caller_list */
+	uint16_t caller_type_count[NOTIFIER_ID_COUNT]; /* per notify_id */
+	uint32_t notify_depth;	/* caller_list walks in progress */
 	struct k_spinlock lock;	/* list lock */
 };
 
+/** \brief Hash of callbacks registered with caller filter. */
+static inline uint32_t notifier_caller_hash(const void *caller,
+					    enum notify_id type)
+{
+	/* Fibonacci hashing, callers are mostly aligned heap objects */
+	return ((uint32_t)(uintptr_t)caller + type) * 2654435761u;
+}
+
 struct notify_data {
 	const void *caller;
 	enum notify_id type;
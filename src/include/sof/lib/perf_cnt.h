@@ -15,6 +15,8 @@
 #define __SOF_LIB_PERF_CNT_H__
 
 #include <sof/drivers/timer.h>
+#include <stdint.h>
+#include <string.h>
 
 struct perf_cnt_data {
 	uint32_t plat_ts;
@@ -124,4 +126,88 @@ struct perf_cnt_data {
 #define perf_cnt_stamp(pcd, trace_m, arg)
 #endif
 
+/** \brief Number of histogram bins in the cycle profile. */
+#define PERF_CNT_PROF_BINS	16
+
+/** \brief Histogram bin width is 1/PERF_CNT_PROF_BIN_DIV of the budget. */
+#define PERF_CNT_PROF_BIN_DIV	8
+
+/**
+ * Cycle profile of a periodic task. Histogram bins cover 0..2x of the per
+ * period budget, the last bin also collects all the longer runs.
+ */
+struct perf_cnt_profile {
+	uint32_t budget;		/**< cycles available per period */
+	uint32_t count;			/**< number of recorded periods */
+	uint64_t frames;		/**< number of processed frames */
+	uint64_t cycles_total;		/**< sum of all recorded cycles */
+	uint32_t cycles_peak;		/**< longest recorded period */
+	uint32_t deadline_misses;	/**< periods longer than budget */
+	uint32_t hist[PERF_CNT_PROF_BINS];	/**< cycles histogram */
+};
+
+/** \brief Clears the profile and sets cycles budget per period. */
+static inline void perf_cnt_profile_init(struct perf_cnt_profile *prof,
+					 uint32_t budget)
+{
+	memset(prof, 0, sizeof(*prof));
+	prof->budget = budget;
+}
+
+/** \brief Adds one period of cycles and processed frames to the profile. */
+static inline void perf_cnt_profile_record(struct perf_cnt_profile *prof,
+					   uint32_t cycles, uint32_t frames)
+{
+	uint32_t bin = PERF_CNT_PROF_BINS - 1;
+
+	prof->count++;
+	prof->frames += frames;
+	prof->cycles_total += cycles;
+	if (cycles > prof->cycles_peak)
+		prof->cycles_peak = cycles;
+
+	/* no budget known, keep totals only */
+	if (!prof->budget)
+		return;
+
+	if (cycles > prof->budget)
+		prof->deadline_misses++;
+
+	if ((uint64_t)cycles * PERF_CNT_PROF_BIN_DIV <
+	    (uint64_t)prof->budget * (PERF_CNT_PROF_BINS - 1))
+		bin = (uint64_t)cycles * PERF_CNT_PROF_BIN_DIV / prof->budget;
+
+	prof->hist[bin]++;
+}
+
+/** \brief Average cycles per period. */
+static inline uint32_t perf_cnt_profile_avg(const struct perf_cnt_profile *prof)
+{
+	return prof->count ? prof->cycles_total / prof->count : 0;
+}
+
+/**
+ * \brief 99th percentile of cycles per period.
+ *
+ * Resolution is the histogram bin width, the upper edge of the bin is
+ * returned. Falls back to peak when the percentile is in the last bin.
+ */
+static inline uint32_t perf_cnt_profile_p99(const struct perf_cnt_profile *prof)
+{
+	uint64_t sum = 0;
+	int i;
+
+	if (!prof->budget)
+		return prof->cycles_peak;
+
+	for (i = 0; i < PERF_CNT_PROF_BINS - 1; i++) {
+		sum += prof->hist[i];
+		if (sum * 100 >= (uint64_t)prof->count * 99)
+			return (uint64_t)prof->budget * (i + 1) /
+				PERF_CNT_PROF_BIN_DIV;
+	}
+
+	return prof->cycles_peak;
+}
+
 #endif /* __SOF_LIB_PERF_CNT_H__ */
@@ -18,12 +18,27 @@ struct icomplex32 {
 	int32_t imag;
 };
 
+struct icomplex16 {
+	int16_t real;
+	int16_t imag;
+};
+
 struct fft_plan {
 	uint32_t size;	/* fft size */
 	uint32_t len;	/* fft length in exponent of 2 */
-	uint32_t *bit_reverse_idx;	/* pointer to bit reverse index array */
+	uint32_t bit_reverse_shift;	/* shift for the shared bit reverse index */
 	struct icomplex32 *inb;	/* pointer to input integer complex buffer */
 	struct icomplex32 *outb;/* pointer to output integer complex buffer */
+	struct icomplex16 *inb16;	/* pointer to input 16 bit complex buffer */
+	struct icomplex16 *outb16;	/* pointer to output 16 bit complex buffer */
+};
+
+/* real input FFT of size N, computed with a N/2 points complex FFT */
+struct fft_plan_real {
+	uint32_t size;	/* real fft size N */
+	struct fft_plan plan;	/* N/2 points complex fft */
+	int32_t *inb;	/* pointer to N real samples */
+	struct icomplex32 *outb;/* pointer to N/2 + 1 complex bins */
 };
 
 /*
@@ -74,7 +89,13 @@ static inline void icomplex_shift(struct icomplex32 *input, int32_t n, struct ic
 
 /* interfaces of the library */
 struct fft_plan *fft_plan_new(struct icomplex32 *inb, struct icomplex32 *outb, uint32_t size);
+struct fft_plan *fft_plan_new_16(struct icomplex16 *inb, struct icomplex16 *outb, uint32_t size);
 void fft_plan_free(struct fft_plan *plan);
 void fft_execute(struct fft_plan *plan, bool ifft);
+void fft_execute_16(struct fft_plan *plan, bool ifft);
+
+struct fft_plan_real *fft_plan_new_real(int32_t *inb, struct icomplex32 *outb, uint32_t size);
+void fft_plan_free_real(struct fft_plan_real *plan);
+void fft_execute_real(struct fft_plan_real *plan, bool ifft);
 
 #endif /* __SOF_FFT_H__ */
@@ -0,0 +1,108 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright(c) 2022 Intel Corporation. All rights reserved.
+ *
+ */
+
+#ifndef __SOF_MATH_FIR_FFT_H__
+#define __SOF_MATH_FIR_FFT_H__
+
+#include <sof/audio/format.h>
+#include <sof/math/fft.h>
+#include <user/fir.h>
+#include <stdint.h>
+
+/*
+ * Uniformly partitioned overlap-save FFT convolution for long FIR filters.
+ *
+ * The first block of taps is computed in direct form so the filter has no
+ * added latency. The rest of the taps are split to partitions of block size
+ * that are convolved in frequency domain with real FFTs of two blocks size.
+ * The tail output for a block is computed when the previous input block has
+ * been received, so it is ready when the direct form part needs it.
+ */
+
+#define FIR_FFT_MAX_LENGTH	4096	/* Max number of taps */
+#define FIR_FFT_BLOCK_MIN	16	/* Min partition size */
+#define FIR_FFT_BLOCK_MAX	(FFT_SIZE_MAX / 2) /* Max partition size */
+
+/* FFT and work buffers, shared by all filters that use the same block size */
+struct fir_fft_plan {
+	struct fft_plan_real *fft;	/* Real FFT of two blocks */
+	int32_t *time;			/* Time domain work, 2 * block samples */
+	struct icomplex32 *freq;	/* Frequency domain work, block + 1 bins */
+	int64_t *acc;			/* Accumulator for the bins products */
+	int block;			/* Partition size */
+	int block_len;			/* Partition size exponent of 2 */
+};
+
+/* Filter response, can be shared by many channels */
+struct fir_fft_coef {
+	int taps;			/* Number of FIR taps */
+	int head_taps;			/* Number of taps in direct form */
+	int partitions;			/* Number of FFT partitions */
+	int out_shift;			/* Amount of right shifts at output */
+	int16_t *head;			/* Pointer to FIR coefficients */
+	struct icomplex32 *h;		/* Spectra of the partitions */
+};
+
+/* Filter state for one channel */
+struct fir_fft_state {
+	const struct fir_fft_coef *coef; /* Response, NULL for bypass */
+	int32_t *x;			/* Previous and current input block */
+	int32_t *y;			/* Tail output for current block */
+	struct icomplex32 *fdl;		/* Frequency domain delay line */
+	int fdl_idx;			/* Index of newest spectrum in fdl */
+	int xi;				/* Index in current block */
+};
+
+int fir_fft_block_size(int taps);
+
+int fir_fft_plan_init(struct fir_fft_plan *plan, int block);
+
+void fir_fft_plan_free(struct fir_fft_plan *plan);
+
+int fir_fft_coef_size(struct fir_fft_plan *plan, struct sof_fir_coef_data *config);
+
+int fir_fft_init_coef(struct fir_fft_plan *plan, struct fir_fft_coef *coef,
+		      struct sof_fir_coef_data *config, int32_t **data);
+
+int fir_fft_delay_size(struct fir_fft_plan *plan, struct sof_fir_coef_data *config);
+
+void fir_fft_init_delay(struct fir_fft_plan *plan, struct fir_fft_state *fir,
+			const struct fir_fft_coef *coef, int32_t **data);
+
+void fir_fft_reset(struct fir_fft_state *fir);
+
+void fir_fft_block(struct fir_fft_plan *plan, struct fir_fft_state *fir);
+
+/* Filter one sample, the FFT part is run when an input block is complete */
+static inline int32_t fir_fft_32x16(struct fir_fft_plan *plan, struct fir_fft_state *fir,
+				    int32_t x)
+{
+	const struct fir_fft_coef *coef = fir->coef;
+	int32_t *data;
+	int64_t y = 0;
+	int32_t tail;
+	int i;
+
+	/* Bypass is set with coef set to NULL. */
+	if (!coef)
+		return x;
+
+	data = &fir->x[plan->block + fir->xi];
+	*data = x;
+
+	/* Direct form for the first block of taps */
+	for (i = 0; i < coef->head_taps; i++)
+		y += (int64_t)coef->head[i] * data[-i];
+
+	tail = fir->y[fir->xi];
+	if (++fir->xi == plan->block)
+		fir_fft_block(plan, fir);
+
+	/* Q2.46 -> Q2.31, add tail and saturate to Q1.31 */
+	return sat_int32((y >> (15 + coef->out_shift)) + tail);
+}
+
+#endif /* __SOF_MATH_FIR_FFT_H__ */
@@ -0,0 +1,120 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright(c) 2022 Intel Corporation. All rights reserved.
+ */
+
+#ifndef __SOF_MATH_IIR_DF2T_BLOCK_H__
+#define __SOF_MATH_IIR_DF2T_BLOCK_H__
+
+#include <sof/math/iir_df2t.h>
+#include <stdint.h>
+
+/* The block filter is built for the generic code, and for HiFi3 only with
+ * the channel pair version. Without it the users keep their single channel
+ * filters, iir_df2t_block_size() returns 0 and the other functions are empty.
+ */
+#if IIR_GENERIC || CONFIG_MATH_IIR_DF2T_BLOCK_HIFI3
+#define IIR_DF2T_BLOCK	1
+#else
+#define IIR_DF2T_BLOCK	0
+#endif
+
+/* Max frames per iir_df2t_block() call, callers split longer periods */
+#define IIR_DF2T_BLOCK_FRAMES	32
+
+/* Channels are processed in pairs, odd channel counts get a padding lane */
+#define IIR_DF2T_BLOCK_LANES	2
+
+/* Size in int32_t of a [frame][lane] data block for nch channels */
+#define IIR_DF2T_BLOCK_SAMPLES(nch) \
+	(IIR_DF2T_BLOCK_FRAMES * IIR_DF2T_BLOCK_NLANES(nch))
+
+/* Number of lanes for nch channels */
+#define IIR_DF2T_BLOCK_NLANES(nch) \
+	(((nch) + IIR_DF2T_BLOCK_LANES - 1) & ~(IIR_DF2T_BLOCK_LANES - 1))
+
+/*
+ * Multichannel DF2T IIR that runs one biquad at a time over a block of
+ * frames for all channels. The coefficients and delays are stored channel
+ * interleaved, so a biquad's coefficients stay in registers for the whole
+ * block and channel pairs are computed with SIMD. The output is identical
+ * to iir_df2t() of the same platform for every channel.
+ *
+ * The channels may have different coefficients but must share the number
+ * of sections and sections in series. Channels in bypass are allowed, they
+ * are run through unity gain sections.
+ */
+struct iir_df2t_block {
+	int channels;
+	int lanes;		/* channels rounded up to IIR_DF2T_BLOCK_LANES */
+	int biquads;		/* sections total */
+	int biquads_in_series;	/* sections in series per parallel branch */
+	int64_t *delay;		/* [biquad][IIR_DF2T_NUM_DELAYS][lane] */
+	int32_t *coef;		/* [biquad][SOF_EQ_IIR_NBIQUAD_DF2T][lane] */
+	int32_t *sum;		/* [frame][lane] parallel branches sum, or NULL */
+};
+
+#if IIR_DF2T_BLOCK
+
+/**
+ * \brief Returns bytes needed by iir_df2t_block_init() for the channel
+ *	  filters or -EINVAL if they can't run as one block filter.
+ * \param[in] iir Initialized single channel filters.
+ * \param[in] nch Number of channels.
+ */
+int iir_df2t_block_size(struct iir_state_df2t *iir, int nch);
+
+/**
+ * \brief Copies the channel filters coefficients to the block filter.
+ * \param[out] blk Block filter.
+ * \param[in] iir Initialized single channel filters.
+ * \param[in] nch Number of channels.
+ * \param[in,out] data Memory of iir_df2t_block_size() bytes, 8 bytes
+ *		  aligned. Advanced past the used memory.
+ */
+void iir_df2t_block_init(struct iir_df2t_block *blk, struct iir_state_df2t *iir,
+			 int nch, void **data);
+
+/**
+ * \brief Clears the block filter delay lines.
+ * \param[in,out] blk Block filter.
+ */
+void iir_df2t_block_reset(struct iir_df2t_block *blk);
+
+/**
+ * \brief Filters a block in place.
+ * \param[in,out] blk Block filter.
+ * \param[in,out] data Q1.31 samples as [frame][lane].
+ * \param[in] frames Number of frames, max IIR_DF2T_BLOCK_FRAMES.
+ */
+void iir_df2t_block(struct iir_df2t_block *blk, int32_t *data, int frames);
+
+/* One biquad over a block for all lanes, provided by generic or HiFi3 code */
+void iir_df2t_block_biquad(const int32_t *coef, int64_t *delay, int32_t *data,
+			   int frames, int lanes);
+
+#else
+
+static inline int iir_df2t_block_size(struct iir_state_df2t *iir, int nch)
+{
+	return 0;
+}
+
+static inline void iir_df2t_block_init(struct iir_df2t_block *blk,
+				       struct iir_state_df2t *iir, int nch,
+				       void **data)
+{
+}
+
+static inline void iir_df2t_block_reset(struct iir_df2t_block *blk)
+{
+}
+
+static inline void iir_df2t_block(struct iir_df2t_block *blk, int32_t *data,
+				  int frames)
+{
+}
+
+#endif /* IIR_DF2T_BLOCK */
+
+#endif /* __SOF_MATH_IIR_DF2T_BLOCK_H__ */
@@ -10,24 +10,35 @@
 
 #include <stdint.h>
 
+/* Q1.31 filter output to 16 and 24 bit samples */
+static inline int16_t iir_df2t_out_s16(int32_t y)
+{
+	return sat_int16(Q_SHIFT_RND(y, 31, 15));
+}
+
+static inline int32_t iir_df2t_out_s24(int32_t y)
+{
+	return sat_int24(Q_SHIFT_RND(y, 31, 23));
+}
+
 static inline int16_t iir_df2t_s16(struct iir_state_df2t *iir, int16_t x)
 {
-	return sat_int16(Q_SHIFT_RND(iir_df2t(iir, ((int32_t)x) << 16), 31, 15));
+	return iir_df2t_out_s16(iir_df2t(iir, ((int32_t)x) << 16));
 }
 
 static inline int32_t iir_df2t_s24(struct iir_state_df2t *iir, int32_t x)
 {
-	return sat_int24(Q_SHIFT_RND(iir_df2t(iir, x << 8), 31, 23));
+	return iir_df2t_out_s24(iir_df2t(iir, x << 8));
 }
 
 static inline int16_t iir_df2t_s32_s16(struct iir_state_df2t *iir, int32_t x)
 {
-	return sat_int16(Q_SHIFT_RND(iir_df2t(iir, x), 31, 15));
+	return iir_df2t_out_s16(iir_df2t(iir, x));
 }
 
 static inline int32_t iir_df2t_s32_s24(struct iir_state_df2t *iir, int32_t x)
 {
-	return sat_int24(Q_SHIFT_RND(iir_df2t(iir, x), 31, 23));
+	return iir_df2t_out_s24(iir_df2t(iir, x));
 }
 
 #endif /* __IIR_DF2T_GENERIC_H__ */
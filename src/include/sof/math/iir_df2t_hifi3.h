@@ -11,32 +11,39 @@
 #include <xtensa/tie/xt_hifi3.h>
 #include <stdint.h>
 
-static inline int16_t iir_df2t_s16(struct iir_state_df2t *iir, int16_t x)
+/* Q1.31 filter output to 16 and 24 bit samples */
+static inline int16_t iir_df2t_out_s16(int32_t x)
 {
-	ae_f32x2 y = iir_df2t(iir, ((int32_t)x) << 16);
+	ae_f32x2 y = x;
 
 	return AE_ROUND16X4F32SSYM(y, y);
 }
 
-static inline int32_t iir_df2t_s24(struct iir_state_df2t *iir, int32_t x)
+static inline int32_t iir_df2t_out_s24(int32_t x)
 {
-	ae_f32x2 y = iir_df2t(iir, x << 8);
+	ae_f32x2 y = x;
 
 	return AE_SRAI32(AE_SLAI32S(AE_SRAI32R(y, 8), 8), 8);
 }
 
-static inline int16_t iir_df2t_s32_s16(struct iir_state_df2t *iir, int32_t x)
+static inline int16_t iir_df2t_s16(struct iir_state_df2t *iir, int16_t x)
 {
-	ae_f32x2 y = iir_df2t(iir, x);
+	return iir_df2t_out_s16(iir_df2t(iir, ((int32_t)x) << 16));
+}
 
-	return AE_ROUND16X4F32SSYM(y, y);
+static inline int32_t iir_df2t_s24(struct iir_state_df2t *iir, int32_t x)
+{
+	return iir_df2t_out_s24(iir_df2t(iir, x << 8));
 }
 
-static inline int32_t iir_df2t_s32_s24(struct iir_state_df2t *iir, int32_t x)
+static inline int16_t iir_df2t_s32_s16(struct iir_state_df2t *iir, int32_t x)
 {
-	ae_f32x2 y = iir_df2t(iir, x);
+	return iir_df2t_out_s16(iir_df2t(iir, x));
+}
 
-	return AE_SRAI32(AE_SLAI32S(AE_SRAI32R(y, 8), 8), 8);
+static inline int32_t iir_df2t_s32_s24(struct iir_state_df2t *iir, int32_t x)
+{
+	return iir_df2t_out_s24(iir_df2t(iir, x));
 }
 
 #endif /* __IIR_DF2T_HIFI3_H__ */
@@ -8,6 +8,8 @@
 #ifndef __SOF_TRACE_DMA_TRACE_H__
 #define __SOF_TRACE_DMA_TRACE_H__
 
+#include <sof/atomic.h>
+#include <sof/bit.h>
 #include <sof/lib/dma.h>
 #include <sof/schedule/task.h>
 #include <sof/sof.h>
@@ -27,6 +29,31 @@ struct dma_trace_buf {
 	uint32_t avail;		/* bytes available to read */
 };
 
+#if CONFIG_DMA_TRACE_PER_CORE
+/* size of the trace ring of every core */
+#define DMA_TRACE_CORE_SIZE		(DMA_TRACE_LOCAL_SIZE / 2)
+
+/* largest entry accepted in a core trace ring */
+#define DMA_TRACE_CORE_ENTRY_MAX	64
+
+/* set in dma_trace_core_buf::users once the ring is being freed */
+#define DMA_TRACE_CORE_CLOSED		BIT(16)
+
+/*
+ * Trace ring of one core. Only the owning core writes entries and only
+ * trace_work() reads them, each entry is preceded by its length. The
+ * positions run modulo twice the ring size, like the lock-free buffers.
+ */
+struct dma_trace_core_buf {
+	atomic_t w_pos;			/* published by the owning core */
+	atomic_t r_pos;			/* published by trace_work() */
+	atomic_t users;			/* writers in progress and closed flag */
+	char *addr;			/* ring base address */
+	uint32_t dropped_entries;	/* entries dropped by the owning core */
+	uint32_t reported_entries;	/* dropped entries already reported */
+};
+#endif
+
 struct dma_trace_data {
 	struct dma_sg_config config;
 	struct dma_trace_buf dmatb;
@@ -47,6 +74,10 @@ struct dma_trace_data {
 				   */
 	uint32_t dropped_entries; /* amount of dropped entries */
 	struct k_spinlock lock; /* dma trace lock */
+#if CONFIG_DMA_TRACE_PER_CORE
+	struct dma_trace_core_buf core_buf[CONFIG_CORE_COUNT];
+	atomic_t core_flush; /* secondary core ring is half full */
+#endif
 };
 
 int dma_trace_init_early(struct sof *sof);
@@ -73,6 +104,14 @@ static inline struct dma_trace_data *dma_trace_data_get(void)
 	return sof_get()->dmat;
 }
 
+#if CONFIG_DMA_TRACE_PER_CORE
+/* total number of trace entries dropped by the core since boot */
+static inline uint32_t dma_trace_core_dropped(const struct dma_trace_data *d, int core)
+{
+	return d->core_buf[core].dropped_entries;
+}
+#endif
+
 static inline uint32_t dtrace_calc_buf_margin(struct dma_trace_buf *buffer)
 {
 	return (char *)buffer->end_addr - (char *)buffer->w_ptr;
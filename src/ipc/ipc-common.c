@@ -78,17 +78,35 @@ int ipc_process_on_core(uint32_t core, bool blocking)
 
 /*
  * Components, buffers and pipelines all use the same set of monotonic ID
- * numbers passed in by the host. They are stored in different lists, hence
- * more than 1 list may need to be searched for the corresponding component.
+ * numbers passed in by the host. They are stored in one list, and indexed
+ * in hash tables by the ID and by the pipeline ID. The hash buckets keep
+ * the list order so the lookups return the same device as a list walk.
  */
 
+void ipc_comp_dev_add(struct ipc *ipc, struct ipc_comp_dev *icd)
+{
+	uint32_t ppl_id = ipc_comp_pipe_id(icd);
+
+	list_item_append(&icd->list, &ipc->comp_list);
+	list_item_append(&icd->hash_list, ipc_comp_bucket(ipc, icd->id));
+	list_item_append(&icd->ppl_list, ipc_ppl_bucket(ipc, ppl_id));
+}
+
+void ipc_comp_dev_del(struct ipc_comp_dev *icd)
+{
+	list_item_del(&icd->list);
+	list_item_del(&icd->hash_list);
+	list_item_del(&icd->ppl_list);
+}
+
 struct ipc_comp_dev *ipc_get_comp_by_id(struct ipc *ipc, uint32_t id)
 {
+	struct list_item *bucket = ipc_comp_bucket(ipc, id);
 	struct ipc_comp_dev *icd;
 	struct list_item *clist;
 
-	list_for_item(clist, &ipc->comp_list) {
-		icd = container_of(clist, struct ipc_comp_dev, list);
+	list_for_item(clist, bucket) {
+		icd = container_of(clist, struct ipc_comp_dev, hash_list);
 		if (icd->id == id)
 			return icd;
 
@@ -100,11 +118,12 @@ struct ipc_comp_dev *ipc_get_comp_by_id(struct ipc *ipc, uint32_t id)
 struct ipc_comp_dev *ipc_get_comp_by_ppl_id(struct ipc *ipc, uint16_t type,
 					    uint32_t ppl_id)
 {
+	struct list_item *bucket = ipc_ppl_bucket(ipc, ppl_id);
 	struct ipc_comp_dev *icd;
 	struct list_item *clist;
 
-	list_for_item(clist, &ipc->comp_list) {
-		icd = container_of(clist, struct ipc_comp_dev, list);
+	list_for_item(clist, bucket) {
+		icd = container_of(clist, struct ipc_comp_dev, ppl_list);
 		if (icd->type != type) {
 			continue;
 		}
@@ -124,14 +143,15 @@ struct ipc_comp_dev *ipc_get_comp_by_ppl_id(struct ipc *ipc, uint16_t type,
 struct ipc_comp_dev *ipc_get_ppl_comp(struct ipc *ipc,
 				      uint32_t pipeline_id, int dir)
 {
+	struct list_item *bucket = ipc_ppl_bucket(ipc, pipeline_id);
 	struct ipc_comp_dev *icd;
 	struct comp_buffer *buffer;
 	struct comp_dev *buff_comp;
 	struct list_item *clist;
 
 	/* first try to find the module in the pipeline */
-	list_for_item(clist, &ipc->comp_list) {
-		icd = container_of(clist, struct ipc_comp_dev, list);
+	list_for_item(clist, bucket) {
+		icd = container_of(clist, struct ipc_comp_dev, ppl_list);
 		if (icd->type != COMP_TYPE_COMPONENT) {
 			continue;
 		}
@@ -147,8 +167,8 @@ struct ipc_comp_dev *ipc_get_ppl_comp(struct ipc *ipc,
 	}
 
 	/* it's connected pipeline, so find the connected module */
-	list_for_item(clist, &ipc->comp_list) {
-		icd = container_of(clist, struct ipc_comp_dev, list);
+	list_for_item(clist, bucket) {
+		icd = container_of(clist, struct ipc_comp_dev, ppl_list);
 		if (icd->type != COMP_TYPE_COMPONENT) {
 			continue;
 		}
@@ -234,6 +254,8 @@ void ipc_schedule_process(struct ipc *ipc)
 
 int ipc_init(struct sof *sof)
 {
+	int i;
+
 	tr_info(&ipc_tr, "ipc_init()");
 
 	/* init ipc data */
@@ -244,6 +266,10 @@ int ipc_init(struct sof *sof)
 	k_spinlock_init(&sof->ipc->lock);
 	list_init(&sof->ipc->msg_list);
 	list_init(&sof->ipc->comp_list);
+	for (i = 0; i < IPC_COMP_HASH_SIZE; i++)
+		list_init(&sof->ipc->comp_hash[i]);
+	for (i = 0; i < IPC_PPL_HASH_SIZE; i++)
+		list_init(&sof->ipc->ppl_hash[i]);
 
 	return platform_ipc_init(sof->ipc);
 }
@@ -185,6 +185,11 @@ int comp_buffer_connect(struct comp_dev *comp, uint32_t comp_core,
 		/* set the buffer as a coherent object */
 		coherent_shared(buffer, c);
 
+#if CONFIG_BUFFER_SPSC
+		/* no locking between the single producer and consumer */
+		buffer_spsc_enable(buffer);
+#endif
+
 		if (!comp->is_shared)
 			comp = comp_make_shared(comp);
 	}
@@ -296,7 +301,7 @@ int ipc_comp_free(struct ipc *ipc, uint32_t comp_id)
 
 	icd->cd = NULL;
 
-	list_item_del(&icd->list);
+	ipc_comp_dev_del(icd);
 	rfree(icd);
 
 	return 0;
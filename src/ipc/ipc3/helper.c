@@ -373,7 +373,7 @@ int ipc_pipeline_new(struct ipc *ipc, ipc_pipe_new *_pipe_desc)
 	ipc_pipe->id = pipe_desc->comp_id;
 
 	/* add new pipeline to the list */
-	list_item_append(&ipc_pipe->list, &ipc->comp_list);
+	ipc_comp_dev_add(ipc, ipc_pipe);
 
 	return 0;
 }
@@ -406,7 +406,7 @@ int ipc_pipeline_free(struct ipc *ipc, uint32_t comp_id)
 		return ret;
 	}
 	ipc_pipe->pipeline = NULL;
-	list_item_del(&ipc_pipe->list);
+	ipc_comp_dev_del(ipc_pipe);
 	rfree(ipc_pipe);
 
 	return 0;
@@ -445,7 +445,7 @@ int ipc_buffer_new(struct ipc *ipc, const struct sof_ipc_buffer *desc)
 	ibd->id = desc->comp.id;
 
 	/* add new buffer to the list */
-	list_item_append(&ibd->list, &ipc->comp_list);
+	ipc_comp_dev_add(ipc, ibd);
 
 	return ret;
 }
@@ -515,7 +515,7 @@ int ipc_buffer_free(struct ipc *ipc, uint32_t buffer_id)
 
 	/* free buffer and remove from list */
 	buffer_free(ibd->cb);
-	list_item_del(&ibd->list);
+	ipc_comp_dev_del(ibd);
 	rfree(ibd);
 
 	return 0;
@@ -537,6 +537,11 @@ static int ipc_comp_to_buffer_connect(struct ipc_comp_dev *comp,
 		/* set the buffer as a coherent object */
 		coherent_shared(buffer->cb, c);
 
+#if CONFIG_BUFFER_SPSC
+		/* no locking between the single producer and consumer */
+		buffer_spsc_enable(buffer->cb);
+#endif
+
 		if (!comp->cd->is_shared)
 			comp->cd = comp_make_shared(comp->cd);
 	}
@@ -559,6 +564,11 @@ static int ipc_buffer_to_comp_connect(struct ipc_comp_dev *buffer,
 		/* set the buffer as a coherent object */
 		coherent_shared(buffer->cb, c);
 
+#if CONFIG_BUFFER_SPSC
+		/* no locking between the single producer and consumer */
+		buffer_spsc_enable(buffer->cb);
+#endif
+
 		if (!comp->cd->is_shared)
 			comp->cd = comp_make_shared(comp->cd);
 	}
@@ -641,7 +651,7 @@ int ipc_comp_new(struct ipc *ipc, ipc_comp *_comp)
 	icd->id = comp->id;
 
 	/* add new component to the list */
-	list_item_append(&icd->list, &ipc->comp_list);
+	ipc_comp_dev_add(ipc, icd);
 
 	return 0;
 }
@@ -20,10 +20,14 @@
 #include <sof/ipc/msg.h>
 #include <sof/ipc/driver.h>
 #include <sof/lib/mailbox.h>
+#include <sof/lib/notifier.h>
 #include <sof/lib/pm_runtime.h>
 #include <sof/lib/wait.h>
 #include <sof/math/numbers.h>
+#include <sof/schedule/schedule.h>
+#include <sof/spinlock.h>
 #include <sof/trace/trace.h>
+#include <sof/ut.h>
 #include <ipc4/error_status.h>
 #include <ipc4/header.h>
 #include <ipc4/module.h>
@@ -46,6 +50,16 @@ struct ipc4_msg_data {
 
 struct ipc4_msg_data msg_data;
 
+/* batch config waiting for the end of LL period */
+struct ipc4_batch_config {
+	char *data; /* mailbox payload, kept by host until reply */
+	uint32_t size;
+	int ret; /* status of deferred batch */
+	struct k_spinlock lock; /* shared by IPC and LL contexts */
+};
+
+static struct ipc4_batch_config batch_config;
+
 /* fw sends a fw ipc message to send the status of the last host ipc message */
 struct ipc_msg msg_reply;
 
@@ -159,8 +173,8 @@ static int propagate_state_to_ppl_comp(struct ipc *ipc, uint32_t ppl_id, int cmd
 	struct ipc_comp_dev *icd;
 	struct list_item *clist;
 
-	list_for_item(clist, &ipc->comp_list) {
-		icd = container_of(clist, struct ipc_comp_dev, list);
+	list_for_item(clist, ipc_ppl_bucket(ipc, ppl_id)) {
+		icd = container_of(clist, struct ipc_comp_dev, ppl_list);
 		if (icd->type != COMP_TYPE_COMPONENT)
 			continue;
 
@@ -177,6 +191,24 @@ static int propagate_state_to_ppl_comp(struct ipc *ipc, uint32_t ppl_id, int cmd
 	return ret;
 }
 
+/* is any pipeline scheduled by LL scheduler of this core running */
+static bool is_any_local_ppl_active(void)
+{
+	struct ipc_comp_dev *icd;
+	struct list_item *clist;
+
+	list_for_item(clist, &ipc_get()->comp_list) {
+		icd = container_of(clist, struct ipc_comp_dev, list);
+		if (icd->type != COMP_TYPE_PIPELINE || !cpu_is_me(icd->core))
+			continue;
+
+		if (icd->pipeline->status == COMP_STATE_ACTIVE)
+			return true;
+	}
+
+	return false;
+}
+
 static bool is_any_ppl_active(void)
 {
 	struct ipc_comp_dev *icd;
@@ -706,6 +738,155 @@ static int ipc4_set_large_config_module_instance(union ipc4_message_header *ipc4
 	return ret;
 }
 
+/* module and driver of batch config item, NULL dev for basefw */
+static int ipc4_batch_config_item_get(const struct ipc4_module_batch_config_item *item,
+				      const struct comp_driver **drv,
+				      struct comp_dev **dev)
+{
+	*drv = ipc4_get_comp_drv(item->module_id);
+	if (!*drv)
+		return IPC4_MOD_INVALID_ID;
+
+	if (!(*drv)->ops.set_large_config)
+		return IPC4_INVALID_REQUEST;
+
+	*dev = NULL;
+	if (item->module_id) {
+		*dev = ipc4_get_comp_dev(IPC4_COMP_ID(item->module_id, item->instance_id));
+		if (!*dev)
+			return IPC4_MOD_INVALID_ID;
+	}
+
+	return 0;
+}
+
+/* walks all items of batch, validates them and applies them if apply is set */
+static int ipc4_batch_config_walk(char *data, uint32_t size, bool apply)
+{
+	struct ipc4_module_batch_config_item *item;
+	const struct comp_driver *drv;
+	struct comp_dev *dev;
+	uint32_t offset = 0;
+	uint32_t item_size;
+	int ret;
+
+	while (offset < size) {
+		if (size - offset < sizeof(*item))
+			return IPC4_INVALID_CONFIG_DATA_LEN;
+
+		item = (struct ipc4_module_batch_config_item *)(data + offset);
+		item_size = sizeof(*item) + ALIGN_UP(item->data_size, sizeof(uint32_t));
+		if (item->data_size > size - offset - sizeof(*item))
+			return IPC4_INVALID_CONFIG_DATA_LEN;
+
+		ret = ipc4_batch_config_item_get(item, &drv, &dev);
+		if (ret)
+			return ret;
+
+		if (apply) {
+			ret = drv->ops.set_large_config(dev, item->large_param_id, true, true,
+							item->data_size, (char *)item->data);
+			if (ret < 0) {
+				tr_err(&ipc_tr, "failed to set batch config of module %x : %x",
+				       item->module_id, item->instance_id);
+				return IPC4_INVALID_RESOURCE_ID;
+			}
+		}
+
+		offset += MIN(item_size, size - offset);
+	}
+
+	return 0;
+}
+
+/* applies pending batch between two LL periods */
+static void ipc4_batch_config_ll_cb(void *arg, enum notify_id type, void *data)
+{
+	struct ipc4_batch_config *batch = arg;
+	k_spinlock_key_t key;
+
+	key = k_spin_lock(&batch->lock);
+
+	/* modules may have been deleted since the batch has been received */
+	batch->ret = ipc4_batch_config_walk(batch->data, batch->size, false);
+	if (!batch->ret)
+		batch->ret = ipc4_batch_config_walk(batch->data, batch->size, true);
+	else
+		tr_err(&ipc_tr, "batch config not applied, module deleted");
+
+	batch->data = NULL;
+	notifier_unregister(arg, NULL, NOTIFIER_ID_LL_POST_RUN);
+	ipc_compound_msg_done(SOF_IPC4_MOD_BATCH_CONFIG_SET, batch->ret);
+
+	k_spin_unlock(&batch->lock, key);
+}
+
+UT_STATIC int ipc4_batch_config_set(char *data, uint32_t size)
+{
+	void *sch = scheduler_get_data(SOF_SCHEDULE_LL_TIMER);
+	k_spinlock_key_t key;
+	int ret;
+
+	ret = ipc4_batch_config_walk(data, size, false);
+	if (ret)
+		return ret;
+
+	/* nothing is processed, apply right away */
+	if (!sch || !is_any_local_ppl_active())
+		return ipc4_batch_config_walk(data, size, true);
+
+	/* host waits for the reply, so the mailbox is not overwritten until then */
+	key = k_spin_lock(&batch_config.lock);
+	batch_config.data = data;
+	batch_config.size = size;
+	batch_config.ret = 0;
+	ret = notifier_register(&batch_config, sch, NOTIFIER_ID_LL_POST_RUN,
+				ipc4_batch_config_ll_cb, 0);
+	if (ret < 0)
+		batch_config.data = NULL;
+	else
+		ipc_compound_pre_start(SOF_IPC4_MOD_BATCH_CONFIG_SET);
+	k_spin_unlock(&batch_config.lock, key);
+
+	if (ret < 0)
+		return IPC4_OUT_OF_MEMORY;
+
+	ret = ipc_wait_for_compound_msg();
+
+	key = k_spin_lock(&batch_config.lock);
+	if (batch_config.data) {
+		/* LL has not run, the batch is not applied */
+		notifier_unregister(&batch_config, NULL, NOTIFIER_ID_LL_POST_RUN);
+		batch_config.data = NULL;
+		msg_data.delayed_reply--;
+	} else {
+		ret = batch_config.ret;
+	}
+	k_spin_unlock(&batch_config.lock, key);
+
+	return ret;
+}
+
+static int ipc4_set_batch_config_module_instance(union ipc4_message_header *ipc4)
+{
+	struct ipc4_module_large_config config;
+	uint32_t size;
+
+	memcpy_s(&config, sizeof(config), ipc4, sizeof(config));
+	size = config.data.r.data_off_size;
+	tr_dbg(&ipc_tr, "ipc4_set_batch_config_module_instance size %u", size);
+
+	if (config.header.r.module_id || config.header.r.instance_id)
+		return IPC4_INVALID_RESOURCE_ID;
+
+	if (size > SOF_IPC_MSG_MAX_SIZE)
+		return IPC4_INVALID_CONFIG_DATA_LEN;
+
+	dcache_invalidate_region((void *)MAILBOX_HOSTBOX_BASE, size);
+
+	return ipc4_batch_config_set((char *)MAILBOX_HOSTBOX_BASE, size);
+}
+
 static int ipc4_delete_module_instance(union ipc4_message_header *ipc4)
 {
 	struct ipc4_module_delete_instance module;
@@ -850,6 +1031,9 @@ static int ipc4_process_module_message(union ipc4_message_header *ipc4)
 	case SOF_IPC4_MOD_LARGE_CONFIG_SET:
 		ret = ipc4_set_large_config_module_instance(ipc4);
 		break;
+	case SOF_IPC4_MOD_BATCH_CONFIG_SET:
+		ret = ipc4_set_batch_config_module_instance(ipc4);
+		break;
 	case SOF_IPC4_MOD_BIND:
 		ret = ipc4_bind_module_instance(ipc4);
 		break;
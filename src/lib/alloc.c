@@ -445,6 +445,10 @@ static void *get_ptr_from_heap(struct mm_heap *heap, uint32_t flags,
 	return ptr;
 }
 
+#if CONFIG_MM_SLAB
+static void slab_free(struct block_hdr *hdr, void *ptr);
+#endif
+
 /* free block(s) */
 static void free_block(void *ptr)
 {
@@ -499,6 +503,14 @@ static void free_block(void *ptr)
 
 	hdr = &block_map->block[block];
 
+#if CONFIG_MM_SLAB
+	/* objects in slab pages go back to their caches */
+	if (hdr->used == BLOCK_USED_SLAB) {
+		slab_free(hdr, free_ptr);
+		return;
+	}
+#endif
+
 	/* bring back original unaligned pointer position
 	 * and calculate correct hdr for free operation (it could
 	 * be from different block since we got user pointer here
@@ -554,6 +566,214 @@ static void free_block(void *ptr)
 #endif
 }
 
+#if CONFIG_MM_SLAB
+/*
+ * Slab caches for small runtime objects.
+ *
+ * The object size classes are between the power of 2 heap block sizes where
+ * a block would waste most memory. Objects of a class are carved from slab
+ * pages of one heap block. The runtime and the runtime shared zone have own
+ * caches, which like the heaps are protected by the memory map lock. The
+ * pages are marked in their block headers so rfree() returns the objects to
+ * their caches, and a page is returned to the heap as soon as it's empty.
+ * The last free blocks of the page size are left to the other users.
+ */
+
+/* page header at the beginning of the page, accessed by uncache alias */
+struct mm_slab_page {
+	struct list_item list;		/* in cache partial pages list */
+	struct mm_slab_cache *cache;	/* owner cache */
+	struct mm_heap *heap;		/* heap of the page */
+	char *obj;			/* first object */
+	uint32_t free_mask;		/* free objects bit mask */
+};
+
+#define SLAB_HDR_SIZE	ALIGN_UP(sizeof(struct mm_slab_page), PLATFORM_DCACHE_ALIGN)
+
+/* slab zone indexes */
+#define SLAB_RUNTIME		0
+#define SLAB_RUNTIME_SHARED	1
+
+/* classes with at least one object more per page than in 256 and 512 blocks */
+static const uint16_t slab_obj_size[MM_SLAB_CLASSES] = {
+	ALIGN_UP(192, PLATFORM_DCACHE_ALIGN),
+	ALIGN_UP(320, PLATFORM_DCACHE_ALIGN),
+};
+
+static void init_slab(struct mm *memmap)
+{
+	struct mm_slab_cache *cache;
+	int zone;
+	int i;
+
+	for (zone = 0; zone < MM_SLAB_ZONES; zone++)
+		for (i = 0; i < MM_SLAB_CLASSES; i++) {
+			cache = &memmap->slab[zone][i];
+			list_init(&cache->partial);
+			cache->obj_size = slab_obj_size[i];
+			cache->obj_count = MIN((MM_SLAB_PAGE_SIZE - SLAB_HDR_SIZE) /
+					       slab_obj_size[i], 32);
+			bzero(&cache->info, sizeof(cache->info));
+		}
+}
+
+/* get cache for the allocation, if a size class fits better than a block */
+static struct mm_slab_cache *slab_get_cache(int zone, uint32_t flags,
+					    uint32_t caps, size_t bytes)
+{
+	struct mm *memmap = memmap_get();
+	size_t block = 1;
+	int i;
+
+	if (flags || (caps & ~SOF_MEM_CAPS_RAM))
+		return NULL;
+
+	while (block < bytes)
+		block <<= 1;
+
+	for (i = 0; i < MM_SLAB_CLASSES; i++) {
+		if (bytes > slab_obj_size[i])
+			continue;
+
+		/* the power of 2 block would waste less */
+		if (slab_obj_size[i] >= block)
+			return NULL;
+
+		return &memmap->slab[zone][i];
+	}
+
+	return NULL;
+}
+
+static struct mm_slab_page *slab_page_new(struct mm_slab_cache *cache,
+					  struct mm_heap *heap)
+{
+	struct mm_slab_page *page;
+	struct block_map *map;
+	void *ptr;
+	int i;
+
+	/* don't take the last free blocks of the page size */
+	for (i = 0; i < heap->blocks; i++) {
+		map = &heap->map[i];
+		if (map->block_size == MM_SLAB_PAGE_SIZE)
+			break;
+	}
+
+	if (i == heap->blocks || map->free_count <= MM_SLAB_PAGE_RESERVE)
+		return NULL;
+
+	ptr = get_ptr_from_heap(heap, 0, SOF_MEM_CAPS_RAM, MM_SLAB_PAGE_SIZE,
+				PLATFORM_DCACHE_ALIGN);
+	if (!ptr)
+		return NULL;
+
+	/* mark the block as slab page */
+	for (i = 0; i < heap->blocks; i++) {
+		map = &heap->map[i];
+		if ((uint32_t)ptr < map->base + map->block_size * map->count) {
+			map->block[((uint32_t)ptr - map->base) / map->block_size].used =
+				BLOCK_USED_SLAB;
+			break;
+		}
+	}
+
+	page = cache_to_uncache(ptr);
+	list_init(&page->list);
+	page->cache = cache;
+	page->heap = heap;
+	page->obj = (char *)ptr + SLAB_HDR_SIZE;
+	page->free_mask = (uint32_t)(((uint64_t)1 << cache->obj_count) - 1);
+
+	cache->info.pages++;
+	cache->info.free += cache->obj_count;
+	heap->info.slab_free += cache->obj_count * cache->obj_size;
+
+	return page;
+}
+
+static void slab_page_free(struct mm_slab_page *page, struct block_hdr *hdr)
+{
+	struct mm_slab_cache *cache = page->cache;
+	void *ptr = page->obj - SLAB_HDR_SIZE;
+
+	cache->info.pages--;
+	cache->info.free -= cache->obj_count;
+	page->heap->info.slab_free -= cache->obj_count * cache->obj_size;
+
+	/* back to a normal block for free_block() */
+	hdr->used = 1;
+	free_block(ptr);
+}
+
+static void *slab_alloc(struct mm_slab_cache *cache, struct mm_heap *heap)
+{
+	struct mm_slab_page *page;
+	int i;
+
+	if (list_is_empty(&cache->partial)) {
+		page = slab_page_new(cache, heap);
+		if (!page)
+			return NULL;
+
+		list_item_prepend(&page->list, &cache->partial);
+	}
+
+	page = list_first_item(&cache->partial, struct mm_slab_page, list);
+
+	for (i = 0; !(page->free_mask & BIT(i)); i++)
+		;
+
+	/* full pages are not in any list */
+	page->free_mask &= ~BIT(i);
+	if (!page->free_mask)
+		list_item_del(&page->list);
+
+	cache->info.used++;
+	cache->info.free--;
+	page->heap->info.slab_used += cache->obj_size;
+	page->heap->info.slab_free -= cache->obj_size;
+
+	return page->obj + i * cache->obj_size;
+}
+
+static void slab_free(struct block_hdr *hdr, void *ptr)
+{
+	struct mm_slab_page *page;
+	struct mm_slab_cache *cache;
+	int i;
+
+	page = cache_to_uncache((struct mm_slab_page *)ALIGN_UP((uintptr_t)hdr->unaligned_ptr,
+								 PLATFORM_DCACHE_ALIGN));
+	cache = page->cache;
+	i = ((char *)ptr - page->obj) / cache->obj_size;
+
+	/* report an error if ptr is not an allocated object */
+	if (page->obj + i * cache->obj_size != ptr || (page->free_mask & BIT(i)))
+		panic(SOF_IPC_PANIC_MEM);
+
+	/* same as for blocks, there may be dirty lines of the object */
+	dcache_writeback_invalidate_region(ptr, cache->obj_size);
+
+	if (!page->free_mask)
+		list_item_prepend(&page->list, &cache->partial);
+
+	page->free_mask |= BIT(i);
+
+	cache->info.used--;
+	cache->info.free++;
+	page->heap->info.slab_used -= cache->obj_size;
+	page->heap->info.slab_free += cache->obj_size;
+
+	if (page->free_mask != ((uint64_t)1 << cache->obj_count) - 1)
+		return;
+
+	/* empty page goes back to the heap */
+	list_item_del(&page->list);
+	slab_page_free(page, hdr);
+}
+#endif /* CONFIG_MM_SLAB */
+
 #if CONFIG_TRACE
 void heap_trace(struct mm_heap *heap, int size)
 {
@@ -567,6 +787,10 @@ void heap_trace(struct mm_heap *heap, int size)
 			heap->caps);
 		tr_info(&mem_tr, "  used %d free %d", heap->info.used,
 			heap->info.free);
+#if CONFIG_MM_SLAB
+		tr_info(&mem_tr, "  slab used %d free %d", heap->info.slab_used,
+			heap->info.slab_free);
+#endif
 
 		/* map[j]'s base is calculated based on map[j-1] */
 		for (j = 0; j < heap->blocks; j++) {
@@ -662,6 +886,10 @@ static void *rmalloc_runtime(uint32_t flags, uint32_t caps, size_t bytes)
 {
 	struct mm *memmap = memmap_get();
 	struct mm_heap *heap;
+#if CONFIG_MM_SLAB
+	struct mm_slab_cache *cache;
+	void *ptr;
+#endif
 
 	/* check runtime heap for capabilities */
 	heap = get_heap_from_caps(memmap->runtime, PLATFORM_HEAP_RUNTIME, caps);
@@ -678,6 +906,16 @@ static void *rmalloc_runtime(uint32_t flags, uint32_t caps, size_t bytes)
 		}
 	}
 
+#if CONFIG_MM_SLAB
+	/* small objects from slab cache, or from blocks if it's out of pages */
+	cache = slab_get_cache(SLAB_RUNTIME, flags, caps, bytes);
+	if (cache) {
+		ptr = slab_alloc(cache, heap);
+		if (ptr)
+			return ptr;
+	}
+#endif
+
 	return get_ptr_from_heap(heap, flags, caps, bytes,
 				 PLATFORM_DCACHE_ALIGN);
 }
@@ -688,6 +926,10 @@ static void *rmalloc_runtime_shared(uint32_t flags, uint32_t caps, size_t bytes)
 {
 	struct mm *memmap = memmap_get();
 	struct mm_heap *heap;
+#if CONFIG_MM_SLAB
+	struct mm_slab_cache *cache;
+	void *ptr;
+#endif
 
 	/* check shared heap for capabilities */
 	heap = get_heap_from_caps(memmap->runtime_shared, PLATFORM_HEAP_RUNTIME_SHARED, caps);
@@ -696,6 +938,15 @@ static void *rmalloc_runtime_shared(uint32_t flags, uint32_t caps, size_t bytes)
 		return NULL;
 	}
 
+#if CONFIG_MM_SLAB
+	cache = slab_get_cache(SLAB_RUNTIME_SHARED, flags, caps, bytes);
+	if (cache) {
+		ptr = slab_alloc(cache, heap);
+		if (ptr)
+			return ptr;
+	}
+#endif
+
 	return get_ptr_from_heap(heap, flags, caps, bytes, PLATFORM_DCACHE_ALIGN);
 }
 #endif
@@ -1078,6 +1329,10 @@ void init_heap(struct sof *sof)
 
 	init_heap_map(memmap->buffer, PLATFORM_HEAP_BUFFER);
 
+#if CONFIG_MM_SLAB
+	init_slab(memmap);
+#endif
+
 #if CONFIG_DEBUG_BLOCK_FREE
 	write_pattern((struct mm_heap *)&memmap->buffer, PLATFORM_HEAP_BUFFER,
 		      DEBUG_BLOCK_FREE_VALUE_8BIT);
@@ -1144,4 +1399,38 @@ error:
 	       (uint32_t)out);
 	return -EINVAL;
 }
+
+#if CONFIG_MM_SLAB
+int heap_slab_info(enum mem_zone zone, int index, struct mm_slab_info *out)
+{
+	struct mm *memmap = memmap_get();
+	struct mm_slab_cache *cache;
+	k_spinlock_key_t key;
+	int slab_zone;
+
+	switch (zone) {
+	case SOF_MEM_ZONE_RUNTIME:
+		slab_zone = SLAB_RUNTIME;
+		break;
+#if CONFIG_CORE_COUNT > 1
+	case SOF_MEM_ZONE_RUNTIME_SHARED:
+		slab_zone = SLAB_RUNTIME_SHARED;
+		break;
+#endif
+	default:
+		return -EINVAL;
+	}
+
+	if (!out || index < 0 || index >= MM_SLAB_CLASSES)
+		return -EINVAL;
+
+	cache = &memmap->slab[slab_zone][index];
+
+	key = k_spin_lock(&memmap->lock);
+	*out = cache->info;
+	k_spin_unlock(&memmap->lock, key);
+
+	return cache->obj_size;
+}
+#endif
 #endif
@@ -30,11 +30,140 @@ static SHARED_DATA struct notify_data notify_data[CONFIG_CORE_COUNT];
 struct callback_handle {
 	void *receiver;
 	void *caller;
+	enum notify_id type;
 	void (*cb)(void *arg, enum notify_id, void *data);
 	struct list_item list;
 	uint32_t num_registrations;
 };
 
+/* caller hash bucket, the table must be allocated */
+static struct list_item *notifier_caller_list(struct notify *notify,
+					      const void *caller,
+					      enum notify_id type)
+{
+	return &notify->caller_list[notifier_caller_hash(caller, type) >>
+				    (32 - notify->caller_bits)];
+}
+
+/* move caller handles to a table of 2^bits buckets */
+static int notifier_caller_resize(struct notify *notify, uint32_t bits)
+{
+	struct list_item *old_list = notify->caller_list;
+	uint32_t old_buckets = old_list ? BIT(notify->caller_bits) : 0;
+	struct list_item *new_list;
+	struct list_item *wlist;
+	struct list_item *tlist;
+	struct callback_handle *handle;
+	uint32_t i;
+
+	new_list = rzalloc(SOF_MEM_ZONE_SYS_RUNTIME, 0, SOF_MEM_CAPS_RAM,
+			   sizeof(*new_list) * BIT(bits));
+	if (!new_list)
+		return -ENOMEM;
+
+	for (i = 0; i < BIT(bits); i++)
+		list_init(&new_list[i]);
+
+	notify->caller_list = new_list;
+	notify->caller_bits = bits;
+
+	for (i = 0; i < old_buckets; i++) {
+		list_for_item_safe(wlist, tlist, &old_list[i]) {
+			handle = container_of(wlist, struct callback_handle,
+					      list);
+			list_item_del(&handle->list);
+			list_item_prepend(&handle->list,
+					  notifier_caller_list(notify,
+							       handle->caller,
+							       handle->type));
+		}
+	}
+
+	rfree(old_list);
+
+	return 0;
+}
+
+/* add handle with caller filter, growing the table with the load */
+static int notifier_caller_add(struct notify *notify,
+			       struct callback_handle *handle)
+{
+	int ret;
+
+	if (!notify->caller_list) {
+		ret = notifier_caller_resize(notify, NOTIFIER_CALLER_MIN_BITS);
+		if (ret < 0)
+			return ret;
+	} else if (notify->caller_count >= BIT(notify->caller_bits) &&
+		   !notify->notify_depth) {
+		/* the table can not be reshaped while a bucket is walked,
+		 * on failure the chains just get longer
+		 */
+		notifier_caller_resize(notify, notify->caller_bits + 1);
+	}
+
+	list_item_prepend(&handle->list,
+			  notifier_caller_list(notify, handle->caller,
+					       handle->type));
+	notify->caller_count++;
+	notify->caller_type_count[handle->type]++;
+
+	return 0;
+}
+
+static void notifier_handle_free(struct notify *notify,
+				 struct callback_handle *handle)
+{
+	list_item_del(&handle->list);
+
+	if (handle->caller) {
+		notify->caller_count--;
+		notify->caller_type_count[handle->type]--;
+	}
+
+	rfree(handle);
+}
+
+/* release the caller table with its last handle */
+static void notifier_caller_release(struct notify *notify)
+{
+	if (notify->caller_list && !notify->caller_count &&
+	    !notify->notify_depth) {
+		rfree(notify->caller_list);
+		notify->caller_list = NULL;
+		notify->caller_bits = 0;
+	}
+}
+
+/* find handle to aggregate a registration with */
+static struct callback_handle *notifier_find(struct notify *notify,
+					     const void *caller,
+					     enum notify_id type,
+					     void (*cb)(void *arg,
+							enum notify_id type,
+							void *data))
+{
+	struct list_item *list;
+	struct list_item *wlist;
+	struct callback_handle *handle;
+
+	if (!caller)
+		list = &notify->list[type];
+	else if (notify->caller_type_count[type])
+		list = notifier_caller_list(notify, caller, type);
+	else
+		return NULL;
+
+	list_for_item(wlist, list) {
+		handle = container_of(wlist, struct callback_handle, list);
+		if (handle->cb == cb && handle->caller == caller &&
+		    handle->type == type)
+			return handle;
+	}
+
+	return NULL;
+}
+
 int notifier_register(void *receiver, void *caller, enum notify_id type,
 		      void (*cb)(void *arg, enum notify_id type, void *data),
 		      uint32_t flags)
@@ -48,14 +177,15 @@ int notifier_register(void *receiver, void *caller, enum notify_id type,
 
 	key = k_spin_lock(&notify->lock);
 
-	/* Find already registered event of this type */
-	if (flags & NOTIFIER_FLAG_AGGREGATE &&
-	    !list_is_empty(&notify->list[type])) {
-		handle = container_of((&notify->list[type])->next,
-				      struct callback_handle, list);
-		handle->num_registrations++;
-
-		goto out;
+	/* Find already registered event of this type, caller and callback,
+	 * other callers may share its hash bucket
+	 */
+	if (flags & NOTIFIER_FLAG_AGGREGATE) {
+		handle = notifier_find(notify, caller, type, cb);
+		if (handle) {
+			handle->num_registrations++;
+			goto out;
+		}
 	}
 
 	handle = rzalloc(SOF_MEM_ZONE_SYS_RUNTIME, 0, SOF_MEM_CAPS_RAM,
@@ -69,23 +199,50 @@ int notifier_register(void *receiver, void *caller, enum notify_id type,
 
 	handle->receiver = receiver;
 	handle->caller = caller;
+	handle->type = type;
 	handle->cb = cb;
 	handle->num_registrations = 1;
 
-	list_item_prepend(&handle->list, &notify->list[type]);
+	if (caller) {
+		ret = notifier_caller_add(notify, handle);
+		if (ret < 0) {
+			tr_err(&nt_tr, "notifier_register(): caller table allocation failed.");
+			rfree(handle);
+		}
+	} else {
+		list_item_prepend(&handle->list, &notify->list[type]);
+	}
 
 out:
 	k_spin_unlock(&notify->lock, key);
 	return ret;
 }
 
-void notifier_unregister(void *receiver, void *caller, enum notify_id type)
+static void notifier_unregister_list(struct notify *notify,
+				     struct list_item *list, void *receiver,
+				     void *caller, enum notify_id type)
 {
-	struct notify *notify = *arch_notify_get();
 	struct list_item *wlist;
 	struct list_item *tlist;
 	struct callback_handle *handle;
+
+	list_for_item_safe(wlist, tlist, list) {
+		handle = container_of(wlist, struct callback_handle, list);
+		if ((!receiver || handle->receiver == receiver) &&
+		    (!caller || handle->caller == caller) &&
+		    handle->type == type) {
+			if (!--handle->num_registrations)
+				notifier_handle_free(notify, handle);
+		}
+	}
+}
+
+void notifier_unregister(void *receiver, void *caller, enum notify_id type)
+{
+	struct notify *notify = *arch_notify_get();
 	k_spinlock_key_t key;
+	uint32_t buckets;
+	uint32_t i;
 
 	assert(type >= NOTIFIER_ID_CPU_FREQ && type < NOTIFIER_ID_COUNT);
 
@@ -101,17 +258,25 @@ void notifier_unregister(void *receiver, void *caller, enum notify_id type)
 	 * Event consumer might unregister from all callers by passing caller
 	 * NULL
 	 */
-	list_for_item_safe(wlist, tlist, &notify->list[type]) {
-		handle = container_of(wlist, struct callback_handle, list);
-		if ((!receiver || handle->receiver == receiver) &&
-		    (!caller || handle->caller == caller)) {
-			if (!--handle->num_registrations) {
-				list_item_del(&handle->list);
-				rfree(handle);
-			}
-		}
+	if (caller) {
+		if (notify->caller_type_count[type])
+			notifier_unregister_list(notify,
+						 notifier_caller_list(notify, caller,
+								      type),
+						 receiver, caller, type);
+	} else {
+		notifier_unregister_list(notify, &notify->list[type], receiver,
+					 NULL, type);
+
+		buckets = notify->caller_type_count[type] ?
+			  BIT(notify->caller_bits) : 0;
+		for (i = 0; i < buckets; i++)
+			notifier_unregister_list(notify, &notify->caller_list[i],
+						 receiver, NULL, type);
 	}
 
+	notifier_caller_release(notify);
+
 	k_spin_unlock(&notify->lock, key);
 }
 
@@ -123,29 +288,55 @@ void notifier_unregister_all(void *receiver, void *caller)
 		notifier_unregister(receiver, caller, i);
 }
 
-static void notifier_notify(const void *caller, enum notify_id type, void *data)
+static void notifier_notify_list(struct list_item *list, const void *caller,
+				 enum notify_id type, void *data)
 {
-	struct notify *notify = *arch_notify_get();
 	struct list_item *wlist;
 	struct list_item *tlist;
 	struct callback_handle *handle;
 
-	/* iterate through notifiers and send event to
-	 * interested clients
-	 */
-	list_for_item_safe(wlist, tlist, &notify->list[type]) {
+	list_for_item_safe(wlist, tlist, list) {
 		handle = container_of(wlist, struct callback_handle, list);
-		if (!caller || !handle->caller || handle->caller == caller)
+		if ((!caller || handle->caller == caller) &&
+		    handle->type == type)
 			handle->cb(handle->receiver, type, data);
 	}
 }
 
+static void notifier_notify(const void *caller, enum notify_id type, void *data)
+{
+	struct notify *notify = *arch_notify_get();
+	uint32_t i;
+
+	/* send event to clients interested in this caller only, walking
+	 * one bucket of the table sized to the number of such clients
+	 */
+	if (notify->caller_type_count[type]) {
+		notify->notify_depth++;
+
+		if (caller)
+			notifier_notify_list(notifier_caller_list(notify, caller,
+								  type),
+					     caller, type, data);
+		else
+			for (i = 0; i < BIT(notify->caller_bits); i++)
+				notifier_notify_list(&notify->caller_list[i],
+						     NULL, type, data);
+
+		notify->notify_depth--;
+	}
+
+	/* and to clients interested in all callers */
+	notifier_notify_list(&notify->list[type], NULL, type, data);
+}
+
 void notifier_notify_remote(void)
 {
 	struct notify *notify = *arch_notify_get();
 	struct notify_data *notify_data = notify_data_get() + cpu_get_id();
 
-	if (!list_is_empty(&notify->list[notify_data->type])) {
+	if (!list_is_empty(&notify->list[notify_data->type]) ||
+	    notify->caller_type_count[notify_data->type]) {
 		dcache_invalidate_region(notify_data->data,
 					 notify_data->data_size);
 		notifier_notify(notify_data->caller, notify_data->type,
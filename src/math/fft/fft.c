@@ -5,26 +5,23 @@
 // Author: Amery Song <chao.song@intel.com>
 //	   Keyon Jie <yang.jie@linux.intel.com>
 
+#include <sof/audio/coefficients/fft/bit_reverse.h>
 #include <sof/audio/coefficients/fft/twiddle.h>
+#include <sof/audio/coefficients/fft/twiddle_16.h>
 #include <sof/audio/buffer.h>
 #include <sof/audio/format.h>
 #include <sof/common.h>
 #include <sof/lib/alloc.h>
 #include <sof/math/fft.h>
+#include <errno.h>
 
-struct fft_plan *fft_plan_new(struct icomplex32 *inb, struct icomplex32 *outb, uint32_t size)
+static int fft_plan_init(struct fft_plan *plan, uint32_t size)
 {
-	struct fft_plan *plan;
-	int lim = 1;
-	int len = 0;
-	int i;
+	uint32_t lim = 1;
+	uint32_t len = 0;
 
-	if (!inb || !outb)
-		return NULL;
-
-	plan = rzalloc(SOF_MEM_ZONE_RUNTIME, 0, SOF_MEM_CAPS_RAM, sizeof(struct fft_plan));
-	if (!plan)
-		return NULL;
+	if (!size || size > FFT_SIZE_MAX)
+		return -EINVAL;
 
 	/* calculate the exponent of 2 */
 	while (lim < size) {
@@ -35,92 +32,175 @@ struct fft_plan *fft_plan_new(struct icomplex32 *inb, struct icomplex32 *outb, u
 	plan->size = lim;
 	plan->len = len;
 
-	plan->bit_reverse_idx = rzalloc(SOF_MEM_ZONE_RUNTIME, 0, SOF_MEM_CAPS_RAM,
-					plan->size * sizeof(uint32_t));
-	if (!plan->bit_reverse_idx) {
+	/* the bit reverse index table is shared by all plans */
+	plan->bit_reverse_shift = FFT_SIZE_MAX_LEN - len;
+
+	return 0;
+}
+
+struct fft_plan *fft_plan_new(struct icomplex32 *inb, struct icomplex32 *outb, uint32_t size)
+{
+	struct fft_plan *plan;
+
+	if (!inb || !outb)
+		return NULL;
+
+	plan = rzalloc(SOF_MEM_ZONE_RUNTIME, 0, SOF_MEM_CAPS_RAM, sizeof(struct fft_plan));
+	if (!plan)
+		return NULL;
+
+	if (fft_plan_init(plan, size) < 0) {
 		rfree(plan);
 		return NULL;
 	}
 
-	/* set up the bit reverse index */
-	for (i = 1; i < plan->size; ++i)
-		plan->bit_reverse_idx[i] = (plan->bit_reverse_idx[i >> 1] >> 1) |
-					   ((i & 1) << (len - 1));
-
 	plan->inb = inb;
 	plan->outb = outb;
 
 	return plan;
 }
 
-void fft_plan_free(struct fft_plan *plan)
+struct fft_plan *fft_plan_new_16(struct icomplex16 *inb, struct icomplex16 *outb, uint32_t size)
 {
+	struct fft_plan *plan;
+
+	if (!inb || !outb)
+		return NULL;
+
+	plan = rzalloc(SOF_MEM_ZONE_RUNTIME, 0, SOF_MEM_CAPS_RAM, sizeof(struct fft_plan));
 	if (!plan)
-		return;
+		return NULL;
 
-	rfree(plan->bit_reverse_idx);
+	if (fft_plan_init(plan, size) < 0) {
+		rfree(plan);
+		return NULL;
+	}
+
+	plan->inb16 = inb;
+	plan->outb16 = outb;
+
+	return plan;
+}
+
+void fft_plan_free(struct fft_plan *plan)
+{
 	rfree(plan);
 }
 
-/**
- * \brief Execute the Fast Fourier Transform (FFT) or Inverse FFT (IFFT)
- *	  For the configured fft_pan.
- * \param[in] plan - pointer to fft_plan which will be executed.
- * \param[in] ifft - set to 1 for IFFT and 0 for FFT.
+/* radix-4 butterfly outputs from x0 and the twiddled x1, x2 and x3 */
+static inline void fft_radix4_32_out(struct icomplex32 *x, int n, struct icomplex32 *tb,
+				     struct icomplex32 *tc, struct icomplex32 *td)
+{
+	struct icomplex32 a;
+	struct icomplex32 b;
+	struct icomplex32 e;
+	struct icomplex32 f;
+
+	icomplex32_add(&x[0], tb, &a);
+	icomplex32_sub(&x[0], tb, &b);
+	icomplex32_add(tc, td, &e);
+	icomplex32_sub(tc, td, &f);
+
+	icomplex32_add(&a, &e, &x[0]);
+	icomplex32_sub(&a, &e, &x[2 * n]);
+
+	/* b -/+ j * f */
+	x[n].real = b.real + f.imag;
+	x[n].imag = b.imag - f.real;
+	x[3 * n].real = b.real - f.imag;
+	x[3 * n].imag = b.imag + f.real;
+}
+
+/*
+ * Mixed radix-4/radix-2 decimation in time transform. Pairs of radix-2
+ * stages are merged to radix-4 stages that need three complex multiplies
+ * per four points instead of four, and half the passes over the buffer.
+ * When the length exponent is odd one trivial radix-2 stage without
+ * multiplies is done first. The input is scaled by 1/N to avoid overflow.
  */
-void fft_execute(struct fft_plan *plan, bool ifft)
+static void fft_radix4_32(struct fft_plan *plan, struct icomplex32 *inb,
+			  struct icomplex32 *outb, bool ifft)
 {
 	struct icomplex32 tmp1;
 	struct icomplex32 tmp2;
+	struct icomplex32 w1;
+	struct icomplex32 w2;
+	struct icomplex32 w3;
+	struct icomplex32 tb;
+	struct icomplex32 tc;
+	struct icomplex32 td;
+	int shift = plan->bit_reverse_shift;
 	int depth;
-	int top;
-	int bottom;
-	int index;
+	int step;
 	int i;
 	int j;
 	int k;
 	int m;
 	int n;
 
-	if (!plan || !plan->bit_reverse_idx)
-		return;
+	/* step 1: re-arrange input in bit reverse order, and shrink the level to avoid overflow,
+	 * the input is converted to complex conjugate for ifft
+	 */
+	for (i = 0; i < plan->size; ++i) {
+		tmp1 = inb[i];
+		if (ifft)
+			icomplex_conj(&tmp1);
 
-	/* convert to complex conjugate for ifft */
-	if (ifft) {
-		for (i = 0; i < plan->size; i++)
-			icomplex_conj(&plan->inb[i]);
+		icomplex_shift(&tmp1, (-1) * plan->len, &outb[bit_reverse_idx[i] >> shift]);
 	}
 
-	/* step 1: re-arrange input in bit reverse order, and shrink the level to avoid overflow */
-	for (i = 1; i < plan->size; ++i)
-		icomplex_shift(&plan->inb[i], (-1) * plan->len,
-			       &plan->outb[plan->bit_reverse_idx[i]]);
+	/* step 2: radix-2 stage with unity twiddle for odd length exponent */
+	if (plan->len & 1) {
+		for (k = 0; k < plan->size; k += 2) {
+			tmp1 = outb[k];
+			tmp2 = outb[k + 1];
+			icomplex32_add(&tmp1, &tmp2, &outb[k]);
+			icomplex32_sub(&tmp1, &tmp2, &outb[k + 1]);
+		}
+	}
 
-	/* step 2: loop to do FFT transform in smaller size */
-	for (depth = 1; depth <= plan->len; ++depth) {
+	/* step 3: radix-4 stages */
+	for (depth = (plan->len & 1) + 2; depth <= plan->len; depth += 2) {
 		m = 1 << depth;
-		n = m >> 1;
-		i = FFT_SIZE_MAX >> depth;
+		n = m >> 2;
+		step = FFT_SIZE_MAX >> depth;
 
-		/* doing FFT transforms in size m */
-		for (k = 0; k < plan->size; k += m) {
-			/* doing one FFT transform for size m */
-			for (j = 0; j < n; ++j) {
-				index = i * j;
-				top = k + j;
-				bottom = top + n;
-				tmp1.real = twiddle_real[index];
-				tmp1.imag = twiddle_imag[index];
-				/* calculate the accumulator: twiddle * bottom */
-				icomplex32_mul(&tmp1, &plan->outb[bottom], &tmp2);
-				tmp1 = plan->outb[top];
-				/* calculate the top output: top = top + accumulate */
-				icomplex32_add(&tmp1, &tmp2, &plan->outb[top]);
-				/* calculate the bottom output: bottom = top - accumulate */
-				icomplex32_sub(&tmp1, &tmp2, &plan->outb[bottom]);
+		/* first butterfly of each group has unity twiddles */
+		for (k = 0; k < plan->size; k += m)
+			fft_radix4_32_out(&outb[k], n, &outb[k + n], &outb[k + 2 * n],
+					  &outb[k + 3 * n]);
+
+		for (j = 1; j < n; ++j) {
+			w1.real = twiddle_real[step * j];
+			w1.imag = twiddle_imag[step * j];
+			w2.real = twiddle_real[2 * step * j];
+			w2.imag = twiddle_imag[2 * step * j];
+			w3.real = twiddle_real[3 * step * j];
+			w3.imag = twiddle_imag[3 * step * j];
+			for (k = j; k < plan->size; k += m) {
+				icomplex32_mul(&w2, &outb[k + n], &tb);
+				icomplex32_mul(&w1, &outb[k + 2 * n], &tc);
+				icomplex32_mul(&w3, &outb[k + 3 * n], &td);
+				fft_radix4_32_out(&outb[k], n, &tb, &tc, &td);
 			}
 		}
 	}
+}
+
+/**
+ * \brief Execute the Fast Fourier Transform (FFT) or Inverse FFT (IFFT)
+ *	  For the configured fft_pan.
+ * \param[in] plan - pointer to fft_plan which will be executed.
+ * \param[in] ifft - set to 1 for IFFT and 0 for FFT.
+ */
+void fft_execute(struct fft_plan *plan, bool ifft)
+{
+	int i;
+
+	if (!plan || !plan->inb || !plan->outb)
+		return;
+
+	fft_radix4_32(plan, plan->inb, plan->outb, ifft);
 
 	/* shift back for ifft */
 	if (ifft) {
@@ -133,3 +213,295 @@ void fft_execute(struct fft_plan *plan, bool ifft)
 			icomplex_shift(&plan->outb[i], plan->len, &plan->outb[i]);
 	}
 }
+
+/* Q1.15 complex multiply, the result is kept in 32 bits */
+static inline void icomplex16_mul(const struct icomplex16 *in1, const struct icomplex16 *in2,
+				  struct icomplex32 *out)
+{
+	out->real = ((int32_t)in1->real * in2->real - (int32_t)in1->imag * in2->imag) >> 15;
+	out->imag = ((int32_t)in1->real * in2->imag + (int32_t)in1->imag * in2->real) >> 15;
+}
+
+/* rounded and saturated scale down of a butterfly output */
+static inline int16_t fft_16_out(int32_t x, int shift)
+{
+	return sat_int16((x + ((1 << shift) >> 1)) >> shift);
+}
+
+static inline void fft_radix4_16_out(struct icomplex16 *x, int n, struct icomplex32 *tb,
+				     struct icomplex32 *tc, struct icomplex32 *td, int shift)
+{
+	int32_t ar = x[0].real + tb->real;
+	int32_t ai = x[0].imag + tb->imag;
+	int32_t br = x[0].real - tb->real;
+	int32_t bi = x[0].imag - tb->imag;
+	int32_t er = tc->real + td->real;
+	int32_t ei = tc->imag + td->imag;
+	int32_t fr = tc->real - td->real;
+	int32_t fi = tc->imag - td->imag;
+
+	x[0].real = fft_16_out(ar + er, shift);
+	x[0].imag = fft_16_out(ai + ei, shift);
+	x[2 * n].real = fft_16_out(ar - er, shift);
+	x[2 * n].imag = fft_16_out(ai - ei, shift);
+	x[n].real = fft_16_out(br + fi, shift);
+	x[n].imag = fft_16_out(bi - fr, shift);
+	x[3 * n].real = fft_16_out(br - fi, shift);
+	x[3 * n].imag = fft_16_out(bi + fr, shift);
+}
+
+/**
+ * \brief Execute the 16 bit FFT or IFFT for the configured fft_plan.
+ *
+ * The forward transform scales every stage by 1/2 for the same 1/N total
+ * scale as fft_execute() with less rounding noise at 16 bit precision. The
+ * inverse transform is not scaled, so IFFT(FFT(x)) returns x. Like
+ * fft_execute(), the IFFT output imaginary part has inverted sign.
+ * \param[in] plan - pointer to fft_plan from fft_plan_new_16().
+ * \param[in] ifft - set to 1 for IFFT and 0 for FFT.
+ */
+void fft_execute_16(struct fft_plan *plan, bool ifft)
+{
+	struct icomplex16 *inb;
+	struct icomplex16 *outb;
+	struct icomplex16 w1;
+	struct icomplex16 w2;
+	struct icomplex16 w3;
+	struct icomplex16 *x;
+	struct icomplex32 tb;
+	struct icomplex32 tc;
+	struct icomplex32 td;
+	int shift = plan ? plan->bit_reverse_shift : 0;
+	int s2 = ifft ? 0 : 1;
+	int s4 = ifft ? 0 : 2;
+	int32_t a;
+	int32_t b;
+	int depth;
+	int step;
+	int i;
+	int j;
+	int k;
+	int m;
+	int n;
+
+	if (!plan || !plan->inb16 || !plan->outb16)
+		return;
+
+	inb = plan->inb16;
+	outb = plan->outb16;
+
+	/* step 1: re-arrange input in bit reverse order, conjugate for ifft */
+	for (i = 0; i < plan->size; ++i) {
+		x = &outb[bit_reverse_idx[i] >> shift];
+		x->real = inb[i].real;
+		x->imag = ifft ? sat_int16(-(int32_t)inb[i].imag) : inb[i].imag;
+	}
+
+	/* step 2: radix-2 stage with unity twiddle for odd length exponent */
+	if (plan->len & 1) {
+		for (k = 0; k < plan->size; k += 2) {
+			a = outb[k].real;
+			b = outb[k + 1].real;
+			outb[k].real = fft_16_out(a + b, s2);
+			outb[k + 1].real = fft_16_out(a - b, s2);
+			a = outb[k].imag;
+			b = outb[k + 1].imag;
+			outb[k].imag = fft_16_out(a + b, s2);
+			outb[k + 1].imag = fft_16_out(a - b, s2);
+		}
+	}
+
+	/* step 3: radix-4 stages */
+	for (depth = (plan->len & 1) + 2; depth <= plan->len; depth += 2) {
+		m = 1 << depth;
+		n = m >> 2;
+		step = FFT_SIZE_MAX >> depth;
+
+		for (k = 0; k < plan->size; k += m) {
+			x = &outb[k];
+			tb.real = x[n].real;
+			tb.imag = x[n].imag;
+			tc.real = x[2 * n].real;
+			tc.imag = x[2 * n].imag;
+			td.real = x[3 * n].real;
+			td.imag = x[3 * n].imag;
+			fft_radix4_16_out(x, n, &tb, &tc, &td, s4);
+		}
+
+		for (j = 1; j < n; ++j) {
+			w1.real = twiddle_real_16[step * j];
+			w1.imag = twiddle_imag_16[step * j];
+			w2.real = twiddle_real_16[2 * step * j];
+			w2.imag = twiddle_imag_16[2 * step * j];
+			w3.real = twiddle_real_16[3 * step * j];
+			w3.imag = twiddle_imag_16[3 * step * j];
+			for (k = j; k < plan->size; k += m) {
+				x = &outb[k];
+				icomplex16_mul(&w2, &x[n], &tb);
+				icomplex16_mul(&w1, &x[2 * n], &tc);
+				icomplex16_mul(&w3, &x[3 * n], &td);
+				fft_radix4_16_out(x, n, &tb, &tc, &td, s4);
+			}
+		}
+	}
+}
+
+struct fft_plan_real *fft_plan_new_real(int32_t *inb, struct icomplex32 *outb, uint32_t size)
+{
+	struct fft_plan_real *plan;
+
+	if (!inb || !outb || size < 2)
+		return NULL;
+
+	plan = rzalloc(SOF_MEM_ZONE_RUNTIME, 0, SOF_MEM_CAPS_RAM, sizeof(struct fft_plan_real));
+	if (!plan)
+		return NULL;
+
+	/* the real samples are packed as N/2 complex samples */
+	if (fft_plan_init(&plan->plan, (size + 1) >> 1) < 0 ||
+	    plan->plan.size > FFT_SIZE_MAX / 2) {
+		rfree(plan);
+		return NULL;
+	}
+
+	plan->size = plan->plan.size << 1;
+	plan->inb = inb;
+	plan->outb = outb;
+
+	return plan;
+}
+
+void fft_plan_free_real(struct fft_plan_real *plan)
+{
+	rfree(plan);
+}
+
+/*
+ * Split the N/2 points FFT Z of the packed real signal to the N points real
+ * signal spectrum X(k) = (Z(k) + Z*(N/2 - k)) / 2 +
+ * W(k) * (Z(k) - Z*(N/2 - k)) / 2j. X(N/2 - k) is computed from the same
+ * terms, so the split is done in place in pairs.
+ */
+static void fft_real_split(struct fft_plan_real *plan)
+{
+	struct icomplex32 *z = plan->outb;
+	struct icomplex32 zk;
+	struct icomplex32 zm;
+	struct icomplex32 p;
+	struct icomplex32 g;
+	struct icomplex32 q;
+	struct icomplex32 w;
+	int m = plan->plan.size;
+	int step = FFT_SIZE_MAX / plan->size;
+	int k;
+
+	/* DC and Nyquist bins are real */
+	zk = z[0];
+	z[0].real = ((int64_t)zk.real + zk.imag) >> 1;
+	z[0].imag = 0;
+	z[m].real = ((int64_t)zk.real - zk.imag) >> 1;
+	z[m].imag = 0;
+
+	for (k = 1; k <= m / 2; k++) {
+		zk = z[k];
+		zm = z[m - k];
+
+		/* halves of zk + conj(zm) and -j * (zk - conj(zm)) */
+		p.real = ((int64_t)zk.real + zm.real) >> 1;
+		p.imag = ((int64_t)zk.imag - zm.imag) >> 1;
+		g.real = ((int64_t)zk.imag + zm.imag) >> 1;
+		g.imag = ((int64_t)zm.real - zk.real) >> 1;
+
+		w.real = twiddle_real[step * k];
+		w.imag = twiddle_imag[step * k];
+		icomplex32_mul(&w, &g, &q);
+
+		/* X(N/2 - k) = conj(p - q) */
+		z[m - k].real = ((int64_t)p.real - q.real) >> 1;
+		z[m - k].imag = ((int64_t)q.imag - p.imag) >> 1;
+		z[k].real = ((int64_t)p.real + q.real) >> 1;
+		z[k].imag = ((int64_t)p.imag + q.imag) >> 1;
+	}
+}
+
+/*
+ * Inverse of fft_real_split(), packs the N points real signal spectrum to a
+ * N/2 points complex spectrum Z(k) = X(k) + X*(N/2 - k) +
+ * j * W*(k) * (X(k) - X*(N/2 - k)). It is scaled by 1/2 to fit Q1.31.
+ */
+static void fft_real_merge(struct fft_plan_real *plan)
+{
+	struct icomplex32 *x = plan->outb;
+	struct icomplex32 xk;
+	struct icomplex32 xm;
+	struct icomplex32 p;
+	struct icomplex32 d;
+	struct icomplex32 t;
+	struct icomplex32 w;
+	int m = plan->plan.size;
+	int step = FFT_SIZE_MAX / plan->size;
+	int k;
+
+	xk = x[0];
+	xm = x[m];
+	x[0].real = ((int64_t)xk.real + xm.real) >> 1;
+	x[0].imag = ((int64_t)xk.real - xm.real) >> 1;
+
+	for (k = 1; k <= m / 2; k++) {
+		xk = x[k];
+		xm = x[m - k];
+
+		/* halves of xk + conj(xm) and xk - conj(xm) */
+		p.real = ((int64_t)xk.real + xm.real) >> 1;
+		p.imag = ((int64_t)xk.imag - xm.imag) >> 1;
+		d.real = ((int64_t)xk.real - xm.real) >> 1;
+		d.imag = ((int64_t)xk.imag + xm.imag) >> 1;
+
+		w.real = twiddle_real[step * k];
+		w.imag = -twiddle_imag[step * k];
+		icomplex32_mul(&w, &d, &t);
+
+		/* q = j * t, Z(N/2 - k) = conj(p - q) */
+		x[m - k].real = sat_int32((int64_t)p.real + t.imag);
+		x[m - k].imag = sat_int32((int64_t)t.real - p.imag);
+		x[k].real = sat_int32((int64_t)p.real - t.imag);
+		x[k].imag = sat_int32((int64_t)p.imag + t.real);
+	}
+}
+
+/**
+ * \brief Execute the real input FFT or real output IFFT.
+ *
+ * The FFT transforms N real samples of inb to N/2 + 1 complex bins of outb
+ * with the same 1/N scale as fft_execute(). The IFFT transforms the N/2 + 1
+ * bins of outb back to N real samples in inb, the contents of outb are
+ * overwritten.
+ * \param[in] plan - pointer to fft_plan_real which will be executed.
+ * \param[in] ifft - set to 1 for IFFT and 0 for FFT.
+ */
+void fft_execute_real(struct fft_plan_real *plan, bool ifft)
+{
+	struct icomplex32 *time;
+	int i;
+
+	if (!plan)
+		return;
+
+	/* even and odd samples are the real and imaginary parts */
+	time = (struct icomplex32 *)plan->inb;
+
+	if (!ifft) {
+		fft_radix4_32(&plan->plan, time, plan->outb, false);
+		fft_real_split(plan);
+		return;
+	}
+
+	fft_real_merge(plan);
+	fft_radix4_32(&plan->plan, plan->outb, time, true);
+
+	/* conjugate the output and compensate for the scaling */
+	for (i = 0; i < plan->plan.size; i++) {
+		icomplex_conj(&time[i]);
+		icomplex_shift(&time[i], plan->plan.len + 1, &time[i]);
+	}
+}
@@ -0,0 +1,261 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2022 Intel Corporation. All rights reserved.
+
+#include <sof/audio/format.h>
+#include <sof/common.h>
+#include <sof/lib/alloc.h>
+#include <sof/math/fft.h>
+#include <sof/math/fir_fft.h>
+#include <sof/math/numbers.h>
+#include <sof/string.h>
+#include <ipc/topology.h>
+#include <user/fir.h>
+#include <errno.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* Right shifts of the bins products to leave guard bits for the sum of
+ * up to FIR_FFT_MAX_LENGTH / FIR_FFT_BLOCK_MIN partitions.
+ */
+#define FIR_FFT_GUARD_BITS	8
+
+/* Max amount of left shifts of a low level spectrum before IFFT */
+#define FIR_FFT_NORM_BITS	12
+
+/* Get block size that gives about minimal cycles per sample. The direct
+ * form part costs block MACs and the frequency domain part about
+ * 4 * taps / block MACs per sample, so the block is set near 2 * sqrt(taps).
+ */
+int fir_fft_block_size(int taps)
+{
+	int block = FIR_FFT_BLOCK_MIN;
+
+	while (block < FIR_FFT_BLOCK_MAX && block * block < 4 * taps)
+		block <<= 1;
+
+	return block;
+}
+
+int fir_fft_plan_init(struct fir_fft_plan *plan, int block)
+{
+	int len = 0;
+
+	if (block < FIR_FFT_BLOCK_MIN || block > FIR_FFT_BLOCK_MAX || (block & (block - 1)))
+		return -EINVAL;
+
+	while ((1 << len) < block)
+		len++;
+
+	plan->block = block;
+	plan->block_len = len;
+	plan->time = rballoc(0, SOF_MEM_CAPS_RAM, 2 * block * sizeof(int32_t));
+	plan->freq = rballoc(0, SOF_MEM_CAPS_RAM, (block + 1) * sizeof(struct icomplex32));
+	plan->acc = rballoc(0, SOF_MEM_CAPS_RAM, 2 * (block + 1) * sizeof(int64_t));
+	if (!plan->time || !plan->freq || !plan->acc)
+		goto err;
+
+	plan->fft = fft_plan_new_real(plan->time, plan->freq, 2 * block);
+	if (!plan->fft)
+		goto err;
+
+	return 0;
+
+err:
+	fir_fft_plan_free(plan);
+	return -ENOMEM;
+}
+
+void fir_fft_plan_free(struct fir_fft_plan *plan)
+{
+	fft_plan_free_real(plan->fft);
+	rfree(plan->time);
+	rfree(plan->freq);
+	rfree(plan->acc);
+	plan->fft = NULL;
+	plan->time = NULL;
+	plan->freq = NULL;
+	plan->acc = NULL;
+}
+
+static int fir_fft_partitions(struct fir_fft_plan *plan, int taps)
+{
+	return (MAX(taps - plan->block, 0) + plan->block - 1) >> plan->block_len;
+}
+
+int fir_fft_coef_size(struct fir_fft_plan *plan, struct sof_fir_coef_data *config)
+{
+	/* Check FIR tap count and shift for implementation specific constraints */
+	if (config->length > FIR_FFT_MAX_LENGTH || config->length < 4)
+		return -EINVAL;
+
+	if (config->out_shift < 0)
+		return -EINVAL;
+
+	return fir_fft_partitions(plan, config->length) * (plan->block + 1) *
+		sizeof(struct icomplex32);
+}
+
+int fir_fft_init_coef(struct fir_fft_plan *plan, struct fir_fft_coef *coef,
+		      struct sof_fir_coef_data *config, int32_t **data)
+{
+	struct fft_plan_real *fft = plan->fft;
+	const int block = plan->block;
+	const int bins = block + 1;
+	int16_t *h = ASSUME_ALIGNED(&config->coef[0], 4);
+	int i;
+	int j;
+	int p;
+
+	coef->taps = config->length;
+	coef->head_taps = MIN(coef->taps, block);
+	coef->partitions = fir_fft_partitions(plan, coef->taps);
+	coef->out_shift = config->out_shift;
+	coef->head = h;
+	coef->h = (struct icomplex32 *)*data;
+	*data += coef->partitions * bins * 2; /* Point to next free data */
+
+	/* Spectrum of each zero padded partition of Q1.15 taps as Q1.31 */
+	for (p = 0; p < coef->partitions; p++) {
+		for (i = 0; i < block; i++) {
+			j = block * (p + 1) + i;
+			plan->time[i] = j < coef->taps ? (int32_t)h[j] << 16 : 0;
+			plan->time[block + i] = 0;
+		}
+
+		fft->outb = &coef->h[p * bins];
+		fft_execute_real(fft, false);
+	}
+
+	fft->outb = plan->freq;
+	return 0;
+}
+
+int fir_fft_delay_size(struct fir_fft_plan *plan, struct sof_fir_coef_data *config)
+{
+	int size = fir_fft_coef_size(plan, config);
+
+	if (size < 0)
+		return size;
+
+	/* Input of two blocks, tail output block, and spectra of partitions */
+	return 3 * plan->block * sizeof(int32_t) + size;
+}
+
+void fir_fft_init_delay(struct fir_fft_plan *plan, struct fir_fft_state *fir,
+			const struct fir_fft_coef *coef, int32_t **data)
+{
+	fir->coef = coef;
+	fir->fdl_idx = 0;
+	fir->xi = 0;
+	fir->x = *data;
+	fir->y = fir->x + 2 * plan->block;
+	fir->fdl = (struct icomplex32 *)(fir->y + plan->block);
+	*data = (int32_t *)(fir->fdl + coef->partitions * (plan->block + 1));
+}
+
+void fir_fft_reset(struct fir_fft_state *fir)
+{
+	fir->coef = NULL;
+	fir->fdl_idx = 0;
+	fir->xi = 0;
+	/* The delay lines are part of a bigger allocation so omitting setting
+	 * the pointers to NULL.
+	 */
+}
+
+/*
+ * Compute tail output for the next block from the frequency domain delay
+ * line of input spectra and the spectra of the partitions.
+ */
+void fir_fft_block(struct fir_fft_plan *plan, struct fir_fft_state *fir)
+{
+	const struct fir_fft_coef *coef = fir->coef;
+	struct fft_plan_real *fft = plan->fft;
+	struct icomplex32 *x;
+	struct icomplex32 *h;
+	int64_t *acc = plan->acc;
+	int64_t sum;
+	const int block = plan->block;
+	const int bins = block + 1;
+	const int partitions = coef->partitions;
+	int shift;
+	int norm;
+	int idx;
+	int i;
+	int p;
+
+	fir->xi = 0;
+	if (!partitions)
+		goto shift_input;
+
+	/* Spectrum of previous and current input block to delay line */
+	idx = fir->fdl_idx;
+	fft->inb = fir->x;
+	fft->outb = &fir->fdl[idx * bins];
+	fft_execute_real(fft, false);
+
+	/* Multiply-accumulate the input spectra with the partitions spectra */
+	memset(acc, 0, 2 * bins * sizeof(int64_t));
+	for (p = 0; p < partitions; p++) {
+		x = &fir->fdl[idx * bins];
+		h = &coef->h[p * bins];
+		for (i = 0; i < bins; i++) {
+			acc[2 * i] += ((int64_t)x[i].real * h[i].real -
+				       (int64_t)x[i].imag * h[i].imag) >> FIR_FFT_GUARD_BITS;
+			acc[2 * i + 1] += ((int64_t)x[i].real * h[i].imag +
+					   (int64_t)x[i].imag * h[i].real) >> FIR_FFT_GUARD_BITS;
+		}
+
+		idx = idx ? idx - 1 : partitions - 1;
+	}
+
+	/* The FFT scales both spectra by 1/N and IFFT of the product needs
+	 * a 1/N scale, so the Q2.62 product is scaled up by N to Q1.31 and
+	 * the output shift is applied here. The spectrum is first kept with
+	 * FIR_FFT_NORM_BITS more fractional bits.
+	 */
+	shift = 31 - FIR_FFT_GUARD_BITS - FIR_FFT_NORM_BITS - (plan->block_len + 1) +
+		coef->out_shift;
+	sum = 0;
+	for (i = 0; i < 2 * bins; i++) {
+		acc[i] = ((acc[i] >> (shift - 1)) + 1) >> 1;
+		sum += acc[i] < 0 ? -acc[i] : acc[i];
+	}
+
+	/* The IFFT scales the input by 1/N that would lose the precision of a
+	 * low level spectrum. The output is bounded by two times the sum of
+	 * magnitudes of the bins, so scale the spectrum up as much as the
+	 * bound allows and scale the output back after IFFT.
+	 */
+	sum <<= 1;
+	norm = 0;
+	while (norm < FIR_FFT_NORM_BITS && (sum << (norm + 1)) < (1LL << (31 + FIR_FFT_NORM_BITS)))
+		norm++;
+
+	shift = FIR_FFT_NORM_BITS - norm;
+	for (i = 0; i < bins; i++) {
+		plan->freq[i].real = sat_int32(shift ? ((acc[2 * i] >> (shift - 1)) + 1) >> 1 :
+					       acc[2 * i]);
+		plan->freq[i].imag = sat_int32(shift ? ((acc[2 * i + 1] >> (shift - 1)) + 1) >> 1 :
+					       acc[2 * i + 1]);
+	}
+
+	fft->inb = plan->time;
+	fft->outb = plan->freq;
+	fft_execute_real(fft, true);
+
+	/* The last block of circular convolution is the valid output */
+	if (norm) {
+		for (i = 0; i < block; i++)
+			fir->y[i] = ((plan->time[block + i] >> (norm - 1)) + 1) >> 1;
+	} else {
+		memcpy_s(fir->y, block * sizeof(int32_t), &plan->time[block],
+			 block * sizeof(int32_t));
+	}
+
+	fir->fdl_idx = fir->fdl_idx + 1 < partitions ? fir->fdl_idx + 1 : 0;
+
+shift_input:
+	memcpy_s(fir->x, block * sizeof(int32_t), &fir->x[block], block * sizeof(int32_t));
+}
@@ -0,0 +1,180 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2022 Intel Corporation. All rights reserved.
+
+#include <sof/audio/format.h>
+#include <sof/common.h>
+#include <sof/math/iir_df2t.h>
+#include <sof/math/iir_df2t_block.h>
+#include <sof/string.h>
+#include <user/eq.h>
+#include <errno.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#if IIR_DF2T_BLOCK
+
+/* Coefficients order is {a2, a1, b2, b1, b0, shift, gain} */
+#define IIR_DF2T_BLOCK_B0	4
+#define IIR_DF2T_BLOCK_SHIFT	5
+#define IIR_DF2T_BLOCK_GAIN	6
+
+/* Unity section for channels in bypass. The gain Q2.14 of 2 with shift of
+ * one is exact also for the HiFi3 multiply that drops the gain LSB.
+ */
+#define IIR_DF2T_BLOCK_UNITY_B0		(1 << 30)	/* Q2.30 */
+#define IIR_DF2T_BLOCK_UNITY_GAIN	(1 << 15)	/* Q2.14 */
+#define IIR_DF2T_BLOCK_UNITY_SHIFT	1
+
+/* Returns the filter that sets the structure for all channels */
+static struct iir_state_df2t *iir_df2t_block_ref(struct iir_state_df2t *iir,
+						 int nch)
+{
+	struct iir_state_df2t *ref = NULL;
+	int i;
+
+	for (i = 0; i < nch; i++) {
+		if (!iir[i].biquads)
+			continue;
+
+		if (!ref) {
+			ref = &iir[i];
+			continue;
+		}
+
+		if (iir[i].biquads != ref->biquads ||
+		    iir[i].biquads_in_series != ref->biquads_in_series)
+			return NULL;
+	}
+
+	if (!ref || !ref->biquads_in_series ||
+	    ref->biquads % ref->biquads_in_series)
+		return NULL;
+
+	return ref;
+}
+
+int iir_df2t_block_size(struct iir_state_df2t *iir, int nch)
+{
+	struct iir_state_df2t *ref = iir_df2t_block_ref(iir, nch);
+	int lanes = IIR_DF2T_BLOCK_NLANES(nch);
+	int size;
+
+	if (!ref)
+		return -EINVAL;
+
+	size = ref->biquads * lanes * (IIR_DF2T_NUM_DELAYS * sizeof(int64_t) +
+				       SOF_EQ_IIR_NBIQUAD_DF2T * sizeof(int32_t));
+
+	/* Parallel sections need a buffer for the branches sum */
+	if (ref->biquads != ref->biquads_in_series)
+		size += IIR_DF2T_BLOCK_SAMPLES(nch) * sizeof(int32_t);
+
+	return size;
+}
+
+void iir_df2t_block_init(struct iir_df2t_block *blk, struct iir_state_df2t *iir,
+			 int nch, void **data)
+{
+	struct iir_state_df2t *ref = iir_df2t_block_ref(iir, nch);
+	int32_t *coef;
+	int lanes = IIR_DF2T_BLOCK_NLANES(nch);
+	int ch;
+	int i;
+	int k;
+
+	blk->channels = nch;
+	blk->lanes = lanes;
+	blk->biquads = ref->biquads;
+	blk->biquads_in_series = ref->biquads_in_series;
+
+	/* The 64 bit delays go first to keep them aligned */
+	blk->delay = *data;
+	blk->coef = (int32_t *)(blk->delay + blk->biquads * IIR_DF2T_NUM_DELAYS * lanes);
+	coef = blk->coef + blk->biquads * SOF_EQ_IIR_NBIQUAD_DF2T * lanes;
+	if (blk->biquads != blk->biquads_in_series) {
+		blk->sum = coef;
+		coef += IIR_DF2T_BLOCK_SAMPLES(nch);
+	} else {
+		blk->sum = NULL;
+	}
+
+	*data = coef;
+
+	/* Transpose to [biquad][coefficient][lane], padding lanes stay zero
+	 * and output silence. Bypass channels use unity sections in the first
+	 * branch and zero sections in the others.
+	 */
+	coef = blk->coef;
+	for (i = 0; i < blk->biquads; i++) {
+		for (k = 0; k < SOF_EQ_IIR_NBIQUAD_DF2T; k++) {
+			for (ch = 0; ch < lanes; ch++)
+				coef[ch] = 0;
+
+			for (ch = 0; ch < nch; ch++) {
+				if (iir[ch].biquads)
+					coef[ch] = iir[ch].coef[i * SOF_EQ_IIR_NBIQUAD_DF2T + k];
+				else if (i < blk->biquads_in_series && k == IIR_DF2T_BLOCK_B0)
+					coef[ch] = IIR_DF2T_BLOCK_UNITY_B0;
+				else if (i < blk->biquads_in_series && k == IIR_DF2T_BLOCK_SHIFT)
+					coef[ch] = IIR_DF2T_BLOCK_UNITY_SHIFT;
+				else if (i < blk->biquads_in_series && k == IIR_DF2T_BLOCK_GAIN)
+					coef[ch] = IIR_DF2T_BLOCK_UNITY_GAIN;
+			}
+
+			coef += lanes;
+		}
+	}
+
+	iir_df2t_block_reset(blk);
+}
+
+void iir_df2t_block_reset(struct iir_df2t_block *blk)
+{
+	memset(blk->delay, 0,
+	       blk->biquads * IIR_DF2T_NUM_DELAYS * blk->lanes * sizeof(int64_t));
+}
+
+/* Runs one branch of sections in series in place */
+static void iir_df2t_block_series(struct iir_df2t_block *blk, int first,
+				  int32_t *data, int frames)
+{
+	const int lanes = blk->lanes;
+	int i;
+
+	for (i = first; i < first + blk->biquads_in_series; i++)
+		iir_df2t_block_biquad(blk->coef + i * SOF_EQ_IIR_NBIQUAD_DF2T * lanes,
+				      blk->delay + i * IIR_DF2T_NUM_DELAYS * lanes,
+				      data, frames, lanes);
+}
+
+void iir_df2t_block(struct iir_df2t_block *blk, int32_t *data, int frames)
+{
+	const size_t bytes = frames * blk->lanes * sizeof(int32_t);
+	const int n = frames * blk->lanes;
+	int i;
+	int j;
+
+	if (!blk->sum) {
+		iir_df2t_block_series(blk, 0, data, frames);
+		return;
+	}
+
+	/* As in iir_df2t() a parallel branch gets the previous branch output
+	 * as input and the branch outputs are summed with saturation.
+	 */
+	for (j = 0; j < blk->biquads; j += blk->biquads_in_series) {
+		iir_df2t_block_series(blk, j, data, frames);
+		if (!j) {
+			memcpy_s(blk->sum, bytes, data, bytes);
+			continue;
+		}
+
+		for (i = 0; i < n; i++)
+			blk->sum[i] = sat_int32((int64_t)blk->sum[i] + data[i]);
+	}
+
+	memcpy_s(data, bytes, blk->sum, bytes);
+}
+
+#endif /* IIR_DF2T_BLOCK */
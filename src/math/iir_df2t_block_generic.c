@@ -0,0 +1,81 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2022 Intel Corporation. All rights reserved.
+
+#include <sof/audio/format.h>
+#include <sof/math/iir_df2t.h>
+#include <sof/math/iir_df2t_block.h>
+#include <user/eq.h>
+#include <stdint.h>
+
+#if IIR_GENERIC
+
+/*
+ * One DF2T biquad for a block of frames, see iir_df2t() for the diagram and
+ * the arithmetic. The channels are run in pairs with the coefficients and
+ * delays of a pair in local arrays, which lets the compiler keep them in
+ * registers and vectorize the two independent lanes.
+ */
+void iir_df2t_block_biquad(const int32_t *coef, int64_t *delay, int32_t *data,
+			   int frames, int lanes)
+{
+	int64_t d0[IIR_DF2T_BLOCK_LANES];
+	int64_t d1[IIR_DF2T_BLOCK_LANES];
+	int32_t a2[IIR_DF2T_BLOCK_LANES];
+	int32_t a1[IIR_DF2T_BLOCK_LANES];
+	int32_t b2[IIR_DF2T_BLOCK_LANES];
+	int32_t b1[IIR_DF2T_BLOCK_LANES];
+	int32_t b0[IIR_DF2T_BLOCK_LANES];
+	int32_t shift[IIR_DF2T_BLOCK_LANES];
+	int32_t gain[IIR_DF2T_BLOCK_LANES];
+	int64_t acc;
+	int32_t *x;
+	int32_t in;
+	int32_t tmp;
+	int ch;
+	int i;
+	int l;
+
+	for (ch = 0; ch < lanes; ch += IIR_DF2T_BLOCK_LANES) {
+		for (l = 0; l < IIR_DF2T_BLOCK_LANES; l++) {
+			a2[l] = coef[ch + l];
+			a1[l] = coef[lanes + ch + l];
+			b2[l] = coef[2 * lanes + ch + l];
+			b1[l] = coef[3 * lanes + ch + l];
+			b0[l] = coef[4 * lanes + ch + l];
+			shift[l] = coef[5 * lanes + ch + l];
+			gain[l] = coef[6 * lanes + ch + l];
+			d0[l] = delay[ch + l];
+			d1[l] = delay[lanes + ch + l];
+		}
+
+		x = data + ch;
+		for (i = 0; i < frames; i++) {
+			for (l = 0; l < IIR_DF2T_BLOCK_LANES; l++) {
+				in = x[l];
+
+				/* Q2.30 x Q1.31 -> Q3.61, saturate to Q1.31 */
+				acc = (int64_t)b0[l] * in + d0[l];
+				tmp = (int32_t)sat_int32(Q_SHIFT_RND(acc, 61, 31));
+
+				/* Update delays */
+				d0[l] = d1[l] + (int64_t)b1[l] * in + (int64_t)a1[l] * tmp;
+				d1[l] = (int64_t)b2[l] * in + (int64_t)a2[l] * tmp;
+
+				/* Gain Q2.14 x Q1.31 -> Q3.45 and output shift */
+				acc = (int64_t)gain[l] * tmp;
+				acc = Q_SHIFT_RND(acc, 45 + shift[l], 31);
+				x[l] = sat_int32(acc);
+			}
+
+			x += lanes;
+		}
+
+		for (l = 0; l < IIR_DF2T_BLOCK_LANES; l++) {
+			delay[ch + l] = d0[l];
+			delay[lanes + ch + l] = d1[l];
+		}
+	}
+}
+
+#endif
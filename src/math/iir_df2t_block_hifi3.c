@@ -0,0 +1,120 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2022 Intel Corporation. All rights reserved.
+
+#include <sof/audio/format.h>
+#include <sof/math/iir_df2t.h>
+#include <sof/math/iir_df2t_block.h>
+#include <user/eq.h>
+#include <stdint.h>
+
+#if IIR_HIFI3
+
+#if CONFIG_MATH_IIR_DF2T_BLOCK_HIFI3
+
+#include <xtensa/tie/xt_hifi3.h>
+
+/*
+ * One DF2T biquad for a block of frames, see iir_df2t() for the diagram and
+ * the arithmetic. A channel pair is loaded and stored as one ae_f32x2 with
+ * the lower address channel in the high half. The two lanes have their own
+ * accumulators, which interleaves two independent dependency chains. The
+ * delays are kept Q17.47 as in the single channel HiFi3 version.
+ */
+void iir_df2t_block_biquad(const int32_t *coef, int64_t *delay, int32_t *data,
+			   int frames, int lanes)
+{
+	ae_f64 acc_h;
+	ae_f64 acc_l;
+	ae_f64 d0_h;
+	ae_f64 d0_l;
+	ae_f64 d1_h;
+	ae_f64 d1_l;
+	ae_f32x2 a2;
+	ae_f32x2 a1;
+	ae_f32x2 b2;
+	ae_f32x2 b1;
+	ae_f32x2 b0;
+	ae_f32x2 gain;
+	ae_f32x2 in;
+	ae_f32x2 tmp;
+	ae_f32x2 *x;
+	ae_int64 *dp;
+	const int step = lanes * sizeof(int32_t);
+	int shift_h;
+	int shift_l;
+	int ch;
+	int i;
+
+	for (ch = 0; ch < lanes; ch += IIR_DF2T_BLOCK_LANES) {
+		a2 = *(ae_f32x2 *)&coef[ch];
+		a1 = *(ae_f32x2 *)&coef[lanes + ch];
+		b2 = *(ae_f32x2 *)&coef[2 * lanes + ch];
+		b1 = *(ae_f32x2 *)&coef[3 * lanes + ch];
+		b0 = *(ae_f32x2 *)&coef[4 * lanes + ch];
+		shift_h = coef[5 * lanes + ch];
+		shift_l = coef[5 * lanes + ch + 1];
+		gain = *(ae_f32x2 *)&coef[6 * lanes + ch];
+
+		dp = (ae_int64 *)&delay[ch];
+		d0_h = dp[0];
+		d0_l = dp[1];
+		dp = (ae_int64 *)&delay[lanes + ch];
+		d1_h = dp[0];
+		d1_l = dp[1];
+
+		x = (ae_f32x2 *)&data[ch];
+		for (i = 0; i < frames; i++) {
+			in = *x;
+
+			/* Output, delay Q17.47 to MAC Q18.46 alignment */
+			acc_h = AE_SRAI64(d0_h, 1);
+			acc_l = AE_SRAI64(d0_l, 1);
+			AE_MULAF32R_HH(acc_h, b0, in);
+			AE_MULAF32R_LL(acc_l, b0, in);
+			acc_h = AE_SLAI64S(acc_h, 1);
+			acc_l = AE_SLAI64S(acc_l, 1);
+			tmp = AE_ROUND32X2F48SSYM(acc_h, acc_l);
+
+			/* Delay d0 */
+			acc_h = AE_SRAI64(d1_h, 1);
+			acc_l = AE_SRAI64(d1_l, 1);
+			AE_MULAF32R_HH(acc_h, b1, in);
+			AE_MULAF32R_LL(acc_l, b1, in);
+			AE_MULAF32R_HH(acc_h, a1, tmp);
+			AE_MULAF32R_LL(acc_l, a1, tmp);
+			d0_h = AE_SLAI64S(acc_h, 1);
+			d0_l = AE_SLAI64S(acc_l, 1);
+
+			/* Delay d1 */
+			acc_h = AE_MULF32R_HH(b2, in);
+			acc_l = AE_MULF32R_LL(b2, in);
+			AE_MULAF32R_HH(acc_h, a2, tmp);
+			AE_MULAF32R_LL(acc_l, a2, tmp);
+			d1_h = AE_SLAI64S(acc_h, 1);
+			d1_l = AE_SLAI64S(acc_l, 1);
+
+			/* Gain Q18.14 x Q1.31 -> Q34.30 -> Q17.47, output shift */
+			acc_h = AE_MULF32R_HH(gain, tmp);
+			acc_l = AE_MULF32R_LL(gain, tmp);
+			acc_h = AE_SLAI64S(acc_h, 17);
+			acc_l = AE_SLAI64S(acc_l, 17);
+			acc_h = AE_SRAA64(acc_h, shift_h);
+			acc_l = AE_SRAA64(acc_l, shift_l);
+			*x = AE_ROUND32X2F48SSYM(acc_h, acc_l);
+
+			x = (ae_f32x2 *)((int8_t *)x + step);
+		}
+
+		dp = (ae_int64 *)&delay[ch];
+		dp[0] = d0_h;
+		dp[1] = d0_l;
+		dp = (ae_int64 *)&delay[lanes + ch];
+		dp[0] = d1_h;
+		dp[1] = d1_l;
+	}
+}
+
+#endif /* CONFIG_MATH_IIR_DF2T_BLOCK_HIFI3 */
+
+#endif /* IIR_HIFI3 */
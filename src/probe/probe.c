@@ -11,6 +11,7 @@
 #include <sof/trace/trace.h>
 #include <user/trace.h>
 #include <sof/lib/alloc.h>
+#include <sof/lib/clk.h>
 #include <sof/lib/dma.h>
 #include <sof/lib/notifier.h>
 #include <sof/lib/uuid.h>
@@ -37,6 +38,9 @@ DECLARE_SOF_UUID("probe-task", probe_task_uuid, 0x2f0b1901, 0xcac0, 0x4b87,
 #define PROBE_BUFFER_LOCAL_SIZE		8192
 #define DMA_ELEM_SIZE		32
 
+/* extraction packets carry whole words of data */
+#define PROBE_BATCH_SIZE	ALIGN_UP_COMPILE(CONFIG_PROBE_BATCH_SIZE, sizeof(uint32_t))
+
 /**
  * DMA buffer
  */
@@ -60,14 +64,40 @@ struct probe_dma_ext {
 	struct dma_copy dc;		/**< DMA copy */
 };
 
+/**
+ * Probe point, registered as the receiver of its buffer notifications
+ */
+struct probe_point_data {
+	uint32_t buffer_id;		/**< ID of buffer to which probe is attached */
+	uint32_t purpose;		/**< PROBE_PURPOSE_EXTRACTION or PROBE_PURPOSE_INJECTION */
+	uint32_t stream_tag;		/**< stream tag of DMA */
+	uint32_t reduction;		/**< extraction data reduction flags from purpose */
+	struct probe_dma_ext *dma;	/**< injection DMA */
+
+	/* extraction batch */
+	uint8_t *batch;			/**< data coalesced for the next packet */
+	uint32_t batch_bytes;		/**< bytes of data in batch */
+	uint32_t transactions;		/**< buffer transactions started in batch */
+	uint32_t sequence;		/**< sequence number of the next packet */
+	uint32_t format;		/**< encoded format of batched data */
+	uint32_t frame_fmt;		/**< frame format of batched data */
+	uint64_t timestamp;		/**< timestamp of the first data in batch */
+	uint64_t deadline;		/**< time to send the batch even if not full */
+
+	/* extraction decimation */
+	uint32_t channel;		/**< channel of the next sample */
+	uint32_t frames;		/**< frames summed in acc */
+	int64_t acc[SOF_IPC_MAX_CHANNELS]; /**< sums of samples as Q1.31 */
+};
+
 /**
  * Probe main struct
  */
 struct probe_pdata {
 	struct probe_dma_ext ext_dma;				  /**< extraction DMA */
 	struct probe_dma_ext inject_dma[CONFIG_PROBE_DMA_MAX];	  /**< injection DMA */
-	struct probe_point probe_points[CONFIG_PROBE_POINTS_MAX]; /**< probe points */
-	struct probe_data_packet header;			  /**< data packet header */
+	struct probe_point_data probe_points[CONFIG_PROBE_POINTS_MAX]; /**< probe points */
+	struct probe_batch_packet header;			  /**< data packet header */
 	struct task dmap_work;					  /**< probe task */
 };
 
@@ -195,11 +225,19 @@ static int probe_dma_deinit(struct probe_dma_ext *dma)
  * Copy extraction probes data to host if available.
  * Return err if dma copy failed.
  */
+static void probe_batch_flush_expired(struct probe_pdata *_probe);
+
 static enum task_state probe_task(void *data)
 {
 	struct probe_pdata *_probe = probe_get();
 	int err;
 
+	/* the scheduled run also sends the batches of low rate probes, the
+	 * direct call is from a flush
+	 */
+	if (data)
+		probe_batch_flush_expired(_probe);
+
 	if (_probe->ext_dma.dmapb.avail > 0)
 		err = dma_copy_to_host(&_probe->ext_dma.dc,
 				       &_probe->ext_dma.config, 0,
@@ -596,43 +634,6 @@ static int copy_from_pbuffer(struct probe_dma_buf *pbuf, void *data,
 	return 0;
 }
 
-/**
- * \brief Generate probe data packet header, update timestamp, calc crc
- *	  and copy data to probe buffer.
- * \param[in] buffer component buffer pointer.
- * \param[in] size data size.
- * \param[in] format audio format.
- * \return 0 on success, error code otherwise.
- */
-static int probe_gen_header(struct comp_buffer *buffer, uint32_t size,
-			    uint32_t format)
-{
-	struct probe_pdata *_probe = probe_get();
-	struct probe_data_packet *header;
-	uint64_t timestamp;
-	uint32_t crc;
-
-	header = &_probe->header;
-	timestamp = platform_timer_get(timer_get());
-
-	header->sync_word = PROBE_EXTRACT_SYNC_WORD;
-	header->buffer_id = buffer->id;
-	header->format = format;
-	header->timestamp_low = (uint32_t)timestamp;
-	header->timestamp_high = (uint32_t)(timestamp >> 32);
-	header->checksum = 0;
-	header->data_size_bytes = size;
-
-	/* calc crc to check validation by probe parse app */
-	crc = crc32(0, header, sizeof(*header));
-	header->checksum = crc;
-
-	dcache_writeback_region(header, sizeof(*header));
-
-	return copy_to_pbuffer(&_probe->ext_dma.dmapb, header,
-			       sizeof(struct probe_data_packet));
-}
-
 /**
  * \brief Generate description of audio format for extraction probes.
  * \param[in] frame_fmt format
@@ -734,96 +735,314 @@ static uint32_t probe_gen_format(uint32_t frame_fmt, uint32_t rate,
 	return format;
 }
 
+/**
+ * \brief Send the batch of extraction probe point as one packet.
+ * \param[in,out] point probe point.
+ * \return 0 on success, error code otherwise.
+ */
+static int probe_batch_flush(struct probe_point_data *point)
+{
+	struct probe_pdata *_probe = probe_get();
+	struct probe_dma_buf *pbuf = &_probe->ext_dma.dmapb;
+	struct probe_batch_packet *header = &_probe->header;
+	uint32_t size = ALIGN_UP(point->batch_bytes, sizeof(uint32_t));
+	int ret;
+
+	if (!point->batch_bytes)
+		return 0;
+
+	header->sync_word = PROBE_EXTRACT_BATCH_SYNC_WORD;
+	header->buffer_id = point->buffer_id;
+	header->format = point->format;
+	header->timestamp_low = (uint32_t)point->timestamp;
+	header->timestamp_high = (uint32_t)(point->timestamp >> 32);
+	header->checksum = 0;
+	header->sequence = point->sequence++;
+	header->transactions = point->transactions;
+	header->data_size_bytes = point->batch_bytes;
+
+	/* pad data to whole words */
+	memset(point->batch + point->batch_bytes, 0, size - point->batch_bytes);
+	point->batch_bytes = 0;
+	point->transactions = 0;
+
+	/* drop the packet instead of overwriting data not sent yet, the
+	 * parse app sees the gap in sequence numbers
+	 */
+	if (pbuf->size - pbuf->avail < sizeof(*header) + size)
+		return 0;
+
+	/* calc crc to check validation by probe parse app */
+	header->checksum = crc32(0, header, sizeof(*header));
+
+	ret = copy_to_pbuffer(pbuf, header, sizeof(*header));
+	if (ret < 0)
+		return ret;
+
+	ret = copy_to_pbuffer(pbuf, point->batch, size);
+	if (ret < 0)
+		return ret;
+
+	/* check if more than 75% of buffer size is already used */
+	if (pbuf->size - pbuf->avail < pbuf->size >> 2)
+		probe_task(NULL);
+
+	return 0;
+}
+
+/**
+ * \brief Send the batches not filled within the flush period.
+ * \param[in] _probe probe main struct.
+ */
+static void probe_batch_flush_expired(struct probe_pdata *_probe)
+{
+	struct probe_point_data *point;
+	uint64_t now = platform_timer_get(timer_get());
+	int i;
+
+	for (i = 0; i < CONFIG_PROBE_POINTS_MAX; i++) {
+		point = &_probe->probe_points[i];
+		if (point->stream_tag == PROBE_POINT_INVALID ||
+		    point->purpose != PROBE_PURPOSE_EXTRACTION ||
+		    !point->batch_bytes || now < point->deadline)
+			continue;
+
+		if (probe_batch_flush(point) < 0)
+			tr_err(&pr_tr, "probe_batch_flush_expired(): failed to send probe data");
+	}
+}
+
+/**
+ * \brief Start new batch of probe point.
+ * \param[in,out] point probe point.
+ */
+static void probe_batch_start(struct probe_point_data *point)
+{
+	point->timestamp = platform_timer_get(timer_get());
+	point->deadline = point->timestamp +
+		clock_ms_to_ticks(PLATFORM_DEFAULT_CLOCK, CONFIG_PROBE_BATCH_FLUSH_MS);
+}
+
+/**
+ * \brief Add extracted data to the batch of probe point.
+ * \param[in,out] point probe point.
+ * \param[in] data pointer.
+ * \param[in] bytes size.
+ * \return 0 on success, error code otherwise.
+ */
+static int probe_batch_copy(struct probe_point_data *point, const void *data,
+			    uint32_t bytes)
+{
+	uint32_t copy_bytes;
+	int ret;
+
+	while (bytes) {
+		if (!point->batch_bytes)
+			probe_batch_start(point);
+
+		copy_bytes = MIN(bytes, PROBE_BATCH_SIZE - point->batch_bytes);
+		memcpy_s(point->batch + point->batch_bytes,
+			 PROBE_BATCH_SIZE - point->batch_bytes, data, copy_bytes);
+		point->batch_bytes += copy_bytes;
+		data = (const char *)data + copy_bytes;
+		bytes -= copy_bytes;
+
+		if (point->batch_bytes == PROBE_BATCH_SIZE) {
+			ret = probe_batch_flush(point);
+			if (ret < 0)
+				return ret;
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * \brief Add averaged frame to the batch of probe point.
+ * \param[in,out] point probe point.
+ * \param[in] channels number of channels.
+ * \param[in] decimation number of frames summed.
+ * \return 0 on success, error code otherwise.
+ */
+static int probe_batch_frame(struct probe_point_data *point, uint32_t channels,
+			     uint32_t decimation)
+{
+	uint32_t sample_bytes = get_sample_bytes(point->frame_fmt);
+	uint8_t *ptr;
+	int32_t sample;
+	uint32_t ch;
+	int ret;
+
+	if (PROBE_BATCH_SIZE - point->batch_bytes < channels * sample_bytes) {
+		ret = probe_batch_flush(point);
+		if (ret < 0)
+			return ret;
+	}
+
+	if (!point->batch_bytes)
+		probe_batch_start(point);
+
+	ptr = point->batch + point->batch_bytes;
+	for (ch = 0; ch < channels; ch++) {
+		sample = point->acc[ch] / (int32_t)decimation;
+		point->acc[ch] = 0;
+
+		switch (point->frame_fmt) {
+		case SOF_IPC_FRAME_S16_LE:
+			*(int16_t *)ptr = sample >> 16;
+			break;
+		case SOF_IPC_FRAME_S24_4LE:
+			*(int32_t *)ptr = sample >> 8;
+			break;
+		default:
+			*(int32_t *)ptr = sample;
+			break;
+		}
+
+		ptr += sample_bytes;
+	}
+
+	point->batch_bytes += channels * sample_bytes;
+
+	return 0;
+}
+
+/**
+ * \brief Decimate and requantize extracted integer samples to the batch.
+ * \param[in,out] point probe point.
+ * \param[in] stream stream of probed buffer.
+ * \param[in] src first sample of transaction.
+ * \param[in] bytes size of transaction.
+ * \param[in] decimation number of frames averaged to one.
+ * \return 0 on success, error code otherwise.
+ */
+static int probe_extract_reduce(struct probe_point_data *point,
+				const struct audio_stream *stream, void *src,
+				uint32_t bytes, uint32_t decimation)
+{
+	uint32_t sample_bytes = audio_stream_sample_bytes(stream);
+	uint32_t samples = bytes / sample_bytes;
+	int32_t sample;
+	int ret;
+
+	while (samples--) {
+		switch (stream->frame_fmt) {
+		case SOF_IPC_FRAME_S16_LE:
+			sample = *(int16_t *)src << 16;
+			break;
+		case SOF_IPC_FRAME_S24_4LE:
+			sample = *(int32_t *)src << 8;
+			break;
+		default:
+			sample = *(int32_t *)src;
+			break;
+		}
+
+		src = audio_stream_wrap(stream, (char *)src + sample_bytes);
+		point->acc[point->channel] += sample;
+		if (++point->channel < stream->channels)
+			continue;
+
+		point->channel = 0;
+		if (++point->frames < decimation)
+			continue;
+
+		point->frames = 0;
+		ret = probe_batch_frame(point, stream->channels, decimation);
+		if (ret < 0)
+			return ret;
+	}
+
+	return 0;
+}
+
+/**
+ * \brief Add data of buffer transaction to the batch of extraction probe.
+ * \param[in,out] point probe point.
+ * \param[in] cb_data buffer transaction.
+ * \return 0 on success, error code otherwise.
+ */
+static int probe_extract(struct probe_point_data *point,
+			 struct buffer_cb_transact *cb_data)
+{
+	struct audio_stream *stream = &cb_data->buffer->stream;
+	uint32_t frame_fmt = stream->frame_fmt;
+	uint32_t decimation = 1;
+	uint32_t format;
+	uint32_t head;
+	bool reduce;
+	int ret;
+
+	/* only integer samples are reduced */
+	reduce = point->reduction && stream->frame_fmt != SOF_IPC_FRAME_FLOAT &&
+		 stream->channels <= SOF_IPC_MAX_CHANNELS;
+	if (reduce) {
+		decimation = ((point->reduction & PROBE_MASK_DECIMATION) >>
+			      PROBE_SHIFT_DECIMATION) + 1;
+		if (point->reduction & PROBE_EXTRACT_S16)
+			frame_fmt = SOF_IPC_FRAME_S16_LE;
+	}
+
+	/* start new packet when the format changes */
+	format = probe_gen_format(frame_fmt, stream->rate / decimation,
+				  stream->channels);
+	if (format != point->format) {
+		ret = probe_batch_flush(point);
+		if (ret < 0)
+			return ret;
+
+		point->format = format;
+		point->frame_fmt = frame_fmt;
+		point->channel = 0;
+		point->frames = 0;
+		memset(point->acc, 0, sizeof(point->acc));
+	}
+
+	point->transactions++;
+
+	if (reduce)
+		return probe_extract_reduce(point, stream,
+					    cb_data->transaction_begin_address,
+					    cb_data->transaction_amount, decimation);
+
+	/* check if transaction amount exceeds component buffer end addr */
+	/* if yes: divide copying into two stages, head and tail */
+	head = (char *)stream->end_addr - (char *)cb_data->transaction_begin_address;
+	head = MIN(head, cb_data->transaction_amount);
+	ret = probe_batch_copy(point, cb_data->transaction_begin_address, head);
+	if (ret < 0)
+		return ret;
+
+	return probe_batch_copy(point, stream->addr, cb_data->transaction_amount - head);
+}
+
 /**
  * \brief General extraction probe callback, called from buffer produce.
- *	  It will search for probe point connected to this buffer.
- *	  Extraction probe: generate format, header and copy data to probe buffer.
- *	  Injection probe: find corresponding DMA, check avail data, copy data,
+ *	  The probe point is the notification receiver so no search is needed.
+ *	  Extraction probe: add data to the batch of the probe point, which is
+ *	  sent with one header when full.
+ *	  Injection probe: check avail data of its DMA, copy data,
  *	  update pointers and request more data from host if needed.
- * \param[in] arg pointer (not used).
+ * \param[in] arg probe point.
  * \param[in] type of notify.
  * \param[in] data pointer.
  */
 static void probe_cb_produce(void *arg, enum notify_id type, void *data)
 {
-	struct probe_pdata *_probe = probe_get();
+	struct probe_point_data *point = arg;
 	struct buffer_cb_transact *cb_data = data;
-	struct comp_buffer *buffer = cb_data->buffer;
 	struct probe_dma_ext *dma;
-	uint32_t buffer_id;
 	uint32_t head, tail;
 	uint32_t free_bytes = 0;
 	int32_t copy_bytes = 0;
 	int ret;
-	uint32_t i, j;
-	uint32_t format;
 
-	buffer_id = buffer->id;
-
-	/* search for probe point connected to this buffer */
-	for (i = 0; i < CONFIG_PROBE_POINTS_MAX; i++)
-		if (_probe->probe_points[i].buffer_id == buffer_id)
-			break;
-
-	if (i == CONFIG_PROBE_POINTS_MAX) {
-		tr_err(&pr_tr, "probe_cb_produce(): probe not found for buffer id: %d",
-		       buffer_id);
-		return;
-	}
-
-	if (_probe->probe_points[i].purpose == PROBE_PURPOSE_EXTRACTION) {
-		format = probe_gen_format(buffer->stream.frame_fmt,
-					  buffer->stream.rate,
-					  buffer->stream.channels);
-		ret = probe_gen_header(buffer,
-				       cb_data->transaction_amount,
-				       format);
+	if (point->purpose == PROBE_PURPOSE_EXTRACTION) {
+		ret = probe_extract(point, cb_data);
 		if (ret < 0)
 			goto err;
-
-		/* check if transaction amount exceeds component buffer end addr */
-		/* if yes: divide copying into two stages, head and tail */
-		if ((char *)cb_data->transaction_begin_address +
-		    cb_data->transaction_amount > (char *)buffer->stream.end_addr) {
-			head = (uintptr_t)buffer->stream.end_addr -
-			       (uintptr_t)cb_data->transaction_begin_address;
-			tail = (uintptr_t)cb_data->transaction_amount - head;
-			ret = copy_to_pbuffer(&_probe->ext_dma.dmapb,
-					      cb_data->transaction_begin_address,
-					      head);
-			if (ret < 0)
-				goto err;
-
-			ret = copy_to_pbuffer(&_probe->ext_dma.dmapb,
-					      buffer->stream.addr, tail);
-			if (ret < 0)
-				goto err;
-		} else {
-			ret = copy_to_pbuffer(&_probe->ext_dma.dmapb,
-					      cb_data->transaction_begin_address,
-					      cb_data->transaction_amount);
-			if (ret < 0)
-				goto err;
-		}
-		/* check if more than 75% of buffer size is already used */
-		if (_probe->ext_dma.dmapb.size - _probe->ext_dma.dmapb.avail <
-		    _probe->ext_dma.dmapb.size >> 2)
-			probe_task(NULL);
 	} else {
-		/* search for DMA used by this probe point */
-		for (j = 0; j < CONFIG_PROBE_DMA_MAX; j++) {
-			if (_probe->inject_dma[j].stream_tag !=
-			    PROBE_DMA_INVALID &&
-			    _probe->inject_dma[j].stream_tag ==
-			    _probe->probe_points[i].stream_tag) {
-				break;
-			}
-		}
-		if (j == CONFIG_PROBE_DMA_MAX) {
-			tr_err(&pr_tr, "probe_cb_produce(): dma not found");
-			return;
-		}
-		dma = &_probe->inject_dma[j];
+		dma = point->dma;
 		/* get avail data info */
 		ret = dma_get_data_size(dma->dc.chan,
 					&dma->dmapb.avail,
@@ -887,23 +1106,45 @@ err:
 	tr_err(&pr_tr, "probe_cb_produce(): failed to generate probe data");
 }
 
+/**
+ * \brief Detach probe point from its buffer, send the remaining extracted
+ *	  data and free the batch.
+ * \param[in] point probe point.
+ * \param[in] buffer buffer the probe is attached to or NULL if not found.
+ */
+static void probe_point_free(struct probe_point_data *point,
+			     struct comp_buffer *buffer)
+{
+	if (buffer) {
+		notifier_unregister(point, buffer, NOTIFIER_ID_BUFFER_PRODUCE);
+		notifier_unregister(point, buffer, NOTIFIER_ID_BUFFER_FREE);
+	}
+
+	if (point->purpose == PROBE_PURPOSE_EXTRACTION) {
+		if (probe_batch_flush(point) < 0)
+			tr_err(&pr_tr, "probe_point_free(): failed to send probe data");
+
+		rfree(point->batch);
+		point->batch = NULL;
+	}
+
+	point->stream_tag = PROBE_POINT_INVALID;
+}
+
 /**
  * \brief Callback for buffer free, it will remove probe point.
- * \param[in] arg pointer (not used).
+ * \param[in] arg probe point.
  * \param[in] type of notify.
  * \param[in] data pointer.
  */
 static void probe_cb_free(void *arg, enum notify_id type, void *data)
 {
 	struct buffer_cb_free *cb_data = data;
-	uint32_t buffer_id = cb_data->buffer->id;
-	int ret;
+	struct probe_point_data *point = arg;
 
-	tr_dbg(&pr_tr, "probe_cb_free() buffer_id = %u", buffer_id);
+	tr_dbg(&pr_tr, "probe_cb_free() buffer_id = %u", point->buffer_id);
 
-	ret = probe_point_remove(1, &buffer_id);
-	if (ret < 0)
-		tr_err(&pr_tr, "probe_cb_free(): probe_point_remove() failed");
+	probe_point_free(point, cb_data->buffer);
 }
 
 int probe_point_add(uint32_t count, struct probe_point *probe)
@@ -914,7 +1155,11 @@ int probe_point_add(uint32_t count, struct probe_point *probe)
 	uint32_t buffer_id;
 	uint32_t first_free;
 	uint32_t dma_found;
+	uint32_t purpose;
+	uint32_t reduction;
 	struct ipc_comp_dev *dev;
+	struct probe_point_data *point;
+	uint8_t *batch;
 
 	tr_dbg(&pr_tr, "probe_point_add() count = %u", count);
 
@@ -930,15 +1175,20 @@ int probe_point_add(uint32_t count, struct probe_point *probe)
 		       i, probe[i].buffer_id, probe[i].purpose,
 		       probe[i].stream_tag);
 
-		if (probe[i].purpose != PROBE_PURPOSE_EXTRACTION &&
-		    probe[i].purpose != PROBE_PURPOSE_INJECTION) {
+		purpose = probe[i].purpose & PROBE_MASK_PURPOSE;
+		reduction = probe[i].purpose & ~PROBE_MASK_PURPOSE;
+
+		if ((purpose != PROBE_PURPOSE_EXTRACTION &&
+		     purpose != PROBE_PURPOSE_INJECTION) ||
+		    (reduction && purpose != PROBE_PURPOSE_EXTRACTION) ||
+		    (reduction & ~(PROBE_MASK_DECIMATION | PROBE_EXTRACT_S16))) {
 			tr_err(&pr_tr, "probe_point_add() error: invalid purpose %d",
 			       probe[i].purpose);
 
 			return -EINVAL;
 		}
 
-		if (probe[i].purpose == PROBE_PURPOSE_EXTRACTION &&
+		if (purpose == PROBE_PURPOSE_EXTRACTION &&
 		    _probe->ext_dma.stream_tag == PROBE_DMA_INVALID) {
 			tr_err(&pr_tr, "probe_point_add(): Setting probe for extraction, while extraction DMA not enabled.");
 
@@ -975,8 +1225,7 @@ int probe_point_add(uint32_t count, struct probe_point *probe)
 			/* and check if probe is already attached */
 			buffer_id = _probe->probe_points[j].buffer_id;
 			if (buffer_id == probe[i].buffer_id) {
-				if (_probe->probe_points[j].purpose ==
-				    probe[i].purpose) {
+				if (_probe->probe_points[j].purpose == purpose) {
 					tr_err(&pr_tr, "probe_point_add(): Probe already attached to buffer %u with purpose %u",
 					       buffer_id,
 					       probe[i].purpose);
@@ -993,8 +1242,10 @@ int probe_point_add(uint32_t count, struct probe_point *probe)
 			return -EINVAL;
 		}
 
+		point = &_probe->probe_points[first_free];
+
 		/* if connecting injection probe, check for associated DMA */
-		if (probe[i].purpose == PROBE_PURPOSE_INJECTION) {
+		if (purpose == PROBE_PURPOSE_INJECTION) {
 			dma_found = 0;
 
 			for (j = 0; j < CONFIG_PROBE_DMA_MAX; j++) {
@@ -1018,7 +1269,21 @@ int probe_point_add(uint32_t count, struct probe_point *probe)
 
 				return -EBUSY;
 			}
-		} else if (probe[i].purpose == PROBE_PURPOSE_EXTRACTION) {
+
+			memset(point, 0, sizeof(*point));
+			point->dma = &_probe->inject_dma[j];
+		} else if (purpose == PROBE_PURPOSE_EXTRACTION) {
+			/* the last step that can fail, so the batch is not leaked */
+			batch = rballoc(0, SOF_MEM_CAPS_RAM, PROBE_BATCH_SIZE);
+			if (!batch) {
+				tr_err(&pr_tr, "probe_point_add(): batch alloc failed");
+
+				return -ENOMEM;
+			}
+
+			memset(point, 0, sizeof(*point));
+			point->batch = batch;
+
 			for (j = 0; j < CONFIG_PROBE_POINTS_MAX; j++) {
 				if (_probe->probe_points[j].stream_tag != PROBE_DMA_INVALID &&
 				    _probe->probe_points[j].purpose == PROBE_PURPOSE_EXTRACTION)
@@ -1033,14 +1298,15 @@ int probe_point_add(uint32_t count, struct probe_point *probe)
 		}
 
 		/* probe point valid, save it */
-		_probe->probe_points[first_free].buffer_id = probe[i].buffer_id;
-		_probe->probe_points[first_free].purpose = probe[i].purpose;
-		_probe->probe_points[first_free].stream_tag =
-			probe[i].stream_tag;
+		point->buffer_id = probe[i].buffer_id;
+		point->purpose = purpose;
+		point->reduction = reduction;
+		point->stream_tag = probe[i].stream_tag;
 
-		notifier_register(_probe, dev->cb, NOTIFIER_ID_BUFFER_PRODUCE,
+		/* the probe point is given to the callbacks directly */
+		notifier_register(point, dev->cb, NOTIFIER_ID_BUFFER_PRODUCE,
 				  &probe_cb_produce, 0);
-		notifier_register(_probe, dev->cb, NOTIFIER_ID_BUFFER_FREE,
+		notifier_register(point, dev->cb, NOTIFIER_ID_BUFFER_FREE,
 				  &probe_cb_free, 0);
 	}
 
@@ -1069,7 +1335,8 @@ int probe_point_info(struct sof_ipc_probe_info_params *data, uint32_t max_size)
 			data->probe_point[j].buffer_id =
 				_probe->probe_points[i].buffer_id;
 			data->probe_point[j].purpose =
-				_probe->probe_points[i].purpose;
+				_probe->probe_points[i].purpose |
+				_probe->probe_points[i].reduction;
 			data->probe_point[j].stream_tag =
 				_probe->probe_points[i].stream_tag;
 			j++;
@@ -1105,15 +1372,8 @@ int probe_point_remove(uint32_t count, uint32_t *buffer_id)
 			if (_probe->probe_points[j].stream_tag != PROBE_POINT_INVALID &&
 			    _probe->probe_points[j].buffer_id == buffer_id[i]) {
 				dev = ipc_get_comp_by_id(ipc_get(), buffer_id[i]);
-				if (dev) {
-					notifier_unregister(_probe, dev->cb,
-							    NOTIFIER_ID_BUFFER_PRODUCE);
-					notifier_unregister(_probe, dev->cb,
-							    NOTIFIER_ID_BUFFER_FREE);
-				}
-
-				_probe->probe_points[j].stream_tag =
-					PROBE_POINT_INVALID;
+				probe_point_free(&_probe->probe_points[j],
+						 dev ? dev->cb : NULL);
 			}
 		}
 	}
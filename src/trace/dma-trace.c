@@ -4,16 +4,20 @@
 //
 // Author: Yan Wang <yan.wang@linux.intel.com>
 
+#include <sof/atomic.h>
 #include <sof/audio/buffer.h>
 #include <sof/common.h>
 #include <sof/debug/panic.h>
+#include <sof/drivers/interrupt.h>
 #include <sof/ipc/msg.h>
 #include <sof/lib/alloc.h>
 #include <sof/lib/cache.h>
 #include <sof/lib/cpu.h>
 #include <sof/lib/dma.h>
 #include <sof/lib/memory.h>
+#include <sof/lib/notifier.h>
 #include <sof/lib/uuid.h>
+#include <sof/lib/wait.h>
 #include <sof/platform.h>
 #include <sof/schedule/ll_schedule.h>
 #include <sof/schedule/schedule.h>
@@ -50,6 +54,244 @@ static int dma_trace_get_avail_data(struct dma_trace_data *d,
 				    struct dma_trace_buf *buffer,
 				    int avail);
 
+static void dtrace_add_event(const char *e, uint32_t length);
+
+static int dtrace_calc_buf_overflow(struct dma_trace_buf *buffer,
+				    uint32_t length);
+
+#if CONFIG_DMA_TRACE_PER_CORE
+static inline uint32_t dtrace_core_avail(uint32_t w_pos, uint32_t r_pos)
+{
+	return w_pos >= r_pos ? w_pos - r_pos : w_pos + 2 * DMA_TRACE_CORE_SIZE - r_pos;
+}
+
+static inline uint32_t dtrace_core_advance(uint32_t pos, uint32_t bytes)
+{
+	pos += bytes;
+
+	return pos >= 2 * DMA_TRACE_CORE_SIZE ? pos - 2 * DMA_TRACE_CORE_SIZE : pos;
+}
+
+static inline uint32_t dtrace_core_offset(uint32_t pos)
+{
+	return pos >= DMA_TRACE_CORE_SIZE ? pos - DMA_TRACE_CORE_SIZE : pos;
+}
+
+static void dtrace_core_write(struct dma_trace_core_buf *cb, uint32_t pos,
+			      const void *data, uint32_t bytes)
+{
+	uint32_t offset = dtrace_core_offset(pos);
+	uint32_t head = MIN(bytes, DMA_TRACE_CORE_SIZE - offset);
+	int ret;
+
+	ret = memcpy_s(cb->addr + offset, head, data, head);
+	assert(!ret);
+	if (bytes > head) {
+		ret = memcpy_s(cb->addr, bytes - head, (const char *)data + head,
+			       bytes - head);
+		assert(!ret);
+	}
+}
+
+static void dtrace_core_read(const struct dma_trace_core_buf *cb, uint32_t pos,
+			     void *data, uint32_t bytes)
+{
+	uint32_t offset = dtrace_core_offset(pos);
+	uint32_t head = MIN(bytes, DMA_TRACE_CORE_SIZE - offset);
+	int ret;
+
+	ret = memcpy_s(data, head, cb->addr + offset, head);
+	assert(!ret);
+	if (bytes > head) {
+		ret = memcpy_s((char *)data + head, bytes - head, cb->addr,
+			       bytes - head);
+		assert(!ret);
+	}
+}
+
+/* timestamp of the entry at pos, entries start with struct log_entry_header */
+static uint64_t dtrace_core_timestamp(const struct dma_trace_core_buf *cb, uint32_t pos)
+{
+	uint64_t timestamp;
+
+	dtrace_core_read(cb, dtrace_core_advance(pos, sizeof(uint32_t) +
+						 offsetof(struct log_entry_header, timestamp)),
+			 &timestamp, sizeof(timestamp));
+
+	return timestamp;
+}
+
+/** Lock-free append to the trace ring of the current core, drops on
+ * overflow. Interrupts are only disabled locally, so that an interrupt on
+ * this core can't interleave its entry with the one being written.
+ */
+static uint32_t dtrace_core_add_event(struct dma_trace_data *d, const char *e,
+				      uint32_t length)
+{
+	struct dma_trace_core_buf *cb = &d->core_buf[cpu_get_id()];
+	uint32_t record = sizeof(uint32_t) + length;
+	uint32_t flags;
+	uint32_t w_pos;
+	uint32_t avail = 0;
+
+	irq_local_disable(flags);
+
+	/* the ring is not freed while a writer is registered */
+	if (atomic_add(&cb->users, 1) & DMA_TRACE_CORE_CLOSED)
+		goto out;
+
+	w_pos = atomic_read(&cb->w_pos);
+	avail = dtrace_core_avail(w_pos, atomic_read_acquire(&cb->r_pos));
+
+	if (length > DMA_TRACE_CORE_ENTRY_MAX || avail + record > DMA_TRACE_CORE_SIZE) {
+		cb->dropped_entries++;
+	} else {
+		dtrace_core_write(cb, w_pos, &length, sizeof(length));
+		dtrace_core_write(cb, dtrace_core_advance(w_pos, sizeof(length)), e, length);
+		avail += record;
+		atomic_set_release(&cb->w_pos, dtrace_core_advance(w_pos, record));
+	}
+
+out:
+	atomic_sub(&cb->users, 1);
+	irq_local_enable(flags);
+
+	return avail;
+}
+
+/** Moves the entries of all core rings to the DMA trace buffer, oldest
+ * first. Entries that don't fit stay in the rings for the next run.
+ */
+static void dtrace_core_merge(struct dma_trace_data *d)
+{
+	struct dma_trace_buf *buffer = &d->dmatb;
+	uint32_t entry[DMA_TRACE_CORE_ENTRY_MAX / sizeof(uint32_t)];
+	uint32_t w_pos[CONFIG_CORE_COUNT];
+	uint32_t r_pos[CONFIG_CORE_COUNT];
+	uint64_t timestamp[CONFIG_CORE_COUNT];
+	struct dma_trace_core_buf *cb;
+	k_spinlock_key_t key;
+	uint32_t length;
+	uint32_t dropped;
+	int core;
+	int i;
+
+	for (i = 0; i < CONFIG_CORE_COUNT; i++) {
+		cb = &d->core_buf[i];
+		r_pos[i] = atomic_read(&cb->r_pos);
+		w_pos[i] = atomic_read_acquire(&cb->w_pos);
+		if (r_pos[i] != w_pos[i])
+			timestamp[i] = dtrace_core_timestamp(cb, r_pos[i]);
+	}
+
+	key = k_spin_lock(&d->lock);
+
+	for (;;) {
+		/* the oldest head entry of all rings goes first */
+		core = -1;
+		for (i = 0; i < CONFIG_CORE_COUNT; i++)
+			if (r_pos[i] != w_pos[i] &&
+			    (core < 0 || timestamp[i] < timestamp[core]))
+				core = i;
+
+		if (core < 0)
+			break;
+
+		cb = &d->core_buf[core];
+		dtrace_core_read(cb, r_pos[core], &length, sizeof(length));
+		if (dtrace_calc_buf_overflow(buffer, length))
+			break;
+
+		dtrace_core_read(cb, dtrace_core_advance(r_pos[core], sizeof(length)),
+				 entry, length);
+		dtrace_add_event((const char *)entry, length);
+
+		r_pos[core] = dtrace_core_advance(r_pos[core], sizeof(length) + length);
+		if (r_pos[core] != w_pos[core])
+			timestamp[core] = dtrace_core_timestamp(cb, r_pos[core]);
+	}
+
+	k_spin_unlock(&d->lock, key);
+
+	for (i = 0; i < CONFIG_CORE_COUNT; i++) {
+		cb = &d->core_buf[i];
+		atomic_set_release(&cb->r_pos, r_pos[i]);
+
+		/* report per core, this trace goes to the ring of this core */
+		dropped = dma_trace_core_dropped(d, i);
+		if (dropped != cb->reported_entries) {
+			tr_warn(&dt_tr, "trace_work(): core %d dropped %u logs, %u in total",
+				i, dropped - cb->reported_entries, dropped);
+			cb->reported_entries = dropped;
+		}
+	}
+}
+
+static int dtrace_core_buffers_init(struct dma_trace_data *d)
+{
+	struct dma_trace_core_buf *cb;
+	int i;
+
+	for (i = 0; i < CONFIG_CORE_COUNT; i++) {
+		cb = &d->core_buf[i];
+
+		/* shared memory is uncached, no cache maintenance needed */
+		cb->addr = rzalloc(SOF_MEM_ZONE_RUNTIME_SHARED, 0, SOF_MEM_CAPS_RAM,
+				   DMA_TRACE_CORE_SIZE);
+		if (!cb->addr)
+			return -ENOMEM;
+
+		atomic_init(&cb->w_pos, 0);
+		atomic_init(&cb->r_pos, 0);
+		atomic_set_release(&cb->users, 0);
+	}
+
+	return 0;
+}
+
+/** Closes the rings and frees them once the writers that got in before
+ * have left. Other cores may still be in dtrace_core_add_event().
+ */
+static void dtrace_core_buffers_free(struct dma_trace_data *d)
+{
+	struct dma_trace_core_buf *cb;
+	int i;
+
+	for (i = 0; i < CONFIG_CORE_COUNT; i++) {
+		cb = &d->core_buf[i];
+		if (cb->addr)
+			atomic_add(&cb->users, DMA_TRACE_CORE_CLOSED);
+	}
+
+	for (i = 0; i < CONFIG_CORE_COUNT; i++) {
+		cb = &d->core_buf[i];
+		if (!cb->addr)
+			continue;
+
+		while (atomic_read_acquire(&cb->users) != DMA_TRACE_CORE_CLOSED)
+			idelay(PLATFORM_DEFAULT_DELAY);
+
+		rfree(cb->addr);
+		cb->addr = NULL;
+	}
+}
+
+/** Secondary cores can't reschedule the trace work of the primary core,
+ * so the primary core checks their flush request after every LL period.
+ */
+static void dtrace_core_flush(void *arg, enum notify_id type, void *data)
+{
+	struct dma_trace_data *d = arg;
+
+	if (!atomic_read(&d->core_flush) || d->copy_in_progress)
+		return;
+
+	atomic_set(&d->core_flush, 0);
+	reschedule_task(&d->dmat_work, DMA_TRACE_RESCHEDULE_TIME);
+	d->copy_in_progress = 1;
+}
+#endif /* CONFIG_DMA_TRACE_PER_CORE */
+
 /** Periodically runs and starts the DMA even when the buffer is not
  * full.
  */
@@ -59,7 +301,7 @@ static enum task_state trace_work(void *data)
 	struct dma_trace_buf *buffer = &d->dmatb;
 	struct dma_sg_config *config = &d->config;
 	k_spinlock_key_t key;
-	uint32_t avail = buffer->avail;
+	uint32_t avail;
 	int32_t size;
 	uint32_t overflow;
 
@@ -67,6 +309,11 @@ static enum task_state trace_work(void *data)
 	if (!d->dc.chan)
 		return SOF_TASK_STATE_RESCHEDULE;
 
+#if CONFIG_DMA_TRACE_PER_CORE
+	dtrace_core_merge(d);
+#endif
+	avail = buffer->avail;
+
 	/* make sure we don't write more than buffer */
 	if (avail > DMA_TRACE_LOCAL_SIZE) {
 		overflow = avail - DMA_TRACE_LOCAL_SIZE;
@@ -237,6 +484,11 @@ static void dma_trace_buffer_free(struct dma_trace_data *d)
 	memset(buffer, 0, sizeof(*buffer));
 
 	k_spin_unlock(&d->lock, key);
+
+#if CONFIG_DMA_TRACE_PER_CORE
+	/* no new entries once the buffer above is gone */
+	dtrace_core_buffers_free(d);
+#endif
 }
 
 static int dma_trace_buffer_init(struct dma_trace_data *d)
@@ -285,6 +537,17 @@ static int dma_trace_buffer_init(struct dma_trace_data *d)
 	bzero(buf, DMA_TRACE_LOCAL_SIZE);
 	dcache_writeback_region(buf, DMA_TRACE_LOCAL_SIZE);
 
+#if CONFIG_DMA_TRACE_PER_CORE
+	/* the core rings must be ready before the buffer below is set */
+	err = dtrace_core_buffers_init(d);
+	if (err < 0) {
+		mtrace_printf(LOG_LEVEL_ERROR, "dma_trace_buffer_init(): core alloc failed");
+		dtrace_core_buffers_free(d);
+		rfree(buf);
+		return err;
+	}
+#endif
+
 	/* initialise the DMA buffer, whole sequence in section */
 	key = k_spin_lock(&d->lock);
 
@@ -486,6 +749,13 @@ int dma_trace_enable(struct dma_trace_data *d)
 	d->enabled = 1;
 	schedule_task(&d->dmat_work, DMA_TRACE_PERIOD, DMA_TRACE_PERIOD);
 
+#if CONFIG_DMA_TRACE_PER_CORE
+	/* enable may be repeated without disable */
+	notifier_unregister(d, NULL, NOTIFIER_ID_LL_POST_RUN);
+	notifier_register(d, scheduler_get_data(SOF_SCHEDULE_LL_TIMER),
+			  NOTIFIER_ID_LL_POST_RUN, dtrace_core_flush, 0);
+#endif
+
 out:
 	if (err < 0)
 		dma_trace_buffer_free(d);
@@ -498,6 +768,10 @@ void dma_trace_disable(struct dma_trace_data *d)
 	/* cancel trace work */
 	schedule_task_cancel(&d->dmat_work);
 
+#if CONFIG_DMA_TRACE_PER_CORE
+	notifier_unregister(d, NULL, NOTIFIER_ID_LL_POST_RUN);
+#endif
+
 	if (d->dc.chan) {
 		dma_stop(d->dc.chan);
 		dma_channel_put(d->dc.chan);
@@ -693,14 +967,34 @@ static void dtrace_add_event(const char *e, uint32_t length)
 void dtrace_event(const char *e, uint32_t length)
 {
 	struct dma_trace_data *trace_data = dma_trace_data_get();
+#if CONFIG_DMA_TRACE_PER_CORE
+	uint32_t avail;
+#else
 	struct dma_trace_buf *buffer = NULL;
 	k_spinlock_key_t key;
+#endif
 
 	if (!dma_trace_initialized(trace_data) ||
 	    length > DMA_TRACE_LOCAL_SIZE / 8 || length == 0) {
 		return;
 	}
 
+#if CONFIG_DMA_TRACE_PER_CORE
+	avail = dtrace_core_add_event(trace_data, e, length);
+
+	/* schedule copy now only if the ring is > 50% full */
+	if (avail < DMA_TRACE_CORE_SIZE / 2)
+		return;
+
+	/* secondary core asks the primary core to copy */
+	if (cpu_get_id() != PLATFORM_PRIMARY_CORE_ID) {
+		atomic_set(&trace_data->core_flush, 1);
+		return;
+	}
+
+	if (trace_data->copy_in_progress)
+		return;
+#else
 	buffer = &trace_data->dmatb;
 
 	key = k_spin_lock(&trace_data->lock);
@@ -717,9 +1011,12 @@ void dtrace_event(const char *e, uint32_t length)
 
 	k_spin_unlock(&trace_data->lock, key);
 
-	/* schedule copy now if buffer > 50% full */
-	if (trace_data->enabled &&
-	    buffer->avail >= (DMA_TRACE_LOCAL_SIZE / 2)) {
+	/* schedule copy now only if buffer > 50% full */
+	if (buffer->avail < (DMA_TRACE_LOCAL_SIZE / 2))
+		return;
+#endif
+
+	if (trace_data->enabled) {
 		reschedule_task(&trace_data->dmat_work,
 				DMA_TRACE_RESCHEDULE_TIME);
 		/* reschedule should not be interrupted
@@ -739,5 +1036,9 @@ void dtrace_event_atomic(const char *e, uint32_t length)
 		return;
 	}
 
+#if CONFIG_DMA_TRACE_PER_CORE
+	dtrace_core_add_event(trace_data, e, length);
+#else
 	dtrace_add_event(e, length);
+#endif
 }
@@ -0,0 +1,239 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2022 Intel Corporation. All rights reserved.
+
+#include <sof/audio/component.h>
+#include <sof/audio/buffer.h>
+#include <sof/audio/pipeline.h>
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <cmocka.h>
+
+#define INPLACE_TEST_SIZE	64
+#define INPLACE_TEST_WORDS	10000
+
+static void inplace_test_check(struct comp_buffer *buf, uint32_t avail, uint32_t free)
+{
+	assert_int_equal(audio_stream_get_avail_bytes(&buf->stream), avail);
+	assert_int_equal(audio_stream_get_free_bytes(&buf->stream), free);
+}
+
+static void test_audio_buffer_inplace_free(void **state)
+{
+	struct comp_buffer *b1 = buffer_alloc(INPLACE_TEST_SIZE, 0, 0);
+	struct comp_buffer *b2 = buffer_alloc(INPLACE_TEST_SIZE, 0, 0);
+	struct comp_buffer *b3 = buffer_alloc(INPLACE_TEST_SIZE, 0, 0);
+	void *b2_addr;
+	void *b3_addr;
+
+	(void)state;
+
+	assert_non_null(b1);
+	assert_non_null(b2);
+	assert_non_null(b3);
+	b2_addr = b2->stream.addr;
+	b3_addr = b3->stream.addr;
+
+	assert_int_equal(buffer_inplace_link(b1, b2), 0);
+	assert_int_equal(buffer_inplace_link(b2, b3), 0);
+	assert_ptr_equal(b2->stream.addr, b1->stream.addr);
+	assert_ptr_equal(b3->stream.addr, b1->stream.addr);
+
+	/* the data moved to the next buffer still takes the space */
+	comp_update_buffer_produce(b1, 48);
+	comp_update_buffer_consume(b1, 32);
+	comp_update_buffer_produce(b2, 32);
+	inplace_test_check(b1, 16, 16);
+	inplace_test_check(b2, 32, 32);
+
+	comp_update_buffer_produce(b3, 32);
+	comp_update_buffer_consume(b2, 32);
+	inplace_test_check(b1, 16, 16);
+	inplace_test_check(b2, 0, 32);
+	inplace_test_check(b3, 32, 32);
+	assert_ptr_equal(b1->stream.r_ptr, b2->stream.w_ptr);
+	assert_ptr_equal(b2->stream.r_ptr, b3->stream.w_ptr);
+
+	/* the last consumer releases the space to all the buffers */
+	comp_update_buffer_consume(b3, 24);
+	inplace_test_check(b1, 16, 40);
+	inplace_test_check(b2, 0, 56);
+	inplace_test_check(b3, 8, 56);
+
+	/* the middle buffer gets own memory back and the last one follows it */
+	buffer_inplace_unlink(b2);
+	assert_ptr_equal(b2->stream.addr, b2_addr);
+	assert_ptr_equal(b3->stream.addr, b2_addr);
+	assert_null(b1->inplace_sink);
+	assert_ptr_equal(b3->inplace_source, b2);
+
+	/* the buffer using freed memory gets own memory back */
+	buffer_free(b2);
+	assert_null(b3->inplace_source);
+	assert_ptr_equal(b3->stream.addr, b3_addr);
+
+	buffer_free(b1);
+	buffer_free(b3);
+}
+
+/* Move an incrementing sequence through two in-place stages */
+static void test_audio_buffer_inplace_stream(void **state)
+{
+	struct comp_buffer *b1 = buffer_alloc(INPLACE_TEST_SIZE, 0, 0);
+	struct comp_buffer *b2 = buffer_alloc(INPLACE_TEST_SIZE, 0, 0);
+	struct comp_buffer *b3 = buffer_alloc(INPLACE_TEST_SIZE, 0, 0);
+	uint32_t seed = 1;
+	uint32_t in = 0;
+	uint32_t out = 0;
+	uint32_t words;
+	uint32_t i;
+	int32_t *ptr;
+
+	(void)state;
+
+	assert_non_null(b1);
+	assert_non_null(b2);
+	assert_non_null(b3);
+	assert_int_equal(buffer_inplace_link(b1, b2), 0);
+	assert_int_equal(buffer_inplace_link(b2, b3), 0);
+
+	while (out < INPLACE_TEST_WORDS) {
+		seed = seed * 1664525 + 1013904223;
+
+		/* producer */
+		words = audio_stream_get_free_bytes(&b1->stream) / sizeof(int32_t);
+		words = MIN(words, (seed >> 8) % 5);
+		ptr = b1->stream.w_ptr;
+		for (i = 0; i < words; i++) {
+			*ptr = in++;
+			ptr = audio_stream_wrap(&b1->stream, ptr + 1);
+		}
+		comp_update_buffer_produce(b1, words * sizeof(int32_t));
+
+		/* first stage adds 1000 in place */
+		words = audio_stream_get_avail_bytes(&b1->stream) / sizeof(int32_t);
+		words = MIN(words, (seed >> 12) % 7);
+		ptr = b1->stream.r_ptr;
+		assert_ptr_equal(ptr, b2->stream.w_ptr);
+		for (i = 0; i < words; i++) {
+			*ptr += 1000;
+			ptr = audio_stream_wrap(&b1->stream, ptr + 1);
+		}
+		comp_update_buffer_consume(b1, words * sizeof(int32_t));
+		comp_update_buffer_produce(b2, words * sizeof(int32_t));
+
+		/* second stage negates in place */
+		words = audio_stream_get_avail_bytes(&b2->stream) / sizeof(int32_t);
+		words = MIN(words, (seed >> 16) % 3);
+		ptr = b2->stream.r_ptr;
+		assert_ptr_equal(ptr, b3->stream.w_ptr);
+		for (i = 0; i < words; i++) {
+			*ptr = -*ptr;
+			ptr = audio_stream_wrap(&b2->stream, ptr + 1);
+		}
+		comp_update_buffer_produce(b3, words * sizeof(int32_t));
+		comp_update_buffer_consume(b2, words * sizeof(int32_t));
+
+		/* consumer */
+		words = audio_stream_get_avail_bytes(&b3->stream) / sizeof(int32_t);
+		words = MIN(words, (seed >> 20) % 6);
+		ptr = b3->stream.r_ptr;
+		for (i = 0; i < words; i++) {
+			assert_int_equal(*ptr, -(int32_t)(out++ + 1000));
+			ptr = audio_stream_wrap(&b3->stream, ptr + 1);
+		}
+		comp_update_buffer_consume(b3, words * sizeof(int32_t));
+
+		assert_int_equal(audio_stream_get_avail_bytes(&b1->stream) +
+				 audio_stream_get_avail_bytes(&b2->stream) +
+				 audio_stream_get_avail_bytes(&b3->stream) +
+				 audio_stream_get_free_bytes(&b1->stream), INPLACE_TEST_SIZE);
+	}
+
+	buffer_free(b3);
+	buffer_free(b2);
+	buffer_free(b1);
+}
+
+static void test_audio_buffer_inplace_pipeline(void **state)
+{
+	struct comp_driver drv_inplace = { .flags = COMP_DRV_FLAG_INPLACE };
+	struct comp_driver drv = { 0 };
+	struct pipeline p = { 0 };
+	struct comp_dev up = { .drv = &drv, .pipeline = &p };
+	struct comp_dev mid = { .drv = &drv_inplace, .pipeline = &p };
+	struct comp_dev down = { .drv = &drv, .pipeline = &p };
+	struct comp_buffer *b1 = buffer_alloc(INPLACE_TEST_SIZE, 0, 0);
+	struct comp_buffer *b2 = buffer_alloc(INPLACE_TEST_SIZE, 0, 0);
+
+	(void)state;
+
+	assert_non_null(b1);
+	assert_non_null(b2);
+	list_init(&up.bsource_list);
+	list_init(&up.bsink_list);
+	list_init(&mid.bsource_list);
+	list_init(&mid.bsink_list);
+	list_init(&down.bsource_list);
+	list_init(&down.bsink_list);
+	pipeline_connect(&up, b1, PPL_CONN_DIR_COMP_TO_BUFFER);
+	pipeline_connect(&mid, b1, PPL_CONN_DIR_BUFFER_TO_COMP);
+	pipeline_connect(&mid, b2, PPL_CONN_DIR_COMP_TO_BUFFER);
+	pipeline_connect(&down, b2, PPL_CONN_DIR_BUFFER_TO_COMP);
+
+	/* only the in-place capable component shares the memory */
+	assert_int_equal(pipeline_comp_inplace(&up), 0);
+	assert_int_equal(pipeline_comp_inplace(&down), 0);
+	assert_null(b1->inplace_sink);
+	assert_int_equal(pipeline_comp_inplace(&mid), 0);
+	assert_ptr_equal(b2->inplace_source, b1);
+	assert_ptr_equal(b2->stream.addr, b1->stream.addr);
+
+	/* a format change gives the sink own memory back */
+	b2->stream.channels = 2;
+	assert_int_equal(pipeline_comp_inplace(&mid), 0);
+	assert_null(b2->inplace_source);
+	assert_ptr_not_equal(b2->stream.addr, b1->stream.addr);
+
+	/* no sharing with a buffer that connects another pipeline */
+	b2->stream.channels = 0;
+	down.pipeline = NULL;
+	assert_int_equal(pipeline_comp_inplace(&mid), 0);
+	assert_null(b2->inplace_source);
+
+	/* shared memory is not resized */
+	down.pipeline = &p;
+	assert_int_equal(pipeline_comp_inplace(&mid), 0);
+	assert_ptr_equal(b2->inplace_source, b1);
+	assert_int_equal(buffer_set_size(b1, 2 * INPLACE_TEST_SIZE), 0);
+	assert_null(b2->inplace_source);
+	assert_ptr_not_equal(b2->stream.addr, b1->stream.addr);
+	assert_int_equal(buffer_set_size(b2, 2 * INPLACE_TEST_SIZE), 0);
+
+	/* disconnecting ends the sharing */
+	assert_int_equal(pipeline_comp_inplace(&mid), 0);
+	assert_ptr_equal(b2->inplace_source, b1);
+	pipeline_disconnect(&mid, b2, PPL_CONN_DIR_COMP_TO_BUFFER);
+	assert_null(b2->inplace_source);
+	assert_ptr_not_equal(b2->stream.addr, b1->stream.addr);
+
+	buffer_free(b1);
+	buffer_free(b2);
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(test_audio_buffer_inplace_free),
+		cmocka_unit_test(test_audio_buffer_inplace_stream),
+		cmocka_unit_test(test_audio_buffer_inplace_pipeline),
+	};
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
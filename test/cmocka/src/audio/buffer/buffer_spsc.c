@@ -0,0 +1,196 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2022 Intel Corporation. All rights reserved.
+
+#include <sof/audio/component.h>
+#include <sof/audio/buffer.h>
+#include <sof/lib/notifier.h>
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <sched.h>
+#include <cmocka.h>
+
+/* Number of 32 bit words passed through the buffer in each stress test */
+#define SPSC_TEST_WORDS		(1 << 21)
+
+struct spsc_test {
+	struct comp_buffer *buf;
+	uint32_t max_words;	/* max words per produce or consume */
+	uint32_t seed;		/* per thread random generator state */
+	uint32_t errors;
+};
+
+static uint32_t spsc_test_rand(struct spsc_test *t)
+{
+	t->seed = t->seed * 1664525 + 1013904223;
+	return t->seed >> 8;
+}
+
+/* Write an incrementing sequence in random sized chunks */
+static void *spsc_test_producer(void *arg)
+{
+	struct spsc_test *t = arg;
+	struct audio_stream *stream = &t->buf->stream;
+	uint32_t *ptr;
+	uint32_t value = 0;
+	uint32_t chunk;
+	uint32_t words;
+	uint32_t i;
+
+	while (value < SPSC_TEST_WORDS) {
+		buffer_spsc_sync_producer(t->buf);
+		chunk = spsc_test_rand(t) % t->max_words + 1;
+		words = audio_stream_get_free_bytes(stream) / sizeof(uint32_t);
+		words = MIN(words, chunk);
+		words = MIN(words, SPSC_TEST_WORDS - value);
+		if (!words) {
+			sched_yield();
+			continue;
+		}
+
+		ptr = stream->w_ptr;
+		for (i = 0; i < words; i++) {
+			*ptr = value++;
+			ptr = audio_stream_wrap(stream, ptr + 1);
+		}
+
+		comp_update_buffer_produce(t->buf, words * sizeof(uint32_t));
+	}
+
+	return NULL;
+}
+
+/* Read the sequence back in different random sized chunks */
+static void *spsc_test_consumer(void *arg)
+{
+	struct spsc_test *t = arg;
+	struct audio_stream *stream = &t->buf->stream;
+	uint32_t *ptr;
+	uint32_t value = 0;
+	uint32_t chunk;
+	uint32_t words;
+	uint32_t i;
+
+	while (value < SPSC_TEST_WORDS) {
+		buffer_spsc_sync_consumer(t->buf);
+		chunk = spsc_test_rand(t) % t->max_words + 1;
+		words = audio_stream_get_avail_bytes(stream) / sizeof(uint32_t);
+		words = MIN(words, chunk);
+		if (!words) {
+			sched_yield();
+			continue;
+		}
+
+		ptr = stream->r_ptr;
+		for (i = 0; i < words; i++) {
+			if (*ptr != value++)
+				t->errors++;
+			ptr = audio_stream_wrap(stream, ptr + 1);
+		}
+
+		comp_update_buffer_consume(t->buf, words * sizeof(uint32_t));
+	}
+
+	return NULL;
+}
+
+static void spsc_test_run(uint32_t size, uint32_t max_words)
+{
+	struct spsc_test producer = { .max_words = max_words, .seed = 1 };
+	struct spsc_test consumer = { .max_words = max_words, .seed = 2 };
+	struct comp_buffer *buf;
+	pthread_t tp;
+	pthread_t tc;
+
+	buf = buffer_alloc(size, 0, 0);
+	assert_non_null(buf);
+	buffer_spsc_enable(buf);
+	assert_true(buf->spsc);
+
+	producer.buf = buf;
+	consumer.buf = buf;
+	assert_int_equal(pthread_create(&tp, NULL, spsc_test_producer, &producer), 0);
+	assert_int_equal(pthread_create(&tc, NULL, spsc_test_consumer, &consumer), 0);
+	assert_int_equal(pthread_join(tp, NULL), 0);
+	assert_int_equal(pthread_join(tc, NULL), 0);
+
+	printf("%s: size %u max chunk %u words, %u errors\n", __func__, size,
+	       max_words, consumer.errors);
+	assert_int_equal(consumer.errors, 0);
+
+	/* everything produced has been consumed */
+	buffer_spsc_sync_producer(buf);
+	buffer_spsc_sync_consumer(buf);
+	assert_int_equal(audio_stream_get_avail_bytes(&buf->stream), 0);
+	assert_int_equal(audio_stream_get_free_bytes(&buf->stream), size);
+	assert_ptr_equal(buf->stream.w_ptr, buf->stream.r_ptr);
+
+	buffer_free(buf);
+}
+
+static void test_audio_buffer_spsc_positions(void **state)
+{
+	struct comp_buffer *buf;
+
+	(void)state;
+
+	buf = buffer_alloc(64, 0, 0);
+	assert_non_null(buf);
+	buffer_spsc_enable(buf);
+
+	/* fill the buffer completely, full is told apart from empty */
+	comp_update_buffer_produce(buf, 40);
+	comp_update_buffer_produce(buf, 24);
+	buffer_spsc_sync_producer(buf);
+	buffer_spsc_sync_consumer(buf);
+	assert_int_equal(audio_stream_get_avail_bytes(&buf->stream), 64);
+	assert_int_equal(audio_stream_get_free_bytes(&buf->stream), 0);
+	assert_ptr_equal(buf->stream.w_ptr, buf->stream.addr);
+
+	/* wrap both positions */
+	comp_update_buffer_consume(buf, 48);
+	comp_update_buffer_produce(buf, 32);
+	buffer_spsc_sync_consumer(buf);
+	assert_int_equal(audio_stream_get_avail_bytes(&buf->stream), 48);
+	assert_ptr_equal(buf->stream.r_ptr, (char *)buf->stream.addr + 48);
+	assert_ptr_equal(buf->stream.w_ptr, (char *)buf->stream.addr + 32);
+
+	/* overrun and underrun are clamped so the positions stay valid */
+	comp_update_buffer_produce(buf, 32);
+	assert_int_equal(audio_stream_get_free_bytes(&buf->stream), 0);
+	comp_update_buffer_consume(buf, 128);
+	assert_int_equal(audio_stream_get_avail_bytes(&buf->stream), 0);
+	buffer_spsc_sync_producer(buf);
+	assert_int_equal(audio_stream_get_free_bytes(&buf->stream), 64);
+
+	buffer_free(buf);
+}
+
+static void test_audio_buffer_spsc_stress(void **state)
+{
+	(void)state;
+
+	spsc_test_run(256, 7);
+	spsc_test_run(4 * 97, 97);
+	spsc_test_run(4 * 1000, 333);
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(test_audio_buffer_spsc_positions),
+		cmocka_unit_test(test_audio_buffer_spsc_stress),
+	};
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	/* the notifier mock is not thread safe when initialized */
+	arch_notify_get();
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,318 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2022 Intel Corporation. All rights reserved.
+
+#include <sof/audio/buffer.h>
+#include <sof/audio/component.h>
+#include <sof/audio/ipc-config.h>
+#include <sof/audio/codec_adapter/codec_adapter.h>
+#include <sof/audio/pipeline.h>
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <cmocka.h>
+
+#define SEGMENTS_TEST_CHANNELS	2
+#define SEGMENTS_TEST_RATE	48000
+#define SEGMENTS_TEST_PERIODS	100
+
+/* S32_LE stereo 1 ms period */
+#define SEGMENTS_TEST_PERIOD_BYTES \
+	(SEGMENTS_TEST_CHANNELS * sizeof(int32_t) * SEGMENTS_TEST_RATE / 1000)
+
+/* Buffer sizes that are not multiples of the period to get the wraps anywhere */
+#define SEGMENTS_TEST_SOURCE_BYTES	(2 * SEGMENTS_TEST_PERIOD_BYTES + 40)
+#define SEGMENTS_TEST_SINK_BYTES	(3 * SEGMENTS_TEST_PERIOD_BYTES - 24)
+
+static int test_module_init(struct processing_module *mod)
+{
+	return 0;
+}
+
+static int test_module_prepare(struct processing_module *mod)
+{
+	struct module_data *md = &mod->priv;
+
+	md->mpd.in_buff = rballoc(0, SOF_MEM_CAPS_RAM, mod->period_bytes);
+	md->mpd.out_buff = rballoc(0, SOF_MEM_CAPS_RAM, mod->period_bytes);
+	if (!md->mpd.in_buff || !md->mpd.out_buff)
+		return -ENOMEM;
+
+	md->mpd.in_buff_size = mod->period_bytes;
+	md->mpd.out_buff_size = mod->period_bytes;
+
+	return 0;
+}
+
+/* Pass the data through from the bounce buffers */
+static int test_module_process(struct processing_module *mod,
+			       struct input_stream_buffer *input_buffers, int num_input_buffers,
+			       struct output_stream_buffer *output_buffers, int num_output_buffers)
+{
+	struct module_data *md = &mod->priv;
+
+	if (!md->mpd.init_done) {
+		md->mpd.init_done = 1;
+		md->mpd.produced = 0;
+		md->mpd.consumed = 0;
+		return 0;
+	}
+
+	memcpy_s(md->mpd.out_buff, md->mpd.out_buff_size, md->mpd.in_buff, md->mpd.in_buff_size);
+	md->mpd.produced = md->mpd.in_buff_size;
+	md->mpd.consumed = md->mpd.in_buff_size;
+
+	return 0;
+}
+
+/* Pass the data through from the source to the local buffer */
+static int test_module_process_segments(struct processing_module *mod,
+					const struct module_stream_segments *input,
+					const struct module_stream_segments *output)
+{
+	struct module_data *md = &mod->priv;
+	uint32_t bytes = MIN(input->bytes, output->bytes);
+
+	assert_int_equal(input->seg[0].size + input->seg[1].size, input->bytes);
+	assert_int_equal(output->seg[0].size + output->seg[1].size, output->bytes);
+
+	if (!md->mpd.init_done) {
+		md->mpd.init_done = 1;
+		return 0;
+	}
+
+	module_segments_copy(output, input, bytes);
+	md->mpd.produced = bytes;
+	md->mpd.consumed = bytes;
+
+	return 0;
+}
+
+static int test_module_process_segments_fail(struct processing_module *mod,
+					     const struct module_stream_segments *input,
+					     const struct module_stream_segments *output)
+{
+	return -EIO;
+}
+
+static int test_module_reset(struct processing_module *mod)
+{
+	return 0;
+}
+
+static int test_module_free(struct processing_module *mod)
+{
+	struct module_data *md = &mod->priv;
+
+	rfree(md->mpd.in_buff);
+	rfree(md->mpd.out_buff);
+
+	return 0;
+}
+
+static struct module_interface test_bounce_interface = {
+	.init = test_module_init,
+	.prepare = test_module_prepare,
+	.process = test_module_process,
+	.reset = test_module_reset,
+	.free = test_module_free,
+};
+
+static struct module_interface test_segments_interface = {
+	.init = test_module_init,
+	.prepare = test_module_prepare,
+	.process_segments = test_module_process_segments,
+	.reset = test_module_reset,
+	.free = test_module_free,
+};
+
+static void test_write_period(struct comp_buffer *source, int32_t *value)
+{
+	int32_t *ptr = source->stream.w_ptr;
+	int i;
+
+	for (i = 0; i < SEGMENTS_TEST_PERIOD_BYTES / sizeof(int32_t); i++) {
+		*ptr = (*value)++;
+		ptr = audio_stream_wrap(&source->stream, ptr + 1);
+	}
+
+	comp_update_buffer_produce(source, SEGMENTS_TEST_PERIOD_BYTES);
+}
+
+static void test_read_all(struct comp_buffer *sink, int32_t *value)
+{
+	uint32_t samples = audio_stream_get_avail_bytes(&sink->stream) / sizeof(int32_t);
+	int32_t *ptr = sink->stream.r_ptr;
+	int i;
+
+	for (i = 0; i < samples; i++) {
+		assert_int_equal(*ptr, (*value)++);
+		ptr = audio_stream_wrap(&sink->stream, ptr + 1);
+	}
+
+	comp_update_buffer_consume(sink, samples * sizeof(int32_t));
+}
+
+/* Run periods through the adapter and return the bytes of copies saved */
+static uint64_t test_codec_adapter_run(struct module_interface *interface)
+{
+	struct comp_driver drv = { .type = SOF_COMP_CODEC_ADAPTOR };
+	struct comp_ipc_config config = { .core = 0 };
+	struct ipc_config_process spec = { 0 };
+	struct sof_ipc_stream_params params = {
+		.frame_fmt = SOF_IPC_FRAME_S32_LE,
+		.rate = SEGMENTS_TEST_RATE,
+		.channels = SEGMENTS_TEST_CHANNELS,
+		.sample_container_bytes = sizeof(int32_t),
+		.sample_valid_bytes = sizeof(int32_t),
+	};
+	struct processing_module *mod;
+	struct comp_buffer *source;
+	struct comp_buffer *sink;
+	struct comp_dev *dev;
+	int32_t in = 0;
+	int32_t out = 0;
+	uint64_t saved;
+	int i;
+
+	dev = codec_adapter_new(&drv, &config, interface, &spec);
+	assert_non_null(dev);
+	mod = comp_get_drvdata(dev);
+	list_init(&dev->bsource_list);
+	list_init(&dev->bsink_list);
+
+	source = buffer_alloc(SEGMENTS_TEST_SOURCE_BYTES, 0, 0);
+	sink = buffer_alloc(SEGMENTS_TEST_SINK_BYTES, 0, 0);
+	assert_non_null(source);
+	assert_non_null(sink);
+	buffer_set_params(source, &params, BUFFER_UPDATE_FORCE);
+	pipeline_connect(dev, source, PPL_CONN_DIR_BUFFER_TO_COMP);
+	pipeline_connect(dev, sink, PPL_CONN_DIR_COMP_TO_BUFFER);
+
+	assert_int_equal(codec_adapter_params(dev, &params), 0);
+	assert_int_equal(codec_adapter_prepare(dev), 0);
+	assert_int_equal(mod->period_bytes, SEGMENTS_TEST_PERIOD_BYTES);
+
+	for (i = 0; i < SEGMENTS_TEST_PERIODS; i++) {
+		test_write_period(source, &in);
+		assert_int_equal(codec_adapter_copy(dev), 0);
+		test_read_all(sink, &out);
+	}
+
+	/* all but the periods kept in the source and local buffer got through */
+	assert_true(out >= in - 2 * SEGMENTS_TEST_PERIOD_BYTES / sizeof(int32_t));
+
+	saved = mod->copy_bytes_saved;
+	assert_int_equal(codec_adapter_reset(dev), 0);
+	assert_int_equal(mod->copy_bytes_saved, 0);
+
+	pipeline_disconnect(dev, source, PPL_CONN_DIR_BUFFER_TO_COMP);
+	pipeline_disconnect(dev, sink, PPL_CONN_DIR_COMP_TO_BUFFER);
+	codec_adapter_free(dev);
+	buffer_free(source);
+	buffer_free(sink);
+
+	return saved;
+}
+
+static void test_codec_adapter_bounce(void **state)
+{
+	(void)state;
+
+	assert_int_equal(test_codec_adapter_run(&test_bounce_interface), 0);
+}
+
+static void test_codec_adapter_segments(void **state)
+{
+	uint64_t saved;
+
+	(void)state;
+
+	/* every period is passed in place from the source to the local buffer */
+	saved = test_codec_adapter_run(&test_segments_interface);
+	printf("%s: %u bytes of copies saved\n", __func__, (uint32_t)saved);
+	assert_int_equal(saved, 2 * SEGMENTS_TEST_PERIODS * SEGMENTS_TEST_PERIOD_BYTES);
+}
+
+static void test_codec_adapter_segments_error(void **state)
+{
+	struct module_interface interface = {
+		.process_segments = test_module_process_segments_fail,
+	};
+	struct module_stream_segments input = { .bytes = 0 };
+	struct module_stream_segments output = { .bytes = 0 };
+	struct comp_dev dev = { 0 };
+	struct processing_module mod = { .dev = &dev };
+
+	(void)state;
+
+	mod.priv.ops = &interface;
+	mod.priv.state = MODULE_IDLE;
+
+	/* a failed process leaves the module ready for the next copy */
+	assert_int_equal(module_process_segments(&mod, &input, &output), -EIO);
+	assert_int_equal(mod.priv.state, MODULE_IDLE);
+	assert_int_equal(module_process_segments(&mod, &input, &output), -EIO);
+}
+
+static void test_codec_adapter_segments_copy(void **state)
+{
+	uint8_t src[16];
+	uint8_t dst[16];
+	struct module_stream_segments input = {
+		.seg = { { &src[10], 6 }, { &src[0], 7 } },
+		.bytes = 13,
+	};
+	struct module_stream_segments output = {
+		.seg = { { &dst[3], 13 }, { &dst[0], 0 } },
+		.bytes = 13,
+	};
+	int i;
+
+	(void)state;
+
+	for (i = 0; i < sizeof(src); i++)
+		src[i] = i;
+	memset(dst, 0xff, sizeof(dst));
+
+	module_segments_copy(&output, &input, 13);
+	for (i = 0; i < 6; i++)
+		assert_int_equal(dst[3 + i], 10 + i);
+	for (i = 0; i < 7; i++)
+		assert_int_equal(dst[9 + i], i);
+	for (i = 0; i < 3; i++)
+		assert_int_equal(dst[i], 0xff);
+
+	/* both regions wrapping at different places */
+	output.seg[0].ptr = &dst[12];
+	output.seg[0].size = 4;
+	output.seg[1].ptr = &dst[0];
+	output.seg[1].size = 9;
+	memset(dst, 0xff, sizeof(dst));
+
+	module_segments_copy(&output, &input, 11);
+	for (i = 0; i < 4; i++)
+		assert_int_equal(dst[12 + i], 10 + i);
+	assert_int_equal(dst[0], 14);
+	assert_int_equal(dst[1], 15);
+	for (i = 0; i < 5; i++)
+		assert_int_equal(dst[2 + i], i);
+	assert_int_equal(dst[7], 0xff);
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(test_codec_adapter_segments_copy),
+		cmocka_unit_test(test_codec_adapter_bounce),
+		cmocka_unit_test(test_codec_adapter_segments),
+		cmocka_unit_test(test_codec_adapter_segments_error),
+	};
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,343 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2022 Intel Corporation. All rights reserved.
+
+#include <sof/audio/buffer.h>
+#include <sof/audio/component_ext.h>
+#include <sof/audio/ipc-config.h>
+#include <sof/audio/kpb.h>
+#include <sof/audio/pipeline.h>
+#include <sof/lib/notifier.h>
+#include <sof/lib/pm_runtime.h>
+#include <sof/schedule/edf_schedule.h>
+#include <sof/schedule/schedule.h>
+#include <sof/schedule/task.h>
+#include <sof/sof.h>
+#include <ipc/stream.h>
+#include <user/kpb.h>
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <cmocka.h>
+
+/* fake timer, every read moves the time forward by one tick */
+#define TEST_TICKS_PER_MS	64
+#define TEST_TIME_LIMIT		(TEST_TICKS_PER_MS * 10000)
+
+/* host reads slower than the draining can copy, one byte per tick */
+#define TEST_HOST_BYTES_PER_MS	TEST_TICKS_PER_MS
+#define TEST_HOST_BUFFER_SIZE	1024
+
+#define TEST_DRAIN_MS		100
+#define TEST_DRAIN_BYTES	(TEST_DRAIN_MS * 16 * 2 * sizeof(int16_t))
+#define TEST_STREAM_SIZE	8192
+
+static const struct comp_driver *kpb_drv;
+static uint64_t test_time;
+static uint64_t host_time;
+static int host_copies;
+static size_t host_read;
+static uint8_t host_data[TEST_DRAIN_BYTES];
+
+struct kpb_test_state {
+	struct comp_dev *kpb;
+	struct comp_dev *host;
+	struct comp_dev *sel;
+	struct comp_buffer *source;
+	struct comp_buffer *host_buf;
+	struct comp_buffer *sel_buf;
+	struct pipeline pipe;
+};
+
+uint64_t platform_timer_get(struct timer *timer)
+{
+	/* draining must not wait for the host forever */
+	assert_true(test_time < TEST_TIME_LIMIT);
+
+	return ++test_time;
+}
+
+uint64_t clock_ms_to_ticks(int clock, uint64_t ms)
+{
+	return ms * TEST_TICKS_PER_MS;
+}
+
+bool pm_runtime_is_active(enum pm_runtime_context context, uint32_t index)
+{
+	return true;
+}
+
+void pm_runtime_enable(enum pm_runtime_context context, uint32_t index)
+{
+}
+
+void pm_runtime_disable(enum pm_runtime_context context, uint32_t index)
+{
+}
+
+/* EDF tasks are run to completion when scheduled */
+static int edf_mock_schedule(void *data, struct task *task, uint64_t start,
+			     uint64_t period)
+{
+	task->state = task->ops.run(task->data);
+
+	return 0;
+}
+
+static int edf_mock_free(void *data, struct task *task)
+{
+	return 0;
+}
+
+static const struct scheduler_ops edf_mock_ops = {
+	.schedule_task = edf_mock_schedule,
+	.schedule_task_free = edf_mock_free,
+};
+
+static struct schedule_data edf_mock = {
+	.type = SOF_SCHEDULE_EDF,
+	.ops = &edf_mock_ops,
+};
+
+static struct schedulers edf_schedulers;
+static struct schedulers *edf_schedulers_ptr = &edf_schedulers;
+
+struct schedulers **arch_schedulers_get(void)
+{
+	return &edf_schedulers_ptr;
+}
+
+int schedule_task_init_edf(struct task *task, const struct sof_uuid_entry *uid,
+			   const struct task_ops *ops,
+			   void *data, uint16_t core, uint32_t flags)
+{
+	memset(task, 0, sizeof(*task));
+	task->uid = uid;
+	task->type = SOF_SCHEDULE_EDF;
+	task->core = core;
+	task->flags = flags;
+	task->state = SOF_TASK_STATE_INIT;
+	task->ops = *ops;
+	task->data = data;
+
+	return 0;
+}
+
+/* host DMA reads the buffer at a fixed rate whenever it is copied */
+static int host_mock_copy(struct comp_dev *dev)
+{
+	struct comp_buffer *buf = list_first_item(&dev->bsource_list,
+						  struct comp_buffer,
+						  sink_list);
+	size_t budget = (test_time - host_time) * TEST_HOST_BYTES_PER_MS /
+			TEST_TICKS_PER_MS;
+	size_t bytes = MIN(budget, audio_stream_get_avail_bytes(&buf->stream));
+	uint8_t *src = buf->stream.r_ptr;
+	size_t i;
+
+	host_copies++;
+
+	/* the host can not read ahead while the buffer is empty */
+	if (bytes < budget)
+		host_time = test_time;
+	else
+		host_time += bytes * TEST_TICKS_PER_MS / TEST_HOST_BYTES_PER_MS;
+
+	bytes = MIN(bytes, sizeof(host_data) - host_read);
+	if (!bytes)
+		return 0;
+
+	for (i = 0; i < bytes; i++) {
+		host_data[host_read++] = *src;
+		src = audio_stream_wrap(&buf->stream, src + 1);
+	}
+
+	comp_update_buffer_consume(buf, bytes);
+
+	return 0;
+}
+
+static int mock_copy(struct comp_dev *dev)
+{
+	return 0;
+}
+
+static const struct comp_driver host_mock_drv = {
+	.type = SOF_COMP_HOST,
+	.ops = {
+		.copy = host_mock_copy,
+	},
+};
+
+static const struct comp_driver sel_mock_drv = {
+	.type = SOF_COMP_SELECTOR,
+	.ops = {
+		.copy = mock_copy,
+	},
+};
+
+static struct comp_dev *create_mock(const struct comp_driver *drv)
+{
+	struct comp_dev *dev = calloc(1, sizeof(*dev));
+
+	assert_non_null(dev);
+	dev->drv = drv;
+	dev->ipc_config.type = drv->type;
+	dev->state = COMP_STATE_ACTIVE;
+	list_init(&dev->bsource_list);
+	list_init(&dev->bsink_list);
+
+	return dev;
+}
+
+static struct comp_buffer *create_buffer(size_t size, struct comp_dev *source,
+					 struct comp_dev *sink)
+{
+	struct sof_ipc_buffer desc = {
+		.size = size,
+	};
+	struct comp_buffer *buf = buffer_new(&desc);
+
+	assert_non_null(buf);
+	buf->stream.channels = 2;
+	buf->stream.rate = 16000;
+	buf->stream.frame_fmt = SOF_IPC_FRAME_S16_LE;
+	buf->source = source;
+	buf->sink = sink;
+	if (source)
+		list_item_prepend(&buf->source_list, &source->bsink_list);
+	if (sink)
+		list_item_prepend(&buf->sink_list, &sink->bsource_list);
+
+	return buf;
+}
+
+static int setup(void **state)
+{
+	struct sof_kpb_config config = {
+		.size = sizeof(config),
+		.channels = 2,
+		.sampling_freq = 16000,
+		.sampling_width = 16,
+	};
+	struct ipc_config_process spec = {
+		.size = sizeof(config),
+		.data = (unsigned char *)&config,
+	};
+	struct comp_ipc_config ipc_config = {
+		.type = SOF_COMP_KPB,
+	};
+	struct sof_ipc_stream_params params = {
+		.buffer.size = 2 * KPB_MAX_BUFFER_SIZE(16),
+		.channels = 2,
+		.rate = 16000,
+		.frame_fmt = SOF_IPC_FRAME_S16_LE,
+		.sample_container_bytes = sizeof(int16_t),
+		.host_period_bytes = 16 * 2 * sizeof(int16_t),
+	};
+	struct kpb_test_state *ts = calloc(1, sizeof(*ts));
+
+	assert_non_null(ts);
+
+	list_init(&edf_schedulers.list);
+	list_item_append(&edf_mock.list, &edf_schedulers.list);
+
+	sys_comp_init(sof_get());
+	sys_comp_kpb_init();
+	kpb_drv = list_first_item(&comp_drivers_get()->list,
+				  struct comp_driver_info, list)->drv;
+	ts->kpb = kpb_drv->ops.create(kpb_drv, &ipc_config, &spec);
+	assert_non_null(ts->kpb);
+	list_init(&ts->kpb->bsource_list);
+	list_init(&ts->kpb->bsink_list);
+	ts->pipe.period = 1000;
+	ts->kpb->pipeline = &ts->pipe;
+
+	ts->host = create_mock(&host_mock_drv);
+	ts->sel = create_mock(&sel_mock_drv);
+	ts->source = create_buffer(TEST_STREAM_SIZE, NULL, ts->kpb);
+	ts->sel_buf = create_buffer(TEST_STREAM_SIZE, ts->kpb, ts->sel);
+	ts->host_buf = create_buffer(TEST_HOST_BUFFER_SIZE, ts->kpb, ts->host);
+
+	assert_int_equal(kpb_drv->ops.params(ts->kpb, &params), 0);
+	assert_int_equal(kpb_drv->ops.prepare(ts->kpb), 0);
+	ts->kpb->state = COMP_STATE_ACTIVE;
+
+	test_time = 0;
+	host_copies = 0;
+	host_read = 0;
+
+	*state = ts;
+
+	return 0;
+}
+
+static int teardown(void **state)
+{
+	struct kpb_test_state *ts = *state;
+
+	kpb_drv->ops.free(ts->kpb);
+	buffer_free(ts->source);
+	buffer_free(ts->sel_buf);
+	buffer_free(ts->host_buf);
+	free(ts->host);
+	free(ts->sel);
+	free(ts);
+
+	return 0;
+}
+
+/* Drain into a host sink smaller than the request, the host reads only
+ * while it is copied, so draining has to keep copying it while waiting.
+ */
+static void test_audio_kpb_drain_slow_host(void **state)
+{
+	struct kpb_test_state *ts = *state;
+	struct kpb_client cli = {
+		.id = 0,
+		.drain_req = TEST_DRAIN_MS,
+	};
+	struct kpb_event_data event = {
+		.event_id = KPB_EVENT_BEGIN_DRAINING,
+		.client_data = &cli,
+	};
+	uint8_t *dst = ts->source->stream.w_ptr;
+	size_t i;
+
+	/* buffer history with a known pattern */
+	for (i = 0; i < TEST_DRAIN_BYTES; i++)
+		dst[i] = i * 7 + (i >> 8);
+	comp_update_buffer_produce(ts->source, TEST_DRAIN_BYTES);
+	kpb_drv->ops.copy(ts->kpb);
+
+	host_time = test_time;
+	notifier_event(ts->kpb, NOTIFIER_ID_KPB_CLIENT_EVT,
+		       NOTIFIER_TARGET_CORE_LOCAL, &event, sizeof(event));
+
+	/* all data is in the host sink or already read by the host */
+	assert_int_equal(host_read +
+			 audio_stream_get_avail_bytes(&ts->host_buf->stream),
+			 TEST_DRAIN_BYTES);
+	assert_true(host_copies > TEST_DRAIN_BYTES / TEST_HOST_BUFFER_SIZE);
+
+#if !CONFIG_KPB_HISTORY_COMPRESSED
+	for (i = 0; i < host_read; i++)
+		assert_int_equal(host_data[i], (uint8_t)(i * 7 + (i >> 8)));
+#endif
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test_setup_teardown(test_audio_kpb_drain_slow_host,
+						setup, teardown),
+	};
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
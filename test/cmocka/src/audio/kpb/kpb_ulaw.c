@@ -0,0 +1,79 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2022 Intel Corporation. All rights reserved.
+
+#include <sof/audio/component.h>
+#include <sof/audio/kpb.h>
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <cmocka.h>
+
+/* Every 16-bit sample decodes within half of the step of its segment */
+static void test_audio_kpb_ulaw_round_trip(void **state)
+{
+	int32_t sample;
+	int32_t expected;
+	int32_t decoded;
+	int32_t max_error;
+	uint8_t code;
+
+	(void)state;
+
+	for (sample = INT16_MIN; sample <= INT16_MAX; sample++) {
+		code = kpb_ulaw_encode(sample);
+		decoded = kpb_ulaw_decode(code);
+
+		/* the magnitude is clipped before coding */
+		expected = sample;
+		if (expected > KPB_ULAW_CLIP)
+			expected = KPB_ULAW_CLIP;
+		else if (expected < -KPB_ULAW_CLIP)
+			expected = -KPB_ULAW_CLIP;
+
+		max_error = 4 << ((code >> 4) & 0x7);
+		assert_true(abs(decoded - expected) <= max_error);
+
+		/* the sign is kept */
+		assert_true(sample >= 0 ? decoded >= 0 : decoded <= 0);
+	}
+}
+
+/* Zeroed history buffer is silence, decoded samples code to themselves */
+static void test_audio_kpb_ulaw_codes(void **state)
+{
+	int32_t prev = 0;
+	int32_t decoded;
+	int code;
+
+	(void)state;
+
+	assert_int_equal(kpb_ulaw_encode(0), 0);
+	assert_int_equal(kpb_ulaw_decode(0), 0);
+
+	for (code = 0; code < 0x80; code++) {
+		decoded = kpb_ulaw_decode(code);
+		assert_int_equal(kpb_ulaw_encode(decoded), code);
+		assert_int_equal(kpb_ulaw_decode(code | 0x80), -decoded);
+
+		/* the codes are in increasing order of magnitude */
+		if (code)
+			assert_true(decoded > prev);
+		prev = decoded;
+	}
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(test_audio_kpb_ulaw_round_trip),
+		cmocka_unit_test(test_audio_kpb_ulaw_codes),
+	};
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
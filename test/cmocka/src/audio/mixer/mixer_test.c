@@ -9,6 +9,7 @@
 #include <math.h>
 #include <setjmp.h>
 #include <stdint.h>
+#include <time.h>
 #include <cmocka.h>
 #include <sof/list.h>
 #include <sof/ipc/driver.h>
@@ -30,6 +31,10 @@
 
 #define MIX_TEST_SAMPLES 32
 
+/* benchmark with 1 ms periods at 48 kHz */
+#define MIX_BENCH_FRAMES	48
+#define MIX_BENCH_PERIODS	2000
+
 struct comp_driver drv_mock;
 
 struct comp_driver mixer_drv_mock;
@@ -71,6 +76,8 @@ struct source {
 struct mix_test_case {
 	int num_sources;
 	int num_chans;
+	enum sof_ipc_frame frame_fmt;
+	int buffer_frames;
 	const char *name;
 	struct source *sources;
 };
@@ -79,12 +86,26 @@ struct mix_test_case {
 	{ \
 		.num_sources = (_num_sources), \
 		.num_chans = (_num_chans), \
+		.frame_fmt = SOF_IPC_FRAME_S32_LE, \
+		.buffer_frames = MIX_TEST_SAMPLES, \
 		.name = ("test_audio_mixer_copy_" \
 			 #_num_sources "_srcs_" \
 			 #_num_chans "ch"), \
 		.sources = NULL \
 	}
 
+#define TEST_CASE_FMT(_num_sources, _num_chans, _fmt, _fmt_name) \
+	{ \
+		.num_sources = (_num_sources), \
+		.num_chans = (_num_chans), \
+		.frame_fmt = (_fmt), \
+		.buffer_frames = MIX_TEST_SAMPLES, \
+		.name = ("test_audio_mixer_copy_" \
+			 #_num_sources "_srcs_" \
+			 #_num_chans "ch_" _fmt_name), \
+		.sources = NULL \
+	}
+
 static struct mix_test_case mix_test_cases[] = {
 	TEST_CASE(1, 2),
 	TEST_CASE(1, 4),
@@ -95,7 +116,14 @@ static struct mix_test_case mix_test_cases[] = {
 	TEST_CASE(3, 2),
 	TEST_CASE(4, 2),
 	TEST_CASE(6, 2),
-	TEST_CASE(8, 2)
+	TEST_CASE(8, 2),
+	TEST_CASE_FMT(2, 2, SOF_IPC_FRAME_S16_LE, "s16"),
+	TEST_CASE_FMT(3, 2, SOF_IPC_FRAME_S16_LE, "s16"),
+	TEST_CASE_FMT(5, 1, SOF_IPC_FRAME_S16_LE, "s16"),
+	TEST_CASE_FMT(2, 2, SOF_IPC_FRAME_S24_4LE, "s24"),
+	TEST_CASE_FMT(3, 4, SOF_IPC_FRAME_S24_4LE, "s24"),
+	TEST_CASE_FMT(7, 1, SOF_IPC_FRAME_S24_4LE, "s24"),
+	TEST_CASE_FMT(7, 1, SOF_IPC_FRAME_S32_LE, "s32"),
 };
 
 static struct sof_ipc_comp mock_comp = {
@@ -122,10 +150,11 @@ static void destroy_comp(struct comp_driver *drv, struct comp_dev *dev)
 	drv->ops.free(dev);
 }
 
-static void init_buffer_pcm_params(struct comp_buffer *buf, int num_chans)
+static void init_buffer_pcm_params(struct comp_buffer *buf, int num_chans,
+				   enum sof_ipc_frame frame_fmt)
 {
 	buf->stream.channels = num_chans;
-	buf->stream.frame_fmt = SOF_IPC_FRAME_S32_LE;
+	buf->stream.frame_fmt = frame_fmt;
 }
 
 static void create_sources(struct mix_test_case *tc)
@@ -140,13 +169,13 @@ static void create_sources(struct mix_test_case *tc)
 		struct source *src = &tc->sources[src_idx];
 
 		struct sof_ipc_buffer buf = {
-			.size = (MIX_TEST_SAMPLES * sizeof(uint32_t)) *
+			.size = (tc->buffer_frames * sizeof(uint32_t)) *
 				tc->num_chans
 		};
 
 		src->comp = create_comp(&mock_comp, &drv_mock, &ipc_config);
 		src->buf = buffer_new(&buf);
-		init_buffer_pcm_params(src->buf, tc->num_chans);
+		init_buffer_pcm_params(src->buf, tc->num_chans, tc->frame_fmt);
 
 		src->buf->source = src->comp;
 		src->buf->sink = mixer_dev_mock;
@@ -186,7 +215,7 @@ static int test_group_setup(void **state)
 	return 0;
 }
 
-static int test_setup(void **state)
+static void mix_case_setup(struct mix_test_case *tc)
 {
 	static struct sof_ipc_comp_mixer mixer = {
 		.comp = {
@@ -204,11 +233,9 @@ static int test_setup(void **state)
 	mixer_dev_mock = create_comp((struct sof_ipc_comp *)&mixer,
 				     &mixer_drv_mock, &ipc_config);
 
-	struct mix_test_case *tc = *((struct mix_test_case **)state);
-
 	if (tc) {
 		struct sof_ipc_buffer buf = {
-			.size = (MIX_TEST_SAMPLES * sizeof(uint32_t)) *
+			.size = (tc->buffer_frames * sizeof(uint32_t)) *
 				tc->num_chans
 		};
 
@@ -219,7 +246,7 @@ static int test_setup(void **state)
 
 		post_mixer_buf->source = mixer_dev_mock;
 		post_mixer_buf->sink = post_mixer_comp;
-		init_buffer_pcm_params(post_mixer_buf, tc->num_chans);
+		init_buffer_pcm_params(post_mixer_buf, tc->num_chans, tc->frame_fmt);
 
 		list_item_prepend(&post_mixer_buf->source_list,
 				  &mixer_dev_mock->bsink_list);
@@ -233,20 +260,28 @@ static int test_setup(void **state)
 
 		mixer_dev_mock->frames = MIX_TEST_SAMPLES;
 	}
-
-	return 0;
 }
 
-static int test_teardown(void **state)
+static void mix_case_teardown(struct mix_test_case *tc)
 {
 	destroy_comp(&mixer_drv_mock, mixer_dev_mock);
 
-	struct mix_test_case *tc = *((struct mix_test_case **)state);
-
 	if (tc) {
 		buffer_free(post_mixer_buf);
 		destroy_sources(tc);
 	}
+}
+
+static int test_setup(void **state)
+{
+	mix_case_setup(*((struct mix_test_case **)state));
+
+	return 0;
+}
+
+static int test_teardown(void **state)
+{
+	mix_case_teardown(*((struct mix_test_case **)state));
 
 	return 0;
 }
@@ -267,50 +302,153 @@ static void test_audio_mixer_prepare_no_sources(void **state)
 	assert_int_equal(downstream, 0);
 }
 
+/* test signal, 24 bit samples of odd sources are not sign extended */
+static int32_t mix_test_sample(struct mix_test_case *tc, int src_idx, int smp)
+{
+	double rad = M_PI / (180.0 / (smp * (src_idx + 1)));
+
+	switch (tc->frame_fmt) {
+	case SOF_IPC_FRAME_S16_LE:
+		return sin(rad) * INT16_MAX;
+	case SOF_IPC_FRAME_S24_4LE:
+		if (src_idx & 1)
+			return (int32_t)(sin(rad) * INT24_MAXVALUE) & 0xffffff;
+		return sin(rad) * INT24_MAXVALUE;
+	default:
+		return ((sin(rad) + 1) / 2) * (0xFFFFFFFF / 2);
+	}
+}
+
 static void test_audio_mixer_copy(void **state)
 {
 	int src_idx;
 	int smp;
 	struct mix_test_case *tc = *((struct mix_test_case **)state);
+	bool s16 = tc->frame_fmt == SOF_IPC_FRAME_S16_LE;
+	int sample_bytes = s16 ? sizeof(int16_t) : sizeof(int32_t);
 
 	for (src_idx = 0; src_idx < tc->num_sources; ++src_idx) {
-		uint32_t *samples = tc->sources[src_idx].buf->stream.addr;
+		int16_t *samples16 = tc->sources[src_idx].buf->stream.addr;
+		int32_t *samples32 = tc->sources[src_idx].buf->stream.addr;
 
 		for (smp = 0; smp < MIX_TEST_SAMPLES; ++smp) {
-			double rad = M_PI / (180.0 / (smp * (src_idx + 1)));
-
-			samples[smp] = ((sin(rad) + 1) / 2) * (0xFFFFFFFF / 2);
+			if (s16)
+				samples16[smp] = mix_test_sample(tc, src_idx, smp);
+			else
+				samples32[smp] = mix_test_sample(tc, src_idx, smp);
 		}
 
 		audio_stream_produce(&tc->sources[src_idx].buf->stream,
-				     sizeof(uint32_t) * MIX_TEST_SAMPLES);
+				     sample_bytes * MIX_TEST_SAMPLES);
 	}
 
 	mixer_drv_mock.ops.copy(mixer_dev_mock);
 
 	for (smp = 0; smp < MIX_TEST_SAMPLES; ++smp) {
-		uint64_t sum = 0;
+		int64_t sum = 0;
+		int32_t out;
 
 		for (src_idx = 0; src_idx < tc->num_sources; ++src_idx) {
 			assert_non_null(tc->sources[src_idx].buf);
 
-			uint32_t *samples =
-				tc->sources[src_idx].buf->stream.addr;
+			int16_t *samples16 = tc->sources[src_idx].buf->stream.addr;
+			uint32_t *samples32 = tc->sources[src_idx].buf->stream.addr;
+
+			switch (tc->frame_fmt) {
+			case SOF_IPC_FRAME_S16_LE:
+				sum += samples16[smp];
+				break;
+			case SOF_IPC_FRAME_S24_4LE:
+				sum += sign_extend_s24(samples32[smp]);
+				break;
+			default:
+				sum += samples32[smp];
+				break;
+			}
+		}
 
-			sum += samples[smp];
+		switch (tc->frame_fmt) {
+		case SOF_IPC_FRAME_S16_LE:
+			sum = sat_int16(sum);
+			out = ((int16_t *)post_mixer_buf->stream.addr)[smp];
+			break;
+		case SOF_IPC_FRAME_S24_4LE:
+			sum = sat_int24(sum);
+			out = ((int32_t *)post_mixer_buf->stream.addr)[smp];
+			break;
+		default:
+			sum = sat_int32(sum);
+			out = ((int32_t *)post_mixer_buf->stream.addr)[smp];
+			break;
 		}
 
-		sum = sat_int32(sum);
+		assert_int_equal(out, sum);
+	}
+}
+
+static uint64_t mix_bench_time_ns(void)
+{
+	struct timespec t;
+
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return (uint64_t)t.tv_sec * 1000000000 + t.tv_nsec;
+}
 
-		uint32_t *out_samples = post_mixer_buf->stream.addr;
+/* Time mixer copy() of 1 ms periods with 2 to 8 sources and 1 to 8 channels */
+static void test_audio_mixer_benchmark(void **state)
+{
+	const enum sof_ipc_frame fmts[] = {
+		SOF_IPC_FRAME_S16_LE, SOF_IPC_FRAME_S24_4LE, SOF_IPC_FRAME_S32_LE
+	};
+	static const char * const fmt_names[] = { "s16", "s24", "s32" };
+	struct mix_test_case tc = {
+		.buffer_frames = 2 * MIX_BENCH_FRAMES,
+	};
+	struct audio_stream *sink;
+	uint32_t period_bytes;
+	uint64_t t;
+	int f;
+	int i;
 
-		assert_int_equal(out_samples[smp], sum);
+	(void)state;
+
+	for (f = 0; f < ARRAY_SIZE(fmts); f++) {
+		for (tc.num_chans = 1; tc.num_chans <= 8; tc.num_chans <<= 1) {
+			for (tc.num_sources = 2; tc.num_sources <= 8; tc.num_sources += 2) {
+				tc.frame_fmt = fmts[f];
+				mix_case_setup(&tc);
+				mixer_dev_mock->frames = MIX_BENCH_FRAMES;
+				sink = &post_mixer_buf->stream;
+				period_bytes = MIX_BENCH_FRAMES * audio_stream_frame_bytes(sink);
+
+				t = mix_bench_time_ns();
+				for (i = 0; i < MIX_BENCH_PERIODS; i++) {
+					int j;
+
+					for (j = 0; j < tc.num_sources; j++)
+						audio_stream_produce(&tc.sources[j].buf->stream,
+								     period_bytes);
+
+					mixer_drv_mock.ops.copy(mixer_dev_mock);
+					assert_int_equal(audio_stream_get_avail_bytes(sink),
+							 period_bytes);
+					audio_stream_consume(sink, period_bytes);
+				}
+
+				t = mix_bench_time_ns() - t;
+				printf("%s: %s %d sources %d ch %.0f ns per period\n", __func__,
+				       fmt_names[f], tc.num_sources, tc.num_chans,
+				       (double)t / MIX_BENCH_PERIODS);
+
+				mix_case_teardown(&tc);
+			}
+		}
 	}
 }
 
 int main(void)
 {
-	struct CMUnitTest tests[ARRAY_SIZE(mix_test_cases) + 2];
+	struct CMUnitTest tests[ARRAY_SIZE(mix_test_cases) + 3];
 
 	int i;
 	int cur_test_case = 0;
@@ -327,7 +465,13 @@ int main(void)
 	tests[1].teardown_func = test_teardown;
 	tests[1].name = "test_audio_mixer_prepare_no_sources";
 
-	for (i = 2; i < ARRAY_SIZE(tests); (++i, ++cur_test_case)) {
+	tests[2].test_func = test_audio_mixer_benchmark;
+	tests[2].initial_state = NULL;
+	tests[2].setup_func = NULL;
+	tests[2].teardown_func = NULL;
+	tests[2].name = "test_audio_mixer_benchmark";
+
+	for (i = 3; i < ARRAY_SIZE(tests); (++i, ++cur_test_case)) {
 		tests[i].test_func = test_audio_mixer_copy;
 		tests[i].initial_state = &mix_test_cases[cur_test_case];
 		tests[i].setup_func = test_setup;
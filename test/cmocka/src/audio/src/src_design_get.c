@@ -0,0 +1,213 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2022 Intel Corporation. All rights reserved.
+
+#include <sof/audio/src/src.h>
+#include <sof/audio/src/src_config.h>
+#include <sof/audio/src/src_design.h>
+#include <sof/common.h>
+#include <sof/lib/alloc.h>
+
+#include <math.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+/* Designed DC gain of a conversion is -1 dB */
+#define SRC_DESIGN_TEST_GAIN		0.8912509
+#define SRC_DESIGN_TEST_GAIN_TOL	0.001
+
+#if SRC_SHORT
+typedef int16_t src_coef_t;
+#else
+typedef int32_t src_coef_t;
+#endif
+
+struct test_conversion {
+	int fs_in;
+	int fs_out;
+};
+
+static const struct test_conversion conversions[] = {
+	{ 44100, 48000 },
+	{ 48000, 16000 },
+	{ 8000, 48000 },
+};
+
+/* Allocations live in the pool, all are freed when the last stage is put */
+static int allocs;
+
+void *rballoc_align(uint32_t flags, uint32_t caps, size_t bytes,
+		    uint32_t alignment)
+{
+	allocs++;
+	return calloc(bytes, 1);
+}
+
+void *rzalloc(enum mem_zone zone, uint32_t flags, uint32_t caps,
+	      size_t bytes)
+{
+	allocs++;
+	return calloc(bytes, 1);
+}
+
+void rfree(void *ptr)
+{
+	if (ptr)
+		allocs--;
+
+	free(ptr);
+}
+
+/* Delay line lengths for one channel as in src.c */
+static int test_fir_delay_length(struct src_stage *s)
+{
+	return s->subfilter_length + (s->num_of_subfilters - 1) * s->idm
+		+ s->blk_in;
+}
+
+static int test_out_delay_length(struct src_stage *s)
+{
+	return 1 + (s->num_of_subfilters - 1) * s->odm;
+}
+
+/* Returns the DC gain of a stage, the subfilters must have the same gain */
+static double test_stage_dc_gain(struct src_stage *s)
+{
+	const src_coef_t *coefs = s->coefs;
+	double scale = ldexp(1.0, 8 * sizeof(src_coef_t) - 1 + s->shift);
+	double gain = 0;
+	double sum;
+	int64_t acc;
+	int i;
+	int j;
+
+	for (i = 0; i < s->num_of_subfilters; i++) {
+		acc = 0;
+		for (j = 0; j < s->subfilter_length; j++)
+			acc += coefs[i * s->subfilter_length + j];
+
+		sum = acc / scale;
+		if (i > 0)
+			assert_true(fabs(sum - gain) < SRC_DESIGN_TEST_GAIN_TOL);
+
+		gain = sum;
+	}
+
+	return gain;
+}
+
+static void test_stage_geometry(struct src_stage *s)
+{
+	assert_non_null(s->coefs);
+	assert_int_equal(s->num_of_subfilters, s->blk_out);
+	assert_int_equal(s->filter_length,
+			 s->num_of_subfilters * s->subfilter_length);
+	assert_true(s->filter_length == 1 || !(s->subfilter_length & 3));
+	assert_true(test_fir_delay_length(s) <= MAX_FIR_DELAY_SIZE);
+	assert_true(test_out_delay_length(s) <= MAX_OUT_DELAY_SIZE);
+}
+
+static int setup(void **state)
+{
+	src_design_init();
+	allocs = 0;
+	return 0;
+}
+
+static void test_audio_src_design_conversions(void **state)
+{
+	struct src_stage *stage1;
+	struct src_stage *stage2;
+	double gain;
+	int i;
+
+	(void)state;
+
+	for (i = 0; i < ARRAY_SIZE(conversions); i++) {
+		assert_int_equal(src_design_get(&stage1, &stage2,
+						conversions[i].fs_in,
+						conversions[i].fs_out), 0);
+
+		test_stage_geometry(stage1);
+		test_stage_geometry(stage2);
+
+		/* The stages interpolate and decimate fs_in to fs_out */
+		assert_true((int64_t)conversions[i].fs_in * stage1->blk_out *
+			    stage2->blk_out ==
+			    (int64_t)conversions[i].fs_out * stage1->blk_in *
+			    stage2->blk_in);
+
+		gain = test_stage_dc_gain(stage1) * test_stage_dc_gain(stage2);
+		if (fabs(gain - SRC_DESIGN_TEST_GAIN) >= SRC_DESIGN_TEST_GAIN_TOL)
+			printf("%s: %d to %d Hz DC gain %f\n", __func__,
+			       conversions[i].fs_in, conversions[i].fs_out, gain);
+
+		assert_true(fabs(gain - SRC_DESIGN_TEST_GAIN) <
+			    SRC_DESIGN_TEST_GAIN_TOL);
+
+		src_design_put(stage1);
+		src_design_put(stage2);
+	}
+
+	assert_int_equal(allocs, 0);
+}
+
+static void test_audio_src_design_pool(void **state)
+{
+	struct src_stage *stage1;
+	struct src_stage *stage2;
+	struct src_stage *shared1;
+	struct src_stage *shared2;
+	int pool_allocs;
+
+	(void)state;
+
+	/* Second user of a conversion gets the same stages */
+	assert_int_equal(src_design_get(&stage1, &stage2, 44100, 48000), 0);
+	pool_allocs = allocs;
+	assert_true(pool_allocs > 0);
+	assert_int_equal(src_design_get(&shared1, &shared2, 44100, 48000), 0);
+	assert_ptr_equal(stage1, shared1);
+	assert_ptr_equal(stage2, shared2);
+	assert_int_equal(allocs, pool_allocs);
+
+	/* Stages stay in pool until the last user puts them */
+	src_design_put(shared1);
+	src_design_put(shared2);
+	assert_int_equal(allocs, pool_allocs);
+	assert_int_equal(src_design_get(&shared1, &shared2, 44100, 48000), 0);
+	assert_ptr_equal(stage1, shared1);
+	assert_ptr_equal(stage2, shared2);
+	src_design_put(shared1);
+	src_design_put(shared2);
+
+	src_design_put(stage1);
+	src_design_put(stage2);
+	assert_int_equal(allocs, 0);
+
+	/* Same rates use a one tap filter that is not in pool */
+	assert_int_equal(src_design_get(&stage1, &stage2, 48000, 48000), 0);
+	assert_int_equal(stage1->filter_length, 1);
+	assert_int_equal(stage2->filter_length, 1);
+	assert_int_equal(allocs, 0);
+	src_design_put(stage1);
+	src_design_put(stage2);
+	assert_int_equal(allocs, 0);
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(test_audio_src_design_conversions),
+		cmocka_unit_test(test_audio_src_design_pool),
+	};
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, setup, NULL);
+}
@@ -54,6 +54,17 @@ static void set_volume(int32_t *vol, int32_t value, uint32_t channels)
 		vol[i] = value;
 }
 
+/* gain of a frame, it starts from the volume and follows the ramp */
+static int32_t frame_volume(struct vol_data *cd, int channel, int frame)
+{
+#if CONFIG_COMP_VOLUME_SMOOTH_RAMP
+	return ((cd->volume[channel] << VOL_RAMP_FRAC_BITS) +
+		frame * cd->ramp_inc[channel]) >> VOL_RAMP_FRAC_BITS;
+#else
+	return cd->volume[channel];
+#endif
+}
+
 static int setup(void **state)
 {
 	struct vol_test_parameters *parameters = *state;
@@ -75,7 +86,7 @@ static int setup(void **state)
 	/* malloc memory to store current volume 4 times to ensure the address
 	 * is 8-byte aligned for multi-way xtensa intrinsic operations.
 	 */
-	const size_t vol_size = sizeof(int32_t) * SOF_IPC_MAX_CHANNELS * 4;
+	const size_t vol_size = sizeof(int32_t) * VOL_GAIN_BUF_SIZE;
 
 	cd->vol = test_malloc(vol_size);
 
@@ -99,6 +110,13 @@ static int setup(void **state)
 	/* set processing function and volume */
 	cd->scale_vol = vol_get_processing_function(vol_state->dev);
 	set_volume(cd->volume, parameters->volume, parameters->channels);
+#if CONFIG_COMP_VOLUME_SMOOTH_RAMP
+	/* flat ramp must give the same output as constant gain */
+	cd->scale_vol_ramp = vol_get_ramp_processing_function(vol_state->dev);
+	set_volume(cd->ramp_vol, parameters->volume << VOL_RAMP_FRAC_BITS,
+		   parameters->channels);
+	set_volume(cd->ramp_inc, 0, parameters->channels);
+#endif
 
 	/* assigns verification function */
 	vol_state->verify = parameters->verify;
@@ -157,7 +175,7 @@ static void verify_s16_to_s16(struct comp_dev *dev, struct comp_buffer *sink,
 	for (i = 0; i < sink->stream.size / sizeof(uint16_t); i += channels) {
 		for (channel = 0; channel < channels; channel++) {
 			processed = src[i + channel] *
-				(double)cd->volume[channel] /
+				(double)frame_volume(cd, channel, i / channels) /
 				(double)VOL_ZERO_DB + 0.5;
 			if (processed > INT16_MAX)
 				processed = INT16_MAX;
@@ -209,7 +227,7 @@ static void verify_s24_to_s24_s32(struct comp_dev *dev,
 	for (i = 0; i < sink->stream.size / sizeof(uint32_t); i += channels) {
 		for (channel = 0; channel < channels; channel++) {
 			processed = (src[i + channel] << 8) *
-				(double)cd->volume[channel] /
+				(double)frame_volume(cd, channel, i / channels) /
 				(double)VOL_ZERO_DB + 0.5 * (1 << shift);
 			if (processed > INT32_MAX)
 				processed = INT32_MAX;
@@ -266,7 +284,7 @@ static void verify_s32_to_s24_s32(struct comp_dev *dev,
 	for (i = 0; i < sink->stream.size / sizeof(uint32_t); i += channels) {
 		for (channel = 0; channel < channels; channel++) {
 			processed = src[i + channel] *
-				    (double)cd->volume[channel] /
+				    (double)frame_volume(cd, channel, i / channels) /
 				    (double)VOL_ZERO_DB + 0.5 * (1 << shift);
 			if (processed > INT32_MAX)
 				processed = INT32_MAX;
@@ -377,11 +395,8 @@ static void verify_sX_to_s16(struct comp_dev *dev, struct comp_buffer *sink,
 
 #endif
 
-static void test_audio_vol(void **state)
+static void fill_source(struct vol_test_state *vol_state)
 {
-	struct vol_test_state *vol_state = *state;
-	struct vol_data *cd = comp_get_drvdata(vol_state->dev);
-
 	switch (vol_state->sink->stream.frame_fmt) {
 	case SOF_IPC_FRAME_S16_LE:
 		fill_source_s16(vol_state);
@@ -397,6 +412,14 @@ static void test_audio_vol(void **state)
 		/* TODO: add 3LE support */
 		break;
 	}
+}
+
+static void test_audio_vol(void **state)
+{
+	struct vol_test_state *vol_state = *state;
+	struct vol_data *cd = comp_get_drvdata(vol_state->dev);
+
+	fill_source(vol_state);
 
 	cd->scale_vol(vol_state->dev, &vol_state->sink->stream,
 		      &vol_state->source->stream, vol_state->dev->frames);
@@ -404,6 +427,50 @@ static void test_audio_vol(void **state)
 	vol_state->verify(vol_state->dev, vol_state->sink, vol_state->source);
 }
 
+#if CONFIG_COMP_VOLUME_SMOOTH_RAMP
+static void test_audio_vol_ramp(void **state)
+{
+	struct vol_test_state *vol_state = *state;
+	struct vol_data *cd = comp_get_drvdata(vol_state->dev);
+
+	fill_source(vol_state);
+
+	cd->scale_vol_ramp(vol_state->dev, &vol_state->sink->stream,
+			   &vol_state->source->stream, vol_state->dev->frames);
+
+	vol_state->verify(vol_state->dev, vol_state->sink, vol_state->source);
+}
+
+/* ramp down to half of the volume, the gain changes for every frame */
+static void test_audio_vol_ramp_down(void **state)
+{
+	struct vol_test_state *vol_state = *state;
+	struct vol_data *cd = comp_get_drvdata(vol_state->dev);
+	int32_t ramp_end;
+	int i;
+
+	for (i = 0; i < vol_state->sink->stream.channels; i++) {
+		cd->ramp_inc[i] = -(cd->ramp_vol[i] / 2) /
+				  (int32_t)vol_state->dev->frames;
+		assert_true(cd->ramp_inc[i] < 0);
+	}
+
+	fill_source(vol_state);
+
+	cd->scale_vol_ramp(vol_state->dev, &vol_state->sink->stream,
+			   &vol_state->source->stream, vol_state->dev->frames);
+
+	vol_state->verify(vol_state->dev, vol_state->sink, vol_state->source);
+
+	/* next block continues from the gain after the last frame */
+	for (i = 0; i < vol_state->sink->stream.channels; i++) {
+		ramp_end = (cd->volume[i] << VOL_RAMP_FRAC_BITS) +
+			   vol_state->dev->frames * cd->ramp_inc[i];
+		assert_int_equal(cd->ramp_vol[i], ramp_end);
+	}
+}
+#endif
+
 static struct vol_test_parameters parameters[] = {
 #if CONFIG_FORMAT_S16LE
 	{ VOL_MAX,        2, 48, 1, SOF_IPC_FRAME_S16_LE,
@@ -436,15 +503,35 @@ static struct vol_test_parameters parameters[] = {
 int main(void)
 {
 	int i;
+	int n = 0;
 
+#if CONFIG_COMP_VOLUME_SMOOTH_RAMP
+	struct CMUnitTest tests[3 * ARRAY_SIZE(parameters)];
+#else
 	struct CMUnitTest tests[ARRAY_SIZE(parameters)];
+#endif
 
 	for (i = 0; i < ARRAY_SIZE(parameters); i++) {
-		tests[i].name = "test_audio_vol";
-		tests[i].test_func = test_audio_vol;
-		tests[i].setup_func = setup;
-		tests[i].teardown_func = teardown;
-		tests[i].initial_state = &parameters[i];
+		tests[n].name = "test_audio_vol";
+		tests[n].test_func = test_audio_vol;
+		tests[n].setup_func = setup;
+		tests[n].teardown_func = teardown;
+		tests[n].initial_state = &parameters[i];
+		n++;
+#if CONFIG_COMP_VOLUME_SMOOTH_RAMP
+		tests[n].name = "test_audio_vol_ramp";
+		tests[n].test_func = test_audio_vol_ramp;
+		tests[n].setup_func = setup;
+		tests[n].teardown_func = teardown;
+		tests[n].initial_state = &parameters[i];
+		n++;
+		tests[n].name = "test_audio_vol_ramp_down";
+		tests[n].test_func = test_audio_vol_ramp_down;
+		tests[n].setup_func = setup;
+		tests[n].teardown_func = teardown;
+		tests[n].initial_state = &parameters[i];
+		n++;
+#endif
 	}
 
 	cmocka_set_message_output(CM_OUTPUT_TAP);
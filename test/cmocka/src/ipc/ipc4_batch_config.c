@@ -0,0 +1,388 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2022 Intel Corporation. All rights reserved.
+
+#include <sof/audio/component.h>
+#include <sof/audio/pipeline.h>
+#include <sof/ipc/common.h>
+#include <sof/ipc/msg.h>
+#include <sof/ipc/topology.h>
+#include <sof/lib/notifier.h>
+#include <sof/lib/pm_runtime.h>
+#include <sof/schedule/schedule.h>
+#include <sof/sof.h>
+#include <ipc4/error_status.h>
+#include <ipc4/module.h>
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <cmocka.h>
+
+#define BATCH_TEST_MODULE	1
+#define BATCH_TEST_INSTANCES	2
+
+/* payload of one item, padded to 4 bytes */
+#define BATCH_TEST_DATA_SIZE	6
+
+struct batch_test_item {
+	struct ipc4_module_batch_config_item item;
+	uint8_t data[ALIGN_UP(BATCH_TEST_DATA_SIZE, sizeof(uint32_t))];
+};
+
+int ipc4_batch_config_set(char *data, uint32_t size);
+
+extern struct ipc_msg msg_reply;
+
+static struct comp_dev *batch_test_dev[BATCH_TEST_INSTANCES];
+static int batch_test_set_ret;
+static int batch_test_sets;
+static int batch_test_ll_runs;
+static int batch_test_waits;
+static bool batch_test_ll_runs_on_wait;
+static bool batch_test_delete_on_wait;
+
+static struct ipc batch_test_ipc;
+static struct ipc_comp_dev batch_test_ppl_icd;
+static struct pipeline batch_test_ppl;
+static int batch_test_ll_data;
+static struct schedule_data batch_test_ll = {
+	.type = SOF_SCHEDULE_LL_TIMER,
+	.data = &batch_test_ll_data,
+};
+static struct schedulers batch_test_schedulers;
+static struct schedulers *batch_test_schedulers_ptr = &batch_test_schedulers;
+
+static int batch_test_set_large_config(struct comp_dev *dev, uint32_t param_id,
+				       bool first_block, bool last_block,
+				       uint32_t data_offset, char *data)
+{
+	assert_true(first_block);
+	assert_true(last_block);
+	assert_int_equal(data_offset, BATCH_TEST_DATA_SIZE);
+
+	/* only parameters of running pipelines wait for LL */
+	if (batch_test_ppl.status == COMP_STATE_ACTIVE)
+		assert_int_equal(batch_test_ll_runs, 1);
+
+	batch_test_sets++;
+
+	return batch_test_set_ret;
+}
+
+static const struct comp_driver batch_test_drv = {
+	.ops = {
+		.set_large_config = batch_test_set_large_config,
+	},
+};
+
+struct schedulers **arch_schedulers_get(void)
+{
+	return &batch_test_schedulers_ptr;
+}
+
+const struct comp_driver *ipc4_get_comp_drv(int module_id)
+{
+	return module_id == BATCH_TEST_MODULE ? &batch_test_drv : NULL;
+}
+
+struct comp_dev *ipc4_get_comp_dev(uint32_t comp_id)
+{
+	uint32_t instance = IPC4_INST_ID(comp_id);
+
+	if (IPC4_MOD_ID(comp_id) != BATCH_TEST_MODULE ||
+	    instance >= BATCH_TEST_INSTANCES)
+		return NULL;
+
+	return batch_test_dev[instance];
+}
+
+/* IPC thread waits for LL, which runs in between */
+void wait_delay(uint64_t number_of_clks)
+{
+	batch_test_waits++;
+
+	if (batch_test_delete_on_wait)
+		batch_test_dev[1] = NULL;
+
+	if (batch_test_ll_runs_on_wait) {
+		batch_test_ll_runs++;
+		notifier_event(&batch_test_ll_data, NOTIFIER_ID_LL_POST_RUN,
+			       NOTIFIER_TARGET_CORE_LOCAL, NULL, 0);
+	}
+}
+
+/* not used by batch config */
+struct comp_dev *comp_new(struct sof_ipc_comp *comp)
+{
+	return NULL;
+}
+
+int comp_verify_params(struct comp_dev *dev, uint32_t flag,
+		       struct sof_ipc_stream_params *params)
+{
+	return 0;
+}
+
+int ipc4_create_chain_dma(struct ipc *ipc, struct ipc4_chain_dma *cdma)
+{
+	return 0;
+}
+
+int ipc4_trigger_chain_dma(struct ipc *ipc, struct ipc4_chain_dma *cdma)
+{
+	return 0;
+}
+
+int ipc_comp_connect(struct ipc *ipc, ipc_pipe_comp_connect *connect)
+{
+	return 0;
+}
+
+int ipc_comp_disconnect(struct ipc *ipc, ipc_pipe_comp_connect *connect)
+{
+	return 0;
+}
+
+int ipc_comp_free(struct ipc *ipc, uint32_t comp_id)
+{
+	return 0;
+}
+
+int32_t ipc_comp_pipe_id(const struct ipc_comp_dev *icd)
+{
+	return 0;
+}
+
+int ipc_pipeline_new(struct ipc *ipc, ipc_pipe_new *pipeline)
+{
+	return 0;
+}
+
+int ipc_pipeline_free(struct ipc *ipc, uint32_t comp_id)
+{
+	return 0;
+}
+
+int ipc_pipeline_complete(struct ipc *ipc, uint32_t comp_id)
+{
+	return 0;
+}
+
+int ipc_platform_compact_read_msg(ipc_cmd_hdr *hdr, int words)
+{
+	return 0;
+}
+
+int ipc_process_on_core(uint32_t core, bool blocking)
+{
+	return 0;
+}
+
+int pipeline_for_each_comp(struct comp_dev *current,
+			   struct pipeline_walk_context *ctx, int dir)
+{
+	return 0;
+}
+
+int pipeline_prepare(struct pipeline *p, struct comp_dev *cd)
+{
+	return 0;
+}
+
+int pipeline_reset(struct pipeline *p, struct comp_dev *host_cd)
+{
+	return 0;
+}
+
+int pipeline_trigger(struct pipeline *p, struct comp_dev *host, int cmd)
+{
+	return 0;
+}
+
+void pm_runtime_get(enum pm_runtime_context context, uint32_t index)
+{
+}
+
+void pm_runtime_put(enum pm_runtime_context context, uint32_t index)
+{
+}
+
+/* one item per instance */
+static uint32_t batch_test_fill(struct batch_test_item *items)
+{
+	int i;
+
+	memset(items, 0, sizeof(*items) * BATCH_TEST_INSTANCES);
+	for (i = 0; i < BATCH_TEST_INSTANCES; i++) {
+		items[i].item.module_id = BATCH_TEST_MODULE;
+		items[i].item.instance_id = i;
+		items[i].item.data_size = BATCH_TEST_DATA_SIZE;
+	}
+
+	return sizeof(*items) * BATCH_TEST_INSTANCES;
+}
+
+static int setup(void **state)
+{
+	int i;
+
+	for (i = 0; i < BATCH_TEST_INSTANCES; i++) {
+		batch_test_dev[i] = calloc(1, sizeof(struct comp_dev));
+		assert_non_null(batch_test_dev[i]);
+	}
+
+	batch_test_set_ret = 0;
+	batch_test_sets = 0;
+	batch_test_ll_runs = 0;
+	batch_test_waits = 0;
+	batch_test_ll_runs_on_wait = true;
+	batch_test_delete_on_wait = false;
+
+	list_init(&batch_test_schedulers.list);
+	list_item_append(&batch_test_ll.list, &batch_test_schedulers.list);
+
+	/* one running pipeline on this core */
+	list_init(&batch_test_ipc.comp_list);
+	batch_test_ppl.status = COMP_STATE_ACTIVE;
+	batch_test_ppl_icd.type = COMP_TYPE_PIPELINE;
+	batch_test_ppl_icd.core = cpu_get_id();
+	batch_test_ppl_icd.pipeline = &batch_test_ppl;
+	list_item_append(&batch_test_ppl_icd.list, &batch_test_ipc.comp_list);
+	sof_get()->ipc = &batch_test_ipc;
+
+	/* set by ipc_cmd() for every message */
+	msg_reply.tx_size = sizeof(uint32_t);
+
+	return 0;
+}
+
+static int teardown(void **state)
+{
+	int i;
+
+	for (i = 0; i < BATCH_TEST_INSTANCES; i++)
+		free(batch_test_dev[i]);
+
+	/* no callback may be left behind */
+	assert_true(list_is_empty(&(*arch_notify_get())->list[NOTIFIER_ID_LL_POST_RUN]));
+
+	return 0;
+}
+
+static void test_ipc4_batch_config_idle(void **state)
+{
+	struct batch_test_item items[BATCH_TEST_INSTANCES];
+	uint32_t size = batch_test_fill(items);
+
+	batch_test_ppl.status = COMP_STATE_READY;
+
+	assert_int_equal(ipc4_batch_config_set((char *)items, size), 0);
+	assert_int_equal(batch_test_sets, BATCH_TEST_INSTANCES);
+	assert_int_equal(batch_test_waits, 0);
+}
+
+static void test_ipc4_batch_config_idle_set_fails(void **state)
+{
+	struct batch_test_item items[BATCH_TEST_INSTANCES];
+	uint32_t size = batch_test_fill(items);
+
+	batch_test_ppl.status = COMP_STATE_READY;
+	batch_test_set_ret = -EINVAL;
+
+	assert_int_equal(ipc4_batch_config_set((char *)items, size),
+			 IPC4_INVALID_RESOURCE_ID);
+}
+
+static void test_ipc4_batch_config_invalid(void **state)
+{
+	struct batch_test_item items[BATCH_TEST_INSTANCES];
+	uint32_t size = batch_test_fill(items);
+
+	items[1].item.instance_id = BATCH_TEST_INSTANCES;
+
+	assert_int_equal(ipc4_batch_config_set((char *)items, size),
+			 IPC4_MOD_INVALID_ID);
+	assert_int_equal(batch_test_sets, 0);
+	assert_int_equal(batch_test_waits, 0);
+}
+
+/* reply is sent once LL has applied the batch */
+static void test_ipc4_batch_config_deferred(void **state)
+{
+	struct batch_test_item items[BATCH_TEST_INSTANCES];
+	uint32_t size = batch_test_fill(items);
+
+	assert_int_equal(ipc4_batch_config_set((char *)items, size), 0);
+	assert_int_equal(batch_test_ll_runs, 1);
+	assert_int_equal(batch_test_sets, BATCH_TEST_INSTANCES);
+}
+
+static void test_ipc4_batch_config_deferred_set_fails(void **state)
+{
+	struct batch_test_item items[BATCH_TEST_INSTANCES];
+	uint32_t size = batch_test_fill(items);
+
+	batch_test_set_ret = -EINVAL;
+
+	assert_int_equal(ipc4_batch_config_set((char *)items, size),
+			 IPC4_INVALID_RESOURCE_ID);
+	assert_int_equal(batch_test_ll_runs, 1);
+}
+
+/* module deleted between the IPC and the end of the LL period */
+static void test_ipc4_batch_config_deferred_deleted(void **state)
+{
+	struct batch_test_item items[BATCH_TEST_INSTANCES];
+	uint32_t size = batch_test_fill(items);
+	struct comp_dev *dev = batch_test_dev[1];
+
+	batch_test_delete_on_wait = true;
+
+	assert_int_equal(ipc4_batch_config_set((char *)items, size),
+			 IPC4_MOD_INVALID_ID);
+	assert_int_equal(batch_test_sets, 0);
+
+	batch_test_dev[1] = dev;
+}
+
+/* LL does not run, the batch is withdrawn */
+static void test_ipc4_batch_config_deferred_timeout(void **state)
+{
+	struct batch_test_item items[BATCH_TEST_INSTANCES];
+	uint32_t size = batch_test_fill(items);
+
+	batch_test_ll_runs_on_wait = false;
+
+	assert_int_equal(ipc4_batch_config_set((char *)items, size),
+			 IPC4_FAILURE);
+	assert_int_equal(batch_test_sets, 0);
+	assert_true(batch_test_waits > 1);
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test_setup_teardown(test_ipc4_batch_config_idle,
+						setup, teardown),
+		cmocka_unit_test_setup_teardown(test_ipc4_batch_config_idle_set_fails,
+						setup, teardown),
+		cmocka_unit_test_setup_teardown(test_ipc4_batch_config_invalid,
+						setup, teardown),
+		cmocka_unit_test_setup_teardown(test_ipc4_batch_config_deferred,
+						setup, teardown),
+		cmocka_unit_test_setup_teardown(test_ipc4_batch_config_deferred_set_fails,
+						setup, teardown),
+		cmocka_unit_test_setup_teardown(test_ipc4_batch_config_deferred_deleted,
+						setup, teardown),
+		cmocka_unit_test_setup_teardown(test_ipc4_batch_config_deferred_timeout,
+						setup, teardown),
+	};
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
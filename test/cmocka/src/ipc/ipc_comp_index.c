@@ -0,0 +1,224 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2022 Intel Corporation. All rights reserved.
+
+#include <sof/audio/component.h>
+#include <sof/audio/pipeline.h>
+#include <sof/ipc/common.h>
+#include <sof/ipc/topology.h>
+#include <sof/list.h>
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <time.h>
+#include <cmocka.h>
+
+/* Objects per pipeline, the first one is the pipeline itself */
+#define INDEX_TEST_PPL_OBJECTS	10
+
+#define INDEX_BENCH_LOOKUPS	100000
+
+struct index_test {
+	struct ipc *ipc;
+	struct ipc_comp_dev *icd;
+	struct comp_dev *cd;
+	struct pipeline *p;
+	int count;
+};
+
+static uint64_t index_test_time_ns(void)
+{
+	struct timespec t;
+
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return (uint64_t)t.tv_sec * 1000000000 + t.tv_nsec;
+}
+
+/* Lookup as done before the index, for reference */
+static struct ipc_comp_dev *index_test_walk(struct ipc *ipc, uint32_t id)
+{
+	struct ipc_comp_dev *icd;
+	struct list_item *clist;
+
+	list_for_item(clist, &ipc->comp_list) {
+		icd = container_of(clist, struct ipc_comp_dev, list);
+		if (icd->id == id)
+			return icd;
+	}
+
+	return NULL;
+}
+
+/* IPC3 style sequential IDs or IPC4 style module and instance IDs */
+static uint32_t index_test_id(int i, bool ipc4)
+{
+	return ipc4 ? ((i % 7 + 1) << 16 | i / 7) : i + 1;
+}
+
+static void index_test_create(struct index_test *t, int count, bool ipc4)
+{
+	struct ipc_comp_dev *icd;
+	int ppl;
+	int i;
+
+	t->count = count;
+	t->icd = calloc(count, sizeof(*t->icd));
+	t->cd = calloc(count, sizeof(*t->cd));
+	t->p = calloc(count / INDEX_TEST_PPL_OBJECTS + 1, sizeof(*t->p));
+	assert_non_null(t->icd);
+	assert_non_null(t->cd);
+	assert_non_null(t->p);
+
+	assert_int_equal(ipc_init(sof_get()), 0);
+	t->ipc = sof_get()->ipc;
+
+	for (i = 0; i < count; i++) {
+		icd = &t->icd[i];
+		ppl = i / INDEX_TEST_PPL_OBJECTS;
+		icd->id = index_test_id(i, ipc4);
+		if (i % INDEX_TEST_PPL_OBJECTS) {
+			icd->type = COMP_TYPE_COMPONENT;
+			icd->cd = &t->cd[i];
+			icd->cd->ipc_config.pipeline_id = ppl;
+			list_init(&icd->cd->bsource_list);
+			list_init(&icd->cd->bsink_list);
+		} else {
+			icd->type = COMP_TYPE_PIPELINE;
+			icd->pipeline = &t->p[ppl];
+			icd->pipeline->pipeline_id = ppl;
+		}
+
+		ipc_comp_dev_add(t->ipc, icd);
+	}
+}
+
+static void index_test_free(struct index_test *t)
+{
+	int i;
+
+	for (i = 0; i < t->count; i++)
+		if (t->icd[i].id)
+			ipc_comp_dev_del(&t->icd[i]);
+
+	rfree(t->ipc->comp_data);
+	rfree(t->ipc);
+	free(t->icd);
+	free(t->cd);
+	free(t->p);
+}
+
+static void index_test_lookups(bool ipc4)
+{
+	struct index_test t;
+	struct ipc_comp_dev *icd;
+	int ppl;
+	int i;
+
+	index_test_create(&t, 500, ipc4);
+
+	for (i = 0; i < t.count; i++)
+		assert_ptr_equal(ipc_get_comp_by_id(t.ipc, t.icd[i].id), &t.icd[i]);
+
+	assert_null(ipc_get_comp_by_id(t.ipc, index_test_id(t.count, ipc4)));
+
+	for (ppl = 0; ppl < t.count / INDEX_TEST_PPL_OBJECTS; ppl++) {
+		i = ppl * INDEX_TEST_PPL_OBJECTS;
+		icd = ipc_get_comp_by_ppl_id(t.ipc, COMP_TYPE_PIPELINE, ppl);
+		assert_ptr_equal(icd, &t.icd[i]);
+
+		/* the first component added is returned as in the list */
+		icd = ipc_get_comp_by_ppl_id(t.ipc, COMP_TYPE_COMPONENT, ppl);
+		assert_ptr_equal(icd, &t.icd[i + 1]);
+		assert_ptr_equal(ipc_get_ppl_src_comp(t.ipc, ppl), &t.icd[i + 1]);
+	}
+
+	/* removed objects are not found and the rest still are */
+	for (i = 0; i < t.count; i += 3) {
+		ipc_comp_dev_del(&t.icd[i]);
+		t.icd[i].id = 0;
+	}
+
+	for (i = 0; i < t.count; i++) {
+		icd = t.icd[i].id ? &t.icd[i] : NULL;
+		assert_ptr_equal(ipc_get_comp_by_id(t.ipc, index_test_id(i, ipc4)), icd);
+		assert_ptr_equal(index_test_walk(t.ipc, index_test_id(i, ipc4)), icd);
+	}
+
+	assert_null(ipc_get_comp_by_ppl_id(t.ipc, COMP_TYPE_PIPELINE, 0));
+	assert_ptr_equal(ipc_get_comp_by_ppl_id(t.ipc, COMP_TYPE_COMPONENT, 0), &t.icd[1]);
+	assert_ptr_equal(ipc_get_comp_by_ppl_id(t.ipc, COMP_TYPE_COMPONENT, 3), &t.icd[31]);
+
+	index_test_free(&t);
+}
+
+static void test_ipc_comp_index_ipc3_ids(void **state)
+{
+	(void)state;
+
+	index_test_lookups(false);
+}
+
+static void test_ipc_comp_index_ipc4_ids(void **state)
+{
+	(void)state;
+
+	index_test_lookups(true);
+}
+
+/* Lookup latency of the index and of the list walk against object count */
+static void test_ipc_comp_index_benchmark(void **state)
+{
+	struct index_test t;
+	uintptr_t sum = 0;
+	uint32_t seed = 1;
+	uint64_t t_walk;
+	uint64_t t_hash;
+	int count;
+	int i;
+
+	(void)state;
+
+	for (count = 50; count <= 3200; count *= 4) {
+		index_test_create(&t, count, false);
+
+		t_hash = index_test_time_ns();
+		for (i = 0; i < INDEX_BENCH_LOOKUPS; i++) {
+			seed = seed * 1664525 + 1013904223;
+			sum += (uintptr_t)ipc_get_comp_by_id(t.ipc, (seed >> 8) % count + 1);
+		}
+		t_hash = index_test_time_ns() - t_hash;
+
+		t_walk = index_test_time_ns();
+		for (i = 0; i < INDEX_BENCH_LOOKUPS; i++) {
+			seed = seed * 1664525 + 1013904223;
+			sum += (uintptr_t)index_test_walk(t.ipc, (seed >> 8) % count + 1);
+		}
+		t_walk = index_test_time_ns() - t_walk;
+
+		printf("%s: %4d objects, walk %7.1f ns, index %5.1f ns per lookup\n",
+		       __func__, count, (double)t_walk / INDEX_BENCH_LOOKUPS,
+		       (double)t_hash / INDEX_BENCH_LOOKUPS);
+
+		index_test_free(&t);
+	}
+
+	/* use the results to keep the lookups from being optimized out */
+	assert_true(sum != 0);
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(test_ipc_comp_index_ipc3_ids),
+		cmocka_unit_test(test_ipc_comp_index_ipc4_ids),
+		cmocka_unit_test(test_ipc_comp_index_benchmark),
+	};
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -102,6 +102,18 @@ static struct test_case test_cases[] = {
 	TEST_CASE(256, SOF_MEM_ZONE_RUNTIME, SOF_MEM_CAPS_RAM |
 		  SOF_MEM_CAPS_DMA, 2, TEST_BULK, "rmalloc_dma"),
 
+	/* sizes between the block sizes, served from the slab caches */
+	TEST_CASE(150, SOF_MEM_ZONE_RUNTIME, SOF_MEM_CAPS_RAM, 16, TEST_BULK,
+		  "rmalloc_slab"),
+	TEST_CASE(300, SOF_MEM_ZONE_RUNTIME, SOF_MEM_CAPS_RAM, 16, TEST_BULK,
+		  "rmalloc_slab"),
+	TEST_CASE(180, SOF_MEM_ZONE_RUNTIME, SOF_MEM_CAPS_RAM, 16, TEST_BULK,
+		  "rmalloc_slab"),
+	TEST_CASE(300, SOF_MEM_ZONE_RUNTIME_SHARED, SOF_MEM_CAPS_RAM, 16,
+		  TEST_BULK, "rmalloc_slab"),
+	TEST_CASE(300, SOF_MEM_ZONE_RUNTIME, SOF_MEM_CAPS_RAM, 64,
+		  TEST_IMMEDIATE_FREE, "rmalloc_slab"),
+
 	/*
 	 * rzalloc tests
 	 */
@@ -161,6 +173,11 @@ static struct test_case test_cases[] = {
 	TEST_CASE(256, SOF_MEM_ZONE_RUNTIME, SOF_MEM_CAPS_RAM |
 		  SOF_MEM_CAPS_DMA, 2, TEST_ZERO, "rzalloc_dma"),
 
+	TEST_CASE(150, SOF_MEM_ZONE_RUNTIME, SOF_MEM_CAPS_RAM, 16, TEST_ZERO,
+		  "rzalloc_slab"),
+	TEST_CASE(300, SOF_MEM_ZONE_RUNTIME, SOF_MEM_CAPS_RAM, 16, TEST_ZERO,
+		  "rzalloc_slab"),
+
 	/*
 	 * rballoc tests
 	 */
@@ -323,9 +340,67 @@ static void test_lib_alloc(void **state)
 	}
 }
 
+#if CONFIG_MM_SLAB
+/* heap slab counters follow the objects and the empty page goes back */
+static void test_lib_alloc_slab_info(void **state)
+{
+	struct mm_slab_info slab;
+	struct mm_info before;
+	struct mm_info info;
+	void *mem[2];
+	int obj_size;
+
+	(void)state;
+
+	obj_size = heap_slab_info(SOF_MEM_ZONE_RUNTIME, 0, &slab);
+	assert_true(obj_size > 0);
+	assert_int_equal(slab.pages, 0);
+	assert_int_equal(heap_info(SOF_MEM_ZONE_RUNTIME, 0, &before), 0);
+
+	/* the first object takes a new page from the heap */
+	mem[0] = rmalloc(SOF_MEM_ZONE_RUNTIME, 0, SOF_MEM_CAPS_RAM, obj_size);
+	mem[1] = rmalloc(SOF_MEM_ZONE_RUNTIME, 0, SOF_MEM_CAPS_RAM, obj_size - 1);
+	assert_non_null(mem[0]);
+	assert_non_null(mem[1]);
+
+	assert_int_equal(heap_slab_info(SOF_MEM_ZONE_RUNTIME, 0, &slab), obj_size);
+	assert_int_equal(slab.pages, 1);
+	assert_int_equal(slab.used, 2);
+	assert_true(slab.free > 0);
+
+	assert_int_equal(heap_info(SOF_MEM_ZONE_RUNTIME, 0, &info), 0);
+	assert_int_equal(info.used, before.used + MM_SLAB_PAGE_SIZE);
+	assert_int_equal(info.slab_used, before.slab_used + 2 * obj_size);
+	assert_int_equal(info.slab_free, before.slab_free + slab.free * obj_size);
+
+	rfree(mem[0]);
+
+	assert_int_equal(heap_info(SOF_MEM_ZONE_RUNTIME, 0, &info), 0);
+	assert_int_equal(info.slab_used, before.slab_used + obj_size);
+	assert_int_equal(info.slab_free, before.slab_free + (slab.free + 1) * obj_size);
+
+	/* the page is released with its last object */
+	rfree(mem[1]);
+
+	assert_int_equal(heap_slab_info(SOF_MEM_ZONE_RUNTIME, 0, &slab), obj_size);
+	assert_int_equal(slab.pages, 0);
+	assert_int_equal(slab.used, 0);
+	assert_int_equal(slab.free, 0);
+
+	assert_int_equal(heap_info(SOF_MEM_ZONE_RUNTIME, 0, &info), 0);
+	assert_int_equal(info.used, before.used);
+	assert_int_equal(info.slab_used, before.slab_used);
+	assert_int_equal(info.slab_free, before.slab_free);
+}
+#endif
+
 int main(void)
 {
+#if CONFIG_MM_SLAB
+	struct CMUnitTest tests[ARRAY_SIZE(test_cases) + 1];
+#else
 	struct CMUnitTest tests[ARRAY_SIZE(test_cases)];
+#endif
 
 	int i;
 
@@ -339,6 +414,14 @@ int main(void)
 		t->teardown_func = NULL;
 	}
 
+#if CONFIG_MM_SLAB
+	tests[i].name = "test_lib_alloc_slab_info";
+	tests[i].test_func = test_lib_alloc_slab_info;
+	tests[i].initial_state = NULL;
+	tests[i].setup_func = clear_sys;
+	tests[i].teardown_func = NULL;
+#endif
+
 	cmocka_set_message_output(CM_OUTPUT_TAP);
 
 	return cmocka_run_group_tests(tests, setup, teardown);
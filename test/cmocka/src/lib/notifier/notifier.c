@@ -0,0 +1,286 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2022 Intel Corporation. All rights reserved.
+
+#include <sof/lib/alloc.h>
+#include <sof/lib/cpu.h>
+#include <sof/lib/notifier.h>
+#include <sof/sof.h>
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <cmocka.h>
+
+/* Number of observed callers, like buffers with a probe attached */
+#define NOTIFIER_TEST_CALLERS	256
+/* Callbacks registered for each observed caller */
+#define NOTIFIER_TEST_RECEIVERS	2
+/* Number of events per benchmark round */
+#define NOTIFIER_TEST_EVENTS	100000
+
+struct notifier_test_receiver {
+	uint32_t calls;
+};
+
+static struct notify *test_notify;
+
+static uint32_t test_callers[NOTIFIER_TEST_CALLERS];
+static uint32_t test_unobserved[NOTIFIER_TEST_CALLERS];
+static struct notifier_test_receiver
+	test_receivers[NOTIFIER_TEST_CALLERS][NOTIFIER_TEST_RECEIVERS];
+static struct notifier_test_receiver test_wildcard;
+
+struct notify **arch_notify_get(void)
+{
+	return &test_notify;
+}
+
+static void notifier_test_cb(void *arg, enum notify_id type, void *data)
+{
+	struct notifier_test_receiver *receiver = arg;
+
+	receiver->calls++;
+}
+
+static void notifier_test_clear_calls(void)
+{
+	memset(test_receivers, 0, sizeof(test_receivers));
+	test_wildcard.calls = 0;
+}
+
+static int setup(void **state)
+{
+	int i;
+	int j;
+
+	init_system_notify(sof_get());
+
+	for (i = 0; i < NOTIFIER_TEST_CALLERS; i++)
+		for (j = 0; j < NOTIFIER_TEST_RECEIVERS; j++)
+			assert_int_equal(notifier_register(&test_receivers[i][j],
+							   &test_callers[i],
+							   NOTIFIER_ID_BUFFER_PRODUCE,
+							   notifier_test_cb, 0), 0);
+
+	notifier_test_clear_calls();
+
+	return 0;
+}
+
+static int setup_empty(void **state)
+{
+	init_system_notify(sof_get());
+	notifier_test_clear_calls();
+
+	return 0;
+}
+
+static int teardown(void **state)
+{
+	notifier_unregister_all(NULL, NULL);
+	rfree(test_notify);
+	test_notify = NULL;
+
+	return 0;
+}
+
+static void test_notifier_caller_filter(void **state)
+{
+	int i;
+	int j;
+
+	(void)state;
+
+	for (i = 0; i < NOTIFIER_TEST_CALLERS; i++)
+		notifier_event(&test_callers[i], NOTIFIER_ID_BUFFER_PRODUCE,
+			       NOTIFIER_TARGET_CORE_LOCAL, NULL, 0);
+
+	/* every receiver sees only the events of its caller */
+	for (i = 0; i < NOTIFIER_TEST_CALLERS; i++)
+		for (j = 0; j < NOTIFIER_TEST_RECEIVERS; j++)
+			assert_int_equal(test_receivers[i][j].calls, 1);
+
+	/* other types and unobserved callers reach nobody */
+	notifier_test_clear_calls();
+	notifier_event(&test_callers[0], NOTIFIER_ID_BUFFER_CONSUME,
+		       NOTIFIER_TARGET_CORE_LOCAL, NULL, 0);
+	for (i = 0; i < NOTIFIER_TEST_CALLERS; i++)
+		notifier_event(&test_unobserved[i], NOTIFIER_ID_BUFFER_PRODUCE,
+			       NOTIFIER_TARGET_CORE_LOCAL, NULL, 0);
+	for (i = 0; i < NOTIFIER_TEST_CALLERS; i++)
+		for (j = 0; j < NOTIFIER_TEST_RECEIVERS; j++)
+			assert_int_equal(test_receivers[i][j].calls, 0);
+
+	/* event without caller reaches everybody */
+	notifier_event(NULL, NOTIFIER_ID_BUFFER_PRODUCE,
+		       NOTIFIER_TARGET_CORE_LOCAL, NULL, 0);
+	for (i = 0; i < NOTIFIER_TEST_CALLERS; i++)
+		for (j = 0; j < NOTIFIER_TEST_RECEIVERS; j++)
+			assert_int_equal(test_receivers[i][j].calls, 1);
+}
+
+static void test_notifier_wildcard(void **state)
+{
+	(void)state;
+
+	assert_int_equal(notifier_register(&test_wildcard, NULL,
+					   NOTIFIER_ID_BUFFER_PRODUCE,
+					   notifier_test_cb, 0), 0);
+
+	notifier_event(&test_callers[3], NOTIFIER_ID_BUFFER_PRODUCE,
+		       NOTIFIER_TARGET_CORE_LOCAL, NULL, 0);
+	notifier_event(&test_unobserved[3], NOTIFIER_ID_BUFFER_PRODUCE,
+		       NOTIFIER_TARGET_CORE_LOCAL, NULL, 0);
+
+	assert_int_equal(test_wildcard.calls, 2);
+	assert_int_equal(test_receivers[3][0].calls, 1);
+	assert_int_equal(test_receivers[4][0].calls, 0);
+}
+
+static void test_notifier_unregister(void **state)
+{
+	int i;
+
+	(void)state;
+
+	/* by receiver from all callers */
+	notifier_unregister(&test_receivers[5][0], NULL,
+			    NOTIFIER_ID_BUFFER_PRODUCE);
+	/* by caller for all receivers */
+	notifier_unregister(NULL, &test_callers[6], NOTIFIER_ID_BUFFER_PRODUCE);
+
+	for (i = 0; i < NOTIFIER_TEST_CALLERS; i++)
+		notifier_event(&test_callers[i], NOTIFIER_ID_BUFFER_PRODUCE,
+			       NOTIFIER_TARGET_CORE_LOCAL, NULL, 0);
+
+	assert_int_equal(test_receivers[5][0].calls, 0);
+	assert_int_equal(test_receivers[5][1].calls, 1);
+	assert_int_equal(test_receivers[6][0].calls, 0);
+	assert_int_equal(test_receivers[6][1].calls, 0);
+	assert_int_equal(test_receivers[7][0].calls, 1);
+
+	/* the table is sized to the handles and goes away with the last one */
+	assert_true(BIT(test_notify->caller_bits) >= test_notify->caller_count);
+	assert_true(BIT(test_notify->caller_bits) < 2 * test_notify->caller_count);
+	notifier_unregister(NULL, NULL, NOTIFIER_ID_BUFFER_PRODUCE);
+	assert_int_equal(test_notify->caller_type_count[NOTIFIER_ID_BUFFER_PRODUCE], 0);
+	assert_null(test_notify->caller_list);
+}
+
+/* Aggregated registrations of two callers sharing a hash bucket stay apart */
+static void test_notifier_aggregate_collision(void **state)
+{
+	const uint32_t shift = 32 - NOTIFIER_CALLER_MIN_BITS;
+	const enum notify_id type = NOTIFIER_ID_BUFFER_CONSUME;
+	uint32_t *caller_a = NULL;
+	uint32_t *caller_b = NULL;
+	int i;
+	int j;
+
+	(void)state;
+
+	/* any BIT(NOTIFIER_CALLER_MIN_BITS) + 1 callers have a collision */
+	for (i = 0; i <= BIT(NOTIFIER_CALLER_MIN_BITS) && !caller_b; i++)
+		for (j = 0; j < i; j++)
+			if (notifier_caller_hash(&test_callers[i], type) >> shift ==
+			    notifier_caller_hash(&test_callers[j], type) >> shift) {
+				caller_a = &test_callers[j];
+				caller_b = &test_callers[i];
+				break;
+			}
+	assert_non_null(caller_b);
+
+	assert_int_equal(notifier_register(&test_receivers[0][0], caller_a, type,
+					   notifier_test_cb,
+					   NOTIFIER_FLAG_AGGREGATE), 0);
+	assert_int_equal(notifier_register(&test_receivers[1][0], caller_b, type,
+					   notifier_test_cb,
+					   NOTIFIER_FLAG_AGGREGATE), 0);
+	assert_int_equal(notifier_register(&test_receivers[0][0], caller_a, type,
+					   notifier_test_cb,
+					   NOTIFIER_FLAG_AGGREGATE), 0);
+
+	/* same bucket, one handle per caller */
+	assert_int_equal(test_notify->caller_bits, NOTIFIER_CALLER_MIN_BITS);
+	assert_int_equal(test_notify->caller_count, 2);
+
+	notifier_event(caller_a, type, NOTIFIER_TARGET_CORE_LOCAL, NULL, 0);
+	assert_int_equal(test_receivers[0][0].calls, 1);
+	assert_int_equal(test_receivers[1][0].calls, 0);
+
+	notifier_event(caller_b, type, NOTIFIER_TARGET_CORE_LOCAL, NULL, 0);
+	assert_int_equal(test_receivers[0][0].calls, 1);
+	assert_int_equal(test_receivers[1][0].calls, 1);
+
+	/* caller a was registered twice */
+	notifier_unregister(NULL, caller_a, type);
+	notifier_event(caller_a, type, NOTIFIER_TARGET_CORE_LOCAL, NULL, 0);
+	assert_int_equal(test_receivers[0][0].calls, 2);
+
+	notifier_unregister(NULL, caller_a, type);
+	notifier_event(caller_a, type, NOTIFIER_TARGET_CORE_LOCAL, NULL, 0);
+	notifier_event(caller_b, type, NOTIFIER_TARGET_CORE_LOCAL, NULL, 0);
+	assert_int_equal(test_receivers[0][0].calls, 2);
+	assert_int_equal(test_receivers[1][0].calls, 2);
+
+	notifier_unregister(NULL, caller_b, type);
+	assert_null(test_notify->caller_list);
+}
+
+static void test_notifier_benchmark(void **state)
+{
+	clock_t observed;
+	clock_t unobserved;
+	clock_t start;
+	int i;
+
+	(void)state;
+
+	start = clock();
+	for (i = 0; i < NOTIFIER_TEST_EVENTS; i++)
+		notifier_event(&test_callers[i % NOTIFIER_TEST_CALLERS],
+			       NOTIFIER_ID_BUFFER_PRODUCE,
+			       NOTIFIER_TARGET_CORE_LOCAL, NULL, 0);
+	observed = clock() - start;
+
+	start = clock();
+	for (i = 0; i < NOTIFIER_TEST_EVENTS; i++)
+		notifier_event(&test_unobserved[i % NOTIFIER_TEST_CALLERS],
+			       NOTIFIER_ID_BUFFER_PRODUCE,
+			       NOTIFIER_TARGET_CORE_LOCAL, NULL, 0);
+	unobserved = clock() - start;
+
+	printf("%s: %d callbacks, %d events, observed %ld unobserved %ld clocks\n",
+	       __func__, NOTIFIER_TEST_CALLERS * NOTIFIER_TEST_RECEIVERS,
+	       NOTIFIER_TEST_EVENTS, (long)observed, (long)unobserved);
+
+	for (i = 0; i < NOTIFIER_TEST_CALLERS; i++)
+		assert_int_equal(test_receivers[i][0].calls,
+				 NOTIFIER_TEST_EVENTS / NOTIFIER_TEST_CALLERS +
+				 (i < NOTIFIER_TEST_EVENTS % NOTIFIER_TEST_CALLERS));
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test_setup_teardown(test_notifier_caller_filter,
+						setup, teardown),
+		cmocka_unit_test_setup_teardown(test_notifier_wildcard,
+						setup, teardown),
+		cmocka_unit_test_setup_teardown(test_notifier_unregister,
+						setup, teardown),
+		cmocka_unit_test_setup_teardown(test_notifier_aggregate_collision,
+						setup_empty, teardown),
+		cmocka_unit_test_setup_teardown(test_notifier_benchmark,
+						setup, teardown),
+	};
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
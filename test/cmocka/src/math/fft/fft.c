@@ -12,6 +12,9 @@
 #include <math.h>
 #include <cmocka.h>
 #include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
 
 #include <sof/audio/buffer.h>
 #include <sof/audio/component.h>
@@ -25,6 +28,14 @@
 
 #define SINE_HZ	1000
 
+/* SNR thresholds against a double precision DFT */
+#define FFT_32_SNR_TH		100.0
+#define FFT_32_IFFT_SNR_TH	80.0
+#define FFT_16_SNR_TH		80.0
+#define FFT_16_IFFT_SNR_TH	50.0
+
+#define FFT_BENCH_RUNS	2000
+
 /**
  * \brief Doing Fast Fourier Transform (FFT) for mono real input buffers.
  * \param[in] src - pointer to input buffer.
@@ -323,7 +334,7 @@ static void test_math_fft_1024_ifft(void **state)
 	db = 10 * log10((float)signal / noise);
 
 	printf("%s: signal: 0x%llx noise: 0x%llx db: %f\n", __func__,
-	       (uint64_t)signal, (uint64_t)noise, db);
+	       (unsigned long long)signal, (unsigned long long)noise, db);
 
 	if (db < FFT_DB_TH)
 		r = 1;
@@ -390,6 +401,304 @@ static void test_math_fft_512_2ch(void **state)
 	assert_in_range(r, i - 1, i + 1);
 }
 
+static uint32_t fft_test_seed;
+
+static int32_t fft_test_rand(int shift)
+{
+	fft_test_seed = fft_test_seed * 1664525 + 1013904223;
+	return (int32_t)fft_test_seed >> shift;
+}
+
+/* reference DFT of x with 1/N scale as in the library */
+static void fft_test_dft(const double *xr, const double *xi, double *yr, double *yi,
+			 int size, bool ifft)
+{
+	double a;
+	int sign = ifft ? 1 : -1;
+	int k;
+	int n;
+
+	for (k = 0; k < size; k++) {
+		yr[k] = 0;
+		yi[k] = 0;
+		for (n = 0; n < size; n++) {
+			a = sign * 2 * M_PI * (double)((int64_t)k * n % size) / size;
+			yr[k] += xr[n] * cos(a) - xi[n] * sin(a);
+			yi[k] += xr[n] * sin(a) + xi[n] * cos(a);
+		}
+
+		if (!ifft) {
+			yr[k] /= size;
+			yi[k] /= size;
+		}
+	}
+}
+
+static double fft_test_snr(const double *refr, const double *refi, const double *r,
+			   const double *i, int size)
+{
+	double signal = 0;
+	double noise = 0;
+	int k;
+
+	for (k = 0; k < size; k++) {
+		signal += refr[k] * refr[k] + refi[k] * refi[k];
+		noise += (r[k] - refr[k]) * (r[k] - refr[k]) +
+			 (i[k] - refi[k]) * (i[k] - refi[k]);
+	}
+
+	if (noise == 0)
+		return 200;
+
+	return 10 * log10(signal / noise);
+}
+
+static uint64_t fft_test_time_ns(void)
+{
+	struct timespec t;
+
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return (uint64_t)t.tv_sec * 1000000000 + t.tv_nsec;
+}
+
+struct fft_test_data {
+	double xr[FFT_SIZE_MAX];
+	double xi[FFT_SIZE_MAX];
+	double refr[FFT_SIZE_MAX];
+	double refi[FFT_SIZE_MAX];
+	double yr[FFT_SIZE_MAX];
+	double yi[FFT_SIZE_MAX];
+	struct icomplex32 inb[FFT_SIZE_MAX];
+	struct icomplex32 outb[FFT_SIZE_MAX];
+	struct icomplex16 inb16[FFT_SIZE_MAX];
+	struct icomplex16 outb16[FFT_SIZE_MAX];
+	int32_t real[FFT_SIZE_MAX];
+};
+
+static void test_math_fft_32_accuracy(void **state)
+{
+	struct fft_test_data *d = malloc(sizeof(*d));
+	struct fft_plan *plan;
+	double snr;
+	int size;
+	int i;
+
+	(void)state;
+
+	assert_non_null(d);
+	fft_test_seed = 1;
+	for (size = 2; size <= FFT_SIZE_MAX; size <<= 1) {
+		plan = fft_plan_new(d->inb, d->outb, size);
+		assert_non_null(plan);
+
+		for (i = 0; i < size; i++) {
+			d->inb[i].real = fft_test_rand(1);
+			d->inb[i].imag = fft_test_rand(1);
+			d->xr[i] = d->inb[i].real;
+			d->xi[i] = d->inb[i].imag;
+		}
+
+		fft_test_dft(d->xr, d->xi, d->refr, d->refi, size, false);
+		fft_execute(plan, false);
+		for (i = 0; i < size; i++) {
+			d->yr[i] = d->outb[i].real;
+			d->yi[i] = d->outb[i].imag;
+		}
+
+		snr = fft_test_snr(d->refr, d->refi, d->yr, d->yi, size);
+		printf("%s: size %4d fft snr %.1f dB\n", __func__, size, snr);
+		assert_true(snr > FFT_32_SNR_TH);
+
+		/* back to time domain, the imaginary part sign is inverted */
+		memcpy(d->inb, d->outb, size * sizeof(struct icomplex32));
+		fft_execute(plan, true);
+		for (i = 0; i < size; i++) {
+			d->yr[i] = d->outb[i].real;
+			d->yi[i] = -d->outb[i].imag;
+		}
+
+		snr = fft_test_snr(d->xr, d->xi, d->yr, d->yi, size);
+		printf("%s: size %4d ifft snr %.1f dB\n", __func__, size, snr);
+		assert_true(snr > FFT_32_IFFT_SNR_TH);
+
+		fft_plan_free(plan);
+	}
+
+	free(d);
+}
+
+static void test_math_fft_16_accuracy(void **state)
+{
+	struct fft_test_data *d = malloc(sizeof(*d));
+	struct fft_plan *plan;
+	double snr;
+	int size;
+	int i;
+
+	(void)state;
+
+	assert_non_null(d);
+	fft_test_seed = 2;
+	for (size = 2; size <= FFT_SIZE_MAX; size <<= 1) {
+		plan = fft_plan_new_16(d->inb16, d->outb16, size);
+		assert_non_null(plan);
+
+		for (i = 0; i < size; i++) {
+			d->inb16[i].real = fft_test_rand(17);
+			d->inb16[i].imag = fft_test_rand(17);
+			d->xr[i] = d->inb16[i].real;
+			d->xi[i] = d->inb16[i].imag;
+		}
+
+		fft_test_dft(d->xr, d->xi, d->refr, d->refi, size, false);
+		fft_execute_16(plan, false);
+		for (i = 0; i < size; i++) {
+			d->yr[i] = d->outb16[i].real;
+			d->yi[i] = d->outb16[i].imag;
+		}
+
+		/* the 1/N scaled output loses about 3 dB per stage */
+		snr = fft_test_snr(d->refr, d->refi, d->yr, d->yi, size);
+		printf("%s: size %4d fft snr %.1f dB\n", __func__, size, snr);
+		assert_true(snr > FFT_16_SNR_TH - 3.0 * plan->len);
+
+		memcpy(d->inb16, d->outb16, size * sizeof(struct icomplex16));
+		fft_execute_16(plan, true);
+		for (i = 0; i < size; i++) {
+			d->yr[i] = d->outb16[i].real;
+			d->yi[i] = -d->outb16[i].imag;
+		}
+
+		/* reference is the ifft of the quantized spectrum */
+		for (i = 0; i < size; i++) {
+			d->refr[i] = d->inb16[i].real;
+			d->refi[i] = d->inb16[i].imag;
+		}
+
+		fft_test_dft(d->refr, d->refi, d->xr, d->xi, size, true);
+		snr = fft_test_snr(d->xr, d->xi, d->yr, d->yi, size);
+		printf("%s: size %4d ifft snr %.1f dB\n", __func__, size, snr);
+		assert_true(snr > FFT_16_IFFT_SNR_TH);
+
+		fft_plan_free(plan);
+	}
+
+	free(d);
+}
+
+static void test_math_fft_real_accuracy(void **state)
+{
+	struct fft_test_data *d = malloc(sizeof(*d));
+	struct fft_plan_real *plan;
+	double snr;
+	int size;
+	int i;
+
+	(void)state;
+
+	assert_non_null(d);
+	fft_test_seed = 3;
+	for (size = 2; size <= FFT_SIZE_MAX; size <<= 1) {
+		plan = fft_plan_new_real(d->real, d->outb, size);
+		assert_non_null(plan);
+		assert_int_equal(plan->size, size);
+
+		for (i = 0; i < size; i++) {
+			d->real[i] = fft_test_rand(0);
+			d->xr[i] = d->real[i];
+			d->xi[i] = 0;
+		}
+
+		fft_test_dft(d->xr, d->xi, d->refr, d->refi, size, false);
+		fft_execute_real(plan, false);
+		for (i = 0; i <= size / 2; i++) {
+			d->yr[i] = d->outb[i].real;
+			d->yi[i] = d->outb[i].imag;
+		}
+
+		snr = fft_test_snr(d->refr, d->refi, d->yr, d->yi, size / 2 + 1);
+		printf("%s: size %4d fft snr %.1f dB\n", __func__, size, snr);
+		assert_true(snr > FFT_32_SNR_TH);
+
+		fft_execute_real(plan, true);
+		for (i = 0; i < size; i++) {
+			d->yr[i] = d->real[i];
+			d->yi[i] = 0;
+		}
+
+		snr = fft_test_snr(d->xr, d->xi, d->yr, d->yi, size);
+		printf("%s: size %4d ifft snr %.1f dB\n", __func__, size, snr);
+		assert_true(snr > FFT_32_IFFT_SNR_TH);
+
+		fft_plan_free_real(plan);
+	}
+
+	/* sizes above FFT_SIZE_MAX are not supported */
+	assert_null(fft_plan_new_real(d->real, d->outb, 2 * FFT_SIZE_MAX));
+	assert_null(fft_plan_new(d->inb, d->outb, 2 * FFT_SIZE_MAX));
+
+	free(d);
+}
+
+static void test_math_fft_benchmark(void **state)
+{
+	struct fft_test_data *d = malloc(sizeof(*d));
+	struct fft_plan_real *plan_real;
+	struct fft_plan *plan16;
+	struct fft_plan *plan;
+	uint64_t t_real;
+	uint64_t t_16;
+	uint64_t t;
+	int size;
+	int i;
+
+	(void)state;
+
+	assert_non_null(d);
+	fft_test_seed = 4;
+	for (i = 0; i < FFT_SIZE_MAX; i++) {
+		d->real[i] = fft_test_rand(1);
+		d->inb[i].real = d->real[i];
+		d->inb[i].imag = 0;
+		d->inb16[i].real = d->real[i] >> 16;
+		d->inb16[i].imag = 0;
+	}
+
+	for (size = 64; size <= FFT_SIZE_MAX; size <<= 2) {
+		plan = fft_plan_new(d->inb, d->outb, size);
+		plan16 = fft_plan_new_16(d->inb16, d->outb16, size);
+		plan_real = fft_plan_new_real(d->real, d->outb, size);
+		assert_non_null(plan);
+		assert_non_null(plan16);
+		assert_non_null(plan_real);
+
+		t = fft_test_time_ns();
+		for (i = 0; i < FFT_BENCH_RUNS; i++)
+			fft_execute(plan, false);
+		t = fft_test_time_ns() - t;
+
+		t_16 = fft_test_time_ns();
+		for (i = 0; i < FFT_BENCH_RUNS; i++)
+			fft_execute_16(plan16, false);
+		t_16 = fft_test_time_ns() - t_16;
+
+		t_real = fft_test_time_ns();
+		for (i = 0; i < FFT_BENCH_RUNS; i++)
+			fft_execute_real(plan_real, false);
+		t_real = fft_test_time_ns() - t_real;
+
+		printf("%s: size %4d complex %6.0f ns, 16 bit %6.0f ns, real %6.0f ns\n",
+		       __func__, size, (double)t / FFT_BENCH_RUNS,
+		       (double)t_16 / FFT_BENCH_RUNS, (double)t_real / FFT_BENCH_RUNS);
+
+		fft_plan_free_real(plan_real);
+		fft_plan_free(plan16);
+		fft_plan_free(plan);
+	}
+
+	free(d);
+}
+
 int main(void)
 {
 	const struct CMUnitTest tests[] = {
@@ -397,6 +706,10 @@ int main(void)
 		cmocka_unit_test(test_math_fft_1024),
 		cmocka_unit_test(test_math_fft_1024_ifft),
 		cmocka_unit_test(test_math_fft_512_2ch),
+		cmocka_unit_test(test_math_fft_32_accuracy),
+		cmocka_unit_test(test_math_fft_16_accuracy),
+		cmocka_unit_test(test_math_fft_real_accuracy),
+		cmocka_unit_test(test_math_fft_benchmark),
 	};
 
 	cmocka_set_message_output(CM_OUTPUT_TAP);
@@ -0,0 +1,263 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2022 Intel Corporation. All rights reserved.
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <math.h>
+#include <cmocka.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <sof/audio/format.h>
+#include <sof/math/fft.h>
+#include <sof/math/fir_fft.h>
+#include <sof/math/fir_generic.h>
+#include <user/fir.h>
+
+/* SNR threshold against the exact direct form convolution */
+#define FIR_FFT_SNR_TH		90.0
+
+#define FIR_FFT_BENCH_SAMPLES	9600
+
+static uint32_t fir_fft_test_seed;
+
+/* Simple LCG to get repeatable pseudo random Q1.31 values */
+static int32_t fir_fft_test_rand(int shift)
+{
+	fir_fft_test_seed = fir_fft_test_seed * 1664525 + 1013904223;
+	return (int32_t)fir_fft_test_seed >> shift;
+}
+
+static uint64_t fir_fft_test_time_ns(void)
+{
+	struct timespec t;
+
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return (uint64_t)t.tv_sec * 1000000000 + t.tv_nsec;
+}
+
+/* Exponentially decaying random response, as a room correction filter */
+static struct sof_fir_coef_data *fir_fft_test_coef(int taps)
+{
+	struct sof_fir_coef_data *config;
+	double sum = 0;
+	int i;
+
+	config = calloc(1, sizeof(*config) + taps * sizeof(int16_t));
+	if (!config)
+		return NULL;
+
+	config->length = taps;
+	for (i = 0; i < taps; i++) {
+		config->coef[i] = (fir_fft_test_rand(16) >> 1) * exp(-4.0 * i / taps);
+		sum += abs(config->coef[i]);
+	}
+
+	/* Scale the output to avoid saturation */
+	while (sum > 32768 << config->out_shift)
+		config->out_shift++;
+
+	return config;
+}
+
+static int32_t fir_fft_test_direct(struct sof_fir_coef_data *config, int32_t *x, int n)
+{
+	int64_t y = 0;
+	int i;
+
+	for (i = 0; i < config->length && i <= n; i++)
+		y += (int64_t)config->coef[i] * x[n - i];
+
+	return sat_int32(y >> (15 + config->out_shift));
+}
+
+static void fir_fft_test_response(int taps, int samples)
+{
+	struct sof_fir_coef_data *config;
+	struct fir_fft_state fir;
+	struct fir_fft_coef coef;
+	struct fir_fft_plan plan;
+	int32_t *data;
+	int32_t *x;
+	int32_t *p;
+	double signal = 0;
+	double noise = 0;
+	double ref;
+	double snr;
+	int coef_size;
+	int delay_size;
+	int i;
+	int ret;
+
+	config = fir_fft_test_coef(taps);
+	x = malloc(samples * sizeof(int32_t));
+	assert_non_null(config);
+	assert_non_null(x);
+
+	ret = fir_fft_plan_init(&plan, fir_fft_block_size(taps));
+	assert_int_equal(ret, 0);
+
+	/* Coefficients spectra and the delay line in one chunk */
+	coef_size = fir_fft_coef_size(&plan, config);
+	delay_size = fir_fft_delay_size(&plan, config);
+	assert_true(coef_size >= 0);
+	assert_true(delay_size > 0);
+	data = calloc(1, coef_size + delay_size);
+	assert_non_null(data);
+
+	p = data;
+	fir_fft_init_coef(&plan, &coef, config, &p);
+	assert_ptr_equal(p, data + coef_size / sizeof(int32_t));
+	fir_fft_init_delay(&plan, &fir, &coef, &p);
+	assert_ptr_equal(p, data + (coef_size + delay_size) / sizeof(int32_t));
+
+	for (i = 0; i < samples; i++) {
+		x[i] = fir_fft_test_rand(1);
+		ref = fir_fft_test_direct(config, x, i);
+		signal += ref * ref;
+		ref -= fir_fft_32x16(&plan, &fir, x[i]);
+		noise += ref * ref;
+	}
+
+	snr = noise ? 10 * log10(signal / noise) : 200;
+	printf("%s: taps %4d block %3d partitions %2d snr %.1f dB\n", __func__,
+	       taps, plan.block, coef.partitions, snr);
+	assert_true(snr > FIR_FFT_SNR_TH);
+
+	fir_fft_plan_free(&plan);
+	free(data);
+	free(x);
+	free(config);
+}
+
+static void test_math_fir_fft_short(void **state)
+{
+	(void)state;
+
+	/* Only the direct form part */
+	fir_fft_test_seed = 1;
+	fir_fft_test_response(8, 256);
+	fir_fft_test_response(16, 256);
+}
+
+static void test_math_fir_fft_long(void **state)
+{
+	int taps[] = {100, 300, 512, 1000, 2048};
+	int i;
+
+	(void)state;
+
+	fir_fft_test_seed = 2;
+	for (i = 0; i < ARRAY_SIZE(taps); i++)
+		fir_fft_test_response(taps[i], 3 * taps[i] + 77);
+}
+
+static void test_math_fir_fft_max(void **state)
+{
+	(void)state;
+
+	fir_fft_test_seed = 3;
+	fir_fft_test_response(FIR_FFT_MAX_LENGTH, 2 * FIR_FFT_MAX_LENGTH);
+}
+
+static void test_math_fir_fft_block_size(void **state)
+{
+	struct fir_fft_plan plan;
+	int taps;
+
+	(void)state;
+
+	for (taps = 4; taps <= FIR_FFT_MAX_LENGTH; taps <<= 1) {
+		assert_true(fir_fft_block_size(taps) >= FIR_FFT_BLOCK_MIN);
+		assert_true(fir_fft_block_size(taps) <= FIR_FFT_BLOCK_MAX);
+		assert_true(fir_fft_block_size(taps) <= fir_fft_block_size(2 * taps));
+	}
+
+	assert_int_equal(fir_fft_plan_init(&plan, FIR_FFT_BLOCK_MIN / 2), -EINVAL);
+	assert_int_equal(fir_fft_plan_init(&plan, 2 * FIR_FFT_BLOCK_MAX), -EINVAL);
+	assert_int_equal(fir_fft_plan_init(&plan, 3 * FIR_FFT_BLOCK_MIN), -EINVAL);
+}
+
+/* Cycles per sample compared to the direct form FIR */
+static void test_math_fir_fft_benchmark(void **state)
+{
+	struct sof_fir_coef_data *config;
+	struct fir_state_32x16 direct;
+	struct fir_fft_state fir;
+	struct fir_fft_coef coef;
+	struct fir_fft_plan plan;
+	int32_t *delay;
+	int32_t *data;
+	int32_t *p;
+	int32_t sum = 0;
+	uint64_t t_direct;
+	uint64_t t;
+	int taps;
+	int i;
+
+	(void)state;
+
+	fir_fft_test_seed = 4;
+	for (taps = 128; taps <= FIR_FFT_MAX_LENGTH; taps <<= 1) {
+		config = fir_fft_test_coef(taps);
+		assert_non_null(config);
+
+		/* The direct form delay line is of the size fir_delay_size() */
+		delay = calloc(taps + 4, sizeof(int32_t));
+		assert_non_null(delay);
+		p = delay;
+		fir_init_coef(&direct, config);
+		fir_init_delay(&direct, &p);
+
+		assert_int_equal(fir_fft_plan_init(&plan, fir_fft_block_size(taps)), 0);
+		data = calloc(1, fir_fft_coef_size(&plan, config) +
+			      fir_fft_delay_size(&plan, config));
+		assert_non_null(data);
+		p = data;
+		fir_fft_init_coef(&plan, &coef, config, &p);
+		fir_fft_init_delay(&plan, &fir, &coef, &p);
+
+		t_direct = fir_fft_test_time_ns();
+		for (i = 0; i < FIR_FFT_BENCH_SAMPLES; i++)
+			sum += fir_32x16(&direct, fir_fft_test_rand(1));
+		t_direct = fir_fft_test_time_ns() - t_direct;
+
+		t = fir_fft_test_time_ns();
+		for (i = 0; i < FIR_FFT_BENCH_SAMPLES; i++)
+			sum += fir_fft_32x16(&plan, &fir, fir_fft_test_rand(1));
+		t = fir_fft_test_time_ns() - t;
+
+		printf("%s: taps %4d direct %6.1f ns, fft %6.1f ns per sample\n",
+		       __func__, taps, (double)t_direct / FIR_FFT_BENCH_SAMPLES,
+		       (double)t / FIR_FFT_BENCH_SAMPLES);
+
+		fir_fft_plan_free(&plan);
+		free(data);
+		free(delay);
+		free(config);
+	}
+
+	/* use the output to keep the filters from being optimized out */
+	printf("%s: checksum %d\n", __func__, sum);
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(test_math_fir_fft_short),
+		cmocka_unit_test(test_math_fir_fft_long),
+		cmocka_unit_test(test_math_fir_fft_max),
+		cmocka_unit_test(test_math_fir_fft_block_size),
+		cmocka_unit_test(test_math_fir_fft_benchmark),
+	};
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,339 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2022 Intel Corporation. All rights reserved.
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <math.h>
+#include <cmocka.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <sof/audio/format.h>
+#include <sof/bit.h>
+#include <sof/common.h>
+#include <sof/math/iir_df2t.h>
+#include <sof/math/iir_df2t_block.h>
+#include <sof/math/numbers.h>
+#include <user/eq.h>
+
+#define IIR_BLOCK_TEST_FRAMES	2000
+#define IIR_BLOCK_BENCH_FRAMES	9600
+#define IIR_BLOCK_MAX_CH	16
+
+static uint32_t iir_block_test_seed;
+
+/* Simple LCG to get repeatable pseudo random Q1.31 values */
+static int32_t iir_block_test_rand(int shift)
+{
+	iir_block_test_seed = iir_block_test_seed * 1664525 + 1013904223;
+	return (int32_t)iir_block_test_seed >> shift;
+}
+
+static uint64_t iir_block_test_time_ns(void)
+{
+	struct timespec t;
+
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return (uint64_t)t.tv_sec * 1000000000 + t.tv_nsec;
+}
+
+/* Random stable sections with poles at radius 0.9 ... 0.99, the gains are
+ * high enough to saturate now and then.
+ */
+static struct sof_eq_iir_header_df2t *iir_block_test_coef(int biquads,
+							  int in_series)
+{
+	struct sof_eq_iir_header_df2t *eq;
+	int32_t *c;
+	double r;
+	double w;
+	int i;
+
+	eq = calloc(1, sizeof(*eq) +
+		    biquads * SOF_EQ_IIR_NBIQUAD_DF2T * sizeof(int32_t));
+	if (!eq)
+		return NULL;
+
+	eq->num_sections = biquads;
+	eq->num_sections_in_series = in_series;
+	for (i = 0; i < biquads; i++) {
+		c = ASSUME_ALIGNED(&eq->biquads[i * SOF_EQ_IIR_NBIQUAD_DF2T], 4);
+		r = 0.9 + 0.09 * (iir_block_test_rand(1) & 0x3fffffff) / 0x40000000;
+		w = M_PI * (iir_block_test_rand(1) & 0x3fffffff) / 0x40000000;
+		c[0] = -r * r * (1 << 30);			/* a2 */
+		c[1] = 2 * r * cos(w) * (1 << 30);		/* a1 */
+		c[2] = iir_block_test_rand(3);			/* b2 */
+		c[3] = iir_block_test_rand(2);			/* b1 */
+		c[4] = iir_block_test_rand(3);			/* b0 */
+		c[5] = (iir_block_test_rand(1) & 0x7fffffff) % 3;	/* shift */
+		c[6] = (1 << 14) + (iir_block_test_rand(1) >> 18);	/* gain */
+	}
+
+	return eq;
+}
+
+/* Compares every channel of the block filter to iir_df2t(). A NULL
+ * response is a channel in bypass.
+ */
+static void iir_block_test_response(struct sof_eq_iir_header_df2t **eq, int nch)
+{
+	struct iir_state_df2t iir[IIR_BLOCK_MAX_CH];
+	struct iir_df2t_block blk;
+	int64_t *delay;
+	int64_t *dp;
+	int32_t *data;
+	int32_t *ref;
+	int32_t *x;
+	void *mem;
+	void *p;
+	int delay_size = 0;
+	int frames;
+	int size;
+	int ch;
+	int i;
+	int n;
+
+	memset(iir, 0, sizeof(iir));
+	for (ch = 0; ch < nch; ch++) {
+		if (eq[ch]) {
+			iir_init_coef_df2t(&iir[ch], eq[ch]);
+			delay_size += iir_delay_size_df2t(eq[ch]);
+		}
+	}
+
+	delay = calloc(1, delay_size);
+	assert_non_null(delay);
+	dp = delay;
+	for (ch = 0; ch < nch; ch++)
+		if (iir[ch].biquads)
+			iir_init_delay_df2t(&iir[ch], &dp);
+
+	size = iir_df2t_block_size(iir, nch);
+	assert_true(size > 0);
+	mem = malloc(size);
+	data = malloc(IIR_DF2T_BLOCK_SAMPLES(nch) * sizeof(int32_t));
+	ref = malloc(nch * sizeof(int32_t));
+	x = malloc(IIR_BLOCK_TEST_FRAMES * nch * sizeof(int32_t));
+	assert_non_null(mem);
+	assert_non_null(data);
+	assert_non_null(ref);
+	assert_non_null(x);
+
+	/* Garbage in the memory must not matter */
+	memset(mem, 0x5a, size);
+	p = mem;
+	iir_df2t_block_init(&blk, iir, nch, &p);
+	assert_ptr_equal(p, (int8_t *)mem + size);
+
+	for (i = 0; i < IIR_BLOCK_TEST_FRAMES * nch; i++)
+		x[i] = iir_block_test_rand(1);
+
+	/* Process in blocks of random length to check the state is kept */
+	for (i = 0; i < IIR_BLOCK_TEST_FRAMES; i += frames) {
+		frames = 1 + (iir_block_test_rand(1) & 0x7fffffff) % IIR_DF2T_BLOCK_FRAMES;
+		frames = MIN(frames, IIR_BLOCK_TEST_FRAMES - i);
+		for (n = 0; n < frames; n++)
+			for (ch = 0; ch < nch; ch++)
+				data[n * blk.lanes + ch] = x[(i + n) * nch + ch];
+
+		iir_df2t_block(&blk, data, frames);
+
+		for (n = 0; n < frames; n++) {
+			for (ch = 0; ch < nch; ch++) {
+				ref[ch] = iir_df2t(&iir[ch], x[(i + n) * nch + ch]);
+				assert_int_equal(data[n * blk.lanes + ch], ref[ch]);
+			}
+		}
+	}
+
+	free(x);
+	free(ref);
+	free(data);
+	free(mem);
+	free(delay);
+}
+
+static void iir_block_test_run(int nch, int biquads, int in_series,
+			       uint32_t bypass_mask)
+{
+	struct sof_eq_iir_header_df2t *eq[IIR_BLOCK_MAX_CH];
+	int ch;
+
+	for (ch = 0; ch < nch; ch++) {
+		if (bypass_mask & BIT(ch)) {
+			eq[ch] = NULL;
+			continue;
+		}
+
+		eq[ch] = iir_block_test_coef(biquads, in_series);
+		assert_non_null(eq[ch]);
+	}
+
+	iir_block_test_response(eq, nch);
+
+	for (ch = 0; ch < nch; ch++)
+		free(eq[ch]);
+}
+
+static void test_math_iir_df2t_block_series(void **state)
+{
+	int nch;
+
+	(void)state;
+
+	iir_block_test_seed = 1;
+	for (nch = 1; nch <= IIR_BLOCK_MAX_CH; nch++) {
+		iir_block_test_run(nch, 1, 1, 0);
+		iir_block_test_run(nch, 4, 4, 0);
+	}
+}
+
+static void test_math_iir_df2t_block_parallel(void **state)
+{
+	(void)state;
+
+	iir_block_test_seed = 2;
+	iir_block_test_run(1, 4, 2, 0);
+	iir_block_test_run(2, 6, 2, 0);
+	iir_block_test_run(5, 6, 3, 0);
+	iir_block_test_run(8, 4, 1, 0);
+}
+
+static void test_math_iir_df2t_block_bypass(void **state)
+{
+	(void)state;
+
+	iir_block_test_seed = 3;
+	iir_block_test_run(2, 3, 3, BIT(0));
+	iir_block_test_run(3, 2, 2, BIT(1));
+	iir_block_test_run(6, 4, 2, BIT(0) | BIT(5));
+	iir_block_test_run(8, 6, 3, 0xaa);
+}
+
+static void test_math_iir_df2t_block_size(void **state)
+{
+	struct sof_eq_iir_header_df2t *eq[3];
+	struct iir_state_df2t iir[3];
+
+	(void)state;
+
+	iir_block_test_seed = 4;
+	eq[0] = iir_block_test_coef(4, 4);
+	eq[1] = iir_block_test_coef(4, 2);
+	eq[2] = iir_block_test_coef(3, 3);
+
+	/* All in bypass */
+	memset(iir, 0, sizeof(iir));
+	assert_int_equal(iir_df2t_block_size(iir, 3), -EINVAL);
+
+	/* Sections in series differ */
+	iir_init_coef_df2t(&iir[0], eq[0]);
+	iir_init_coef_df2t(&iir[1], eq[1]);
+	assert_int_equal(iir_df2t_block_size(iir, 2), -EINVAL);
+
+	/* Sections count differs */
+	iir_init_coef_df2t(&iir[1], eq[2]);
+	assert_int_equal(iir_df2t_block_size(iir, 2), -EINVAL);
+
+	/* Same structure */
+	iir_init_coef_df2t(&iir[1], eq[0]);
+	assert_true(iir_df2t_block_size(iir, 2) > 0);
+
+	free(eq[0]);
+	free(eq[1]);
+	free(eq[2]);
+}
+
+/* Time per sample compared to iir_df2t() for each channel */
+static void test_math_iir_df2t_block_benchmark(void **state)
+{
+	struct sof_eq_iir_header_df2t *eq;
+	struct iir_state_df2t iir[IIR_BLOCK_MAX_CH];
+	struct iir_df2t_block blk;
+	int64_t *delay;
+	int64_t *dp;
+	int32_t *data;
+	int32_t sum = 0;
+	uint64_t t_ref;
+	uint64_t t;
+	void *mem;
+	void *p;
+	int nch;
+	int ch;
+	int i;
+	int n;
+
+	(void)state;
+
+	iir_block_test_seed = 5;
+	eq = iir_block_test_coef(4, 4);
+	assert_non_null(eq);
+	for (nch = 2; nch <= IIR_BLOCK_MAX_CH; nch <<= 1) {
+		delay = calloc(nch, iir_delay_size_df2t(eq));
+		assert_non_null(delay);
+		dp = delay;
+		for (ch = 0; ch < nch; ch++) {
+			iir_init_coef_df2t(&iir[ch], eq);
+			iir_init_delay_df2t(&iir[ch], &dp);
+		}
+
+		mem = calloc(1, iir_df2t_block_size(iir, nch));
+		data = calloc(IIR_DF2T_BLOCK_SAMPLES(nch), sizeof(int32_t));
+		assert_non_null(mem);
+		assert_non_null(data);
+		p = mem;
+		iir_df2t_block_init(&blk, iir, nch, &p);
+
+		t_ref = iir_block_test_time_ns();
+		for (i = 0; i < IIR_BLOCK_BENCH_FRAMES; i++)
+			for (ch = 0; ch < nch; ch++)
+				sum += iir_df2t(&iir[ch], iir_block_test_rand(1));
+		t_ref = iir_block_test_time_ns() - t_ref;
+
+		t = iir_block_test_time_ns();
+		for (i = 0; i < IIR_BLOCK_BENCH_FRAMES; i += IIR_DF2T_BLOCK_FRAMES) {
+			for (n = 0; n < IIR_DF2T_BLOCK_FRAMES * blk.lanes; n += blk.lanes)
+				for (ch = 0; ch < nch; ch++)
+					data[n + ch] = iir_block_test_rand(1);
+
+			iir_df2t_block(&blk, data, IIR_DF2T_BLOCK_FRAMES);
+			sum += data[0];
+		}
+		t = iir_block_test_time_ns() - t;
+
+		printf("%s: channels %2d biquads %d iir_df2t %5.2f ns, block %5.2f ns per sample\n",
+		       __func__, nch, eq->num_sections,
+		       (double)t_ref / (IIR_BLOCK_BENCH_FRAMES * nch),
+		       (double)t / (IIR_BLOCK_BENCH_FRAMES * nch));
+
+		free(data);
+		free(mem);
+		free(delay);
+	}
+
+	/* use the output to keep the filters from being optimized out */
+	printf("%s: checksum %d\n", __func__, sum);
+	free(eq);
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(test_math_iir_df2t_block_series),
+		cmocka_unit_test(test_math_iir_df2t_block_parallel),
+		cmocka_unit_test(test_math_iir_df2t_block_bypass),
+		cmocka_unit_test(test_math_iir_df2t_block_size),
+		cmocka_unit_test(test_math_iir_df2t_block_benchmark),
+	};
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
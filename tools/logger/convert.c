@@ -14,6 +14,7 @@
 #include <errno.h>
 #include <unistd.h>
 #include <math.h>
+#include <pthread.h>
 #include <sof/lib/uuid.h>
 #include <time.h>
 #include <user/abi_dbg.h>
@@ -30,6 +31,8 @@
 #define TRACE_MAX_IDS_STR		10
 #define TRACE_IDS_MASK			((1 << TRACE_ID_LENGTH) - 1)
 #define INVALID_TRACE_ID		(-1 & TRACE_IDS_MASK)
+#define TRACE_MAX_SUBST_LEN		128
+#define TRACE_CAPTURE_BUF_SIZE		(64 * 1024)
 
 /** Dictionary entry. This MUST match the start of the linker output
  * defined by _DECLARE_LOG_ENTRY().
@@ -48,16 +51,51 @@ struct ldc_entry {
 	struct ldc_entry_header header;
 	char *file_name;
 	char *text;
-	uint32_t *params;
+	const uint32_t *params;
 };
 
 /** Dictionary entry + formatted parameters */
 struct proc_ldc_entry {
-	int subst_mask;
 	struct ldc_entry_header header;
 	char *file_name;
-	char *text;
+	char text[TRACE_MAX_TEXT_LEN];
 	uintptr_t params[TRACE_MAX_PARAMS_COUNT];
+	char subst[TRACE_MAX_PARAMS_COUNT][TRACE_MAX_SUBST_LEN];
+};
+
+/** Log entries section of the ldc file, loaded once and indexed by the
+ * entry address used in the firmware.
+ */
+struct ldc_dict {
+	uint8_t *data;
+	struct ldc_entry *entries;
+	uint32_t entries_num;
+	int32_t *index;		/* entries[] position for each dword, -1 if none */
+};
+
+/** Timestamp and synchronization state carried between log statements */
+struct logger_state {
+	uint64_t last_timestamp;
+	uint64_t timestamp_origin;
+	int entry_number;
+	bool ldc_address_OK;
+	unsigned int skipped_dwords;
+};
+
+/** Part of an in-memory capture converted by one thread, split at a
+ * statement boundary
+ */
+struct convert_chunk {
+	const uint8_t *data;
+	size_t start;
+	size_t end;
+	struct logger_state state;	/* state before the first statement */
+	FILE *out_fd;
+	char *out_buf;
+	size_t out_size;
+	pthread_t thread;
+	bool running;
+	int ret;
 };
 
 static const char *BAD_PTR_STR = "<bad uid ptr 0x%.8x>";
@@ -68,28 +106,44 @@ static const char *BAD_PTR_STR = "<bad uid ptr 0x%.8x>";
 /* pointer to config for global context */
 struct convert_config *global_config;
 
-static int read_entry_from_ldc_file(struct ldc_entry *entry, uint32_t log_entry_address);
+static struct ldc_dict ldc_dict;
 
-char *format_uid_raw(const struct sof_uuid_entry *uid_entry, int use_colors, int name_first,
-		     bool be, bool upper)
+static int get_ldc_entry(struct ldc_entry *entry, uint32_t log_entry_address);
+
+static int format_uid_buf(char *buf, size_t size, const struct sof_uuid_entry *uid_entry,
+			  int use_colors, int name_first, bool be, bool upper)
 {
 	const struct sof_uuid *uid_val = &uid_entry->id;
 	uint32_t a = be ? htobe32(uid_val->a) : uid_val->a;
 	uint16_t b = be ? htobe16(uid_val->b) : uid_val->b;
 	uint16_t c = be ? htobe16(uid_val->c) : uid_val->c;
+
+	return snprintf(buf, size, upper ? UUID_UPPER : UUID_LOWER,
+			use_colors ? KBLU : "",
+			name_first ? uid_entry->name : "",
+			name_first ? " " : "",
+			a, b, c,
+			uid_val->d[0], uid_val->d[1], uid_val->d[2],
+			uid_val->d[3], uid_val->d[4], uid_val->d[5],
+			uid_val->d[6], uid_val->d[7],
+			name_first ? "" : " ",
+			name_first ? "" : uid_entry->name,
+			use_colors ? KNRM : "");
+}
+
+char *format_uid_raw(const struct sof_uuid_entry *uid_entry, int use_colors, int name_first,
+		     bool be, bool upper)
+{
+	int len = format_uid_buf(NULL, 0, uid_entry, use_colors, name_first, be, upper);
 	char *str;
 
-	str = log_asprintf(upper ? UUID_UPPER : UUID_LOWER,
-			   use_colors ? KBLU : "",
-			   name_first ? uid_entry->name : "",
-			   name_first ? " " : "",
-			   a, b, c,
-			   uid_val->d[0], uid_val->d[1], uid_val->d[2],
-			   uid_val->d[3], uid_val->d[4], uid_val->d[5],
-			   uid_val->d[6], uid_val->d[7],
-			   name_first ? "" : " ",
-			   name_first ? "" : uid_entry->name,
-			   use_colors ? KNRM : "");
+	if (len < 0)
+		return NULL;
+
+	str = malloc(len + 1);
+	if (str)
+		format_uid_buf(str, len + 1, uid_entry, use_colors, name_first, be, upper);
+
 	return str;
 }
 
@@ -122,35 +176,29 @@ uint32_t get_uuid_key(const struct sof_uuid_entry *entry)
 		uids_dict->data_offset + uids_dict->base_address;
 }
 
-static const char *format_uid(uint32_t uid_ptr, int use_colors, bool be, bool upper)
+static void format_uid(char *buf, size_t size, uint32_t uid_ptr, int use_colors, bool be,
+		       bool upper)
 {
 	const struct snd_sof_uids_header *uids_dict = global_config->uids_dict;
-	const struct sof_uuid_entry *uid_entry;
-	char *str;
 
 	if (uid_ptr < uids_dict->base_address ||
-	    uid_ptr >= uids_dict->base_address + uids_dict->data_length) {
-		str = calloc(1, strlen(BAD_PTR_STR) + 1 + 6);
-		sprintf(str, BAD_PTR_STR, uid_ptr);
-	} else {
-		uid_entry = get_uuid_entry(uid_ptr);
-		str = format_uid_raw(uid_entry, use_colors, 1, be, upper);
-	}
-
-	return str;
+	    uid_ptr >= uids_dict->base_address + uids_dict->data_length)
+		snprintf(buf, size, BAD_PTR_STR, uid_ptr);
+	else
+		format_uid_buf(buf, size, get_uuid_entry(uid_ptr), use_colors, 1, be, upper);
 }
 
-/* fmt should point '%pUx`, return pointer to UUID string or zero */
-static const char *asprintf_uuid(const char *fmt, uint32_t uuid_key, bool use_colors, int *fmt_len)
+/* fmt should point '%pUx`, print UUID string to buf and return the format length or zero */
+static int format_uuid_param(char *buf, size_t size, const char *fmt, uint32_t uuid_key,
+			     bool use_colors)
 {
 	const char *fmt_end = fmt + strlen(fmt);
 	int be, upper;
 	int len = 4; /* assure full formating, with x */
 
-	if (fmt + 2 >= fmt_end || fmt[1] != 'p' || fmt[2] != 'U') {
-		*fmt_len = 0;
-		return NULL;
-	}
+	if (fmt + 2 >= fmt_end || fmt[1] != 'p' || fmt[2] != 'U')
+		return 0;
+
 	/* check 'x' value */
 	switch (fmt + 3 < fmt_end ? fmt[3] : 0) {
 	case 'b':
@@ -175,27 +223,24 @@ static const char *asprintf_uuid(const char *fmt, uint32_t uuid_key, bool use_co
 		--len;
 		break;
 	}
-	*fmt_len = len;
-	return format_uid(uuid_key, use_colors, be, upper);
+	format_uid(buf, size, uuid_key, use_colors, be, upper);
+	return len;
 }
 
-static const char *asprintf_entry_text(uint32_t entry_address)
+static const char *get_entry_text(uint32_t entry_address)
 {
 	struct ldc_entry entry;
-	int ret;
-
-	ret = read_entry_from_ldc_file(&entry, entry_address);
-	if (ret)
-		return NULL;
 
-	free(entry.file_name);
+	if (get_ldc_entry(&entry, entry_address))
+		return "<bad entry ptr>";
 
 	return entry.text;
 }
 
 /** printf-like formatting from the binary ldc_entry input to the
  *  formatted proc_lpc_entry output. Also copies the unmodified
- *  ldc_entry_header from input to output.
+ *  ldc_entry_header from input to output. Substituted strings are
+ *  stored in the output entry, so nothing needs to be freed.
  *
  * @param[out] pe copy of the header + formatted output
  * @param[in] e copy of the dictionary entry where unformatted,
@@ -206,15 +251,18 @@ static void process_params(struct proc_ldc_entry *pe,
 			   const struct ldc_entry *e,
 			   int use_colors)
 {
-	char *p = e->text;
-	const char *t_end = p + strlen(e->text);
+	char *p = pe->text;
+	const char *t_end;
 	int uuid_fmt_len;
 	int i = 0;
 
-	pe->subst_mask = 0;
 	pe->header =  e->header;
 	pe->file_name = e->file_name;
-	pe->text = e->text;
+
+	/* dictionary text is shared, work on a copy of it */
+	strncpy(pe->text, e->text, sizeof(pe->text) - 1);
+	pe->text[sizeof(pe->text) - 1] = '\0';
+	t_end = p + strlen(pe->text);
 
 	/*
 	 * Scan the text for possible replacements. We follow the Linux kernel
@@ -247,16 +295,17 @@ static void process_params(struct proc_ldc_entry *pe,
 			/* %s format specifier */
 			/* check for string printing, because it leads to logger crash */
 			log_err("String printing is not supported\n");
-			pe->params[i] = (uintptr_t)log_asprintf("<String @ 0x%08x>", raw_param);
-			pe->subst_mask |= 1 << i;
+			snprintf(pe->subst[i], sizeof(pe->subst[i]), "<String @ 0x%08x>",
+				 raw_param);
+			pe->params[i] = (uintptr_t)pe->subst[i];
 			++i;
 			p += 2;
 		} else if (p + 2 < t_end && p[1] == 'p' && p[2] == 'U') {
 			/* %pUx format specifier */
-			/* substitute UUID entry address with formatted string pointer from heap */
-			pe->params[i] = (uintptr_t)asprintf_uuid(p, raw_param, use_colors,
-								 &uuid_fmt_len);
-			pe->subst_mask |= 1 << i;
+			/* substitute UUID entry address with formatted string */
+			uuid_fmt_len = format_uuid_param(pe->subst[i], sizeof(pe->subst[i]), p,
+							 raw_param, use_colors);
+			pe->params[i] = (uintptr_t)pe->subst[i];
 			++i;
 			/* replace uuid formatter with %s */
 			p[1] = 's';
@@ -265,9 +314,8 @@ static void process_params(struct proc_ldc_entry *pe,
 			t_end -= uuid_fmt_len - 2;
 		} else if (p + 2 < t_end && p[1] == 'p' && p[2] == 'Q') {
 			/* %pQ format specifier */
-			/* substitute log entry address with formatted entry text */
-			pe->params[i] = (uintptr_t)asprintf_entry_text(raw_param);
-			pe->subst_mask |= 1 << i;
+			/* substitute log entry address with the entry text */
+			pe->params[i] = (uintptr_t)get_entry_text(raw_param);
 			++i;
 
 			/* replace entry formatter with %s */
@@ -288,17 +336,6 @@ static void process_params(struct proc_ldc_entry *pe,
 		log_err("Too few %% conversion specifiers in '%s'\n", e->text);
 }
 
-static void free_proc_ldc_entry(struct proc_ldc_entry *pe)
-{
-	int i;
-
-	for (i = 0; i < TRACE_MAX_PARAMS_COUNT; i++) {
-		if (pe->subst_mask & (1 << i))
-			free((void *)pe->params[i]);
-		pe->params[i] = 0;
-	}
-}
-
 static double to_usecs(uint64_t time)
 {
 	/* trace timestamp uses CPU system clock at default 25MHz ticks */
@@ -415,9 +452,11 @@ static const char *get_component_name(uint32_t trace_class, uint32_t uid_ptr)
 }
 
 /* remove superfluous leading file path and shrink to last 20 chars */
-static char *format_file_name(char *file_name_raw, int full_name)
+static const char *format_file_name(const char *file_name_raw, int full_name, char *buf,
+				    size_t size)
 {
-	char *name;
+	const char *name;
+	char *sep_pos;
 	int len;
 
 	/* most/all string should have "src" */
@@ -427,41 +466,66 @@ static char *format_file_name(char *file_name_raw, int full_name)
 
 	if (full_name)
 		return name;
-	/* keep the last 24 chars */
+	/* keep the last 24 chars, dictionary text is shared so edit a copy */
 	len = strlen(name);
 	if (len > 24) {
-		char *sep_pos = NULL;
-
 		name += (len - 24);
-		sep_pos = strchr(name, '/');
+		snprintf(buf, size, "%s", name);
+		sep_pos = strchr(buf, '/');
 		if (!sep_pos)
-			return name;
-		while (--sep_pos >= name)
+			return buf;
+		while (--sep_pos >= buf)
 			*sep_pos = '.';
+		return buf;
 	}
 	return name;
 }
 
-static int entry_number = 1;
+/** Moves the timestamp state forward to the statement with @timestamp.
+ * Kept separate from printing, so the state at any statement of a capture
+ * can be found without formatting everything before it.
+ */
+static void advance_state(struct logger_state *state, uint64_t timestamp)
+{
+	if (timestamp < state->last_timestamp)
+		state->entry_number = 1;
+
+	/* The first entry:
+	 *  - is never shown with a relative TIMESTAMP (to itself!?)
+	 *  - shows a zero DELTA
+	 */
+	if (state->entry_number == 1) {
+		state->entry_number++;
+		/* Display absolute (and random) timestamps */
+		state->timestamp_origin = 0;
+	} else if (state->entry_number == 2) {
+		state->entry_number++;
+		if (global_config->relative_timestamps == 1)
+			/* Switch to relative timestamps from now on. */
+			state->timestamp_origin = state->last_timestamp;
+	} /* We don't need the exact entry_number after 3 */
+
+	state->last_timestamp = timestamp;
+}
+
 /** Formats and outputs one entry from the trace + the corresponding
  * ldc_entry from the dictionary passed as arguments. Expects the log
  * variables to have already been copied into the ldc_entry.
  */
-static void print_entry_params(const struct log_entry_header *dma_log,
-			       const struct ldc_entry *entry, uint64_t last_timestamp)
+static void print_entry_params(FILE *out_fd, struct logger_state *state,
+			       const struct log_entry_header *dma_log,
+			       const struct ldc_entry *entry)
 {
-	static uint64_t timestamp_origin;
-
-	FILE *out_fd = global_config->out_fd;
 	int use_colors = global_config->use_colors;
 	int raw_output = global_config->raw_output;
 	int hide_location = global_config->hide_location;
 	int time_precision = global_config->time_precision;
 
 	char ids[TRACE_MAX_IDS_STR];
-	float dt = to_usecs(dma_log->timestamp - last_timestamp);
+	float dt = to_usecs(dma_log->timestamp - state->last_timestamp);
 	struct proc_ldc_entry proc_entry;
-	static char time_fmt[64];
+	char file_name[TRACE_MAX_FILENAME_LEN];
+	char time_fmt[64];
 	int ret;
 
 	if (raw_output)
@@ -471,28 +535,15 @@ static void print_entry_params(const struct log_entry_header *dma_log,
 	if (dt > 1000.0 * 1000.0 * 1000.0)
 		dt = NAN;
 
-	if (dma_log->timestamp < last_timestamp) {
+	if (dma_log->timestamp < state->last_timestamp)
 		fprintf(out_fd,
 			"\n\t\t --- negative DELTA = %.3f us: wrap, IPC_TRACE, other? ---\n\n",
-			-to_usecs(last_timestamp - dma_log->timestamp));
-		entry_number = 1;
-	}
+			-to_usecs(state->last_timestamp - dma_log->timestamp));
 
-	/* The first entry:
-	 *  - is never shown with a relative TIMESTAMP (to itself!?)
-	 *  - shows a zero DELTA
-	 */
-	if (entry_number == 1) {
-		entry_number++;
-		/* Display absolute (and random) timestamps */
-		timestamp_origin = 0;
+	if (dma_log->timestamp < state->last_timestamp || state->entry_number == 1)
 		dt = 0;
-	} else if (entry_number == 2) {
-		entry_number++;
-		if (global_config->relative_timestamps == 1)
-			/* Switch to relative timestamps from now on. */
-			timestamp_origin = last_timestamp;
-	} /* We don't need the exact entry_number after 3 */
+
+	advance_state(state, dma_log->timestamp);
 
 	if (dma_log->id_0 != INVALID_TRACE_ID &&
 	    dma_log->id_1 != INVALID_TRACE_ID)
@@ -518,10 +569,11 @@ static void print_entry_params(const struct log_entry_header *dma_log,
 			ids);
 		if (time_precision >= 0)
 			fprintf(out_fd, time_fmt,
-				to_usecs(dma_log->timestamp - timestamp_origin), dt);
+				to_usecs(dma_log->timestamp - state->timestamp_origin), dt);
 		if (!hide_location)
 			fprintf(out_fd, "(%s:%u) ",
-				format_file_name(entry->file_name, raw_output),
+				format_file_name(entry->file_name, raw_output,
+						 file_name, sizeof(file_name)),
 				entry->header.line_idx);
 	} else {
 		if (time_precision >= 0) {
@@ -533,7 +585,7 @@ static void print_entry_params(const struct log_entry_header *dma_log,
 
 			fprintf(out_fd, time_fmt,
 				use_colors ? KGRN : "",
-				to_usecs(dma_log->timestamp - timestamp_origin), dt,
+				to_usecs(dma_log->timestamp - state->timestamp_origin), dt,
 				use_colors ? KNRM : "");
 		}
 
@@ -550,7 +602,8 @@ static void print_entry_params(const struct log_entry_header *dma_log,
 		/* location */
 		if (!hide_location)
 			fprintf(out_fd, "%24s:%-4u ",
-				format_file_name(entry->file_name, raw_output),
+				format_file_name(entry->file_name, raw_output,
+						 file_name, sizeof(file_name)),
 				entry->header.line_idx);
 
 		/* level name */
@@ -585,93 +638,140 @@ static void print_entry_params(const struct log_entry_header *dma_log,
 		ret = 0; /* don't log ferror */
 		break;
 	}
-	free_proc_ldc_entry(&proc_entry);
 	/* log format text comes from ldc file (may be invalid), so error check is needed here */
 	if (ret < 0)
 		log_err("trace fprintf failed for '%s', %d '%s'",
 			proc_entry.text, ferror(out_fd), strerror(ferror(out_fd)));
 	fprintf(out_fd, "%s\n", use_colors ? KNRM : "");
-	fflush(out_fd);
 }
 
-static int read_entry_from_ldc_file(struct ldc_entry *entry, uint32_t log_entry_address)
+/** Validates the dictionary entry at @offset of the in-memory log entries
+ * section and points @entry at its strings.
+ */
+static int parse_ldc_entry(struct ldc_entry *entry, uint32_t offset)
 {
-	uint32_t base_address = global_config->logs_header->base_address;
-	uint32_t data_offset = global_config->logs_header->data_offset;
-
-	int ret;
+	uint32_t data_length = global_config->logs_header->data_length;
 
-	/* evaluate entry offset in input file */
-	uint32_t entry_offset = (log_entry_address - base_address) + data_offset;
+	if ((uint64_t)offset + sizeof(entry->header) > data_length)
+		return -EINVAL;
 
-	entry->file_name = NULL;
-	entry->text = NULL;
+	memcpy(&entry->header, ldc_dict.data + offset, sizeof(entry->header));
 	entry->params = NULL;
 
-	/* set file position to beginning of processed entry */
-	fseek(global_config->ldc_fd, entry_offset, SEEK_SET);
+	if (!entry->header.file_name_len ||
+	    entry->header.file_name_len > TRACE_MAX_FILENAME_LEN ||
+	    !entry->header.text_len || entry->header.text_len > TRACE_MAX_TEXT_LEN)
+		return -EINVAL;
 
-	/* fetching elf header params */
-	ret = fread(&entry->header, sizeof(entry->header), 1, global_config->ldc_fd);
-	if (ret != 1) {
-		log_err("Failed to read entry header for offset 0x%x in dictionary.\n",
-			entry_offset);
-		ret = -1;
-		goto out;
-	}
-	if (entry->header.file_name_len > TRACE_MAX_FILENAME_LEN) {
-		log_err("Invalid filename length %d or ldc file does not match firmware\n",
-			entry->header.file_name_len);
-		ret = -EINVAL;
-		goto out;
-	}
-	entry->file_name = (char *)malloc(entry->header.file_name_len);
+	if ((uint64_t)offset + sizeof(entry->header) + entry->header.file_name_len +
+	    entry->header.text_len > data_length)
+		return -EINVAL;
 
-	if (!entry->file_name) {
-		log_err("can't allocate %d byte for entry.file_name\n",
-			entry->header.file_name_len);
-		ret = -ENOMEM;
-		goto out;
+	entry->file_name = (char *)ldc_dict.data + offset + sizeof(entry->header);
+	entry->text = entry->file_name + entry->header.file_name_len;
+
+	/* both strings are stored with their terminating null */
+	if (entry->file_name[entry->header.file_name_len - 1] ||
+	    entry->text[entry->header.text_len - 1])
+		return -EINVAL;
+
+	return 0;
+}
+
+/** Finds the dictionary entry for a firmware log entry address, through the
+ * index built by load_ldc_dict() or, for an address missed by the index,
+ * straight from the in-memory section. Nothing is allocated or modified, so
+ * this is safe to call from the conversion threads.
+ */
+static int get_ldc_entry(struct ldc_entry *entry, uint32_t log_entry_address)
+{
+	uint32_t offset = log_entry_address - global_config->logs_header->base_address;
+	int32_t idx = -1;
+
+	if (!(offset % sizeof(uint32_t)) &&
+	    offset < global_config->logs_header->data_length)
+		idx = ldc_dict.index[offset / sizeof(uint32_t)];
+
+	if (idx >= 0) {
+		*entry = ldc_dict.entries[idx];
+		return 0;
 	}
 
-	ret = fread(entry->file_name, sizeof(char), entry->header.file_name_len,
-		    global_config->ldc_fd);
-	if (ret != entry->header.file_name_len) {
-		log_err("Failed to read source filename for offset 0x%x in dictionary.\n",
-			entry_offset);
-		ret = -1;
-		goto out;
+	if (parse_ldc_entry(entry, offset)) {
+		log_err("Invalid entry at offset 0x%x or ldc file does not match firmware\n",
+			offset);
+		return -EINVAL;
 	}
 
-	/* fetching text */
-	if (entry->header.text_len > TRACE_MAX_TEXT_LEN) {
-		log_err("Invalid text length.\n");
-		ret = -EINVAL;
-		goto out;
+	return 0;
+}
+
+/** Reads the log entries section of the ldc file into memory once and
+ * indexes all entries found in it by their address, instead of seeking
+ * and reading the file for every log statement.
+ */
+static int load_ldc_dict(void)
+{
+	const struct snd_sof_logs_header *logs_header = global_config->logs_header;
+	uint32_t data_length = logs_header->data_length;
+	uint32_t dwords = data_length / sizeof(uint32_t) + 1;
+	uint32_t entries_size = 0;
+	struct ldc_entry *entries;
+	struct ldc_entry entry;
+	uint32_t offset = 0;
+	uint32_t i;
+
+	ldc_dict.data = malloc(data_length);
+	ldc_dict.index = malloc(dwords * sizeof(*ldc_dict.index));
+	if (!ldc_dict.data || !ldc_dict.index) {
+		log_err("failed to alloc memory for log entries.\n");
+		return -ENOMEM;
 	}
-	entry->text = (char *)malloc(entry->header.text_len);
-	if (!entry->text) {
-		log_err("can't allocate %d byte for entry.text\n", entry->header.text_len);
-		ret = -ENOMEM;
-		goto out;
+
+	fseek(global_config->ldc_fd, logs_header->data_offset, SEEK_SET);
+	if (fread(ldc_dict.data, 1, data_length, global_config->ldc_fd) != data_length) {
+		log_err("Error while reading log entries from %s.\n",
+			global_config->ldc_file);
+		return -ferror(global_config->ldc_fd) ? : -EINVAL;
 	}
-	ret = fread(entry->text, sizeof(char), entry->header.text_len, global_config->ldc_fd);
-	if (ret != entry->header.text_len) {
-		log_err("Failed to read log message at offset 0x%x from dictionary.\n",
-			entry_offset);
-		ret = -1;
-		goto out;
+
+	for (i = 0; i < dwords; i++)
+		ldc_dict.index[i] = -1;
+
+	/* entries are dword aligned structures, skip any padding in between */
+	while (offset + sizeof(entry.header) <= data_length) {
+		if (parse_ldc_entry(&entry, offset)) {
+			offset += sizeof(uint32_t);
+			continue;
+		}
+
+		if (ldc_dict.entries_num == entries_size) {
+			entries_size = entries_size ? entries_size * 2 : 256;
+			entries = realloc(ldc_dict.entries, entries_size * sizeof(*entries));
+			if (!entries) {
+				log_err("failed to alloc memory for log entries index.\n");
+				return -ENOMEM;
+			}
+			ldc_dict.entries = entries;
+		}
+
+		ldc_dict.index[offset / sizeof(uint32_t)] = ldc_dict.entries_num;
+		ldc_dict.entries[ldc_dict.entries_num++] = entry;
+
+		offset += sizeof(entry.header) + entry.header.file_name_len +
+			  entry.header.text_len;
+		offset = CEIL(offset, sizeof(uint32_t)) * sizeof(uint32_t);
 	}
 
 	return 0;
+}
 
-out:
-	free(entry->text);
-	entry->text = NULL;
-	free(entry->file_name);
-	entry->file_name = NULL;
-
-	return ret;
+static void free_ldc_dict(void)
+{
+	free(ldc_dict.entries);
+	free(ldc_dict.index);
+	free(ldc_dict.data);
+	memset(&ldc_dict, 0, sizeof(ldc_dict));
 }
 
 /** Gets the dictionary entry matching the log entry argument, reads
@@ -681,36 +781,30 @@ out:
  *
  * @param[in] dma_log protocol header from any trace (not just from the
  * "DMA" trace)
- * @param[in,out] last_timestamp timestamp found for this entry
+ * @param[in,out] state timestamps updated with this entry
  */
-static int fetch_entry(const struct log_entry_header *dma_log, uint64_t *last_timestamp)
+static int fetch_entry(const struct log_entry_header *dma_log, struct logger_state *state)
 {
+	uint32_t params[TRACE_MAX_PARAMS_COUNT];
 	struct ldc_entry entry;
 	int ret;
 
-	ret = read_entry_from_ldc_file(&entry, dma_log->log_entry_address);
+	ret = get_ldc_entry(&entry, dma_log->log_entry_address);
 	if (ret < 0) {
-		log_err("read_entry_from_ldc_file(0x%x) returned %d\n",
+		log_err("get_ldc_entry(0x%x) returned %d\n",
 			dma_log->log_entry_address, ret);
-		goto out;
+		return ret;
 	}
 
 	/* fetching entry params from dma dump */
 	if (entry.header.params_num > TRACE_MAX_PARAMS_COUNT) {
 		log_err("Invalid number of parameters.\n");
-		ret = -EINVAL;
-		goto out;
-	}
-	entry.params = (uint32_t *)malloc(sizeof(uint32_t) * entry.header.params_num);
-	if (!entry.params) {
-		log_err("can't allocate %d byte for entry.params\n",
-			(int)(sizeof(uint32_t) * entry.header.params_num));
-		ret = -ENOMEM;
-		goto out;
+		return -EINVAL;
 	}
+	entry.params = params;
 
 	if (global_config->serial_fd < 0) {
-		ret = fread(entry.params, sizeof(uint32_t), entry.header.params_num,
+		ret = fread(params, sizeof(uint32_t), entry.header.params_num,
 			    global_config->in_fd);
 		if (ret != entry.header.params_num) {
 			fprintf(global_config->out_fd,
@@ -724,7 +818,7 @@ static int fetch_entry(const struct log_entry_header *dma_log, uint64_t *last_ti
 				fprintf(global_config->out_fd,
 					"warn: log's End Of File. Device suspend?\n");
 
-			goto out;
+			return ret;
 		}
 	} else { /* serial */
 		size_t size = sizeof(uint32_t) * entry.header.params_num;
@@ -734,13 +828,13 @@ static int fetch_entry(const struct log_entry_header *dma_log, uint64_t *last_ti
 		 * enough for the number of params needed by this
 		 * particular statement.
 		 */
-		for (n = (uint8_t *)entry.params; size; n += ret, size -= ret) {
+		for (n = (uint8_t *)params; size; n += ret, size -= ret) {
 			ret = read(global_config->serial_fd, n, size);
 			if (ret < 0) {
 				ret = -errno;
 				log_err("Failed to fread %d params from serial: %s\n",
 					entry.header.params_num, strerror(errno));
-				goto out;
+				return ret;
 			}
 			if (ret != size)
 				log_err("Partial read of %u bytes of %zu, reading more\n",
@@ -749,23 +843,50 @@ static int fetch_entry(const struct log_entry_header *dma_log, uint64_t *last_ti
 	} /* serial */
 
 	/* printing entry content */
-	print_entry_params(dma_log, &entry, *last_timestamp);
-	*last_timestamp = dma_log->timestamp;
+	print_entry_params(global_config->out_fd, state, dma_log, &entry);
 
-	/* set f_ldc file position to the beginning */
-	rewind(global_config->ldc_fd);
+	/* live input is shown as it comes, files are converted in one go */
+	if (global_config->trace || global_config->input_std ||
+	    global_config->serial_fd >= 0)
+		fflush(global_config->out_fd);
 
-	ret = 0;
-out:
-	/* free alocated memory */
-	free(entry.params);
-	free(entry.text);
-	free(entry.file_name);
+	return 0;
+}
 
-	return ret;
+/** Reports the bytes skipped before a valid statement was found (again) */
+static void print_resync(FILE *out_fd, struct logger_state *state)
+{
+	/* At this point, skipped_dwords can be == 0
+	 * only when we just started to run.
+	 */
+	if (state->skipped_dwords != 0) {
+		fprintf(out_fd,
+			"\nFound valid LDC address after skipping %zu bytes (one line uses %zu + 0 to 16 bytes)\n",
+			sizeof(uint32_t) * state->skipped_dwords,
+			sizeof(struct log_entry_header));
+	}
+
+	state->ldc_address_OK = true;
+	state->skipped_dwords = 0;
 }
 
-static int serial_read(uint64_t *last_timestamp)
+static void print_read_end(const struct logger_state *state)
+{
+	/* End of (etrace) file */
+	fprintf(global_config->out_fd,
+		"Skipped %zu bytes after the last statement",
+		sizeof(uint32_t) * state->skipped_dwords);
+
+	if (!global_config->trace &&
+	    /* maximum 4 arguments supported */
+	    state->skipped_dwords < sizeof(struct log_entry_header) + 4 * sizeof(uint32_t))
+		fprintf(global_config->out_fd,
+			". Potential mailbox wrap, check the start of the output for later logs");
+
+	fprintf(global_config->out_fd, ".\n");
+}
+
+static int serial_read(struct logger_state *state)
 {
 	struct log_entry_header dma_log;
 	size_t len;
@@ -815,18 +936,15 @@ static int serial_read(uint64_t *last_timestamp)
 	/* fetching entry from elf dump and complete processing this log
 	 * line
 	 */
-	return fetch_entry(&dma_log, last_timestamp);
+	return fetch_entry(&dma_log, state);
 }
 
 /** Main logger loop */
 static int logger_read(void)
 {
 	struct log_entry_header dma_log;
+	struct logger_state state = { .entry_number = 1 };
 	int ret = 0;
-	uint64_t last_timestamp = 0;
-
-	bool ldc_address_OK = false;
-	unsigned int skipped_dwords = 0;
 
 	if (!global_config->raw_output)
 		print_table_header();
@@ -834,7 +952,7 @@ static int logger_read(void)
 	if (global_config->serial_fd >= 0)
 		/* Wait for CTRL-C */
 		for (;;) {
-			ret = serial_read(&last_timestamp);
+			ret = serial_read(&state);
 			if (ret < 0)
 				return ret;
 		}
@@ -862,7 +980,7 @@ static int logger_read(void)
 					"Re-opening trace input file",
 					"device suspend?");
 				if (freopen(NULL, "rb", global_config->in_fd)) {
-					entry_number = 1;
+					state.entry_number = 1;
 					continue;
 				} else {
 					log_err("in %s(), freopen(..., %s) failed: %s(%d)\n",
@@ -890,60 +1008,309 @@ static int logger_read(void)
 			 * mailbox ring buffer is routine. Take note in both cases but
 			 * report errors only for the DMA trace.
 			 */
-			if (global_config->trace && ldc_address_OK) {
+			if (global_config->trace && state.ldc_address_OK) {
 				log_err("log_entry_address %#10x is not in dictionary range!\n",
 					dma_log.log_entry_address);
 				fprintf(global_config->out_fd,
 					"warn: Seeking forward 4 bytes at a time until re-synchronize.\n");
 			}
-			ldc_address_OK = false;
+			state.ldc_address_OK = false;
 			/* When the address is not correct, move forward by one DWORD (not
 			 * entire struct dma_log)
 			 */
 			fseek(global_config->in_fd, -(sizeof(dma_log) - sizeof(uint32_t)),
 			      SEEK_CUR);
-			skipped_dwords++;
+			state.skipped_dwords++;
 			continue;
 
-		} else if (!ldc_address_OK) {
+		} else if (!state.ldc_address_OK) {
 			 /* Just found a valid address (again) */
-
-			/* At this point, skipped_dwords can be == 0
-			 * only when we just started to run.
-			 */
-			if (skipped_dwords != 0) {
-				fprintf(global_config->out_fd,
-					"\nFound valid LDC address after skipping %zu bytes (one line uses %zu + 0 to 16 bytes)\n",
-				       sizeof(uint32_t) * skipped_dwords, sizeof(dma_log));
-			}
-
-			ldc_address_OK = true;
-			skipped_dwords = 0;
+			print_resync(global_config->out_fd, &state);
 		}
 
 		/* fetching entry from dictionary, read the number of
 		 * arguments needed and finish the entire processing of
 		 * this log line.
 		 */
-		ret = fetch_entry(&dma_log, &last_timestamp);
+		ret = fetch_entry(&dma_log, &state);
 		if (ret) {
 			log_err("fetch_entry() failed with: %d, aborting\n", ret);
 			break;
 		}
 	} /* next log entry */
 
-	/* End of (etrace) file */
-	fprintf(global_config->out_fd,
-		"Skipped %zu bytes after the last statement",
-		sizeof(uint32_t) * skipped_dwords);
+	print_read_end(&state);
 
-	if (!global_config->trace &&
-	    /* maximum 4 arguments supported */
-	    skipped_dwords < sizeof(dma_log) + 4 * sizeof(uint32_t))
+	return ret;
+}
+
+/** Gets the statement at @offset of an in-memory capture, its params
+ * point straight into the capture.
+ * @return statement size in bytes, 0 when there is no dictionary address
+ * at @offset or -errno
+ */
+static int capture_get_entry(const uint8_t *data, size_t size, size_t offset,
+			     struct log_entry_header *dma_log, struct ldc_entry *entry)
+{
+	const struct snd_sof_logs_header *logs_header = global_config->logs_header;
+	size_t len = sizeof(*dma_log);
+	int ret;
+
+	memcpy(dma_log, data + offset, sizeof(*dma_log));
+	if (dma_log->log_entry_address < logs_header->base_address ||
+	    dma_log->log_entry_address > logs_header->base_address +
+	    logs_header->data_length)
+		return 0;
+
+	ret = get_ldc_entry(entry, dma_log->log_entry_address);
+	if (ret < 0)
+		return ret;
+
+	if (entry->header.params_num > TRACE_MAX_PARAMS_COUNT) {
+		log_err("Invalid number of parameters.\n");
+		return -EINVAL;
+	}
+
+	len += sizeof(uint32_t) * entry->header.params_num;
+	if (offset + len > size)
+		return -ENODATA;
+
+	entry->params = (const uint32_t *)(data + offset + sizeof(*dma_log));
+
+	return len;
+}
+
+static void *convert_chunk_thread(void *arg)
+{
+	struct convert_chunk *chunk = arg;
+	struct log_entry_header dma_log;
+	struct ldc_entry entry;
+	size_t offset = chunk->start;
+	int ret;
+
+	chunk->out_fd = open_memstream(&chunk->out_buf, &chunk->out_size);
+	if (!chunk->out_fd) {
+		chunk->ret = -errno;
+		return NULL;
+	}
+
+	/* same walk as logger_read(), the first pass already validated it */
+	while (offset + sizeof(dma_log) <= chunk->end) {
+		ret = capture_get_entry(chunk->data, chunk->end, offset, &dma_log, &entry);
+		if (ret < 0) {
+			chunk->ret = ret;
+			break;
+		}
+
+		if (!ret) {
+			chunk->state.ldc_address_OK = false;
+			chunk->state.skipped_dwords++;
+			offset += sizeof(uint32_t);
+			continue;
+		}
+
+		if (!chunk->state.ldc_address_OK)
+			print_resync(chunk->out_fd, &chunk->state);
+
+		print_entry_params(chunk->out_fd, &chunk->state, &dma_log, &entry);
+		offset += ret;
+	}
+
+	fclose(chunk->out_fd);
+
+	return NULL;
+}
+
+static int read_capture(uint8_t **data, size_t *size)
+{
+	FILE *in_fd = global_config->in_fd;
+	long len;
+
+	len = fseek(in_fd, 0, SEEK_END) ? -1 : ftell(in_fd);
+	if (len < 0 || fseek(in_fd, 0, SEEK_SET)) {
+		log_err("in %s(), %s is not a seekable file: %s\n",
+			__func__, global_config->in_file, strerror(errno));
+		return -errno;
+	}
+
+	*size = len;
+	*data = malloc(len + 1);
+	if (!*data) {
+		log_err("can't allocate %ld bytes for %s\n", len, global_config->in_file);
+		return -ENOMEM;
+	}
+
+	if (fread(*data, 1, len, in_fd) != len) {
+		log_err("in %s(), fread(..., %s) failed\n", __func__,
+			global_config->in_file);
+		free(*data);
+		return -EIO;
+	}
+
+	return 0;
+}
+
+/** Offline conversion of a capture file with several threads. A first,
+ * cheap pass walks the statements to split the capture at statement
+ * boundaries and to record the timestamp state at each split, then every
+ * part is formatted by its own thread and the outputs are written in order.
+ */
+static int logger_convert_parallel(void)
+{
+	int threads = global_config->threads;
+	struct logger_state state = { .entry_number = 1 };
+	struct convert_chunk *chunks;
+	struct log_entry_header dma_log;
+	struct ldc_entry entry;
+	size_t offset = 0;
+	uint8_t *data;
+	size_t size;
+	int err;
+	int ret;
+	int n = 0;
+	int i;
+
+	ret = read_capture(&data, &size);
+	if (ret < 0)
+		return ret;
+
+	chunks = calloc(threads, sizeof(*chunks));
+	if (!chunks) {
+		free(data);
+		return -ENOMEM;
+	}
+
+	chunks[0].state = state;
+	while (offset + sizeof(dma_log) <= size) {
+		ret = capture_get_entry(data, size, offset, &dma_log, &entry);
+		if (ret < 0)
+			break;
+
+		if (!ret) {
+			state.ldc_address_OK = false;
+			state.skipped_dwords++;
+			offset += sizeof(uint32_t);
+			continue;
+		}
+
+		/* start the next part once this one has its share of the input */
+		if (n + 1 < threads && offset >= (n + 1) * (size / threads)) {
+			chunks[n].end = offset;
+			chunks[++n].start = offset;
+			chunks[n].state = state;
+		}
+
+		if (!state.ldc_address_OK) {
+			state.ldc_address_OK = true;
+			state.skipped_dwords = 0;
+		}
+
+		advance_state(&state, dma_log.timestamp);
+		offset += ret;
+	}
+	chunks[n].end = offset;
+
+	for (i = 0; i <= n; i++) {
+		chunks[i].data = data;
+		err = pthread_create(&chunks[i].thread, NULL, convert_chunk_thread,
+				     &chunks[i]);
+		if (err)
+			chunks[i].ret = -err;
+		else
+			chunks[i].running = true;
+	}
+
+	if (!global_config->raw_output)
+		print_table_header();
+
+	for (i = 0; i <= n; i++) {
+		if (chunks[i].running)
+			pthread_join(chunks[i].thread, NULL);
+
+		if (chunks[i].ret < 0) {
+			log_err("conversion thread %d failed with: %d\n", i, chunks[i].ret);
+			ret = chunks[i].ret;
+		} else {
+			fwrite(chunks[i].out_buf, 1, chunks[i].out_size,
+			       global_config->out_fd);
+		}
+		free(chunks[i].out_buf);
+	}
+
+	if (ret == -ENODATA) {
 		fprintf(global_config->out_fd,
-			". Potential mailbox wrap, check the start of the output for later logs");
+			"warn: failed to fread() %d params from the log for %s:%d\n",
+			entry.header.params_num, entry.file_name, entry.header.line_idx);
+		fprintf(global_config->out_fd,
+			"warn: log's End Of File. Device suspend?\n");
+		ret = 0;
+	} else if (ret < 0) {
+		log_err("fetch_entry() failed with: %d, aborting\n", ret);
+	} else {
+		ret = 0;
+	}
 
-	fprintf(global_config->out_fd, ".\n");
+	print_read_end(&state);
+
+	free(chunks);
+	free(data);
+
+	return ret;
+}
+
+/** Copies the log input to the output as it comes, without decoding it, so
+ * that a busy trace can be saved with minimum work and converted later with
+ * the -i option.
+ */
+int capture(struct convert_config *config)
+{
+	uint8_t *buf;
+	ssize_t len;
+	int ret = 0;
+	int fd;
+
+	global_config = config;
+
+	buf = malloc(TRACE_CAPTURE_BUF_SIZE);
+	if (!buf)
+		return -ENOMEM;
+
+	for (;;) {
+		fd = config->serial_fd >= 0 ? config->serial_fd : fileno(config->in_fd);
+
+		len = read(fd, buf, TRACE_CAPTURE_BUF_SIZE);
+		if (len < 0) {
+			if (errno == EINTR)
+				continue;
+			ret = -errno;
+			log_err("in %s(), read(..., %s) failed: %s(%d)\n",
+				__func__, config->in_file, strerror(errno), errno);
+			break;
+		}
+
+		if (!len) {
+			/* for trace mode, try to reopen */
+			if (!config->trace || config->serial_fd >= 0)
+				break;
+			if (!freopen(NULL, "rb", config->in_fd)) {
+				ret = -errno;
+				log_err("in %s(), freopen(..., %s) failed: %s(%d)\n",
+					__func__, config->in_file, strerror(errno), errno);
+				break;
+			}
+			continue;
+		}
+
+		if (fwrite(buf, 1, len, config->out_fd) != len) {
+			ret = -EIO;
+			log_err("in %s(), fwrite(..., %s) failed\n",
+				__func__, config->out_file ? config->out_file : "stdout");
+			break;
+		}
+		fflush(config->out_fd);
+	}
+
+	free(buf);
 
 	return ret;
 }
@@ -1115,8 +1482,16 @@ int convert(struct convert_config *config)
 		}
 	}
 
-	ret = logger_read();
+	ret = load_ldc_dict();
+	if (ret)
+		goto out;
+
+	if (config->threads > 1)
+		ret = logger_convert_parallel();
+	else
+		ret = logger_read();
 out:
+	free_ldc_dict();
 	free(config->uids_dict);
 	return ret;
 }
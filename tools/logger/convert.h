@@ -42,9 +42,12 @@ struct convert_config {
 	int hide_location;
 	int relative_timestamps;
 	int time_precision;
+	int capture_raw;
+	int threads;
 	struct snd_sof_uids_header *uids_dict;
 	struct snd_sof_logs_header *logs_header;
 };
 
 uint32_t get_uuid_key(const struct sof_uuid_entry *entry);
 int convert(struct convert_config *config);
+int capture(struct convert_config *config);
@@ -73,6 +73,10 @@ static void usage(void)
 	fprintf(stdout, "%s:\t -F filter\t\tUpdate trace filter, format: "
 		"<level>=<comp1>[, <comp2>]\n",
 		APP_NAME);
+	fprintf(stdout, "%s:\t -b\t\t\tCapture binary log to outfile, convert it later with -i\n",
+		APP_NAME);
+	fprintf(stdout, "%s:\t -j threads\t\tConvert infile with multiple threads\n",
+		APP_NAME);
 	exit(0);
 }
 
@@ -172,7 +176,7 @@ static int append_filter_config(struct convert_config *config, const char *input
 
 int main(int argc, char *argv[])
 {
-	static const char optstring[] = "ho:i:l:ps:c:u:tv:rd:Le:f:gF:n";
+	static const char optstring[] = "ho:i:l:ps:c:u:tv:rd:Le:f:gF:nbj:";
 	struct convert_config config;
 	unsigned int baud = 0;
 	const char *snapshot_file = 0;
@@ -199,6 +203,8 @@ int main(int argc, char *argv[])
 	config.time_precision = 6;
 	config.relative_timestamps = INT_MAX; /* unspecified */
 	config.filter_config = NULL;
+	config.capture_raw = 0;
+	config.threads = 1;
 
 	while ((opt = getopt(argc, argv, optstring)) != -1) {
 		switch (opt) {
@@ -277,6 +283,17 @@ int main(int argc, char *argv[])
 			if (ret < 0)
 				return ret;
 			break;
+		case 'b':
+			config.capture_raw = 1;
+			break;
+		case 'j':
+			config.threads = atoi(optarg);
+			if (config.threads < 1) {
+				fprintf(stderr, "%s: invalid option: -j %s\n",
+					APP_NAME, optarg);
+				return -EINVAL;
+			}
+			break;
 		case 'h':
 		default: /* '?' */
 			usage();
@@ -291,20 +308,29 @@ int main(int argc, char *argv[])
 	if (snapshot_file)
 		return baud ? EINVAL : -snapshot(snapshot_file);
 
-	if (!config.ldc_file) {
+	if (config.threads > 1 &&
+	    (config.trace || config.input_std || baud || !config.in_file)) {
+		fprintf(stderr, "error: -j needs an input file given with -i\n");
+		usage();
+	}
+
+	/* binary capture is converted later, no dictionary needed */
+	if (!config.ldc_file && !config.capture_raw) {
 		fprintf(stderr, "error: Missing ldc file\n");
 		usage();
 	}
 
-	config.ldc_fd = fopen(config.ldc_file, "rb");
-	if (!config.ldc_fd) {
-		ret = errno;
-		fprintf(stderr, "error: Unable to open ldc file %s: %s\n",
-			config.ldc_file, strerror(ret));
-		goto out;
+	if (config.ldc_file) {
+		config.ldc_fd = fopen(config.ldc_file, "rb");
+		if (!config.ldc_fd) {
+			ret = errno;
+			fprintf(stderr, "error: Unable to open ldc file %s: %s\n",
+				config.ldc_file, strerror(ret));
+			goto out;
+		}
 	}
 
-	if (config.version_fw) {
+	if (config.version_fw && !config.capture_raw) {
 		config.version_fd = fopen(config.version_file, "rb");
 		if (!config.version_fd && !config.dump_ldc) {
 			ret = errno;
@@ -360,7 +386,16 @@ int main(int argc, char *argv[])
 	if (isatty(fileno(config.out_fd)) != 1)
 		config.use_colors = 0;
 
-	ret = -convert(&config);
+	if (config.capture_raw) {
+		if (config.use_colors) {
+			fprintf(stderr, "error: Binary capture needs an out file\n");
+			ret = EINVAL;
+			goto out;
+		}
+		ret = -capture(&config);
+	} else {
+		ret = -convert(&config);
+	}
 
 out:
 	/* free memory */
@@ -0,0 +1,143 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright(c) 2022 Intel Corporation. All rights reserved.
+
+/*
+ * Replays IPC messages, e.g. the fuzzer corpus or captured control updates,
+ * through the library build of the firmware IPC handler and reports the
+ * number of processed messages per second.
+ */
+
+#include <errno.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sof/ipc/driver.h>
+#include <sof/math/numbers.h>
+#include <sof/audio/component_ext.h>
+#include <sof/lib/notifier.h>
+
+struct replay_msg {
+	uint8_t *data;
+	size_t size;
+};
+
+static void usage(const char *name)
+{
+	fprintf(stderr, "usage: %s [-r rounds] msg_file...\n", name);
+	fprintf(stderr, "  -r rounds  number of times all messages are replayed, default 1\n");
+}
+
+static int replay_load(const char *file, struct replay_msg *msg)
+{
+	FILE *f = fopen(file, "rb");
+
+	if (!f) {
+		fprintf(stderr, "error: can't open %s: %s\n", file, strerror(errno));
+		return -errno;
+	}
+
+	/* like the fuzzer, the message is copied to a mailbox sized buffer */
+	msg->data = calloc(SOF_IPC_MSG_MAX_SIZE, 1);
+	if (!msg->data) {
+		fclose(f);
+		return -ENOMEM;
+	}
+
+	msg->size = fread(msg->data, 1, SOF_IPC_MSG_MAX_SIZE, f);
+	fclose(f);
+
+	return 0;
+}
+
+static void replay_init(void)
+{
+	init_system_notify(sof_get());
+
+	trace_init(sof_get());
+
+	platform_init(sof_get());
+
+	/* init components */
+	sys_comp_init(sof_get());
+
+	pipeline_posn_init(sof_get());
+}
+
+int main(int argc, char **argv)
+{
+	struct sof_ipc_cmd_hdr *hdr;
+	struct replay_msg *msgs;
+	struct timespec start;
+	struct timespec end;
+	uint64_t count = 0;
+	double seconds;
+	int rounds = 1;
+	int num_msgs;
+	int opt;
+	int ret;
+	int i;
+	int r;
+
+	while ((opt = getopt(argc, argv, "hr:")) != -1) {
+		switch (opt) {
+		case 'r':
+			rounds = atoi(optarg);
+			break;
+		default:
+			usage(argv[0]);
+			return opt == 'h' ? 0 : -EINVAL;
+		}
+	}
+
+	num_msgs = argc - optind;
+	if (num_msgs <= 0 || rounds <= 0) {
+		usage(argv[0]);
+		return -EINVAL;
+	}
+
+	msgs = calloc(num_msgs, sizeof(*msgs));
+	hdr = calloc(SOF_IPC_MSG_MAX_SIZE, 1);
+	if (!msgs || !hdr)
+		return -ENOMEM;
+
+	for (i = 0; i < num_msgs; i++) {
+		ret = replay_load(argv[optind + i], &msgs[i]);
+		if (ret < 0)
+			return ret;
+	}
+
+	replay_init();
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+
+	for (r = 0; r < rounds; r++) {
+		for (i = 0; i < num_msgs; i++) {
+			/* the handler may modify the mailbox, replay a fresh copy */
+			memcpy_s(hdr, SOF_IPC_MSG_MAX_SIZE, msgs[i].data,
+				 SOF_IPC_MSG_MAX_SIZE);
+
+			/* sanity check performed typically by platform dependent code */
+			if (hdr->size < sizeof(*hdr) || hdr->size > SOF_IPC_MSG_MAX_SIZE)
+				continue;
+
+			ipc_cmd((ipc_cmd_hdr *)hdr);
+			count++;
+		}
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &end);
+
+	seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+	printf("%" PRIu64 " messages in %.3f s, %.0f messages/s\n", count, seconds,
+	       seconds > 0 ? count / seconds : 0);
+
+	for (i = 0; i < num_msgs; i++)
+		free(msgs[i].data);
+	free(msgs);
+	free(hdr);
+
+	return 0;
+}
@@ -8,12 +8,15 @@
  * Probes will extract data for several probe points in one stream
  * with extra headers. This app will read the resulting file,
  * strip the headers and create wave files for each extracted buffer.
+ * Both the per transaction packets and the batched packets, which carry
+ * a sequence number to detect dropped packets, are accepted.
  *
  * Usage to parse data and create wave files: ./sof-probes -p data.bin
  *
  */
 
 #include <ipc/probe.h>
+#include <sof/common.h>
 #include <sof/math/numbers.h>
 #include "wave.h"
 
@@ -39,6 +42,8 @@ struct wave_files {
 	FILE *fd;
 	uint32_t buffer_id;
 	uint32_t size;
+	uint32_t sequence;	/**< expected sequence of next batch packet */
+	bool batched;		/**< batch packet received */
 	struct wave header;
 };
 
@@ -92,6 +97,7 @@ int get_buffer_file(struct wave_files *files, uint32_t buffer_id)
 int init_wave(struct wave_files *files, uint32_t buffer_id, uint32_t format)
 {
 	char path[FILE_PATH_LIMIT];
+	uint32_t rate;
 	int i;
 
 	i = get_buffer_file(files, 0);
@@ -120,7 +126,13 @@ int init_wave(struct wave_files *files, uint32_t buffer_id, uint32_t format)
 	files[i].header.fmt.subchunk_size = 16;
 	files[i].header.fmt.audio_format = 1;
 	files[i].header.fmt.num_channels = ((format & PROBE_MASK_NB_CHANNELS) >> PROBE_SHIFT_NB_CHANNELS) + 1;
-	files[i].header.fmt.sample_rate = sample_rate[(format & PROBE_MASK_SAMPLE_RATE) >> PROBE_SHIFT_SAMPLE_RATE];
+	rate = (format & PROBE_MASK_SAMPLE_RATE) >> PROBE_SHIFT_SAMPLE_RATE;
+	if (rate >= ARRAY_SIZE(sample_rate)) {
+		fprintf(stderr, "warning: unknown sample rate for buffer %d, using 48000\n",
+			buffer_id);
+		rate = 8;
+	}
+	files[i].header.fmt.sample_rate = sample_rate[rate];
 	files[i].header.fmt.bits_per_sample = (((format & PROBE_MASK_CONTAINER_SIZE) >> PROBE_SHIFT_CONTAINER_SIZE) + 1) * 8;
 	files[i].header.fmt.byte_rate = files[i].header.fmt.sample_rate *
 					files[i].header.fmt.num_channels *
@@ -158,52 +170,116 @@ void finalize_wave_files(struct wave_files *files)
 	}
 }
 
-int validate_data_packet(struct probe_data_packet *data_packet)
+/* size of packet header for the sync word */
+static uint32_t packet_header_size(bool batch)
 {
+	return batch ? sizeof(struct probe_batch_packet) :
+		sizeof(struct probe_data_packet);
+}
+
+int validate_data_packet(void *packet, bool batch)
+{
+	struct probe_batch_packet *batch_packet = packet;
+	struct probe_data_packet *data_packet = packet;
+	uint32_t *checksum = batch ? &batch_packet->checksum : &data_packet->checksum;
 	uint32_t received_crc;
 	uint32_t calc_crc;
 
-	received_crc = data_packet->checksum;
-	data_packet->checksum = 0;
-	calc_crc = crc32(0, (char *)data_packet, sizeof(*data_packet));
+	received_crc = *checksum;
+	*checksum = 0;
+	calc_crc = crc32(0, (char *)packet, packet_header_size(batch));
 
 	if (received_crc == calc_crc) {
 		return 0;
 	} else {
 		fprintf(stderr, "error: data packet for buffer %d is not valid: crc32: %d/%d\n",
-			data_packet->buffer_id, calc_crc, received_crc);
+			batch ? batch_packet->buffer_id : data_packet->buffer_id,
+			calc_crc, received_crc);
 		return -EINVAL;
 	}
 }
 
-int process_sync(struct probe_data_packet *packet, uint32_t **w_ptr, uint32_t *total_data_to_copy)
+int process_sync(void **packet, bool batch, uint32_t **w_ptr,
+		 uint32_t *total_data_to_copy)
 {
-	struct probe_data_packet *temp_packet;
+	struct probe_batch_packet *batch_packet = *packet;
+	struct probe_data_packet *data_packet = *packet;
+	uint32_t header_size = packet_header_size(batch);
+	uint32_t data_size;
+	void *temp_packet;
+
+	/* batched data is padded to whole words */
+	if (batch)
+		data_size = ALIGN_UP(batch_packet->data_size_bytes, sizeof(uint32_t));
+	else
+		data_size = data_packet->data_size_bytes;
 
 	/* request to copy data_size from probe packet */
-	*total_data_to_copy = packet->data_size_bytes /
-					 sizeof(uint32_t);
-	if (packet->data_size_bytes > PACKET_MAX_SIZE) {
-		temp_packet = realloc(packet,
-				      sizeof(struct probe_data_packet) + packet->data_size_bytes);
+	*total_data_to_copy = data_size / sizeof(uint32_t);
+	if (header_size + data_size > PACKET_MAX_SIZE) {
+		temp_packet = realloc(*packet, header_size + data_size);
 		if (!temp_packet)
 			return -ENOMEM;
+		*packet = temp_packet;
 	}
 
-	*w_ptr = (uint32_t *)&packet->data;
+	*w_ptr = (uint32_t *)((char *)*packet + header_size);
 	return 0;
 }
 
+void save_packet(struct wave_files *files, void *packet, bool batch)
+{
+	struct probe_batch_packet *batch_packet = packet;
+	struct probe_data_packet *data_packet = packet;
+	uint32_t buffer_id;
+	uint32_t format;
+	uint32_t size;
+	void *data;
+	int file;
+
+	if (batch) {
+		buffer_id = batch_packet->buffer_id;
+		format = batch_packet->format;
+		size = batch_packet->data_size_bytes;
+		data = batch_packet->data;
+	} else {
+		buffer_id = data_packet->buffer_id;
+		format = data_packet->format;
+		size = data_packet->data_size_bytes;
+		data = data_packet->data;
+	}
+
+	/* find corresponding file and save data */
+	file = get_buffer_file(files, buffer_id);
+	if (file < 0)
+		file = init_wave(files, buffer_id, format);
+
+	if (batch) {
+		if (files[file].batched &&
+		    batch_packet->sequence != files[file].sequence)
+			fprintf(stderr, "warning: %u packets lost for buffer %d\n",
+				batch_packet->sequence - files[file].sequence,
+				buffer_id);
+
+		files[file].sequence = batch_packet->sequence + 1;
+		files[file].batched = true;
+	}
+
+	fwrite(data, 1, size, files[file].fd);
+	files[file].size += size;
+}
+
 void parse_data(char *file_in)
 {
 	FILE *fd_in;
 	struct wave_files files[FILES_LIMIT];
-	struct probe_data_packet *packet;
+	void *packet;
+	bool batch = false;
 	uint32_t data[DATA_READ_LIMIT];
 	uint32_t total_data_to_copy = 0;
 	uint32_t data_to_copy = 0;
 	uint32_t *w_ptr;
-	int i, j, file;
+	int i, j;
 
 	enum p_state state = READY;
 
@@ -231,17 +307,16 @@ void parse_data(char *file_in)
 		i = fread(&data, sizeof(uint32_t), DATA_READ_LIMIT, fd_in);
 		/* processing all loaded bytes */
 		for (j = 0; j < i; j++) {
-			/* SYNC received */
-			if (data[j] == PROBE_EXTRACT_SYNC_WORD) {
-				if (state != READY) {
-					fprintf(stderr, "error: wrong state %d, err %d\n",
-						state, errno);
-					free(packet);
-					exit(0);
-				}
+			/* SYNC received, data words may match it so it is
+			 * looked for only between packets
+			 */
+			if (state == READY &&
+			    (data[j] == PROBE_EXTRACT_SYNC_WORD ||
+			     data[j] == PROBE_EXTRACT_BATCH_SYNC_WORD)) {
+				batch = data[j] == PROBE_EXTRACT_BATCH_SYNC_WORD;
 				memset(packet, 0, PACKET_MAX_SIZE);
 				/* request to copy full data packet */
-				total_data_to_copy = sizeof(struct probe_data_packet) /
+				total_data_to_copy = packet_header_size(batch) /
 					sizeof(uint32_t);
 				w_ptr = (uint32_t *)packet;
 				state = SYNC;
@@ -268,7 +343,8 @@ void parse_data(char *file_in)
 					break;
 				case SYNC:
 					/* SYNC -> CHECK */
-					if (process_sync(packet, &w_ptr, &total_data_to_copy) < 0) {
+					if (process_sync(&packet, batch, &w_ptr,
+							 &total_data_to_copy) < 0) {
 						fprintf(stderr, "OOM, quitting\n");
 						goto err;
 					}
@@ -276,24 +352,9 @@ void parse_data(char *file_in)
 					break;
 				case CHECK:
 					/* CHECK -> READY */
-					/* find corresponding file and save data if valid */
-					if (validate_data_packet(packet) == 0) {
-						file = get_buffer_file(files,
-								       packet->buffer_id);
-
-						if (file < 0)
-							file = init_wave(files,
-									 packet->buffer_id,
-									 packet->format);
-
-						fwrite(packet->data,
-						       sizeof(uint32_t),
-						       packet->data_size_bytes /
-						       sizeof(uint32_t),
-						       files[file].fd);
-
-						files[file].size += packet->data_size_bytes;
-					}
+					/* save data if valid */
+					if (validate_data_packet(packet, batch) == 0)
+						save_packet(files, packet, batch);
 					state = READY;
 					break;
 				}
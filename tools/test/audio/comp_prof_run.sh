@@ -0,0 +1,201 @@
+#!/bin/bash
+# SPDX-License-Identifier: BSD-3-Clause
+# Copyright(c) 2022 Intel Corporation. All rights reserved.
+
+# stop on most errors
+set -e
+
+usage ()
+{
+    cat <<EOFHELP
+Usage:     $0 <options>
+Example 1: $0
+Example 2: $0 -t src -r ../../testbench/build_ref -M 400 -c "2 4 8"
+
+Runs test topologies with the testbench component profiler and prints
+the MCPS of the tested component for each test, conversion, format and
+channels count. With a reference testbench build, e.g. one built without
+the optimization to measure, the MCPS of both builds and their ratio
+are printed. Channels counts above PLATFORM_MAX_CHANNELS of the
+testbench build are rejected by the components.
+
+Options:
+  -t <list>    tests, default
+               "src crossover-2way crossover-3way crossover-4way multiband-drc"
+  -r <dir>     reference testbench build directory to compare with
+  -M <MHz>     clock for the MCPS estimate, default from the testbench
+  -c <list>    channels counts, default "2 4 8"
+  -b <list>    sample bits, default "16 24 32"
+  -f <list>    SRC conversions as in:out rates, default
+               "48000:16000 16000:48000 44100:48000 48000:44100",
+               the other tests run at 48000:48000
+  -s <seconds> length of test input, default 10
+  -x <cmd>     run the testbench with a command, e.g. a simulator
+EOFHELP
+}
+
+parse_args ()
+{
+    # Defaults
+    TESTS="src crossover-2way crossover-3way crossover-4way multiband-drc"
+    REF_ROOT=
+    MHZ=
+    CHANNELS="2 4 8"
+    BITS="16 24 32"
+    RATES="48000:16000 16000:48000 44100:48000 48000:44100"
+    SECONDS_IN=10
+    RUN_CMD=
+
+    while getopts ":ht:r:M:c:b:f:s:x:" opt; do
+	case "${opt}" in
+	    t)
+		TESTS="${OPTARG}"
+		;;
+	    r)
+		REF_ROOT="${OPTARG}"
+		;;
+	    M)
+		MHZ="-M ${OPTARG}"
+		;;
+	    c)
+		CHANNELS="${OPTARG}"
+		;;
+	    b)
+		BITS="${OPTARG}"
+		;;
+	    f)
+		RATES="${OPTARG}"
+		;;
+	    s)
+		SECONDS_IN="${OPTARG}"
+		;;
+	    x)
+		RUN_CMD="${OPTARG}"
+		;;
+	    h)
+		usage
+		exit
+		;;
+	    *)
+		usage
+		exit 1
+		;;
+	esac
+    done
+}
+
+# Topology, conversions, number of outputs and the component type in
+# the testbench profile table for a test. SRC is SOF_COMP_SRC and the
+# process components are SOF_COMP_NONE.
+test_setup ()
+{
+    TEST_RATES=48000:48000
+    TEST_NOUT=1
+
+    case "$1" in
+	src)
+	    TEST_TPLG=src
+	    TEST_TYPE=8
+	    TEST_RATES=$RATES
+	    ;;
+	crossover-2way|crossover-3way|crossover-4way)
+	    TEST_TPLG=${1#crossover-}-crossover
+	    TEST_TYPE=0
+	    TEST_NOUT=${TEST_TPLG%%way*}
+	    ;;
+	multiband-drc)
+	    TEST_TPLG=multiband-drc
+	    TEST_TYPE=0
+	    ;;
+	*)
+	    echo "Unknown test $1" >&2
+	    exit 1
+	    ;;
+    esac
+}
+
+# Comma separated output files for the outputs of the test
+outputs ()
+{
+    local i list=
+
+    for i in $(seq 1 "$TEST_NOUT"); do
+	list="${list:+$list,}$TMP_DIR/out$i.raw"
+    done
+    echo "$list"
+}
+
+# Sum of MCPS of the components of the tested type from the testbench
+# profile table.
+run_mcps ()
+{
+    local root=$1 tplg=$2 bits=$3 ch=$4 fs_in=$5 fs_out=$6
+
+    # shellcheck disable=SC2086
+    LD_LIBRARY_PATH=$root/sof_ep/install/lib:$root/sof_parser/install/lib \
+	$RUN_CMD "$root"/install/bin/testbench -q $MHZ -r "$fs_in" -R "$fs_out" \
+	-c "$ch" -n "$ch" -b "S${bits}_LE" -t "$tplg" -i "$FN_IN" \
+	-o "$(outputs)" 2> /dev/null |
+	awk '/^Component profile/ { p = 1; next }
+	     p && $2 == "'"$TEST_TYPE"'" { mcps += $NF }
+	     /^Pipeline .* total load/ { p = 0 }
+	     END { printf "%.2f", mcps }'
+}
+
+run_test ()
+{
+    local name=$1
+    local bits ch rates fs_in fs_out tplg mcps mcps_ref
+
+    test_setup "$name"
+    for rates in $TEST_RATES; do
+	fs_in=${rates%:*}
+	fs_out=${rates#*:}
+	for bits in $BITS; do
+	    for ch in $CHANNELS; do
+		# Topologies are for 16, 24, and 32 bits, 24 bit is s24le
+		# in S32_LE container.
+		tplg=$TPLG_DIR/test-playback-ssp5-mclk-0-I2S-$TEST_TPLG-s${bits}le-s${bits}le-48k-24576k-codec.tplg
+		if [ ! -f "$tplg" ]; then
+		    echo "Missing $tplg" >&2
+		    exit 1
+		fi
+
+		mcps=$(run_mcps "$HOST_ROOT" "$tplg" "$bits" "$ch" "$fs_in" "$fs_out")
+		if [ -n "$REF_ROOT" ]; then
+		    mcps_ref=$(run_mcps "$REF_ROOT" "$tplg" "$bits" "$ch" "$fs_in" "$fs_out")
+		    printf "%-16s %-12s %4s %4s %10s %10s %8s\n" "$name" "$rates" \
+			   "$bits" "$ch" "$mcps_ref" "$mcps" \
+			   "$(awk -v a="$mcps" -v b="$mcps_ref" 'BEGIN { if (a > 0) printf "%.2f", b / a }')"
+		else
+		    printf "%-16s %-12s %4s %4s %10s\n" "$name" "$rates" "$bits" \
+			   "$ch" "$mcps"
+		fi
+	    done
+	done
+    done
+}
+
+parse_args "$@"
+
+# Paths
+HOST_ROOT=../../testbench/build_testbench
+TPLG_DIR=../../build_tools/test/topology
+TMP_DIR=$(mktemp -d)
+trap 'rm -rf "$TMP_DIR"' EXIT
+
+# Noise input for max channels count in 32 bit samples
+FN_IN=$TMP_DIR/in.raw
+MAX_CH=$(echo "$CHANNELS" | tr ' ' '\n' | sort -n | tail -1)
+head -c $((48000 * SECONDS_IN * MAX_CH * 4)) /dev/urandom > "$FN_IN"
+
+if [ -n "$REF_ROOT" ]; then
+    printf "%-16s %-12s %4s %4s %10s %10s %8s\n" "test" "in:out" "bits" "ch" \
+	   "ref MCPS" "MCPS" "speedup"
+else
+    printf "%-16s %-12s %4s %4s %10s\n" "test" "in:out" "bits" "ch" "MCPS"
+fi
+
+for test in $TESTS; do
+    run_test "$test"
+done
@@ -0,0 +1,391 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2022 Intel Corporation. All rights reserved.
+
+/*
+ * Testbench batch mode
+ *
+ * Runs a manifest of independent jobs over a pool of worker processes. The
+ * SOF library keeps its IPC, scheduler and heap state in process globals
+ * (sof_get()), so every job is forked into its own process to get a private
+ * struct sof and IPC context. The job result is passed back to the parent
+ * over a pipe and collected into a CSV summary.
+ *
+ * Manifest format, one job per line, '#' starts a comment line:
+ *   <topology> <input> <output1[,output2,...]> [<blob>|-]
+ * The blob replaces the bytes control data of the process widget given with
+ * the -K option.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <limits.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include "testbench/common_test.h"
+
+#define TB_BATCH_MAX_JOBS	4096
+#define TB_BATCH_TOKENS		4
+
+struct tb_batch_job {
+	char *tplg_file;
+	char *input_file;
+	char *output_files;
+	char *blob_file;
+
+	pid_t pid;
+	int fd;			/* read end of the result pipe */
+	struct timespec t0;
+	uint64_t wall_us;
+	int ret;
+	struct tb_run_stats stats;
+};
+
+/* message written by the worker into the result pipe */
+struct tb_batch_result {
+	int ret;
+	struct tb_run_stats stats;
+};
+
+static uint64_t tb_batch_elapsed_us(struct timespec *t0)
+{
+	struct timespec t1;
+
+	clock_gettime(CLOCK_MONOTONIC, &t1);
+	return (t1.tv_sec - t0->tv_sec) * 1000000 +
+		(t1.tv_nsec - t0->tv_nsec) / 1000;
+}
+
+/* host clock in MHz from /proc/cpuinfo, 0 if not known */
+int tb_host_mhz(void)
+{
+	char line[256];
+	double mhz = 0;
+	FILE *fh;
+
+	fh = fopen("/proc/cpuinfo", "r");
+	if (!fh)
+		return 0;
+
+	while (fgets(line, sizeof(line), fh)) {
+		if (sscanf(line, "cpu MHz : %lf", &mhz) == 1)
+			break;
+	}
+
+	fclose(fh);
+	return (int)mhz;
+}
+
+static void tb_batch_free_jobs(struct tb_batch_job *jobs, int num_jobs)
+{
+	int i;
+
+	for (i = 0; i < num_jobs; i++) {
+		free(jobs[i].tplg_file);
+		free(jobs[i].input_file);
+		free(jobs[i].output_files);
+		free(jobs[i].blob_file);
+	}
+
+	free(jobs);
+}
+
+static int tb_batch_parse(const char *manifest, const char *blob_widget,
+			  struct tb_batch_job **jobs_out)
+{
+	struct tb_batch_job *jobs;
+	char *token[TB_BATCH_TOKENS];
+	char *line = NULL;
+	char *save;
+	size_t len = 0;
+	int num_jobs = 0;
+	int line_num = 0;
+	int n;
+	FILE *fh;
+
+	fh = fopen(manifest, "r");
+	if (!fh) {
+		fprintf(stderr, "error: opening batch manifest %s: %s\n",
+			manifest, strerror(errno));
+		return -errno;
+	}
+
+	jobs = calloc(TB_BATCH_MAX_JOBS, sizeof(*jobs));
+	if (!jobs) {
+		fclose(fh);
+		return -ENOMEM;
+	}
+
+	while (getline(&line, &len, fh) > 0) {
+		line_num++;
+
+		n = 0;
+		token[n] = strtok_r(line, " \t\r\n", &save);
+		while (token[n] && ++n < TB_BATCH_TOKENS)
+			token[n] = strtok_r(NULL, " \t\r\n", &save);
+
+		/* skip empty and comment lines */
+		if (!n || token[0][0] == '#')
+			continue;
+
+		if (n < 3) {
+			fprintf(stderr, "error: %s:%d: expected <topology> <input> <outputs>\n",
+				manifest, line_num);
+			goto err;
+		}
+
+		if (num_jobs == TB_BATCH_MAX_JOBS) {
+			fprintf(stderr, "error: max batch job count is %d\n",
+				TB_BATCH_MAX_JOBS);
+			goto err;
+		}
+
+		jobs[num_jobs].tplg_file = strdup(token[0]);
+		jobs[num_jobs].input_file = strdup(token[1]);
+		jobs[num_jobs].output_files = strdup(token[2]);
+		if (n > 3 && strcmp(token[3], "-")) {
+			if (!blob_widget) {
+				fprintf(stderr, "error: %s:%d: blob needs -K widget name\n",
+					manifest, line_num);
+				goto err;
+			}
+			jobs[num_jobs].blob_file = strdup(token[3]);
+		}
+		jobs[num_jobs].fd = -1;
+		num_jobs++;
+	}
+
+	free(line);
+	fclose(fh);
+	*jobs_out = jobs;
+	return num_jobs;
+
+err:
+	free(line);
+	fclose(fh);
+	tb_batch_free_jobs(jobs, num_jobs);
+	return -EINVAL;
+}
+
+/* worker process body, never returns */
+static void tb_batch_worker(struct testbench_prm *tp, struct tb_batch_job *job,
+			    int fd, int (*run)(struct testbench_prm *tp))
+{
+	struct tb_batch_result result = {0};
+	char *outputs = strdup(job->output_files);
+	char *save = NULL;
+	char *token;
+	char log_file[PATH_MAX];
+	int log_fd;
+	int i;
+
+	/* job output goes to <first output>.log to keep the summary clean */
+	token = strtok_r(outputs, ",", &save);
+	for (i = 0; i < MAX_OUTPUT_FILE_NUM && token; i++) {
+		tp->output_file[i] = token;
+		token = strtok_r(NULL, ",", &save);
+	}
+	tp->output_file_num = i;
+
+	snprintf(log_file, sizeof(log_file), "%s.log", tp->output_file[0]);
+	log_fd = open(log_file, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (log_fd >= 0) {
+		dup2(log_fd, STDOUT_FILENO);
+		dup2(log_fd, STDERR_FILENO);
+		close(log_fd);
+	}
+
+	tp->tplg_file = job->tplg_file;
+	tp->input_file = job->input_file;
+	if (job->blob_file)
+		tp->blob_file = job->blob_file;
+	memset(&tp->stats, 0, sizeof(tp->stats));
+
+	result.ret = run(tp);
+	result.stats = tp->stats;
+
+	if (write(fd, &result, sizeof(result)) != sizeof(result))
+		result.ret = -EIO;
+
+	close(fd);
+	fflush(NULL);
+	_exit(result.ret < 0 ? EXIT_FAILURE : EXIT_SUCCESS);
+}
+
+static int tb_batch_start(struct testbench_prm *tp, struct tb_batch_job *job,
+			  int (*run)(struct testbench_prm *tp))
+{
+	int fds[2];
+
+	if (pipe(fds) < 0)
+		return -errno;
+
+	/* flush before fork so buffered output is not duplicated */
+	fflush(NULL);
+	clock_gettime(CLOCK_MONOTONIC, &job->t0);
+
+	job->pid = fork();
+	if (job->pid < 0) {
+		close(fds[0]);
+		close(fds[1]);
+		return -errno;
+	}
+
+	if (!job->pid) {
+		close(fds[0]);
+		tb_batch_worker(tp, job, fds[1], run);
+	}
+
+	close(fds[1]);
+	job->fd = fds[0];
+	return 0;
+}
+
+static void tb_batch_collect(struct tb_batch_job *job, int status)
+{
+	struct tb_batch_result result;
+
+	job->wall_us = tb_batch_elapsed_us(&job->t0);
+
+	if (read(job->fd, &result, sizeof(result)) == sizeof(result)) {
+		job->ret = result.ret;
+		job->stats = result.stats;
+	} else {
+		/* worker crashed before reporting */
+		job->ret = -EPIPE;
+	}
+
+	if (!WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS)
+		job->ret = job->ret < 0 ? job->ret : -ECHILD;
+
+	close(job->fd);
+	job->fd = -1;
+}
+
+static void tb_batch_summary(FILE *out, struct tb_batch_job *jobs, int num_jobs,
+			     int host_mhz)
+{
+	struct tb_run_stats *s;
+	double audio_us;
+	double mcps;
+	double rt;
+	int frames;
+	int i;
+
+	fprintf(out, "job,status,topology,input,outputs,blob,frames_out,rate_out,");
+	fprintf(out, "wall_us,exec_us,cpu_us,realtime_x,host_mhz,mcps\n");
+	for (i = 0; i < num_jobs; i++) {
+		s = &jobs[i].stats;
+		frames = s->channels_out ? s->n_out / s->channels_out : 0;
+		audio_us = s->fs_out ? 1e6 * frames / s->fs_out : 0;
+		rt = s->exec_us ? audio_us / s->exec_us : 0;
+		mcps = audio_us ? (double)s->cpu_us * host_mhz / audio_us : 0;
+
+		fprintf(out, "%d,%d,%s,%s,\"%s\",%s,%d,%u,%" PRIu64 ",%" PRIu64 ",%" PRIu64
+			",%.2f,%d,%.2f\n",
+			i, jobs[i].ret, jobs[i].tplg_file, jobs[i].input_file,
+			jobs[i].output_files,
+			jobs[i].blob_file ? jobs[i].blob_file : "-",
+			frames, s->fs_out, jobs[i].wall_us, s->exec_us,
+			s->cpu_us, rt, host_mhz, mcps);
+	}
+}
+
+/* run all manifest jobs, returns number of failed jobs or negative error */
+int tb_batch_run(struct testbench_prm *tp,
+		 int (*run)(struct testbench_prm *tp))
+{
+	struct tb_batch_job *jobs = NULL;
+	struct timespec t0;
+	FILE *out = stdout;
+	int num_jobs;
+	int running = 0;
+	int next = 0;
+	int done = 0;
+	int failed = 0;
+	int status;
+	pid_t pid;
+	int ret;
+	int i;
+
+	num_jobs = tb_batch_parse(tp->batch_file, tp->blob_widget, &jobs);
+	if (num_jobs <= 0) {
+		/* the job array exists also for an empty manifest */
+		free(jobs);
+		return num_jobs;
+	}
+
+	if (tp->batch_workers <= 0)
+		tp->batch_workers = sysconf(_SC_NPROCESSORS_ONLN);
+
+	if (!tp->host_mhz)
+		tp->host_mhz = tb_host_mhz();
+
+	clock_gettime(CLOCK_MONOTONIC, &t0);
+
+	while (done < num_jobs) {
+		/* fill the worker pool */
+		while (running < tp->batch_workers && next < num_jobs) {
+			ret = tb_batch_start(tp, &jobs[next], run);
+			if (ret < 0) {
+				fprintf(stderr, "error: can't start job %d: %s\n",
+					next, strerror(-ret));
+				jobs[next].ret = ret;
+				done++;
+			} else {
+				running++;
+			}
+			next++;
+		}
+
+		if (!running)
+			continue;
+
+		pid = waitpid(-1, &status, 0);
+		if (pid < 0) {
+			if (errno == EINTR)
+				continue;
+			fprintf(stderr, "error: waitpid: %s\n", strerror(errno));
+			break;
+		}
+
+		for (i = 0; i < next; i++) {
+			if (jobs[i].pid == pid && jobs[i].fd >= 0) {
+				tb_batch_collect(&jobs[i], status);
+				running--;
+				done++;
+				break;
+			}
+		}
+	}
+
+	if (tp->summary_file) {
+		out = fopen(tp->summary_file, "w");
+		if (!out) {
+			fprintf(stderr, "error: opening summary %s: %s\n",
+				tp->summary_file, strerror(errno));
+			out = stdout;
+		}
+	}
+
+	tb_batch_summary(out, jobs, num_jobs, tp->host_mhz);
+	if (out != stdout)
+		fclose(out);
+
+	for (i = 0; i < num_jobs; i++)
+		if (jobs[i].ret < 0)
+			failed++;
+
+	fprintf(stderr, "batch: %d jobs, %d failed, %d workers, %" PRIu64 " us total\n",
+		num_jobs, failed, tp->batch_workers, tb_batch_elapsed_us(&t0));
+
+	tb_batch_free_jobs(jobs, num_jobs);
+	return failed;
+}
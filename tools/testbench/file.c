@@ -10,6 +10,12 @@
 #include <stdlib.h>
 #include <errno.h>
 #include <inttypes.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <sof/sof.h>
 #include <sof/list.h>
 #include <sof/audio/stream.h>
@@ -80,61 +86,427 @@ static void sign_extend_source_s24(const struct audio_stream *source, int sample
 }
 
 /*
- * Read 32-bit samples from binary file
+ * Raw and wav files are memory mapped. Samples are copied with memcpy()
+ * directly between the mapping and the contiguous segments of the
+ * audio_stream ring buffer.
  */
-static int read_binary_s32(struct file_comp_data *cd, const struct audio_stream *sink, int samples)
+
+#define FILE_MAP_MIN_GROW	(1024 * 1024)
+
+bool file_async_writeback;
+
+/*
+ * Read samples of any width from mapped file
+ */
+static int read_mapped(struct file_comp_data *cd, const struct audio_stream *sink,
+		       int samples, int sample_bytes)
 {
-	int32_t *snk = (int32_t *)sink->w_ptr;
-	size_t samples_avail;
-	size_t bytes_snk;
-	size_t bytes = samples * sizeof(int32_t);
-	int ret;
-	int samples_copied = 0;
+	struct file_map *map = &cd->fs.map;
+	uint8_t *snk = sink->w_ptr;
+	size_t bytes = (size_t)samples * sample_bytes;
+	size_t avail = map->end - map->pos;
+	size_t n;
+
+	/* end of file, round down to full samples */
+	if (bytes > avail) {
+		bytes = avail - avail % sample_bytes;
+		cd->fs.reached_eof = true;
+	}
 
+	samples = bytes / sample_bytes;
 	while (bytes) {
-		bytes_snk = audio_stream_bytes_without_wrap(sink, snk);
-		samples_avail = FILE_BYTES_TO_S32_SAMPLES(MIN(bytes, bytes_snk));
-		ret = fread(snk, sizeof(int32_t), samples_avail, cd->fs.rfh);
-		if (!ret) {
-			cd->fs.reached_eof = 1;
-			return samples_copied;
-		}
+		n = MIN(bytes, audio_stream_bytes_without_wrap(sink, snk));
+		memcpy(snk, map->addr + map->pos, n);
+		map->pos += n;
+		bytes -= n;
+		snk = audio_stream_wrap(sink, snk + n);
+	}
 
-		samples_copied += ret;
-		bytes -= ret * sizeof(int32_t);
-		snk = audio_stream_wrap(sink, snk + ret);
+	return samples;
+}
+
+/* extend output file and its mapping to at least size bytes */
+static int file_map_grow(struct file_map *map, size_t size)
+{
+	size = MAX(size, 2 * map->size);
+	size = MAX(size, FILE_MAP_MIN_GROW);
+
+	if (map->addr)
+		munmap(map->addr, map->size);
+
+	map->addr = NULL;
+	map->size = 0;
+	if (ftruncate(map->fd, size) < 0)
+		return -errno;
+
+	map->addr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED,
+			 map->fd, 0);
+	if (map->addr == MAP_FAILED) {
+		map->addr = NULL;
+		return -errno;
 	}
 
-	return samples_copied;
+	map->size = size;
+	return 0;
 }
 
 /*
- * Write 32-bit samples to binary file
+ * Write samples of any width to mapped file
  */
-static int write_binary_s32(struct file_comp_data *cd, const struct audio_stream *source,
-			    int samples)
+static int write_mapped(struct file_comp_data *cd, const struct audio_stream *source,
+			int samples, int sample_bytes)
 {
-	int32_t *src = (int32_t *)source->r_ptr;
-	size_t samples_avail;
-	size_t bytes_src;
-	size_t bytes = samples * sizeof(int32_t);
+	struct file_map *map = &cd->fs.map;
+	uint8_t *src = source->r_ptr;
+	size_t bytes = (size_t)samples * sample_bytes;
+	size_t n;
+
+	if (map->pos + bytes > map->size && file_map_grow(map, map->pos + bytes) < 0) {
+		cd->fs.write_failed = true;
+		return 0;
+	}
+
+	while (bytes) {
+		n = MIN(bytes, audio_stream_bytes_without_wrap(source, src));
+		memcpy(map->addr + map->pos, src, n);
+		map->pos += n;
+		bytes -= n;
+		src = audio_stream_wrap(source, src + n);
+	}
+
+	map->end = map->pos;
+	return samples;
+}
+
+/* writeback thread, writes full buffers in order until told to exit */
+static void *file_wb_thread(void *data)
+{
+	struct file_state *fs = data;
+	struct file_writeback *wb = fs->wb;
+	ssize_t ret;
+	int i;
+
+	pthread_mutex_lock(&wb->lock);
+	for (;;) {
+		i = wb->next;
+		while (!wb->full[i] && !wb->exit)
+			pthread_cond_wait(&wb->cond, &wb->lock);
+
+		/* exit only after all submitted buffers are written */
+		if (!wb->full[i])
+			break;
+
+		pthread_mutex_unlock(&wb->lock);
+		ret = write(fs->map.fd, wb->buf[i], wb->fill[i]);
+		pthread_mutex_lock(&wb->lock);
+
+		if (ret != wb->fill[i])
+			wb->error = -EIO;
+
+		wb->fill[i] = 0;
+		wb->full[i] = false;
+		wb->next = (i + 1) % FILE_WB_BUFFERS;
+		pthread_cond_broadcast(&wb->cond);
+	}
+	pthread_mutex_unlock(&wb->lock);
+
+	return NULL;
+}
+
+/* hand the active buffer over to the writeback thread */
+static void file_wb_submit(struct file_writeback *wb)
+{
+	pthread_mutex_lock(&wb->lock);
+	wb->full[wb->active] = true;
+	wb->active = (wb->active + 1) % FILE_WB_BUFFERS;
+	pthread_cond_broadcast(&wb->cond);
+
+	/* wait until the thread has drained the next buffer */
+	while (wb->full[wb->active])
+		pthread_cond_wait(&wb->cond, &wb->lock);
+	pthread_mutex_unlock(&wb->lock);
+}
+
+static int file_wb_start(struct file_state *fs)
+{
+	struct file_writeback *wb;
+	int i;
+
+	wb = calloc(1, sizeof(*wb));
+	if (!wb)
+		return -ENOMEM;
+
+	for (i = 0; i < FILE_WB_BUFFERS; i++) {
+		wb->buf[i] = malloc(FILE_WB_BUFFER_BYTES);
+		if (!wb->buf[i])
+			goto err;
+	}
+
+	pthread_mutex_init(&wb->lock, NULL);
+	pthread_cond_init(&wb->cond, NULL);
+	fs->wb = wb;
+
+	if (pthread_create(&wb->thread, NULL, file_wb_thread, fs)) {
+		fs->wb = NULL;
+		pthread_cond_destroy(&wb->cond);
+		pthread_mutex_destroy(&wb->lock);
+		goto err;
+	}
+
+	return 0;
+
+err:
+	for (i = 0; i < FILE_WB_BUFFERS; i++)
+		free(wb->buf[i]);
+	free(wb);
+	return -ENOMEM;
+}
+
+/* flush pending data and stop the writeback thread */
+static int file_wb_stop(struct file_state *fs)
+{
+	struct file_writeback *wb = fs->wb;
 	int ret;
-	int samples_copied = 0;
+	int i;
+
+	pthread_mutex_lock(&wb->lock);
+	if (wb->fill[wb->active])
+		wb->full[wb->active] = true;
+	wb->exit = true;
+	pthread_cond_broadcast(&wb->cond);
+	pthread_mutex_unlock(&wb->lock);
+
+	pthread_join(wb->thread, NULL);
+	ret = wb->error;
+
+	pthread_cond_destroy(&wb->cond);
+	pthread_mutex_destroy(&wb->lock);
+	for (i = 0; i < FILE_WB_BUFFERS; i++)
+		free(wb->buf[i]);
+	free(wb);
+	fs->wb = NULL;
+
+	return ret;
+}
+
+/*
+ * Write samples of any width through the double buffered writeback
+ */
+static int write_async(struct file_comp_data *cd, const struct audio_stream *source,
+		       int samples, int sample_bytes)
+{
+	struct file_writeback *wb = cd->fs.wb;
+	uint8_t *src = source->r_ptr;
+	size_t bytes = (size_t)samples * sample_bytes;
+	size_t n;
+	int i;
+
+	if (wb->error) {
+		cd->fs.write_failed = true;
+		return 0;
+	}
 
 	while (bytes) {
-		bytes_src = audio_stream_bytes_without_wrap(source, src);
-		samples_avail = FILE_BYTES_TO_S32_SAMPLES(MIN(bytes, bytes_src));
-		ret = fwrite(src, sizeof(int32_t), samples_avail, cd->fs.wfh);
-		if (ret == 0) {
-			cd->fs.write_failed = true;
-			return samples_copied;
+		i = wb->active;
+		n = MIN(bytes, audio_stream_bytes_without_wrap(source, src));
+		n = MIN(n, FILE_WB_BUFFER_BYTES - wb->fill[i]);
+		memcpy(wb->buf[i] + wb->fill[i], src, n);
+		wb->fill[i] += n;
+		bytes -= n;
+		src = audio_stream_wrap(source, src + n);
+
+		if (wb->fill[i] == FILE_WB_BUFFER_BYTES)
+			file_wb_submit(wb);
+	}
+
+	cd->fs.map.end += (size_t)samples * sample_bytes;
+	return samples;
+}
+
+static int write_binary(struct file_comp_data *cd, const struct audio_stream *source,
+			int samples, int sample_bytes)
+{
+	if (cd->fs.wb)
+		return write_async(cd, source, samples, sample_bytes);
+
+	return write_mapped(cd, source, samples, sample_bytes);
+}
+
+static void wav_header_init(struct file_state *fs, struct file_wav_header *hdr)
+{
+	uint32_t data_size = fs->map.end - fs->map.data_offset;
+
+	memcpy(hdr->riff, "RIFF", 4);
+	hdr->riff_size = sizeof(*hdr) - 8 + data_size;
+	memcpy(hdr->wave, "WAVE", 4);
+	memcpy(hdr->fmt, "fmt ", 4);
+	hdr->fmt_size = 16;
+	hdr->format_tag = 1; /* PCM */
+	hdr->channels = fs->channels;
+	hdr->rate = fs->rate;
+	hdr->block_align = fs->channels * fs->sample_bytes;
+	hdr->byte_rate = fs->rate * hdr->block_align;
+	hdr->bits_per_sample = fs->sample_bytes * 8;
+	memcpy(hdr->data, "data", 4);
+	hdr->data_size = data_size;
+}
+
+/* find the PCM sample data chunk of a wav file */
+static int wav_parse(struct file_state *fs)
+{
+	struct file_map *map = &fs->map;
+	const uint8_t *chunk;
+	uint32_t chunk_size;
+	uint16_t channels = 0;
+	uint32_t rate = 0;
+	size_t offset = 12;
+
+	if (map->size < sizeof(struct file_wav_header) ||
+	    memcmp(map->addr, "RIFF", 4) || memcmp(map->addr + 8, "WAVE", 4)) {
+		fprintf(stderr, "error: %s is not a RIFF/WAVE file\n", fs->fn);
+		return -EINVAL;
+	}
+
+	while (offset + 8 <= map->size) {
+		chunk = map->addr + offset;
+		memcpy(&chunk_size, chunk + 4, sizeof(chunk_size));
+
+		if (!memcmp(chunk, "fmt ", 4) && chunk_size >= 16) {
+			memcpy(&channels, chunk + 10, sizeof(channels));
+			memcpy(&rate, chunk + 12, sizeof(rate));
+		} else if (!memcmp(chunk, "data", 4)) {
+			map->data_offset = offset + 8;
+			map->end = MIN(map->data_offset + chunk_size, map->size);
+			map->pos = map->data_offset;
+
+			if (fs->channels && channels != fs->channels)
+				fprintf(stderr, "warning: %s has %u channels, using %u\n",
+					fs->fn, channels, fs->channels);
+			if (fs->rate && rate != fs->rate)
+				fprintf(stderr, "warning: %s has rate %u, using %u\n",
+					fs->fn, rate, fs->rate);
+			return 0;
+		}
+
+		/* chunks are word aligned */
+		offset += 8 + chunk_size + (chunk_size & 1);
+	}
+
+	fprintf(stderr, "error: no data chunk in %s\n", fs->fn);
+	return -EINVAL;
+}
+
+static int file_map_open_read(struct file_state *fs)
+{
+	struct file_map *map = &fs->map;
+	struct stat st;
+	int ret;
+
+	map->fd = open(fs->fn, O_RDONLY);
+	if (map->fd < 0)
+		return -errno;
+
+	if (fstat(map->fd, &st) < 0) {
+		ret = -errno;
+		goto err;
+	}
+
+	map->size = st.st_size;
+	map->end = map->size;
+	if (map->size) {
+		map->addr = mmap(NULL, map->size, PROT_READ, MAP_PRIVATE, map->fd, 0);
+		if (map->addr == MAP_FAILED) {
+			map->addr = NULL;
+			ret = -errno;
+			goto err;
 		}
-		samples_copied += ret;
-		bytes -= ret * sizeof(int32_t);
-		src = audio_stream_wrap(source, src + ret);
+
+		/* samples are read once front to back */
+		madvise(map->addr, map->size, MADV_SEQUENTIAL);
 	}
 
-	return samples_copied;
+	if (fs->f_format == FILE_WAV) {
+		ret = wav_parse(fs);
+		if (ret < 0)
+			goto err;
+	}
+
+	return 0;
+
+err:
+	if (map->addr)
+		munmap(map->addr, map->size);
+	close(map->fd);
+	map->addr = NULL;
+	return ret;
+}
+
+static int file_map_open_write(struct file_state *fs)
+{
+	struct file_wav_header hdr = {0};
+	struct file_map *map = &fs->map;
+	int ret;
+
+	map->fd = open(fs->fn, O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if (map->fd < 0)
+		return -errno;
+
+	/* wav header is completed when the file is closed */
+	if (fs->f_format == FILE_WAV)
+		map->data_offset = sizeof(hdr);
+
+	map->pos = map->data_offset;
+	map->end = map->data_offset;
+
+	if (file_async_writeback) {
+		if (map->data_offset &&
+		    write(map->fd, &hdr, sizeof(hdr)) != sizeof(hdr)) {
+			ret = -EIO;
+			goto err;
+		}
+
+		ret = file_wb_start(fs);
+	} else {
+		ret = file_map_grow(map, map->data_offset);
+	}
+
+	if (ret < 0)
+		goto err;
+
+	return 0;
+
+err:
+	close(map->fd);
+	return ret;
+}
+
+static void file_map_close(struct file_state *fs)
+{
+	struct file_map *map = &fs->map;
+	struct file_wav_header hdr;
+
+	if (fs->mode == FILE_WRITE) {
+		if (fs->wb && file_wb_stop(fs) < 0)
+			fprintf(stderr, "error: writeback to %s failed\n", fs->fn);
+
+		if (fs->f_format == FILE_WAV) {
+			wav_header_init(fs, &hdr);
+			if (map->addr)
+				memcpy(map->addr, &hdr, sizeof(hdr));
+			else if (pwrite(map->fd, &hdr, sizeof(hdr), 0) != sizeof(hdr))
+				fprintf(stderr, "error: wav header write to %s\n", fs->fn);
+		}
+	}
+
+	if (map->addr)
+		munmap(map->addr, map->size);
+
+	/* drop the unused tail of the last mapping growth */
+	if (fs->mode == FILE_WRITE && ftruncate(map->fd, map->end) < 0)
+		fprintf(stderr, "error: truncating %s\n", fs->fn);
+
+	close(map->fd);
+	map->addr = NULL;
 }
 
 /*
@@ -204,8 +576,9 @@ static int read_samples_s32(struct file_comp_data *cd, const struct audio_stream
 
 	switch (cd->fs.f_format) {
 	case FILE_RAW:
-		/* raw input file */
-		n_samples = read_binary_s32(cd, sink, samples);
+	case FILE_WAV:
+		/* raw or wav input file */
+		n_samples = read_mapped(cd, sink, samples, sizeof(int32_t));
 		break;
 	case FILE_TEXT:
 		/* text input file */
@@ -234,8 +607,9 @@ static int write_samples_s32(struct file_comp_data *cd, struct audio_stream *sou
 
 	switch (cd->fs.f_format) {
 	case FILE_RAW:
-		/* raw input file */
-		samples_written = write_binary_s32(cd, source, samples);
+	case FILE_WAV:
+		/* raw or wav output file */
+		samples_written = write_binary(cd, source, samples, sizeof(int32_t));
 		break;
 	case FILE_TEXT:
 		/* text input file */
@@ -248,65 +622,6 @@ static int write_samples_s32(struct file_comp_data *cd, struct audio_stream *sou
 	return samples_written;
 }
 
-/*
- * Read 16-bit samples from binary file
- */
-static int read_binary_s16(struct file_comp_data *cd, const struct audio_stream *sink, int samples)
-{
-	int16_t *snk = (int16_t *)sink->w_ptr;
-	size_t samples_avail;
-	size_t bytes_snk;
-	size_t bytes = samples * sizeof(int16_t);
-	int ret;
-	int samples_copied = 0;
-
-	while (bytes) {
-		bytes_snk = audio_stream_bytes_without_wrap(sink, snk);
-		samples_avail = FILE_BYTES_TO_S16_SAMPLES(MIN(bytes, bytes_snk));
-		ret = fread(snk, sizeof(int16_t), samples_avail, cd->fs.rfh);
-		if (!ret) {
-			cd->fs.reached_eof = 1;
-			return samples_copied;
-		}
-
-		samples_copied += ret;
-		bytes -= ret * sizeof(int16_t);
-		snk = audio_stream_wrap(sink, snk + ret);
-	}
-
-	return samples_copied;
-}
-
-/*
- * Write 16-bit samples to binary file
- */
-static int write_binary_s16(struct file_comp_data *cd, const struct audio_stream *source,
-			    int samples)
-{
-	int16_t *src = (int16_t *)source->r_ptr;
-	size_t samples_avail;
-	size_t bytes_src;
-	size_t bytes = samples * sizeof(int16_t);
-	int ret;
-	int samples_copied = 0;
-
-	while (bytes) {
-		bytes_src = audio_stream_bytes_without_wrap(source, src);
-		samples_avail = FILE_BYTES_TO_S16_SAMPLES(MIN(bytes, bytes_src));
-		ret = fwrite(src, sizeof(int16_t), samples_avail, cd->fs.wfh);
-		if (!ret) {
-			cd->fs.write_failed = true;
-			return samples_copied;
-		}
-
-		samples_copied += ret;
-		bytes -= ret * sizeof(int16_t);
-		src = audio_stream_wrap(source, src + ret);
-	}
-
-	return samples_copied;
-}
-
 /*
  * Read 16-bit samples from text file
  */
@@ -373,8 +688,9 @@ static int read_samples_s16(struct file_comp_data *cd, const struct audio_stream
 
 	switch (cd->fs.f_format) {
 	case FILE_RAW:
-		/* raw input file */
-		n_samples = read_binary_s16(cd, sink, samples);
+	case FILE_WAV:
+		/* raw or wav input file */
+		n_samples = read_mapped(cd, sink, samples, sizeof(int16_t));
 		break;
 	case FILE_TEXT:
 		/* text input file */
@@ -396,8 +712,9 @@ static int write_samples_s16(struct file_comp_data *cd, struct audio_stream *sou
 
 	switch (cd->fs.f_format) {
 	case FILE_RAW:
-		/* raw input file */
-		samples_written = write_binary_s16(cd, source, samples);
+	case FILE_WAV:
+		/* raw or wav output file */
+		samples_written = write_binary(cd, source, samples, sizeof(int16_t));
 		break;
 	case FILE_TEXT:
 		/* text input file */
@@ -529,6 +846,9 @@ static enum file_format get_file_format(char *filename)
 	if (!strcmp(ext, ".txt"))
 		return FILE_TEXT;
 
+	if (!strcmp(ext, ".wav"))
+		return FILE_WAV;
+
 	return FILE_RAW;
 }
 
@@ -542,6 +862,7 @@ static struct comp_dev *file_new(const struct comp_driver *drv,
 	struct dai_data *dd;
 	struct dai *fdai;
 	struct file_comp_data *cd;
+	int ret;
 
 	debug_print("file_new()\n");
 
@@ -587,6 +908,31 @@ static struct comp_dev *file_new(const struct comp_driver *drv,
 	cd->rate = ipc_file->rate;
 	cd->channels = ipc_file->channels;
 	cd->frame_fmt = ipc_file->frame_fmt;
+	cd->fs.rate = cd->rate;
+	cd->fs.channels = cd->channels;
+
+	/* raw and wav files are memory mapped */
+	if (cd->fs.f_format != FILE_TEXT) {
+		switch (cd->fs.mode) {
+		case FILE_READ:
+			ret = file_map_open_read(&cd->fs);
+			break;
+		case FILE_WRITE:
+			ret = file_map_open_write(&cd->fs);
+			break;
+		default:
+			ret = -EINVAL;
+			break;
+		}
+
+		if (ret < 0) {
+			fprintf(stderr, "error: mapping file %s - %s\n",
+				cd->fs.fn, strerror(-ret));
+			goto error;
+		}
+
+		goto out;
+	}
 
 	/* open file handle(s) depending on mode */
 	switch (cd->fs.mode) {
@@ -612,6 +958,7 @@ static struct comp_dev *file_new(const struct comp_driver *drv,
 		goto error;
 	}
 
+out:
 	cd->fs.reached_eof = false;
 	cd->fs.write_failed = false;
 	cd->fs.n = 0;
@@ -620,6 +967,7 @@ static struct comp_dev *file_new(const struct comp_driver *drv,
 	return dev;
 
 error:
+	free(cd->fs.fn);
 	free(cd);
 
 error_skip_cd:
@@ -643,7 +991,9 @@ static void file_free(struct comp_dev *dev)
 
 	comp_dbg(dev, "file_free()");
 
-	if (cd->fs.mode == FILE_READ)
+	if (cd->fs.f_format != FILE_TEXT)
+		file_map_close(&cd->fs);
+	else if (cd->fs.mode == FILE_READ)
 		fclose(cd->fs.rfh);
 	else
 		fclose(cd->fs.wfh);
@@ -875,6 +1225,12 @@ static int file_prepare(struct comp_dev *dev)
 	}
 
 	cd->sample_container_bytes = get_sample_bytes(stream->frame_fmt);
+
+	/* stream format for wav header */
+	cd->fs.channels = stream->channels;
+	cd->fs.rate = stream->rate;
+	cd->fs.sample_bytes = cd->sample_container_bytes;
+
 	buffer_reset_pos(buffer, NULL);
 	dev->state = COMP_STATE_PREPARE;
 	return ret;
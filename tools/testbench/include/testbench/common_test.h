@@ -27,6 +27,17 @@
 #define NUM_WIDGETS_SUPPORTED	12
 
 struct tplg_context;
+struct tplg_index;
+
+/* processing statistics of one testbench run, used by batch mode summary */
+struct tb_run_stats {
+	int n_in;		/* input samples */
+	int n_out;		/* output samples */
+	uint32_t fs_out;	/* output sample rate */
+	uint32_t channels_out;	/* output channels */
+	uint64_t exec_us;	/* processing wall time */
+	uint64_t cpu_us;	/* process CPU time while pipelines run */
+};
 
 /*
  * Global testbench data.
@@ -56,9 +67,20 @@ struct testbench_prm {
 	int pipeline_duration_ms;
 	int real_time;
 	FILE *file;
+	struct tplg_index *tplg_index; /* topology index shared by all pipelines */
+	char *tplg_cache_dir; /* directory for topology index cache files */
 	char *pipeline_string;
 	int output_file_index;
 
+	/* batch mode */
+	char *batch_file; /* job manifest, one job per line */
+	char *summary_file; /* machine readable summary, default stdout */
+	char *blob_file; /* binary blob with ABI header for a process widget */
+	char *blob_widget; /* name of the process widget to get the blob */
+	int batch_workers; /* number of parallel worker processes */
+	int host_mhz; /* host clock for MCPS estimate, 0 = probe */
+	struct tb_run_stats stats;
+
 	/* global cmd line args that can override topology */
 	enum sof_ipc_frame cmd_frame_fmt;
 	uint32_t cmd_fs_in;
@@ -103,6 +125,11 @@ int tb_pipeline_reset(struct ipc *ipc, struct pipeline *p,
 
 void debug_print(char *message);
 
+int tb_batch_run(struct testbench_prm *tp,
+		 int (*run)(struct testbench_prm *tp));
+
+int tb_host_mhz(void);
+
 int get_index_by_name(char *comp_name,
 		      struct shared_lib_table *lib_table);
 
@@ -11,6 +11,11 @@
 #ifndef _FILE_H
 #define _FILE_H
 
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
 /**< Convert with right shift a bytes count to samples count */
 #define FILE_BYTES_TO_S16_SAMPLES(s)	((s) >> 1)
 #define FILE_BYTES_TO_S32_SAMPLES(s)	((s) >> 2)
@@ -25,6 +30,55 @@ enum file_mode {
 enum file_format {
 	FILE_TEXT = 0,
 	FILE_RAW,
+	FILE_WAV,
+};
+
+/* canonical 44 byte RIFF/WAVE PCM header */
+struct file_wav_header {
+	char riff[4];
+	uint32_t riff_size;
+	char wave[4];
+	char fmt[4];
+	uint32_t fmt_size;
+	uint16_t format_tag;
+	uint16_t channels;
+	uint32_t rate;
+	uint32_t byte_rate;
+	uint16_t block_align;
+	uint16_t bits_per_sample;
+	char data[4];
+	uint32_t data_size;
+} __attribute__((packed));
+
+/* memory mapped sample file, used for raw and wav formats */
+struct file_map {
+	int fd;
+	uint8_t *addr;		/* start of mapping, NULL if not mapped */
+	size_t size;		/* mapped length */
+	size_t data_offset;	/* first sample byte, after wav header */
+	size_t pos;		/* current read or write offset */
+	size_t end;		/* end of sample data */
+};
+
+#define FILE_WB_BUFFERS		2
+#define FILE_WB_BUFFER_BYTES	(1024 * 1024)
+
+/*
+ * Double buffered writeback. copy() fills one buffer while a helper
+ * thread writes the other one to the file, so file I/O does not add to
+ * the pipeline processing time.
+ */
+struct file_writeback {
+	pthread_t thread;
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+	uint8_t *buf[FILE_WB_BUFFERS];
+	size_t fill[FILE_WB_BUFFERS];
+	bool full[FILE_WB_BUFFERS];
+	int active;		/* buffer filled by copy() */
+	int next;		/* buffer written next by the thread */
+	bool exit;
+	int error;
 };
 
 /* file component state */
@@ -37,6 +91,15 @@ struct file_state {
 	enum file_mode mode;
 	enum file_format f_format;
 	int copy_count;
+
+	/* raw and wav files */
+	struct file_map map;
+	struct file_writeback *wb;
+
+	/* stream format for wav header */
+	uint32_t channels;
+	uint32_t rate;
+	uint32_t sample_bytes;
 };
 
 /* file comp data */
@@ -54,4 +117,7 @@ struct file_comp_data {
 	int max_copies;
 };
 
+/* use double buffered async writeback for raw and wav output files */
+extern bool file_async_writeback;
+
 #endif
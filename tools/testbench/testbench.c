@@ -62,6 +62,7 @@ struct pipeline_thread_data {
 	struct testbench_prm *tp;
 	int count;			/* copy iteration count */
 	int core_id;
+	int ret;			/* test result */
 };
 
 /* shared library look up table */
@@ -201,7 +202,16 @@ static void print_usage(char *executable)
 	printf("  -D <pipeline duration in ms>\n");
 	printf("  -P <number of dynamic pipeline iterations>\n");
 	printf("  -T <microseconds for tick, 0 for batch mode>\n");
-	printf("  -V <number of virtual cores>\n\n");
+	printf("  -V <number of virtual cores>\n");
+	printf("  -k <blob file>, override bytes control data of the -K widget\n");
+	printf("  -K <widget name>, process widget to apply the -k or batch job blob\n");
+	printf("  -A Write raw and wav output files with async double buffered writeback\n");
+	printf("  -x <directory>, cache topology indexes keyed by topology file identity\n\n");
+	printf("Options for batch mode:\n");
+	printf("  -B <manifest>, run jobs \"<topology> <input> <outputs> [blob|-]\" from file\n");
+	printf("  -J <number of parallel batch workers>, default online CPU count\n");
+	printf("  -m <summary file>, write CSV batch summary to file instead of stdout\n");
+	printf("  -M <host MHz>, host clock for MCPS estimate, default from /proc/cpuinfo\n\n");
 	printf("Options for input and output format override:\n");
 	printf("  -b <input_format>, S16_LE, S24_LE, or S32_LE\n");
 	printf("  -c <input channels>\n");
@@ -351,7 +361,8 @@ static int parse_input_args(int argc, char **argv, struct testbench_prm *tp)
 	int option = 0;
 	int ret = 0;
 
-	while ((option = getopt(argc, argv, "hdqi:o:t:b:a:r:R:c:n:C:P:Vp:T:D:")) != -1) {
+	while ((option = getopt(argc, argv,
+				"hdqi:o:t:b:a:r:R:c:n:C:P:Vp:T:D:k:K:B:J:m:M:Ax:")) != -1) {
 		switch (option) {
 		/* input sample file */
 		case 'i':
@@ -439,6 +450,46 @@ static int parse_input_args(int argc, char **argv, struct testbench_prm *tp)
 			tp->pipeline_duration_ms = atoi(optarg);
 			break;
 
+		/* binary blob for process widgets */
+		case 'k':
+			tp->blob_file = strdup(optarg);
+			break;
+
+		/* process widget for the blob */
+		case 'K':
+			tp->blob_widget = strdup(optarg);
+			break;
+
+		/* batch mode job manifest */
+		case 'B':
+			tp->batch_file = strdup(optarg);
+			break;
+
+		/* number of batch mode worker processes */
+		case 'J':
+			tp->batch_workers = atoi(optarg);
+			break;
+
+		/* batch mode summary file */
+		case 'm':
+			tp->summary_file = strdup(optarg);
+			break;
+
+		/* host clock in MHz for MCPS estimate */
+		case 'M':
+			tp->host_mhz = atoi(optarg);
+			break;
+
+		/* async writeback of output files */
+		case 'A':
+			file_async_writeback = true;
+			break;
+
+		/* topology index cache directory */
+		case 'x':
+			tp->tplg_cache_dir = strdup(optarg);
+			break;
+
 		/* print usage */
 		default:
 			fprintf(stderr, "unknown option %c\n", option);
@@ -543,6 +594,7 @@ static int test_pipeline_load(struct pipeline_thread_data *ptdata,
 	ctx->sof = sof_get();
 	ctx->tp = tp;
 	ctx->tplg_file = tp->tplg_file;
+	ctx->index = tp->tplg_index;
 	ctx->pipeline_id = pipeline_id;
 	ctx->fs_in = tp->cmd_fs_in;
 	ctx->fs_out = tp->cmd_fs_out;
@@ -564,6 +616,84 @@ static void test_pipeline_free(struct pipeline_thread_data *ptdata,
 	test_pipeline_free_comps(pipeline_id);
 }
 
+#if CONFIG_COMP_PROFILING
+/* print copy() profile of each component, host cpu timer counts ns */
+static void test_pipeline_get_profile(int pipeline_id, int host_mhz)
+{
+	struct perf_cnt_profile *prof;
+	struct list_item *clist;
+	struct ipc_comp_dev *icd;
+	struct comp_dev *cd;
+	double load_total = 0;
+	double load;
+
+	printf("Component profile, ns per period, MCPS at %d MHz host clock:\n",
+	       host_mhz);
+	printf("%6s %4s %8s %10s %8s %8s %8s %8s %6s %7s %8s\n", "comp", "type",
+	       "periods", "frames", "avg", "p99", "peak", "budget", "misses",
+	       "load%", "MCPS");
+
+	list_for_item(clist, &sof_get()->ipc->comp_list) {
+		icd = container_of(clist, struct ipc_comp_dev, list);
+		if (icd->type != COMP_TYPE_COMPONENT)
+			continue;
+
+		cd = icd->cd;
+		if (cd->pipeline->pipeline_id != pipeline_id)
+			continue;
+
+		prof = &cd->prof;
+		load = prof->count && prof->budget ? (double)prof->cycles_total /
+			((double)prof->count * prof->budget) : 0;
+		load_total += load;
+
+		printf("%6u %4u %8u %10zu %8u %8u %8u %8u %6u %7.2f %8.2f\n",
+		       cd->ipc_config.id, cd->drv->type, prof->count, prof->frames,
+		       perf_cnt_profile_avg(prof), perf_cnt_profile_p99(prof),
+		       prof->cycles_peak, prof->budget, prof->deadline_misses,
+		       load * 100, load * host_mhz);
+	}
+
+	printf("Pipeline %d total load %.2f%%, %.2f MCPS\n\n", pipeline_id,
+	       load_total * 100, load_total * host_mhz);
+}
+#endif
+
+static uint64_t timespec_delta_us(struct timespec *t0, struct timespec *t1)
+{
+	return (t1->tv_sec - t0->tv_sec) * 1000000 +
+		(t1->tv_nsec - t0->tv_nsec) / 1000;
+}
+
+/*
+ * The process CPU time includes all virtual core threads, so it is sampled
+ * when the first tester thread starts processing and when the last one
+ * stops. The time of concurrently running pipelines is counted once.
+ */
+static pthread_mutex_t stats_lock = PTHREAD_MUTEX_INITIALIZER;
+static int stats_active;
+static struct timespec stats_cpu_t0;
+
+static void test_cpu_time_start(void)
+{
+	pthread_mutex_lock(&stats_lock);
+	if (!stats_active++)
+		clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &stats_cpu_t0);
+	pthread_mutex_unlock(&stats_lock);
+}
+
+static void test_cpu_time_stop(struct testbench_prm *tp)
+{
+	struct timespec tc1;
+
+	pthread_mutex_lock(&stats_lock);
+	if (!--stats_active) {
+		clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &tc1);
+		tp->stats.cpu_us += timespec_delta_us(&stats_cpu_t0, &tc1);
+	}
+	pthread_mutex_unlock(&stats_lock);
+}
+
 static void test_pipeline_stats(struct pipeline_thread_data *ptdata,
 				struct tplg_context *ctx, uint64_t delta)
 {
@@ -618,6 +748,9 @@ static void test_pipeline_stats(struct pipeline_thread_data *ptdata,
 	printf("Test Pipeline:\n");
 	printf("%s\n", tp->pipeline_string);
 	test_pipeline_get_file_stats(ctx->pipeline_id);
+#if CONFIG_COMP_PROFILING
+	test_pipeline_get_profile(ctx->pipeline_id, tp->host_mhz);
+#endif
 
 	printf("Input bit format: %s\n", tp->bits_in);
 	printf("Input sample rate: %d\n", ctx->fs_in);
@@ -630,6 +763,15 @@ static void test_pipeline_stats(struct pipeline_thread_data *ptdata,
 	printf("Output sample (frame) count: %d (%d)\n", n_out, n_out / ctx->channels_out);
 	printf("Total execution time: %zu us, %.2f x realtime\n\n",
 	       delta, (double)((double)n_out / ctx->channels_out / ctx->fs_out) * 1000000 / delta);
+
+	/* accumulate for batch mode summary */
+	pthread_mutex_lock(&stats_lock);
+	tp->stats.n_in += n_in;
+	tp->stats.n_out += n_out;
+	tp->stats.fs_out = ctx->fs_out;
+	tp->stats.channels_out = ctx->channels_out;
+	tp->stats.exec_us += delta;
+	pthread_mutex_unlock(&stats_lock);
 }
 
 /*
@@ -644,7 +786,7 @@ static void *pipline_test(void *data)
 	struct tplg_context ctx;
 	struct timespec ts;
 	struct timespec td0, td1;
-	int err;
+	int err = 0;
 	int nsleep_time;
 	int nsleep_limit;
 	uint64_t delta;
@@ -673,6 +815,7 @@ static void *pipline_test(void *data)
 			break;
 		}
 		clock_gettime(CLOCK_MONOTONIC, &td0);
+		test_cpu_time_start();
 
 		/* sleep to let the pipeline work - we exit at timeout OR
 		 * if copy iterations OR max_samples is reached (whatever first)
@@ -707,6 +850,7 @@ static void *pipline_test(void *data)
 		}
 
 		clock_gettime(CLOCK_MONOTONIC, &td1);
+		test_cpu_time_stop(tp);
 		err = test_pipeline_stop(ptdata, &ctx);
 		if (err < 0) {
 			fprintf(stderr, "error: pipeline stop %d failed %d\n",
@@ -714,8 +858,7 @@ static void *pipline_test(void *data)
 			break;
 		}
 
-		delta = (td1.tv_sec - td0.tv_sec) * 1000000;
-		delta += (td1.tv_nsec - td0.tv_nsec) / 1000;
+		delta = timespec_delta_us(&td0, &td1);
 		test_pipeline_stats(ptdata, &ctx, delta);
 
 		err = test_pipeline_reset(ptdata, &ctx);
@@ -731,14 +874,74 @@ static void *pipline_test(void *data)
 		dp_count++;
 	}
 
+	ptdata->ret = err < 0 ? err : 0;
 	return NULL;
 }
 
+/* set up firmware services and run the test threads, one per virtual core */
+static int testbench_run(struct testbench_prm *tp)
+{
+	struct pipeline_thread_data ptdata[CONFIG_CORE_COUNT];
+	struct tplg_index tplg_index;
+	int ret = 0;
+	int i, err;
+
+	if (!tp->host_mhz)
+		tp->host_mhz = tb_host_mhz();
+
+	/* index the topology once for all virtual cores and iterations */
+	ret = tplg_index_open(&tplg_index, tp->tplg_file, tp->tplg_cache_dir);
+	if (ret < 0) {
+		fprintf(stderr, "error: indexing topology %s\n", tp->tplg_file);
+		return ret;
+	}
+	tp->tplg_index = &tplg_index;
+
+	/* initialize ipc and scheduler */
+	if (tb_setup(sof_get(), tp) < 0) {
+		fprintf(stderr, "error: pipeline init\n");
+		tplg_index_close(&tplg_index);
+		tp->tplg_index = NULL;
+		return -EINVAL;
+	}
+
+	/* build, run and teardown pipelines */
+	for (i = 0; i < tp->num_vcores; i++) {
+		ptdata[i].core_id = i;
+		ptdata[i].tp = tp;
+		ptdata[i].count = 0;
+		ptdata[i].ret = 0;
+
+		err = pthread_create(&hc.thread_id[i], NULL,
+				     pipline_test, &ptdata[i]);
+		if (err) {
+			printf("error: can't create thread %d %s\n", err, strerror(err));
+			ret = -err;
+			break;
+		}
+	}
+
+	/* only join the threads that were created */
+	tp->num_vcores = i;
+	for (i = 0; i < tp->num_vcores; i++) {
+		pthread_join(hc.thread_id[i], NULL);
+		if (ptdata[i].ret < 0 && !ret)
+			ret = ptdata[i].ret;
+	}
+
+	/* free other core FW services */
+	tb_free(sof_get());
+
+	tplg_index_close(&tplg_index);
+	tp->tplg_index = NULL;
+
+	return ret;
+}
+
 static struct testbench_prm tp;
 
 int main(int argc, char **argv)
 {
-	struct pipeline_thread_data ptdata[CONFIG_CORE_COUNT];
 	int i, err;
 
 	/* initialize input and output sample rates, files, etc. */
@@ -774,25 +977,31 @@ int main(int argc, char **argv)
 	if (!tp.cmd_channels_out)
 		tp.cmd_channels_out = tp.cmd_channels_in;
 
-	/* check mandatory args */
-	if (!tp.tplg_file) {
+	/* check mandatory args, batch jobs provide their own files */
+	if (!tp.tplg_file && !tp.batch_file) {
 		fprintf(stderr, "topology file not specified, use -t file.tplg\n");
 		print_usage(argv[0]);
 		exit(EXIT_FAILURE);
 	}
 
-	if (!tp.input_file) {
+	if (!tp.input_file && !tp.batch_file) {
 		fprintf(stderr, "input audio file not specified, use -i file\n");
 		print_usage(argv[0]);
 		exit(EXIT_FAILURE);
 	}
 
-	if (!tp.output_file_num) {
+	if (!tp.output_file_num && !tp.batch_file) {
 		fprintf(stderr, "output files not specified, use -o file1,file2\n");
 		print_usage(argv[0]);
 		exit(EXIT_FAILURE);
 	}
 
+	if (tp.blob_file && !tp.blob_widget) {
+		fprintf(stderr, "blob widget not specified, use -K widget name\n");
+		print_usage(argv[0]);
+		exit(EXIT_FAILURE);
+	}
+
 	if (!tp.bits_in) {
 		fprintf(stderr, "input format not specified, use -b format\n");
 		print_usage(argv[0]);
@@ -814,32 +1023,10 @@ int main(int argc, char **argv)
 	else
 		tb_enable_trace(true);
 
-	/* initialize ipc and scheduler */
-	if (tb_setup(sof_get(), &tp) < 0) {
-		fprintf(stderr, "error: pipeline init\n");
-		exit(EXIT_FAILURE);
-	}
-
-	/* build, run and teardown pipelines */
-	for (i = 0; i < tp.num_vcores; i++) {
-		ptdata[i].core_id = i;
-		ptdata[i].tp = &tp;
-		ptdata[i].count = 0;
-
-		err = pthread_create(&hc.thread_id[i], NULL,
-				     pipline_test, &ptdata[i]);
-		if (err) {
-			printf("error: can't create thread %d %s\n", err, strerror(err));
-			goto join;
-		}
-	}
-
-join:
-	for (i = 0; i < tp.num_vcores; i++)
-		err = pthread_join(hc.thread_id[i], NULL);
-
-	/* free other core FW services */
-	tb_free(sof_get());
+	if (tp.batch_file)
+		err = tb_batch_run(&tp, testbench_run);
+	else
+		err = testbench_run(&tp);
 
 out:
 	/* free all other data */
@@ -849,6 +1036,11 @@ out:
 	for (i = 0; i < tp.output_file_num; i++)
 		free(tp.output_file[i]);
 	free(tp.pipeline_string);
+	free(tp.blob_file);
+	free(tp.blob_widget);
+	free(tp.batch_file);
+	free(tp.summary_file);
+	free(tp.tplg_cache_dir);
 
 #ifdef TESTBENCH_CACHE_CHECK
 	_cache_free_all();
@@ -860,5 +1052,6 @@ out:
 			dlclose(lib_table[i].handle);
 	}
 
-	return EXIT_SUCCESS;
+	/* batch mode reports the number of failed jobs */
+	return tp.batch_file && err ? EXIT_FAILURE : EXIT_SUCCESS;
 }
@@ -96,18 +96,19 @@ int find_widget(struct comp_info *temp_comp_list, int count, char *name)
 }
 
 /* load pipeline graph DAPM widget*/
-static int load_graph(void *dev, struct comp_info *temp_comp_list,
-		      struct testbench_prm *tp,
-		      int count, int num_comps, int pipeline_id)
+static int load_graph(struct tplg_context *ctx, int count, int num_comps,
+		      int pipeline_id)
 {
 	struct sof_ipc_pipe_comp_connect connection;
-	struct sof *sof = (struct sof *)dev;
+	struct comp_info *temp_comp_list = ctx->info;
+	struct testbench_prm *tp = ctx->tp;
+	struct sof *sof = ctx->sof;
 	int ret = 0;
 	int i;
 
 	for (i = 0; i < count; i++) {
 		ret = tplg_load_graph(num_comps, pipeline_id, temp_comp_list,
-				      tp->pipeline_string, &connection, tp->file, i,
+				      tp->pipeline_string, &connection, ctx->file, i,
 				      count);
 		if (ret < 0)
 			return ret;
@@ -614,6 +615,64 @@ static int process_append_data(struct sof_ipc_comp_process **process_ipc,
 	return 0;
 }
 
+/* read binary blob with ABI header to replace bytes control data */
+static int process_load_blob(const char *blob_file, char **priv_data,
+			     struct snd_soc_tplg_ctl_hdr *ctl)
+{
+	struct snd_soc_tplg_bytes_control *bytes_ctl;
+	FILE *fh;
+	long size;
+	int ret = 0;
+
+	if (ctl->ops.info != SND_SOC_TPLG_CTL_BYTES)
+		return 0;
+
+	fh = fopen(blob_file, "rb");
+	if (!fh) {
+		fprintf(stderr, "error: opening blob %s: %s\n", blob_file,
+			strerror(errno));
+		return -errno;
+	}
+
+	if (fseek(fh, 0, SEEK_END)) {
+		ret = -errno;
+		goto out;
+	}
+
+	size = ftell(fh);
+	if (size < 0 || fseek(fh, 0, SEEK_SET)) {
+		ret = -errno;
+		goto out;
+	}
+
+	if (size < sizeof(struct sof_abi_hdr)) {
+		fprintf(stderr, "error: blob %s is smaller than ABI header\n",
+			blob_file);
+		ret = -EINVAL;
+		goto out;
+	}
+
+	free(*priv_data);
+	*priv_data = malloc(size);
+	if (!*priv_data) {
+		ret = -ENOMEM;
+		goto out;
+	}
+
+	if (fread(*priv_data, size, 1, fh) != 1) {
+		fprintf(stderr, "error: reading blob %s\n", blob_file);
+		ret = -EIO;
+		goto out;
+	}
+
+	bytes_ctl = (struct snd_soc_tplg_bytes_control *)ctl;
+	bytes_ctl->priv.size = size;
+
+out:
+	fclose(fh);
+	return ret;
+}
+
 /* load process dapm widget */
 int load_process(struct tplg_context *ctx)
 {
@@ -645,8 +704,13 @@ int load_process(struct tplg_context *ctx)
 			return ret;
 		}
 
+		/* Optionally use blob from command line or batch job */
+		if (priv_data && ctx->tp->blob_file &&
+		    !strncmp(widget->name, ctx->tp->blob_widget, sizeof(widget->name)))
+			ret = process_load_blob(ctx->tp->blob_file, &priv_data, ctl);
+
 		/* Merge process and priv_data into process_ipc */
-		if (priv_data)
+		if (priv_data && !ret)
 			ret = process_append_data(&process_ipc, &process, ctl, priv_data);
 
 		free(ctl);
@@ -705,17 +769,58 @@ int load_mixer(struct tplg_context *ctx)
 	return ret;
 }
 
-static int get_next_hdr(struct tplg_context *ctx, struct snd_soc_tplg_hdr *hdr, size_t file_size)
+/* load the DAPM widgets of one block, seeking to indexed widgets if known */
+static int load_widget_block(struct tplg_context *ctx,
+			     const struct tplg_index *idx,
+			     const struct tplg_block *block)
 {
-	if (fseek(ctx->file, hdr->payload_size, SEEK_CUR)) {
-		fprintf(stderr, "error: fseek payload size\n");
+	struct testbench_prm *tp = ctx->tp;
+	struct comp_info *comp_list_realloc;
+	const struct tplg_widget_entry *entry;
+	char message[DEBUG_MSG_LEN];
+	size_t size;
+	int ret;
+	int i;
+
+	sprintf(message, "number of DAPM widgets %d\n", block->count);
+	debug_print(message);
+
+	/* update max pipeline_id */
+	if (block->index > tp->max_pipeline_id)
+		tp->max_pipeline_id = block->index;
+
+	ctx->info_elems += block->count;
+	size = sizeof(struct comp_info) * ctx->info_elems;
+	comp_list_realloc = (struct comp_info *)realloc(ctx->info, size);
+	if (!comp_list_realloc && size) {
+		fprintf(stderr, "error: mem realloc\n");
 		return -errno;
 	}
+	ctx->info = comp_list_realloc;
 
-	if (ftell(ctx->file) == file_size)
-		return 0;
+	for (i = (ctx->info_elems - block->count); i < ctx->info_elems; i++)
+		ctx->info[i].name = NULL;
+
+	entry = block->first_widget != TPLG_INDEX_NONE ?
+		&idx->widgets[block->first_widget] : NULL;
+
+	for (ctx->info_index = (ctx->info_elems - block->count);
+	     ctx->info_index < ctx->info_elems;
+	     ctx->info_index++) {
+		/* widget loaders don't need to consume all of their data */
+		if (entry && fseek(ctx->file, (entry++)->offset, SEEK_SET))
+			return -errno;
+
+		ret = load_widget(ctx);
+		if (ret < 0) {
+			printf("error: loading widget\n");
+			return ret;
+		} else if (ret > 0) {
+			ctx->comp_id++;
+		}
+	}
 
-	return 1;
+	return 0;
 }
 
 /* parse topology file and set up pipeline */
@@ -723,54 +828,49 @@ int parse_topology(struct tplg_context *ctx)
 {
 	struct snd_soc_tplg_hdr *hdr;
 	struct testbench_prm *tp = ctx->tp;
-	struct comp_info *comp_list_realloc = NULL;
+	const struct tplg_block *block;
+	const struct tplg_index *idx = ctx->index;
+	struct tplg_index local_idx;
 	char message[DEBUG_MSG_LEN];
 	int i;
-	int next;
 	int ret = 0;
-	size_t file_size;
-	size_t size;
 
 	/* initialize output file index */
 	tp->output_file_index = 0;
 
-	/* open topology file */
-	ctx->file = fopen(ctx->tplg_file, "rb");
+	/* index the topology here if the caller has not done it */
+	if (!idx) {
+		ret = tplg_index_open(&local_idx, ctx->tplg_file, NULL);
+		if (ret < 0)
+			return ret;
+		idx = &local_idx;
+	}
+
+	/* topology is read from the mapping shared by all pipeline loads */
+	ctx->file = tplg_index_fopen(idx);
 	if (!ctx->file) {
 		fprintf(stderr, "error: opening file %s\n", ctx->tplg_file);
 		fprintf(stderr, "error: %s\n", strerror(errno));
-		return -errno;
+		ret = -errno;
+		goto close;
 	}
 	tp->file = ctx->file; /* duplicated until we can merge tp with ctx */
 
-	/* file size */
-	if (fseek(ctx->file, 0, SEEK_END)) {
-		fprintf(stderr, "error: seek to end of topology\n");
-		fclose(ctx->file);
-		return -errno;
-	}
-	file_size = ftell(ctx->file);
-	if (fseek(ctx->file, 0, SEEK_SET)) {
-		fprintf(stderr, "error: seek to beginning of topology\n");
-		fclose(ctx->file);
-		return -errno;
-	}
-
 	/* allocate memory */
-	size = sizeof(struct snd_soc_tplg_hdr);
-	hdr = (struct snd_soc_tplg_hdr *)malloc(size);
+	hdr = (struct snd_soc_tplg_hdr *)malloc(sizeof(*hdr));
 	if (!hdr) {
 		fprintf(stderr, "error: mem alloc\n");
-		fclose(ctx->file);
-		return -errno;
+		ret = -errno;
+		goto close;
 	}
 
 	debug_print("topology parsing start\n");
-	while (1) {
-		/* read topology header */
-		ret = fread(hdr, sizeof(struct snd_soc_tplg_hdr), 1, ctx->file);
-		if (ret != 1)
-			goto out;
+	for (block = idx->blocks; block < idx->blocks + idx->num_blocks; block++) {
+		/* only the blocks of this pipeline are visited */
+		if (block->index != ctx->pipeline_id)
+			continue;
+
+		memcpy(hdr, idx->data + block->offset, sizeof(*hdr));
 
 		sprintf(message, "type: %x, size: 0x%x count: %d index: %d\n",
 			hdr->type, hdr->payload_size, hdr->count, hdr->index);
@@ -779,79 +879,34 @@ int parse_topology(struct tplg_context *ctx)
 
 		ctx->hdr = hdr;
 
-		if (hdr->index != ctx->pipeline_id) {
-			next = get_next_hdr(ctx, hdr, file_size);
-			if (next < 0)
-				goto out;
-			else if (next > 0)
-				continue;
-			else
-				goto finish;
+		if (fseek(ctx->file, block->offset + sizeof(*hdr), SEEK_SET)) {
+			ret = -errno;
+			goto out;
 		}
 
 		/* parse header and load the next block based on type */
 		switch (hdr->type) {
 		/* load dapm widget */
 		case SND_SOC_TPLG_TYPE_DAPM_WIDGET:
-
-			sprintf(message, "number of DAPM widgets %d\n",
-				hdr->count);
-
-			debug_print(message);
-
-			/* update max pipeline_id */
-			if (hdr->index > tp->max_pipeline_id)
-				tp->max_pipeline_id = hdr->index;
-
-			ctx->info_elems += hdr->count;
-			size = sizeof(struct comp_info) * ctx->info_elems;
-			comp_list_realloc = (struct comp_info *)
-					 realloc(ctx->info, size);
-
-			if (!comp_list_realloc && size) {
-				fprintf(stderr, "error: mem realloc\n");
-				ret = -errno;
+			ret = load_widget_block(ctx, idx, block);
+			if (ret < 0)
 				goto out;
-			}
-			ctx->info = comp_list_realloc;
-
-			for (i = (ctx->info_elems - hdr->count); i < ctx->info_elems; i++)
-				ctx->info[i].name = NULL;
-
-			for (ctx->info_index = (ctx->info_elems - hdr->count);
-			     ctx->info_index < ctx->info_elems;
-			     ctx->info_index++) {
-				ret = load_widget(ctx);
-				if (ret < 0) {
-					printf("error: loading widget\n");
-					goto finish;
-				} else if (ret > 0)
-					ctx->comp_id++;
-			}
 			break;
 
 		/* set up component connections from pipeline graph */
 		case SND_SOC_TPLG_TYPE_DAPM_GRAPH:
-			if (load_graph(ctx->sof, ctx->info, tp, hdr->count,
-				       ctx->comp_id, hdr->index) < 0) {
+			if (load_graph(ctx, hdr->count, ctx->comp_id,
+				       hdr->index) < 0) {
 				fprintf(stderr, "error: pipeline graph\n");
 				ret = -EINVAL;
 				goto out;
 			}
-			if (ftell(ctx->file) == file_size)
-				goto finish;
 			break;
 
 		default:
-			next = get_next_hdr(ctx, hdr, file_size);
-			if (next < 0)
-				goto out;
-			else if (next == 0)
-				goto finish;
 			break;
 		}
 	}
-finish:
 	debug_print("topology parsing end\n");
 
 out:
@@ -863,5 +918,8 @@ out:
 
 	free(ctx->info);
 	fclose(ctx->file);
+close:
+	if (idx == &local_idx)
+		tplg_index_close(&local_idx);
 	return ret;
 }
@@ -33,6 +33,17 @@ C_CONTROLMIXER(TDFB Direction, PIPELINE_ID,
 	"1")
 undefine(`CONTROL_NAME')
 
+define(`CONTROL_NAME', `DEF_TDFB_GCC_PHAT')
+C_CONTROLMIXER(TDFB GCC-PHAT, PIPELINE_ID,
+	CONTROLMIXER_OPS(volsw, 259 binds the mixer control to switch get/put handlers, 259, 259),
+	CONTROLMIXER_MAX(max 1 indicates switch type control, 1),
+	false,
+	,
+	Channel register and shift for Front Center,
+	LIST(`	', ENUM_CHANNEL(FC, 3, 0)),
+	"0")
+undefine(`CONTROL_NAME')
+
 # TDFB enum list
 CONTROLENUM_LIST(DEF_TDFB_AZIMUTH_VALUES,
 	LIST(`	', `"-90"', `"-75"', `"-60"', `"-45"', `"-30"', `"-15"', `"0"', `"15"', `"30"', `"45"', `"60"', `"75"', `"90"'))
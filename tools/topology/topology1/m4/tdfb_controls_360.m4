@@ -33,6 +33,17 @@ C_CONTROLMIXER(TDFB Direction, PIPELINE_ID,
 	"1")
 undefine(`CONTROL_NAME')
 
+define(`CONTROL_NAME', `DEF_TDFB_GCC_PHAT')
+C_CONTROLMIXER(TDFB GCC-PHAT, PIPELINE_ID,
+	CONTROLMIXER_OPS(volsw, 259 binds the mixer control to switch get/put handlers, 259, 259),
+	CONTROLMIXER_MAX(max 1 indicates switch type control, 1),
+	false,
+	,
+	Channel register and shift for Front Center,
+	LIST(`	', ENUM_CHANNEL(FC, 3, 0)),
+	"0")
+undefine(`CONTROL_NAME')
+
 # TDFB enum list
 CONTROLENUM_LIST(DEF_TDFB_AZIMUTH_VALUES,
 	LIST(`	', `"0"', `"30"', `"60"', `"90"', `"120"', `"150"', `"180"', `"210"', `"240"', `"270"', `"300"', `"330"'))
@@ -114,7 +114,7 @@ W_EQ_IIR(0, PIPELINE_FORMAT, 2, 2, SCHEDULE_CORE,
 # "TDFB 0" has 2 sink period and x source periods
 W_TDFB(0, PIPELINE_FORMAT, 2, DAI_PERIODS, SCHEDULE_CORE,
 	LIST(`		', "DEF_TDFB_BEAM"),
-	LIST(`		', "DEF_TDFB_DIRECTION"),
+	LIST(`		', "DEF_TDFB_DIRECTION", "DEF_TDFB_GCC_PHAT"),
 	LIST(`		', "DEF_TDFB_AZIMUTH"),
 	LIST(`		', "DEF_TDFB_AZIMUTH_ESTIMATE"),
 	LIST(`		', "DEF_TDFB_BYTES"))
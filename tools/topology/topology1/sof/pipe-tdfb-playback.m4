@@ -40,7 +40,7 @@ W_PCM_PLAYBACK(PCM_ID, TDFB Playback, 2, 0)
 # "TDFB 0" has x sink period and 2 source periods
 W_TDFB(0, PIPELINE_FORMAT, DAI_PERIODS, 2, SCHEDULE_CORE,
 	LIST(`		', "DEF_TDFB_BEAM"),
-	LIST(`		', "DEF_TDFB_DIRECTION"),
+	LIST(`		', "DEF_TDFB_DIRECTION", "DEF_TDFB_GCC_PHAT"),
 	LIST(`		', "DEF_TDFB_AZIMUTH"),
 	LIST(`		', "DEF_TDFB_AZIMUTH_ESTIMATE"),
 	LIST(`		', "DEF_TDFB_BYTES"))
@@ -12,6 +12,8 @@
 
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
 #include <sound/asoc.h>
 #include <ipc/dai.h>
 #include <kernel/tokens.h>
@@ -76,9 +78,45 @@ struct tplg_context {
 	struct testbench_prm *tp;
 	struct sof *sof;
 	const char *tplg_file;
+	const struct tplg_index *index;	/* optional, see tplg_index_open() */
 	struct fuzz *fuzzer;
 };
 
+#define TPLG_INDEX_NONE		UINT32_MAX
+
+/* one header and its payload in the topology file */
+struct tplg_block {
+	uint32_t type;		/* SND_SOC_TPLG_TYPE_ */
+	uint32_t index;		/* pipeline ID */
+	uint32_t count;		/* number of elements in payload */
+	uint32_t offset;	/* header offset in file */
+	uint32_t size;		/* payload size */
+	uint32_t first_widget;	/* widget entry or TPLG_INDEX_NONE */
+};
+
+/* one DAPM widget with its private data and kcontrols */
+struct tplg_widget_entry {
+	uint32_t offset;	/* widget offset in file */
+	uint32_t size;
+	uint32_t id;		/* SND_SOC_TPLG_DAPM_ */
+	uint32_t block;		/* owning block */
+};
+
+/*
+ * Index of a memory mapped topology file, built once and shared read only by
+ * all pipeline loads of the file.
+ */
+struct tplg_index {
+	const uint8_t *data;	/* topology file contents */
+	size_t size;
+	uint64_t key;		/* hash of the file identity, cache key */
+	struct tplg_block *blocks;
+	int num_blocks;
+	struct tplg_widget_entry *widgets;
+	int num_widgets;
+	uint32_t max_pipeline_id;
+};
+
 static const struct frame_types sof_frames[] = {
 	/* TODO: fix topology to use ALSA formats */
 	{"s16le", SOF_IPC_FRAME_S16_LE},
@@ -322,4 +360,9 @@ bool is_valid_priv_size(size_t size_read, size_t priv_size,
 
 int parse_topology(struct tplg_context *ctx);
 
+int tplg_index_open(struct tplg_index *idx, const char *tplg_file,
+		    const char *cache_dir);
+void tplg_index_close(struct tplg_index *idx);
+FILE *tplg_index_fopen(const struct tplg_index *idx);
+
 #endif
@@ -0,0 +1,444 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2022 Intel Corporation. All rights reserved.
+
+/*
+ * Topology file index. The topology is memory mapped once and the headers and
+ * DAPM widgets are located in a single pass, so loading a pipeline only
+ * visits its own blocks instead of walking the whole file with fread() and
+ * fseek(). The index can be stored in a cache directory, keyed by the device,
+ * inode, size and modification time of the topology, so later runs with the
+ * same topology skip the walk without reading the file contents.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <limits.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <ipc/topology.h>
+#include <ipc/stream.h>
+#include <ipc/dai.h>
+#include <tplg_parser/topology.h>
+
+#define TPLG_INDEX_MAGIC	0x58495054	/* "TPIX" */
+#define TPLG_INDEX_VERSION	2
+
+/* topology file identity, a changed file gets a new index */
+struct tplg_index_file_id {
+	uint64_t dev;
+	uint64_t ino;
+	uint64_t size;
+	uint64_t mtime_sec;
+	uint64_t mtime_nsec;
+};
+
+/* serialized index header, followed by the blocks and widgets arrays */
+struct tplg_index_cache_hdr {
+	uint32_t magic;
+	uint32_t version;
+	struct tplg_index_file_id id;
+	uint32_t num_blocks;
+	uint32_t num_widgets;
+};
+
+/* 64 bit FNV-1a of the file identity, names the cache file */
+static uint64_t tplg_index_key(const struct tplg_index_file_id *id)
+{
+	const uint8_t *data = (const uint8_t *)id;
+	uint64_t hash = 0xcbf29ce484222325ULL;
+	size_t i;
+
+	for (i = 0; i < sizeof(*id); i++) {
+		hash ^= data[i];
+		hash *= 0x100000001b3ULL;
+	}
+
+	return hash;
+}
+
+/* copy a topology object, the mapping gives no alignment guarantee */
+static int tplg_index_read(const struct tplg_index *idx, size_t offset,
+			   size_t end, void *obj, size_t size)
+{
+	if (offset > end || size > end - offset)
+		return -EINVAL;
+
+	memcpy(obj, idx->data + offset, size);
+	return 0;
+}
+
+/* size of one kcontrol including its private data */
+static int tplg_index_control_size(const struct tplg_index *idx, size_t offset,
+				   size_t end, size_t *size)
+{
+	struct snd_soc_tplg_mixer_control mixer_ctl;
+	struct snd_soc_tplg_enum_control enum_ctl;
+	struct snd_soc_tplg_bytes_control bytes_ctl;
+	struct snd_soc_tplg_ctl_hdr ctl_hdr;
+	int ret;
+
+	ret = tplg_index_read(idx, offset, end, &ctl_hdr, sizeof(ctl_hdr));
+	if (ret < 0)
+		return ret;
+
+	switch (ctl_hdr.ops.info) {
+	case SND_SOC_TPLG_CTL_VOLSW:
+	case SND_SOC_TPLG_CTL_STROBE:
+	case SND_SOC_TPLG_CTL_VOLSW_SX:
+	case SND_SOC_TPLG_CTL_VOLSW_XR_SX:
+	case SND_SOC_TPLG_CTL_RANGE:
+	case SND_SOC_TPLG_DAPM_CTL_VOLSW:
+		ret = tplg_index_read(idx, offset, end, &mixer_ctl,
+				      sizeof(mixer_ctl));
+		*size = sizeof(mixer_ctl) + mixer_ctl.priv.size;
+		break;
+	case SND_SOC_TPLG_CTL_ENUM:
+	case SND_SOC_TPLG_CTL_ENUM_VALUE:
+	case SND_SOC_TPLG_DAPM_CTL_ENUM_DOUBLE:
+	case SND_SOC_TPLG_DAPM_CTL_ENUM_VIRT:
+	case SND_SOC_TPLG_DAPM_CTL_ENUM_VALUE:
+		ret = tplg_index_read(idx, offset, end, &enum_ctl,
+				      sizeof(enum_ctl));
+		*size = sizeof(enum_ctl) + enum_ctl.priv.size;
+		break;
+	case SND_SOC_TPLG_CTL_BYTES:
+		ret = tplg_index_read(idx, offset, end, &bytes_ctl,
+				      sizeof(bytes_ctl));
+		*size = sizeof(bytes_ctl) + bytes_ctl.priv.size;
+		break;
+	default:
+		return -EINVAL;
+	}
+
+	return ret;
+}
+
+/* locate the widgets of a DAPM widget block, appended to idx->widgets */
+static int tplg_index_widgets(struct tplg_index *idx, struct tplg_block *block,
+			      int *widgets_max)
+{
+	struct snd_soc_tplg_dapm_widget widget;
+	struct tplg_widget_entry *entry;
+	size_t offset = block->offset + sizeof(struct snd_soc_tplg_hdr);
+	size_t end = offset + block->size;
+	size_t size;
+	void *tmp;
+	uint32_t i;
+	uint32_t j;
+	int ret;
+
+	for (i = 0; i < block->count; i++) {
+		ret = tplg_index_read(idx, offset, end, &widget, sizeof(widget));
+		if (ret < 0)
+			return ret;
+
+		if (idx->num_widgets == *widgets_max) {
+			*widgets_max = *widgets_max ? *widgets_max * 2 : 64;
+			tmp = realloc(idx->widgets,
+				      *widgets_max * sizeof(*idx->widgets));
+			if (!tmp)
+				return -ENOMEM;
+			idx->widgets = tmp;
+		}
+
+		entry = &idx->widgets[idx->num_widgets];
+		entry->offset = offset;
+		entry->id = widget.id;
+		entry->block = block - idx->blocks;
+
+		offset += sizeof(widget) + widget.priv.size;
+		for (j = 0; j < widget.num_kcontrols; j++) {
+			ret = tplg_index_control_size(idx, offset, end, &size);
+			if (ret < 0)
+				return ret;
+			offset += size;
+		}
+
+		if (offset > end)
+			return -EINVAL;
+
+		entry->size = offset - entry->offset;
+		idx->num_widgets++;
+	}
+
+	return 0;
+}
+
+/* walk all topology headers once */
+static int tplg_index_build(struct tplg_index *idx)
+{
+	struct snd_soc_tplg_hdr hdr;
+	struct tplg_block *block;
+	int blocks_max = 0;
+	int widgets_max = 0;
+	int first_widget;
+	size_t offset = 0;
+	void *tmp;
+	int ret;
+
+	while (offset < idx->size) {
+		ret = tplg_index_read(idx, offset, idx->size, &hdr, sizeof(hdr));
+		if (ret < 0) {
+			fprintf(stderr, "error: topology header at 0x%zx truncated\n",
+				offset);
+			return ret;
+		}
+
+		if (hdr.payload_size > idx->size - offset - sizeof(hdr)) {
+			fprintf(stderr, "error: topology payload at 0x%zx truncated\n",
+				offset);
+			return -EINVAL;
+		}
+
+		if (idx->num_blocks == blocks_max) {
+			blocks_max = blocks_max ? blocks_max * 2 : 32;
+			tmp = realloc(idx->blocks, blocks_max * sizeof(*idx->blocks));
+			if (!tmp)
+				return -ENOMEM;
+			idx->blocks = tmp;
+		}
+
+		block = &idx->blocks[idx->num_blocks++];
+		block->type = hdr.type;
+		block->index = hdr.index;
+		block->count = hdr.count;
+		block->offset = offset;
+		block->size = hdr.payload_size;
+		block->first_widget = TPLG_INDEX_NONE;
+
+		if (hdr.type == SND_SOC_TPLG_TYPE_DAPM_WIDGET) {
+			/* blocks the parser can't walk are loaded sequentially */
+			first_widget = idx->num_widgets;
+			if (tplg_index_widgets(idx, block, &widgets_max) < 0)
+				idx->num_widgets = first_widget;
+			else
+				block->first_widget = first_widget;
+		}
+
+		offset += sizeof(hdr) + hdr.payload_size;
+	}
+
+	return 0;
+}
+
+static int tplg_index_cache_file(const struct tplg_index *idx,
+				 const char *cache_dir, char *name)
+{
+	int len;
+
+	len = snprintf(name, PATH_MAX, "%s/%016" PRIx64 ".tplgidx", cache_dir,
+		       idx->key);
+
+	return len < 0 || len >= PATH_MAX ? -ENAMETOOLONG : 0;
+}
+
+/* load a cached index, any mismatch makes the caller rebuild it */
+static int tplg_index_cache_load(struct tplg_index *idx, const char *cache_dir,
+				 const struct tplg_index_file_id *id)
+{
+	struct tplg_index_cache_hdr hdr;
+	size_t blocks_size;
+	size_t widgets_size;
+	char name[PATH_MAX];
+	FILE *f;
+	int ret;
+	int i;
+
+	ret = tplg_index_cache_file(idx, cache_dir, name);
+	if (ret < 0)
+		return ret;
+
+	ret = -EINVAL;
+	f = fopen(name, "rb");
+	if (!f)
+		return -errno;
+
+	if (fread(&hdr, sizeof(hdr), 1, f) != 1 ||
+	    hdr.magic != TPLG_INDEX_MAGIC || hdr.version != TPLG_INDEX_VERSION ||
+	    memcmp(&hdr.id, id, sizeof(*id)))
+		goto out;
+
+	blocks_size = hdr.num_blocks * sizeof(*idx->blocks);
+	widgets_size = hdr.num_widgets * sizeof(*idx->widgets);
+	idx->blocks = malloc(blocks_size + 1);
+	idx->widgets = malloc(widgets_size + 1);
+	if (!idx->blocks || !idx->widgets) {
+		ret = -ENOMEM;
+		goto out;
+	}
+
+	if ((blocks_size && fread(idx->blocks, blocks_size, 1, f) != 1) ||
+	    (widgets_size && fread(idx->widgets, widgets_size, 1, f) != 1))
+		goto out;
+
+	idx->num_blocks = hdr.num_blocks;
+	idx->num_widgets = hdr.num_widgets;
+
+	/* the offsets are used to seek in the mapping, check them */
+	for (i = 0; i < idx->num_blocks; i++)
+		if (idx->blocks[i].offset > idx->size ||
+		    (idx->blocks[i].first_widget != TPLG_INDEX_NONE &&
+		     idx->blocks[i].first_widget + idx->blocks[i].count >
+		     idx->num_widgets))
+			goto out;
+
+	for (i = 0; i < idx->num_widgets; i++)
+		if (idx->widgets[i].offset > idx->size)
+			goto out;
+
+	ret = 0;
+
+out:
+	fclose(f);
+	if (ret < 0) {
+		free(idx->blocks);
+		free(idx->widgets);
+		idx->blocks = NULL;
+		idx->widgets = NULL;
+		idx->num_blocks = 0;
+		idx->num_widgets = 0;
+	}
+
+	return ret;
+}
+
+/* store the index, written to a temporary file first for concurrent runs */
+static int tplg_index_cache_store(const struct tplg_index *idx,
+				  const char *cache_dir,
+				  const struct tplg_index_file_id *id)
+{
+	struct tplg_index_cache_hdr hdr;
+	char name[PATH_MAX];
+	char tmp_name[PATH_MAX + 16];
+	FILE *f;
+	int ret;
+
+	ret = tplg_index_cache_file(idx, cache_dir, name);
+	if (ret < 0)
+		return ret;
+
+	snprintf(tmp_name, sizeof(tmp_name), "%s.%d", name, getpid());
+	f = fopen(tmp_name, "wb");
+	if (!f)
+		return -errno;
+
+	hdr.magic = TPLG_INDEX_MAGIC;
+	hdr.version = TPLG_INDEX_VERSION;
+	hdr.id = *id;
+	hdr.num_blocks = idx->num_blocks;
+	hdr.num_widgets = idx->num_widgets;
+
+	if (fwrite(&hdr, sizeof(hdr), 1, f) != 1 ||
+	    fwrite(idx->blocks, sizeof(*idx->blocks), idx->num_blocks, f) !=
+	    idx->num_blocks ||
+	    fwrite(idx->widgets, sizeof(*idx->widgets), idx->num_widgets, f) !=
+	    idx->num_widgets)
+		ret = -EIO;
+
+	if (fclose(f) && !ret)
+		ret = -errno;
+
+	if (!ret && rename(tmp_name, name) < 0)
+		ret = -errno;
+
+	if (ret < 0)
+		unlink(tmp_name);
+
+	return ret;
+}
+
+int tplg_index_open(struct tplg_index *idx, const char *tplg_file,
+		    const char *cache_dir)
+{
+	struct tplg_index_file_id id;
+	struct stat st;
+	int ret;
+	int fd;
+	int i;
+
+	memset(idx, 0, sizeof(*idx));
+	memset(&id, 0, sizeof(id));
+
+	fd = open(tplg_file, O_RDONLY);
+	if (fd < 0) {
+		fprintf(stderr, "error: opening file %s: %s\n", tplg_file,
+			strerror(errno));
+		return -errno;
+	}
+
+	if (fstat(fd, &st) < 0) {
+		ret = -errno;
+		close(fd);
+		return ret;
+	}
+
+	if (!st.st_size) {
+		fprintf(stderr, "error: topology %s is empty\n", tplg_file);
+		close(fd);
+		return -EINVAL;
+	}
+
+	idx->size = st.st_size;
+	idx->data = mmap(NULL, idx->size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (idx->data == MAP_FAILED) {
+		idx->data = NULL;
+		return -errno;
+	}
+
+	id.dev = st.st_dev;
+	id.ino = st.st_ino;
+	id.size = st.st_size;
+	id.mtime_sec = st.st_mtim.tv_sec;
+	id.mtime_nsec = st.st_mtim.tv_nsec;
+	idx->key = tplg_index_key(&id);
+
+	if (!cache_dir || tplg_index_cache_load(idx, cache_dir, &id) < 0) {
+		ret = tplg_index_build(idx);
+		if (ret < 0) {
+			tplg_index_close(idx);
+			return ret;
+		}
+
+		/* a failed store only costs the walk on the next run */
+		if (cache_dir && tplg_index_cache_store(idx, cache_dir, &id) < 0)
+			fprintf(stderr, "warning: can't write topology index to %s\n",
+				cache_dir);
+	}
+
+	for (i = 0; i < idx->num_blocks; i++)
+		if (idx->blocks[i].type == SND_SOC_TPLG_TYPE_DAPM_WIDGET &&
+		    idx->blocks[i].index > idx->max_pipeline_id)
+			idx->max_pipeline_id = idx->blocks[i].index;
+
+	return 0;
+}
+
+void tplg_index_close(struct tplg_index *idx)
+{
+	if (idx->data)
+		munmap((void *)idx->data, idx->size);
+
+	free(idx->blocks);
+	free(idx->widgets);
+	memset(idx, 0, sizeof(*idx));
+}
+
+FILE *tplg_index_fopen(const struct tplg_index *idx)
+{
+	FILE *file;
+
+	/* read only memory stream, reads are copies out of the mapping */
+	file = fmemopen((void *)idx->data, idx->size, "rb");
+	if (file)
+		setvbuf(file, NULL, _IONBF, 0);
+
+	return file;
+}
@@ -17,4 +17,8 @@
 #define atomic_read(p)		((long)atomic_get(p))
 #define atomic_init(p, v)	atomic_set(p, v)
 
+/* Zephyr atomics are sequentially consistent, so also acquire/release */
+#define atomic_read_acquire(p)	((long)atomic_get(p))
+#define atomic_set_release(p, v)	atomic_set(p, v)
+
 #endif